@@ -77,131 +77,293 @@ ts::json::ValuePtr ts::json::Factory(Type type, const UString& value)
 // Parse a JSON value (typically an object or array).
 //----------------------------------------------------------------------------
 
-bool ts::json::Parse(ValuePtr& value, const UStringList& lines, Report& report)
+//
+// The JSON grammar is implemented once, in the template function ParseValue()
+// below. It gets its tokens from a "lexer" class. There are two lexers: one
+// over a TextParser and one over a contiguous buffer. Complete JSON documents
+// are parsed directly from one contiguous buffer, without splitting the text
+// into lines and without any intermediate substring for literals. Large JSON
+// documents (EPG exports or converted tables for instance) are consequently
+// parsed with one allocation per value only.
+//
+// A lexer class shall provide the following methods:
+//   void   skipWhiteSpace();
+//   bool   match(const UChar* str);         // match and skip str
+//   bool   parseString(UString& str);       // JSON string literal
+//   bool   parseNumber(UString& str);       // numeric literal, floating point allowed, no hexadecimal
+//   bool   eof() const;
+//   size_t lineNumber() const;
+//
+
+namespace {
+
+    // Lexer over a TextParser.
+    class TextLexer
+    {
+        TS_NOBUILD_NOCOPY(TextLexer);
+    public:
+        TextLexer(ts::TextParser& parser) : _parser(parser) {}
+        void skipWhiteSpace() { _parser.skipWhiteSpace(); }
+        bool match(const ts::UChar* str) { return _parser.match(str, true); }
+        bool parseString(ts::UString& str) { return _parser.parseJSONStringLiteral(str); }
+        bool parseNumber(ts::UString& str) { return _parser.parseNumericLiteral(str, false, true); }
+        bool eof() const { return _parser.eof(); }
+        size_t lineNumber() const { return _parser.lineNumber(); }
+    private:
+        ts::TextParser& _parser;
+    };
+
+    // Lexer over a contiguous buffer, same tokens as TextParser.
+    class BufferLexer
+    {
+        TS_NOBUILD_NOCOPY(BufferLexer);
+    public:
+        BufferLexer(const ts::UString& text) : _cur(text.data()), _end(text.data() + text.size()), _line(1), _past_end(false) {}
+        void skipWhiteSpace();
+        bool match(const ts::UChar* str);
+        bool parseString(ts::UString& str);
+        bool parseNumber(ts::UString& str);
+        bool eof() const { return _cur >= _end; }
+        size_t lineNumber() const { return _line; }
+    private:
+        const ts::UChar* _cur;
+        const ts::UChar* _end;
+        size_t           _line;
+        bool             _past_end;  // Skipped past the end of the last line, as TextParser.
+    };
+
+}
+
+void BufferLexer::skipWhiteSpace()
 {
-    TextParser parser(lines, report);
-    return Parse(value, parser, true, report);
+    while (_cur < _end && ts::IsSpace(*_cur)) {
+        if (*_cur++ == ts::LINE_FEED) {
+            _line++;
+        }
+    }
+    // Like TextParser, skipping the end of the last line moves to the next line number.
+    if (_cur >= _end && !_past_end) {
+        _past_end = true;
+        _line++;
+    }
 }
 
-bool ts::json::Parse(ValuePtr& value, const UString& text, Report& report)
+bool BufferLexer::match(const ts::UChar* str)
+{
+    const ts::UChar* cur = _cur;
+    while (*str != ts::CHAR_NULL) {
+        if (cur >= _end || *cur++ != *str++) {
+            return false;
+        }
+    }
+    _cur = cur;
+    return true;
+}
+
+bool BufferLexer::parseString(ts::UString& str)
 {
-    TextParser parser(text, report);
-    return Parse(value, parser, true, report);
+    // Same as TextParser::parseJSONStringLiteral(): a string literal cannot span several lines.
+    if (_cur >= _end || *_cur != u'"') {
+        return false;
+    }
+    const ts::UChar* const start = _cur + 1;
+    const ts::UChar* cur = start;
+    bool escaped = false;
+    while (cur < _end && *cur != u'"' && *cur != ts::LINE_FEED) {
+        if (*cur++ == u'\\') {
+            escaped = true;
+            if (cur < _end && *cur != ts::LINE_FEED) {
+                cur++; // skip character after backslash.
+            }
+        }
+    }
+    if (cur >= _end || *cur != u'"') {
+        return false;
+    }
+    str.assign(start, cur - start);
+    if (escaped) {
+        str.convertFromJSON();
+    }
+    _cur = cur + 1;
+    return true;
 }
 
-bool ts::json::Parse(ValuePtr& value, TextParser& parser, bool jsonOnly, Report& report)
+bool BufferLexer::parseNumber(ts::UString& str)
+{
+    // Same as TextParser::parseNumericLiteral(), floating point allowed, hexadecimal not allowed.
+    const ts::UChar* cur = _cur;
+    if (cur < _end && (*cur == u'-' || *cur == u'+')) {
+        ++cur;
+    }
+    if (cur >= _end || !ts::IsDigit(*cur)) {
+        return false;
+    }
+    if (cur + 2 < _end && cur[0] == u'0' && (cur[1] == u'x' || cur[1] == u'X') && ts::IsHexa(cur[2])) {
+        return false;
+    }
+    while (cur < _end && ts::IsDigit(*cur)) {
+        ++cur;
+    }
+    if (cur < _end && *cur == u'.') {
+        ++cur;
+        while (cur < _end && ts::IsDigit(*cur)) {
+            ++cur;
+        }
+    }
+    if (cur < _end && (*cur == u'e' || *cur == u'E')) {
+        ++cur;
+        if (cur < _end && (*cur == u'+' || *cur == u'-')) {
+            ++cur;
+        }
+        while (cur < _end && ts::IsDigit(*cur)) {
+            ++cur;
+        }
+    }
+    if (cur < _end && (*cur == u'.' || *cur == u'_' || ts::IsAlpha(*cur))) {
+        return false;
+    }
+    str.assign(_cur, cur - _cur);
+    _cur = cur;
+    return true;
+}
+
+// The JSON grammar.
+template <class LEXER>
+static bool ParseValue(ts::json::ValuePtr& value, LEXER& lexer, bool jsonOnly, ts::Report& report)
 {
     value.clear();
 
-    UString str;
+    ts::UString str;
     int64_t intVal;
 
     // Leading spaces are ignored.
-    parser.skipWhiteSpace();
+    lexer.skipWhiteSpace();
 
     // Look for one of the seven possible forms or JSON value.
-    if (parser.match(u"null", true)) {
-        value = new Null;
+    if (lexer.match(u"null")) {
+        value = new ts::json::Null;
     }
-    else if (parser.match(u"true", true)) {
-        value = new True;
+    else if (lexer.match(u"true")) {
+        value = new ts::json::True;
     }
-    else if (parser.match(u"false", true)) {
-        value = new False;
+    else if (lexer.match(u"false")) {
+        value = new ts::json::False;
     }
-    else if (parser.parseJSONStringLiteral(str)) {
-        value = new String(str);
+    else if (lexer.parseString(str)) {
+        value = new ts::json::String(str);
     }
-    else if (parser.parseNumericLiteral(str, false, true)) {
+    else if (lexer.parseNumber(str)) {
         if (str.toInteger(intVal)) {
-            value = new Number(intVal);
+            value = new ts::json::Number(intVal);
         }
         else {
             // Invalid integer,
-            report.error(u"line %d: JSON floating-point numbers not yet supported, using \"null\" instead", {parser.lineNumber()});
-            value = new Null;
+            report.error(u"line %d: JSON floating-point numbers not yet supported, using \"null\" instead", {lexer.lineNumber()});
+            value = new ts::json::Null;
         }
     }
-    else if (parser.match(u"{", true)) {
+    else if (lexer.match(u"{")) {
         // Parse an object.
-        value = new Object;
+        value = new ts::json::Object;
         // Loop on all fields of the object.
         for (;;) {
-            parser.skipWhiteSpace();
+            lexer.skipWhiteSpace();
             // Exit at end of object
-            if (parser.match(u"}", true)) {
+            if (lexer.match(u"}")) {
                 break;
             }
-            ValuePtr element;
-            if (!parser.parseJSONStringLiteral(str) ||
-                !parser.skipWhiteSpace() ||
-                !parser.match(u":", true) ||
-                !parser.skipWhiteSpace() ||
-                !Parse(element, parser, false, report))
-            {
+            ts::json::ValuePtr element;
+            if (!lexer.parseString(str)) {
+                return false;
+            }
+            lexer.skipWhiteSpace();
+            if (!lexer.match(u":")) {
+                return false;
+            }
+            lexer.skipWhiteSpace();
+            if (!ParseValue(element, lexer, false, report)) {
                 return false;
             }
             // Found field.
             value->add(str, element);
-            parser.skipWhiteSpace();
+            lexer.skipWhiteSpace();
             // Exit at end of object
-            if (parser.match(u"}", true)) {
+            if (lexer.match(u"}")) {
                 break;
             }
             // Expect a comma before next field.
-            if (!parser.match(u",", true)) {
-                report.error(u"line %d: syntax error in JSON object, missing ','", {parser.lineNumber()});
+            if (!lexer.match(u",")) {
+                report.error(u"line %d: syntax error in JSON object, missing ','", {lexer.lineNumber()});
                 return false;
             }
         }
     }
-    else if (parser.match(u"[", true)) {
+    else if (lexer.match(u"[")) {
         // Parse an array.
-        value = new Array;
+        value = new ts::json::Array;
         // Loop on all elements of the array.
         for (;;) {
-            parser.skipWhiteSpace();
+            lexer.skipWhiteSpace();
             // Exit at end of array.
-            if (parser.match(u"]", true)) {
+            if (lexer.match(u"]")) {
                 break;
             }
-            ValuePtr element;
-            if (!Parse(element, parser, false, report)) {
+            ts::json::ValuePtr element;
+            if (!ParseValue(element, lexer, false, report)) {
                 return false;
             }
             // Found an element.
             value->set(element);
-            parser.skipWhiteSpace();
+            lexer.skipWhiteSpace();
             // Exit at end of array.
-            if (parser.match(u"]", true)) {
+            if (lexer.match(u"]")) {
                 break;
             }
             // Expect a comma before next element
-            if (!parser.match(u",", true)) {
-                report.error(u"line %d: syntax error in JSON array, missing ','", {parser.lineNumber()});
+            if (!lexer.match(u",")) {
+                report.error(u"line %d: syntax error in JSON array, missing ','", {lexer.lineNumber()});
                 return false;
             }
         }
     }
     else {
-        report.error(u"line %d: not a valid JSON value", {parser.lineNumber()});
+        report.error(u"line %d: not a valid JSON value", {lexer.lineNumber()});
         return false;
     }
 
     // Process text after the JSON value.
     if (jsonOnly) {
         // Nothing is allowed after the JSON value.
-        parser.skipWhiteSpace();
-        if (parser.eof()) {
-            return true;
-        }
-        else {
-            report.error(u"line %d: extraneous text after JSON value", {parser.lineNumber()});
+        lexer.skipWhiteSpace();
+        if (!lexer.eof()) {
+            report.error(u"line %d: extraneous text after JSON value", {lexer.lineNumber()});
             return false;
         }
     }
+    return true;
+}
+
+bool ts::json::Parse(ValuePtr& value, const UStringList& lines, Report& report)
+{
+    return Parse(value, UString::Join(lines, UString(1, LINE_FEED)), report);
+}
+
+bool ts::json::Parse(ValuePtr& value, const UString& text, Report& report)
+{
+    // Same as TextParser, ignore carriage returns.
+    if (text.find(CARRIAGE_RETURN) != NPOS) {
+        const UString filtered(text.toRemoved(CARRIAGE_RETURN));
+        BufferLexer lexer(filtered);
+        return ParseValue(value, lexer, true, report);
+    }
     else {
-        // Do not parse further.
-        return true;
+        BufferLexer lexer(text);
+        return ParseValue(value, lexer, true, report);
     }
 }
+
+bool ts::json::Parse(ValuePtr& value, TextParser& parser, bool jsonOnly, Report& report)
+{
+    TextLexer lexer(parser);
+    return ParseValue(value, lexer, jsonOnly, report);
+}
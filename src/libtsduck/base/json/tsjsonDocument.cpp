@@ -0,0 +1,536 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsjsonDocument.h"
+#include "tsjsonReader.h"
+#include "tsjsonNull.h"
+#include "tsjsonTrue.h"
+#include "tsjsonFalse.h"
+#include "tsjsonNumber.h"
+#include "tsjsonString.h"
+#include "tsjsonObject.h"
+#include "tsjsonArray.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor and clear.
+//----------------------------------------------------------------------------
+
+ts::json::Document::Document() :
+    _text(),
+    _nodes(),
+    _members()
+{
+}
+
+void ts::json::Document::clear()
+{
+    _text.clear();
+    _nodes.clear();
+    _members.clear();
+}
+
+const ts::json::Value& ts::json::Document::root() const
+{
+    if (_nodes.empty()) {
+        return NullValue;
+    }
+    else {
+        return _nodes.front();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Parse a JSON document.
+//----------------------------------------------------------------------------
+
+bool ts::json::Document::parse(const UString& text, Report& report)
+{
+    // Same as json::Parse(), ignore carriage returns.
+    return parse(text.toRemoved(CARRIAGE_RETURN).toUTF8(), report);
+}
+
+bool ts::json::Document::load(const UString& fileName, Report& report)
+{
+    clear();
+    std::ifstream strm(fileName.toUTF8().c_str(), std::ios::in | std::ios::binary);
+    std::string text;
+    if (strm) {
+        strm.seekg(0, std::ios::end);
+        const std::streamoff size = strm.tellg();
+        strm.seekg(0, std::ios::beg);
+        if (size >= 0) {
+            text.resize(size_t(size));
+            strm.read(&text[0], size);
+        }
+    }
+    if (!strm) {
+        report.error(u"error reading file %s", {fileName});
+        return false;
+    }
+    return parse(text, report);
+}
+
+bool ts::json::Document::parse(const char* data, size_t size, Report& report)
+{
+    clear();
+
+    // Fields and elements of all open objects and arrays. When an object or array
+    // is complete, its members are moved at the end of _members, contiguously.
+    std::vector<Member> pending;
+    // Open objects and arrays: node index and index of first member in pending.
+    std::vector<std::pair<size_t, size_t>> open;
+
+    Reader reader(data, size, report);
+    while (reader.next()) {
+        const Reader::Event event = reader.event();
+
+        // End of object or array.
+        if (event == Reader::EventEndObject || event == Reader::EventEndArray) {
+            Node& node(_nodes[open.back().first]);
+            const size_t first = open.back().second;
+            open.pop_back();
+            node._index = _members.size();
+            node._size = pending.size() - first;
+            if (event == Reader::EventEndObject) {
+                node._size = removeDuplicates(pending, first, node._size);
+            }
+            _members.insert(_members.end(), pending.begin() + first, pending.begin() + first + node._size);
+            pending.resize(first);
+            continue;
+        }
+
+        // New value.
+        const size_t index = _nodes.size();
+        switch (event) {
+            case Reader::EventTrue:
+                _nodes.push_back(Node(this, TypeTrue));
+                break;
+            case Reader::EventFalse:
+                _nodes.push_back(Node(this, TypeFalse));
+                break;
+            case Reader::EventString:
+                _nodes.push_back(Node(this, TypeString));
+                _nodes.back()._index = _text.size();
+                _nodes.back()._size = reader.text().size();
+                _text.append(reader.text());
+                break;
+            case Reader::EventNumber:
+                _nodes.push_back(Node(this, TypeNumber));
+                // Fast path for plain integers, otherwise same conversion as json::Parse().
+                if (!Reader::ToInteger(_nodes.back()._number, reader.text()) && !UString::FromUTF8(reader.text()).toInteger(_nodes.back()._number)) {
+                    report.error(u"line %d: JSON floating-point numbers not yet supported, using \"null\" instead", {reader.lineNumber()});
+                    _nodes.back()._type = TypeNull;
+                }
+                break;
+            case Reader::EventBeginObject:
+                _nodes.push_back(Node(this, TypeObject));
+                break;
+            case Reader::EventBeginArray:
+                _nodes.push_back(Node(this, TypeArray));
+                break;
+            case Reader::EventNull:
+            case Reader::EventNone:
+            case Reader::EventEndObject:
+            case Reader::EventEndArray:
+            default:
+                _nodes.push_back(Node(this, TypeNull));
+                break;
+        }
+
+        // Add the value in the enclosing object or array.
+        if (!open.empty()) {
+            pending.push_back(Member({_text.size(), reader.key().size(), index}));
+            _text.append(reader.key());
+        }
+        if (event == Reader::EventBeginObject || event == Reader::EventBeginArray) {
+            open.push_back(std::make_pair(index, pending.size()));
+        }
+    }
+
+    if (reader.error() || _nodes.empty()) {
+        clear();
+        return false;
+    }
+
+    // The document is read-only, release unused capacity.
+    _text.shrink_to_fit();
+    _nodes.shrink_to_fit();
+    _members.shrink_to_fit();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove duplicated field names in a list of object members.
+//----------------------------------------------------------------------------
+
+bool ts::json::Document::sameKey(const Member& m1, const Member& m2) const
+{
+    return m1.key_size == m2.key_size && _text.compare(m1.key, m1.key_size, _text, m2.key, m2.key_size) == 0;
+}
+
+size_t ts::json::Document::removeDuplicates(std::vector<Member>& members, size_t first, size_t count) const
+{
+    // Same as json::Object: a duplicated field replaces the value of the previous one.
+    // The field keeps the position of its first occurrence in insertion order.
+    const size_t end = first + count;
+    bool found = false;
+
+    if (count <= 16) {
+        // Objects are usually small, a simple quadratic search is faster than sorting.
+        for (size_t i = first + 1; i < end; ++i) {
+            for (size_t j = first; j < i; ++j) {
+                if (members[j].node != NPOS && sameKey(members[j], members[i])) {
+                    members[j].node = members[i].node;
+                    members[i].node = NPOS;
+                    found = true;
+                    break;
+                }
+            }
+        }
+    }
+    else {
+        // Sort member indexes by field name, then position.
+        std::vector<size_t> order(count);
+        for (size_t i = 0; i < count; ++i) {
+            order[i] = first + i;
+        }
+        std::stable_sort(order.begin(), order.end(), [this, &members](size_t i1, size_t i2) {
+            const Member& m1(members[i1]);
+            const Member& m2(members[i2]);
+            return _text.compare(m1.key, m1.key_size, _text, m2.key, m2.key_size) < 0;
+        });
+        // In each sequence of identical names, the first member gets the value of the last one.
+        for (size_t i = 0; i < count; ) {
+            size_t j = i + 1;
+            while (j < count && sameKey(members[order[i]], members[order[j]])) {
+                ++j;
+            }
+            if (j > i + 1) {
+                members[order[i]].node = members[order[j - 1]].node;
+                for (size_t k = i + 1; k < j; ++k) {
+                    members[order[k]].node = NPOS;
+                }
+                found = true;
+            }
+            i = j;
+        }
+    }
+
+    // Compact the list of members.
+    if (!found) {
+        return count;
+    }
+    const auto last = std::remove_if(members.begin() + first, members.begin() + end, [](const Member& m) { return m.node == NPOS; });
+    return size_t(last - (members.begin() + first));
+}
+
+
+//----------------------------------------------------------------------------
+// Build a modifiable copy of the document.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::json::Document::toValue() const
+{
+    return _nodes.empty() ? ValuePtr() : toValue(_nodes.front());
+}
+
+ts::json::ValuePtr ts::json::Document::toValue(const Node& node) const
+{
+    switch (node._type) {
+        case TypeTrue:
+            return ValuePtr(new True);
+        case TypeFalse:
+            return ValuePtr(new False);
+        case TypeString:
+            return ValuePtr(new String(node.toString()));
+        case TypeNumber:
+            return ValuePtr(new Number(node._number));
+        case TypeObject: {
+            ValuePtr obj(new Object);
+            for (size_t i = 0; i < node._size; ++i) {
+                const Member& mem(_members[node._index + i]);
+                obj->add(UString::FromUTF8(_text.data() + mem.key, mem.key_size), toValue(_nodes[mem.node]));
+            }
+            return obj;
+        }
+        case TypeArray: {
+            ValuePtr arr(new Array);
+            for (size_t i = 0; i < node._size; ++i) {
+                arr->set(toValue(_nodes[_members[node._index + i].node]));
+            }
+            return arr;
+        }
+        case TypeNull:
+        default:
+            return ValuePtr(new Null);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Node: simple virtual methods.
+//----------------------------------------------------------------------------
+
+ts::json::Type ts::json::Document::Node::type() const
+{
+    return _type;
+}
+
+bool ts::json::Document::Node::isNull()   const { return _type == TypeNull; }
+bool ts::json::Document::Node::isTrue()   const { return _type == TypeTrue; }
+bool ts::json::Document::Node::isFalse()  const { return _type == TypeFalse; }
+bool ts::json::Document::Node::isNumber() const { return _type == TypeNumber; }
+bool ts::json::Document::Node::isString() const { return _type == TypeString; }
+bool ts::json::Document::Node::isObject() const { return _type == TypeObject; }
+bool ts::json::Document::Node::isArray()  const { return _type == TypeArray; }
+
+size_t ts::json::Document::Node::size() const
+{
+    // The size of a string is a number of characters, not UTF-8 bytes.
+    return _type == TypeString ? toString().size() : (_type == TypeObject || _type == TypeArray ? _size : 0);
+}
+
+
+//----------------------------------------------------------------------------
+// Node: conversions, same as the json::Value subclasses.
+//----------------------------------------------------------------------------
+
+bool ts::json::Document::Node::toBoolean(bool defaultValue) const
+{
+    switch (_type) {
+        case TypeTrue:
+            return True().toBoolean(defaultValue);
+        case TypeFalse:
+            return False().toBoolean(defaultValue);
+        case TypeString:
+            return String(toString()).toBoolean(defaultValue);
+        case TypeNumber:
+            return Number(_number).toBoolean(defaultValue);
+        default:
+            return defaultValue;
+    }
+}
+
+int64_t ts::json::Document::Node::toInteger(int64_t defaultValue) const
+{
+    switch (_type) {
+        case TypeTrue:
+            return True().toInteger(defaultValue);
+        case TypeFalse:
+            return False().toInteger(defaultValue);
+        case TypeString:
+            return String(toString()).toInteger(defaultValue);
+        case TypeNumber:
+            return _number;
+        default:
+            return defaultValue;
+    }
+}
+
+ts::UString ts::json::Document::Node::toString(const UString& defaultValue) const
+{
+    switch (_type) {
+        case TypeTrue:
+            return True().toString(defaultValue);
+        case TypeFalse:
+            return False().toString(defaultValue);
+        case TypeString:
+            return UString::FromUTF8(_doc->_text.data() + _index, _size);
+        case TypeNumber:
+            return Number(_number).toString(defaultValue);
+        default:
+            return defaultValue;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Node: access object fields and array elements.
+//----------------------------------------------------------------------------
+
+void ts::json::Document::Node::getNames(UStringList& names) const
+{
+    names.clear();
+    if (_type == TypeObject) {
+        for (size_t i = 0; i < _size; ++i) {
+            const Member& mem(_doc->_members[_index + i]);
+            names.push_back(UString::FromUTF8(_doc->_text.data() + mem.key, mem.key_size));
+        }
+    }
+}
+
+const ts::json::Value& ts::json::Document::Node::value(const UString& name) const
+{
+    if (_type == TypeObject) {
+        const std::string key(name.toUTF8());
+        for (size_t i = 0; i < _size; ++i) {
+            const Member& mem(_doc->_members[_index + i]);
+            if (mem.key_size == key.size() && _doc->_text.compare(mem.key, mem.key_size, key) == 0) {
+                return _doc->_nodes[mem.node];
+            }
+        }
+    }
+    return NullValue;
+}
+
+ts::json::Value& ts::json::Document::Node::value(const UString& name, bool create, Type type)
+{
+    // The document is read-only, never create a field.
+    return const_cast<Value&>(static_cast<const Node*>(this)->value(name));
+}
+
+const ts::json::Value& ts::json::Document::Node::at(size_t index) const
+{
+    if (_type == TypeArray && index < _size) {
+        return _doc->_nodes[_doc->_members[_index + index].node];
+    }
+    else {
+        return NullValue;
+    }
+}
+
+ts::json::Value& ts::json::Document::Node::at(size_t index)
+{
+    return const_cast<Value&>(static_cast<const Node*>(this)->at(index));
+}
+
+
+//----------------------------------------------------------------------------
+// Node: deep query, same path syntax as json::Object and json::Array.
+//----------------------------------------------------------------------------
+
+const ts::json::Value& ts::json::Document::Node::query(const UString& path) const
+{
+    if (path.empty()) {
+        return *this;
+    }
+    else if (_type == TypeObject) {
+        if (path.front() == u'[') {
+            return NullValue; // array syntax => error.
+        }
+        // Extract first field name.
+        size_t end = std::min(path.size(), std::min(path.find(u'.'), path.find(u'[')));
+        if (end == 0) {
+            return *this; // same as json::Object.
+        }
+        const UString field(path.substr(0, end));
+        // Skip separators, point to next field name or array index.
+        while (end < path.size() && path[end] == u'.') {
+            ++end;
+        }
+        return value(field).query(path.substr(end));
+    }
+    else if (_type == TypeArray) {
+        if (path.front() != u'[') {
+            return NullValue; // not an array index syntax => error.
+        }
+        // Extract index.
+        size_t end = path.find(u']', 1);
+        size_t index = 0;
+        if (end >= path.size() || end == 1 || !path.substr(1, end - 1).toInteger(index, u",")) {
+            return NullValue; // invalid or empty index.
+        }
+        // Skip separators, point to next field name or array index.
+        while (++end < path.size() && path[end] == u'.') {
+        }
+        return at(index).query(path.substr(end));
+    }
+    else {
+        return NullValue;
+    }
+}
+
+ts::json::Value& ts::json::Document::Node::query(const UString& path, bool create, Type type)
+{
+    // The document is read-only, never create a field.
+    return const_cast<Value&>(static_cast<const Node*>(this)->query(path));
+}
+
+
+//----------------------------------------------------------------------------
+// Node: format the value as JSON text.
+//----------------------------------------------------------------------------
+
+void ts::json::Document::Node::print(TextFormatter& output) const
+{
+    switch (_type) {
+        case TypeTrue:
+            output << "true";
+            break;
+        case TypeFalse:
+            output << "false";
+            break;
+        case TypeString:
+            output << '"' << toString().toJSON() << '"';
+            break;
+        case TypeNumber:
+            output << UString::Decimal(_number, 0, true, UString());
+            break;
+        case TypeObject: {
+            // Same output as json::Object: fields are printed in sorted name order.
+            std::vector<std::pair<UString, size_t>> fields;
+            fields.reserve(_size);
+            for (size_t i = 0; i < _size; ++i) {
+                const Member& mem(_doc->_members[_index + i]);
+                fields.push_back(std::make_pair(UString::FromUTF8(_doc->_text.data() + mem.key, mem.key_size), mem.node));
+            }
+            std::sort(fields.begin(), fields.end());
+            output << "{" << ts::indent;
+            for (auto it = fields.begin(); it != fields.end(); ++it) {
+                if (it != fields.begin()) {
+                    output << ",";
+                }
+                output << ts::endl << ts::margin << '"' << it->first.toJSON() << "\": ";
+                _doc->_nodes[it->second].print(output);
+            }
+            output << ts::endl << ts::unindent << ts::margin << "}";
+            break;
+        }
+        case TypeArray: {
+            output << "[" << ts::indent;
+            for (size_t i = 0; i < _size; ++i) {
+                if (i > 0) {
+                    output << ",";
+                }
+                output << ts::endl << ts::margin;
+                _doc->_nodes[_doc->_members[_index + i].node].print(output);
+            }
+            output << ts::endl << ts::unindent << ts::margin << "]";
+            break;
+        }
+        case TypeNull:
+        default:
+            output << "null";
+            break;
+    }
+}
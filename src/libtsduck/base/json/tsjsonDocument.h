@@ -0,0 +1,197 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Compact read-only JSON document.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsjsonValue.h"
+
+namespace ts {
+    namespace json {
+        //!
+        //! Compact read-only JSON document.
+        //! @ingroup json
+        //!
+        //! A JSON document is parsed using a json::Reader, from UTF-8 text. All values are
+        //! stored in a few flat arrays instead of one heap-allocated object per value:
+        //! - one array of value nodes,
+        //! - one array of object fields and array elements, contiguous for each object or array,
+        //! - one UTF-8 buffer containing all strings and field names.
+        //!
+        //! Each node is a json::Value and the document is accessed using the json::Value API.
+        //! The references which are returned by root(), Value::value(), Value::at() or
+        //! Value::query() remain valid until the document is cleared, reparsed or destroyed.
+        //!
+        //! The document is read-only: all modification methods of the json::Value API do nothing.
+        //! Use toValue() to get a modifiable copy of the document.
+        //!
+        //! The fields of an object are stored in insertion order and getNames() returns them
+        //! in this order. As with json::Object, a duplicated field name replaces the previous
+        //! value of the field. Objects are printed in sorted field name order, like json::Object,
+        //! so that the output is the same as the output of a document loaded with json::Parse().
+        //!
+        class TSDUCKDLL Document
+        {
+            TS_NOCOPY(Document);
+        public:
+            //!
+            //! Constructor.
+            //!
+            Document();
+
+            //!
+            //! Clear the content of the document.
+            //!
+            void clear();
+
+            //!
+            //! Parse a JSON document.
+            //! The text shall contain exactly one JSON value (usually an object or array).
+            //! @param [in] data Address of the UTF-8 JSON text.
+            //! @param [in] size Size in bytes of the UTF-8 JSON text.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error. On error, the document is empty.
+            //!
+            bool parse(const char* data, size_t size, Report& report = NULLREP);
+
+            //!
+            //! Parse a JSON document.
+            //! @param [in] text The UTF-8 JSON text.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error. On error, the document is empty.
+            //!
+            bool parse(const std::string& text, Report& report = NULLREP)
+            {
+                return parse(text.data(), text.size(), report);
+            }
+
+            //!
+            //! Parse a JSON document.
+            //! @param [in] text The JSON text.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error. On error, the document is empty.
+            //!
+            bool parse(const UString& text, Report& report = NULLREP);
+
+            //!
+            //! Load and parse a JSON file.
+            //! @param [in] fileName Name of the UTF-8 JSON file.
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on error. On error, the document is empty.
+            //!
+            bool load(const UString& fileName, Report& report = NULLREP);
+
+            //!
+            //! Check if the document is empty.
+            //! @return True if the document is empty, after an error for instance.
+            //!
+            bool empty() const { return _nodes.empty(); }
+
+            //!
+            //! Get the top-level value of the document.
+            //! @return A constant reference to the top-level value or a reference to a null JSON if the document is empty.
+            //!
+            const Value& root() const;
+
+            //!
+            //! Build a modifiable copy of the document.
+            //! @return A smart pointer to a copy of the top-level value, using json::Object, json::Array, etc.
+            //! Null pointer if the document is empty.
+            //!
+            ValuePtr toValue() const;
+
+        private:
+            // A JSON value in the document.
+            // For strings, _index and _size are the offset and size in _text.
+            // For objects and arrays, _index and _size are the first index and count in _members.
+            // For numbers, _number is the value.
+            class Node : public Value
+            {
+            public:
+                Node(const Document* doc, Type type) : _doc(doc), _type(type), _index(0), _size(0) {}
+                Node(const Node&) = default;
+                Node& operator=(const Node&) = default;
+
+                // Implementation of ts::json::Value.
+                virtual Type type() const override;
+                virtual bool isNull() const override;
+                virtual bool isTrue() const override;
+                virtual bool isFalse() const override;
+                virtual bool isNumber() const override;
+                virtual bool isString() const override;
+                virtual bool isObject() const override;
+                virtual bool isArray() const override;
+                virtual void print(TextFormatter& output) const override;
+                virtual bool toBoolean(bool defaultValue = false) const override;
+                virtual int64_t toInteger(int64_t defaultValue = 0) const override;
+                virtual UString toString(const UString& defaultValue = UString()) const override;
+                virtual size_t size() const override;
+                virtual void getNames(UStringList& names) const override;
+                virtual const Value& value(const UString& name) const override;
+                virtual Value& value(const UString& name, bool create = false, Type type = TypeObject) override;
+                virtual const Value& at(size_t index) const override;
+                virtual Value& at(size_t index) override;
+                virtual const Value& query(const UString& path) const override;
+                virtual Value& query(const UString& path, bool create = false, Type type = TypeObject) override;
+
+                const Document* _doc;
+                Type            _type;
+                union {
+                    size_t      _index;
+                    int64_t     _number;
+                };
+                size_t          _size;
+            };
+
+            // A field in an object (with a name) or an element in an array (empty name).
+            struct Member
+            {
+                size_t key;       // Offset of the UTF-8 field name in _text.
+                size_t key_size;  // Size of the UTF-8 field name.
+                size_t node;      // Index of the value in _nodes.
+            };
+
+            std::string         _text;     // All strings and field names in UTF-8.
+            std::vector<Node>   _nodes;    // All values, the top-level value first.
+            std::vector<Member> _members;  // All object fields and array elements.
+
+            // Check if two members have the same field name.
+            bool sameKey(const Member& m1, const Member& m2) const;
+
+            // Remove duplicated field names in a list of object members, the last value is kept.
+            size_t removeDuplicates(std::vector<Member>& members, size_t first, size_t count) const;
+
+            // Build a modifiable copy of a node.
+            ValuePtr toValue(const Node& node) const;
+        };
+    }
+}
@@ -0,0 +1,380 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsjsonReader.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::json::Reader::Reader(const char* data, size_t size, Report& report) :
+    _report(report),
+    _cur(data),
+    _end(data + size),
+    _line(1),
+    _past_end(false),
+    _error(false),
+    _done(false),
+    _after_value(false),
+    _has_key(false),
+    _event(EventNone),
+    _key(),
+    _text(),
+    _stack()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Lexical analysis, same tokens as TextParser.
+//----------------------------------------------------------------------------
+
+void ts::json::Reader::skipWhiteSpace()
+{
+    while (_cur < _end && (*_cur == ' ' || (*_cur >= '\t' && *_cur <= '\r'))) {
+        if (*_cur++ == '\n') {
+            _line++;
+        }
+    }
+    // Like TextParser, skipping the end of the last line moves to the next line number.
+    if (_cur >= _end && !_past_end) {
+        _past_end = true;
+        _line++;
+    }
+}
+
+bool ts::json::Reader::match(const char* str)
+{
+    const char* cur = _cur;
+    while (*str != '\0') {
+        if (cur >= _end || *cur++ != *str++) {
+            return false;
+        }
+    }
+    _cur = cur;
+    return true;
+}
+
+bool ts::json::Reader::parseString(std::string& str)
+{
+    // Same as TextParser::parseJSONStringLiteral(): a string literal cannot span several lines.
+    if (_cur >= _end || *_cur != '"') {
+        return false;
+    }
+    const char* const start = _cur + 1;
+    const char* cur = start;
+    bool escaped = false;
+    while (cur < _end && *cur != '"' && *cur != '\n') {
+        if (*cur++ == '\\') {
+            escaped = true;
+            if (cur < _end && *cur != '\n') {
+                cur++; // skip character after backslash.
+            }
+        }
+    }
+    if (cur >= _end || *cur != '"') {
+        return false;
+    }
+    _cur = cur + 1;
+
+    // Most strings have no escape sequence and are copied as is.
+    if (!escaped) {
+        str.assign(start, cur - start);
+        return true;
+    }
+
+    // Same escape sequences as UString::convertFromJSON(), unknown sequences are left unchanged.
+    str.clear();
+    const char* const last = cur;
+    cur = start;
+    while (cur < last) {
+        if (*cur != '\\' || cur + 1 >= last) {
+            str.push_back(*cur++);
+            continue;
+        }
+        uint32_t code = 0;
+        bool hexa = cur[1] == 'u' && cur + 6 <= last;
+        for (size_t i = 2; hexa && i < 6; ++i) {
+            const char c = cur[i];
+            hexa = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+            code = (code << 4) | uint32_t(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+        }
+        if (hexa) {
+            cur += 6;
+            // Combine UTF-16 surrogate pairs into one code point.
+            if (code >= 0xD800 && code < 0xDC00 && cur + 6 <= last && cur[0] == '\\' && cur[1] == 'u') {
+                uint32_t low = 0;
+                bool ok = true;
+                for (size_t i = 2; ok && i < 6; ++i) {
+                    const char c = cur[i];
+                    ok = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+                    low = (low << 4) | uint32_t(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+                }
+                if (ok && low >= 0xDC00 && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    cur += 6;
+                }
+            }
+            // Encode the code point in UTF-8.
+            if (code < 0x80) {
+                str.push_back(char(code));
+            }
+            else if (code < 0x800) {
+                str.push_back(char(0xC0 | (code >> 6)));
+                str.push_back(char(0x80 | (code & 0x3F)));
+            }
+            else if (code < 0x10000) {
+                str.push_back(char(0xE0 | (code >> 12)));
+                str.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+                str.push_back(char(0x80 | (code & 0x3F)));
+            }
+            else {
+                str.push_back(char(0xF0 | (code >> 18)));
+                str.push_back(char(0x80 | ((code >> 12) & 0x3F)));
+                str.push_back(char(0x80 | ((code >> 6) & 0x3F)));
+                str.push_back(char(0x80 | (code & 0x3F)));
+            }
+            continue;
+        }
+        char unquoted = '\0';
+        switch (cur[1]) {
+            case '"':
+            case '\\':
+            case '/': unquoted = cur[1]; break;
+            case 'b': unquoted = '\b'; break;
+            case 'f': unquoted = '\f'; break;
+            case 'n': unquoted = '\n'; break;
+            case 'r': unquoted = '\r'; break;
+            case 't': unquoted = '\t'; break;
+            default: break;
+        }
+        if (unquoted != '\0') {
+            str.push_back(unquoted);
+            cur += 2;
+        }
+        else {
+            str.push_back(*cur++);
+        }
+    }
+    return true;
+}
+
+bool ts::json::Reader::parseNumber(std::string& str)
+{
+    // Same as TextParser::parseNumericLiteral(), floating point allowed, hexadecimal not allowed.
+    const char* cur = _cur;
+    if (cur < _end && (*cur == '-' || *cur == '+')) {
+        ++cur;
+    }
+    if (cur >= _end || *cur < '0' || *cur > '9') {
+        return false;
+    }
+    if (cur + 2 < _end && cur[0] == '0' && (cur[1] == 'x' || cur[1] == 'X') && std::isxdigit(uint8_t(cur[2]))) {
+        return false;
+    }
+    while (cur < _end && *cur >= '0' && *cur <= '9') {
+        ++cur;
+    }
+    if (cur < _end && *cur == '.') {
+        ++cur;
+        while (cur < _end && *cur >= '0' && *cur <= '9') {
+            ++cur;
+        }
+    }
+    if (cur < _end && (*cur == 'e' || *cur == 'E')) {
+        ++cur;
+        if (cur < _end && (*cur == '+' || *cur == '-')) {
+            ++cur;
+        }
+        while (cur < _end && *cur >= '0' && *cur <= '9') {
+            ++cur;
+        }
+    }
+    // A number cannot be followed by a letter. All non-ASCII characters are rejected as well.
+    if (cur < _end && (*cur == '.' || *cur == '_' || (*cur & 0x80) != 0 || std::isalpha(uint8_t(*cur)))) {
+        return false;
+    }
+    str.assign(_cur, cur - _cur);
+    _cur = cur;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Convert the literal of a JSON number to an integer.
+//----------------------------------------------------------------------------
+
+bool ts::json::Reader::ToInteger(int64_t& value, const std::string& literal)
+{
+    value = 0;
+    size_t i = 0;
+    const bool negative = !literal.empty() && literal[0] == '-';
+    if (!literal.empty() && (literal[0] == '-' || literal[0] == '+')) {
+        i++;
+    }
+    if (i >= literal.size()) {
+        return false;
+    }
+    uint64_t uvalue = 0;
+    const uint64_t limit = negative ? uint64_t(std::numeric_limits<int64_t>::max()) + 1 : uint64_t(std::numeric_limits<int64_t>::max());
+    for (; i < literal.size(); ++i) {
+        const char c = literal[i];
+        if (c < '0' || c > '9' || uvalue > (limit - uint64_t(c - '0')) / 10) {
+            return false;
+        }
+        uvalue = 10 * uvalue + uint64_t(c - '0');
+    }
+    value = negative ? int64_t(0 - uvalue) : int64_t(uvalue);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Common processing on errors and values.
+//----------------------------------------------------------------------------
+
+bool ts::json::Reader::fail(const UChar* message)
+{
+    // Some syntax errors are not reported, same as json::Parse().
+    if (message != nullptr) {
+        _report.error(message, {_line});
+    }
+    _error = true;
+    _event = EventNone;
+    _has_key = false;
+    _key.clear();
+    _text.clear();
+    return false;
+}
+
+void ts::json::Reader::valueDone()
+{
+    if (_stack.empty()) {
+        _done = true;
+    }
+    else {
+        _after_value = true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Move to the next event.
+//----------------------------------------------------------------------------
+
+bool ts::json::Reader::next()
+{
+    if (_error || (_done && _event == EventNone)) {
+        return false;
+    }
+
+    _event = EventNone;
+    _has_key = false;
+    _key.clear();
+    _text.clear();
+    skipWhiteSpace();
+
+    // After the top-level value, nothing is allowed but white spaces.
+    if (_done) {
+        return _cur >= _end ? false : fail(u"line %d: extraneous text after JSON value");
+    }
+
+    // Inside an object or array, process separators and end of object or array.
+    if (!_stack.empty()) {
+        const bool object = _stack.back();
+        const char* const close = object ? "}" : "]";
+        if (_after_value) {
+            if (match(close)) {
+                _stack.pop_back();
+                _event = object ? EventEndObject : EventEndArray;
+                valueDone();
+                return true;
+            }
+            if (!match(",")) {
+                return fail(object ? u"line %d: syntax error in JSON object, missing ','" : u"line %d: syntax error in JSON array, missing ','");
+            }
+            _after_value = false;
+            skipWhiteSpace();
+        }
+        if (match(close)) {
+            _stack.pop_back();
+            _event = object ? EventEndObject : EventEndArray;
+            valueDone();
+            return true;
+        }
+        if (object) {
+            // Field name and colon, no error message, same as json::Parse().
+            if (!parseString(_key)) {
+                return fail(nullptr);
+            }
+            skipWhiteSpace();
+            if (!match(":")) {
+                return fail(nullptr);
+            }
+            skipWhiteSpace();
+            _has_key = true;
+        }
+    }
+
+    // Look for one of the seven possible forms or JSON value.
+    if (match("null")) {
+        _event = EventNull;
+    }
+    else if (match("true")) {
+        _event = EventTrue;
+    }
+    else if (match("false")) {
+        _event = EventFalse;
+    }
+    else if (parseString(_text)) {
+        _event = EventString;
+    }
+    else if (parseNumber(_text)) {
+        _event = EventNumber;
+    }
+    else if (match("{")) {
+        _event = EventBeginObject;
+        _stack.push_back(true);
+        _after_value = false;
+        return true;
+    }
+    else if (match("[")) {
+        _event = EventBeginArray;
+        _stack.push_back(false);
+        _after_value = false;
+        return true;
+    }
+    else {
+        return fail(u"line %d: not a valid JSON value");
+    }
+    valueDone();
+    return true;
+}
@@ -0,0 +1,170 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Pull parser for JSON text in UTF-8.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsjson.h"
+
+namespace ts {
+    namespace json {
+        //!
+        //! Pull parser for JSON text in UTF-8.
+        //! @ingroup json
+        //!
+        //! The text is read directly from a contiguous UTF-8 buffer. Each call to next()
+        //! delivers one event: the beginning or end of an object or array, or a scalar value.
+        //! Inside an object, each value event also provides the field name. No JSON value is
+        //! built: very large documents can be scanned with a constant memory footprint.
+        //!
+        //! The syntax, the error messages and their line numbers are the same as json::Parse().
+        //! The buffer must remain valid and unmodified while the parser is in use.
+        //!
+        class TSDUCKDLL Reader
+        {
+            TS_NOBUILD_NOCOPY(Reader);
+        public:
+            //!
+            //! Parsing events.
+            //!
+            enum Event {
+                EventNone,         //!< No event, before the first call to next(), at end of document or on error.
+                EventBeginObject,  //!< Beginning of a JSON object.
+                EventEndObject,    //!< End of a JSON object.
+                EventBeginArray,   //!< Beginning of a JSON array.
+                EventEndArray,     //!< End of a JSON array.
+                EventNull,         //!< JSON null literal.
+                EventTrue,         //!< JSON true literal.
+                EventFalse,        //!< JSON false literal.
+                EventString,       //!< JSON string, see text().
+                EventNumber,       //!< JSON number, see text().
+            };
+
+            //!
+            //! Constructor.
+            //! @param [in] data Address of the UTF-8 JSON text.
+            //! @param [in] size Size in bytes of the UTF-8 JSON text.
+            //! @param [in,out] report Where to report errors.
+            //!
+            Reader(const char* data, size_t size, Report& report = NULLREP);
+
+            //!
+            //! Move to the next event.
+            //! The document shall contain exactly one JSON value (usually an object or array).
+            //! Nothing but white spaces is allowed after it.
+            //! @return True when a new event is available, false at end of document or on error.
+            //!
+            bool next();
+
+            //!
+            //! Get the current event.
+            //! @return The current event.
+            //!
+            Event event() const { return _event; }
+
+            //!
+            //! Check if the current value is an object field.
+            //! @return True if the current event is a value or the beginning of an object or array
+            //! and the enclosing JSON value is an object.
+            //!
+            bool hasKey() const { return _has_key; }
+
+            //!
+            //! Get the field name of the current value.
+            //! @return A constant reference to the UTF-8 field name, after unescaping.
+            //! Empty when hasKey() is false.
+            //!
+            const std::string& key() const { return _key; }
+
+            //!
+            //! Get the text of the current value.
+            //! @return A constant reference to the UTF-8 text of the current value: the
+            //! content of a string after unescaping or the literal of a number.
+            //! Empty for all other events.
+            //!
+            const std::string& text() const { return _text; }
+
+            //!
+            //! Get the current nesting depth.
+            //! @return The number of enclosing objects and arrays, including the one which
+            //! just began on EventBeginObject and EventBeginArray.
+            //!
+            size_t depth() const { return _stack.size(); }
+
+            //!
+            //! Get the current line number in the JSON text.
+            //! @return The current line number, starting at 1.
+            //!
+            size_t lineNumber() const { return _line; }
+
+            //!
+            //! Check if an error was found.
+            //! @return True if a syntax error was found.
+            //!
+            bool error() const { return _error; }
+
+            //!
+            //! Convert the literal of a JSON number to an integer.
+            //! Floating-point literals and out-of-range integers are rejected.
+            //! @param [out] value The integer value.
+            //! @param [in] literal The number literal in UTF-8, as returned by text().
+            //! @return True on success, false if @a literal is not an integer.
+            //!
+            static bool ToInteger(int64_t& value, const std::string& literal);
+
+        private:
+            Report&           _report;
+            const char*       _cur;
+            const char*       _end;
+            size_t            _line;
+            bool              _past_end;     // Skipped past the end of the last line, as TextParser.
+            bool              _error;
+            bool              _done;         // The top-level value is complete.
+            bool              _after_value;  // Inside an object or array, just after a value.
+            bool              _has_key;
+            Event             _event;
+            std::string       _key;
+            std::string       _text;
+            std::vector<bool> _stack;        // Enclosing objects (true) and arrays (false).
+
+            // Lexical analysis.
+            void skipWhiteSpace();
+            bool match(const char* str);
+            bool parseString(std::string& str);
+            bool parseNumber(std::string& str);
+
+            // Common processing on errors and values.
+            bool fail(const UChar* message);
+            void valueDone();
+        };
+    }
+}
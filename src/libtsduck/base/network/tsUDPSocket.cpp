@@ -51,7 +51,8 @@ ts::UDPSocket::UDPSocket(bool auto_open, Report& report) :
     _local_address(),
     _default_destination(),
     _mcast(),
-    _ssmcast()
+    _ssmcast(),
+    _txtime(false)
 {
     if (auto_open) {
         // Returned value ignored on purpose, the socket is marked as closed in the object on error.
@@ -244,6 +245,35 @@ bool ts::UDPSocket::setReceiveTimestamps(bool on, Report& report)
 }
 
 
+//----------------------------------------------------------------------------
+// Enable or disable the transmission time of outgoing packets.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::setTransmitTime(bool on, Report& report)
+{
+#if defined(TS_LINUX) && defined(SO_TXTIME)
+    // The transmission times are expressed in CLOCK_TAI, as required by the "etf" queueing discipline.
+    ::sock_txtime config;
+    TS_ZERO(config);
+    config.clockid = on ? CLOCK_TAI : CLOCK_MONOTONIC;
+    config.flags = on ? SOF_TXTIME_REPORT_ERRORS : 0;
+    if (::setsockopt(getSocket(), SOL_SOCKET, SO_TXTIME, &config, sizeof(config)) != 0) {
+        report.error(u"socket option SO_TXTIME: " + SysSocketErrorCodeMessage());
+        return false;
+    }
+    _txtime = on;
+    return true;
+#else
+    if (on) {
+        report.error(u"transmission time of UDP packets is not supported on this system");
+        return false;
+    }
+    _txtime = false;
+    return true;
+#endif
+}
+
+
 //----------------------------------------------------------------------------
 // Enable or disable the broadcast option.
 //----------------------------------------------------------------------------
@@ -424,6 +454,108 @@ bool ts::UDPSocket::send(const void* data, size_t size, const SocketAddress& des
 }
 
 
+//----------------------------------------------------------------------------
+// Send several messages to their respective destinations.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendBatch(const OutgoingMessage* messages, size_t count, Report& report)
+{
+#if defined(TS_LINUX)
+    // Maximum number of messages per system call.
+    constexpr size_t MAX_BATCH = 64;
+
+    ::sockaddr addr[MAX_BATCH];
+    ::iovec iov[MAX_BATCH];
+    ::mmsghdr hdr[MAX_BATCH];
+
+    while (count > 0) {
+        const size_t n = std::min(count, MAX_BATCH);
+        TS_ZERO(hdr);
+        for (size_t i = 0; i < n; ++i) {
+            messages[i].destination.copy(addr[i]);
+            iov[i].iov_base = const_cast<void*>(messages[i].data);
+            iov[i].iov_len = messages[i].size;
+            hdr[i].msg_hdr.msg_name = &addr[i];
+            hdr[i].msg_hdr.msg_namelen = sizeof(addr[i]);
+            hdr[i].msg_hdr.msg_iov = &iov[i];
+            hdr[i].msg_hdr.msg_iovlen = 1;
+        }
+        // sendmmsg() may send less messages than requested.
+        for (size_t sent = 0; sent < n; ) {
+            const int ret = ::sendmmsg(getSocket(), hdr + sent, unsigned(n - sent), 0);
+            if (ret < 0) {
+                report.error(u"error sending UDP message: " + SysSocketErrorCodeMessage());
+                return false;
+            }
+            sent += size_t(ret);
+        }
+        messages += n;
+        count -= n;
+    }
+    return true;
+#else
+    bool ok = true;
+    for (size_t i = 0; ok && i < count; ++i) {
+        ok = send(messages[i].data, messages[i].size, messages[i].destination, report);
+    }
+    return ok;
+#endif
+}
+
+
+//----------------------------------------------------------------------------
+// Send a message to the default destination at a given time.
+//----------------------------------------------------------------------------
+
+bool ts::UDPSocket::sendAt(const void* data, size_t size, const Monotonic& due, Report& report)
+{
+#if defined(TS_LINUX) && defined(SO_TXTIME)
+    if (_txtime) {
+        // Convert the monotonic due time into CLOCK_TAI.
+        const uint64_t txtime = uint64_t(Time::UnixClockNanoSeconds(CLOCK_TAI) + (due - Monotonic(true)));
+
+        ::sockaddr addr;
+        _default_destination.copy(addr);
+
+        ::iovec iov;
+        iov.iov_base = const_cast<void*>(data);
+        iov.iov_len = size;
+
+        // Control message containing the transmission time.
+        uint8_t control[CMSG_SPACE(sizeof(txtime))];
+        TS_ZERO(control);
+
+        ::msghdr hdr;
+        TS_ZERO(hdr);
+        hdr.msg_name = &addr;
+        hdr.msg_namelen = sizeof(addr);
+        hdr.msg_iov = &iov;
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = control;
+        hdr.msg_controllen = sizeof(control);
+
+        ::cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(txtime));
+        ::memcpy(CMSG_DATA(cmsg), &txtime, sizeof(txtime));
+
+        if (::sendmsg(getSocket(), &hdr, 0) < 0) {
+            report.error(u"error sending UDP message: " + SysSocketErrorCodeMessage());
+            return false;
+        }
+        return true;
+    }
+#else
+    // Transmission time is not supported, the due time is ignored.
+    TS_UNUSED const Monotonic& ignored(due);
+#endif
+
+    // No transmission time, send immediately.
+    return send(data, size, _default_destination, report);
+}
+
+
 //----------------------------------------------------------------------------
 // Receive a message.
 // If abort interface is non-zero, invoke it when I/O is interrupted
@@ -39,6 +39,7 @@
 #include "tsAbortInterface.h"
 #include "tsReport.h"
 #include "tsMemory.h"
+#include "tsMonotonic.h"
 
 namespace ts {
     //!
@@ -204,6 +205,22 @@ namespace ts {
         //!
         bool setReceiveTimestamps(bool on, Report& report = CERR);
 
+        //!
+        //! Enable or disable the transmission time of outgoing packets.
+        //!
+        //! When enabled, the packets which are sent using sendAt() are handed to the kernel
+        //! in advance and are transmitted at the requested time by the queueing discipline
+        //! of the network interface (typically "etf" or "fq" on Linux).
+        //!
+        //! Currently, this option is supported on Linux only (SO_TXTIME socket option).
+        //! On other systems, enabling the option is an error.
+        //!
+        //! @param [in] on If true, transmission times are activated on the socket. Otherwise, they are disabled.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool setTransmitTime(bool on, Report& report = CERR);
+
         //!
         //! Enable or disable the broadcast option.
         //!
@@ -305,6 +322,60 @@ namespace ts {
         //!
         virtual bool send(const void* data, size_t size, Report& report = CERR);
 
+        //!
+        //! Send a message to the default destination address and port at a given time.
+        //!
+        //! When transmission times are enabled on the socket (see setTransmitTime()), the
+        //! message is transmitted by the kernel at the specified time. Otherwise, the
+        //! message is immediately sent and @a due is ignored.
+        //!
+        //! @param [in] data Address of the message to send.
+        //! @param [in] size Size in bytes of the message to send.
+        //! @param [in] due Transmission time of the message.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool sendAt(const void* data, size_t size, const Monotonic& due, Report& report = CERR);
+
+        //!
+        //! Description of an outgoing message for sendBatch().
+        //!
+        class TSDUCKDLL OutgoingMessage
+        {
+        public:
+            const void*   data;         //!< Address of the message to send.
+            size_t        size;         //!< Size in bytes of the message to send.
+            SocketAddress destination;  //!< Socket address of the destination.
+
+            //!
+            //! Constructor.
+            //! @param [in] d Address of the message to send.
+            //! @param [in] s Size in bytes of the message to send.
+            //! @param [in] dest Socket address of the destination.
+            //!
+            OutgoingMessage(const void* d = nullptr, size_t s = 0, const SocketAddress& dest = SocketAddress()) :
+                data(d), size(s), destination(dest) {}
+
+            //! @cond nodoxygen
+            OutgoingMessage(const OutgoingMessage&) = default;
+            OutgoingMessage& operator=(const OutgoingMessage&) = default;
+            //! @endcond
+        };
+
+        //!
+        //! Send several messages to their respective destinations.
+        //!
+        //! On Linux, the messages are sent in batches using sendmmsg(), with one
+        //! system call for many messages. On other systems, the messages are sent
+        //! one by one.
+        //!
+        //! @param [in] messages Address of an array of messages to send.
+        //! @param [in] count Number of messages to send.
+        //! @param [in,out] report Where to report error.
+        //! @return True on success, false on error.
+        //!
+        bool sendBatch(const OutgoingMessage* messages, size_t count, Report& report = CERR);
+
         //!
         //! Receive a message.
         //!
@@ -391,6 +462,7 @@ namespace ts {
         SocketAddress _default_destination;
         MReqSet       _mcast;    // Current set of multicast memberships
         SSMReqSet     _ssmcast;  // Current set of source-specific multicast memberships
+        bool          _txtime;   // Transmission time is enabled on the socket
 
         // Perform one receive operation. Hide the system mud.
         SysSocketErrorCode receiveOne(void* data, size_t max_size, size_t& ret_size, SocketAddress& sender, SocketAddress& destination, Report& report, MicroSecond* timestamp);
@@ -30,6 +30,12 @@
 #include "tsMemory.h"
 TSDUCK_SOURCE;
 
+// SSE2 is always available on x86_64 and used for start code search.
+#if defined(TS_X86_64) || defined(__SSE2__)
+    #define TS_MEM_SSE2 1
+    #include <emmintrin.h>
+#endif
+
 
 //----------------------------------------------------------------------------
 // Check if a memory area starts with the specified prefix
@@ -52,21 +58,75 @@ bool ts::StartsWith(const void* area, size_t area_size, const void* prefix, size
 
 const uint8_t* ts::LocatePattern(const void* area, size_t area_size, const void* pattern, size_t pattern_size)
 {
-    if (pattern_size > 0) {
+    if (area != nullptr && pattern != nullptr && pattern_size > 0 && area_size >= pattern_size) {
         const uint8_t* a = reinterpret_cast<const uint8_t*>(area);
-        const uint8_t* p = reinterpret_cast<const uint8_t*>(pattern);
-        while (area_size >= pattern_size) {
-            if (*a == *p && ::memcmp(a, p, pattern_size) == 0) {
+        const uint8_t* const p = reinterpret_cast<const uint8_t*>(pattern);
+        const uint8_t* const last = a + area_size - pattern_size; // last possible start of pattern
+        // Locate candidates using memchr() on the first byte. The C library implements
+        // memchr() using vector instructions, much faster than a byte-per-byte loop.
+        while (a <= last && (a = reinterpret_cast<const uint8_t*>(::memchr(a, p[0], last - a + 1))) != nullptr) {
+            if (::memcmp(a + 1, p + 1, pattern_size - 1) == 0) {
                 return a;
             }
             ++a;
-            --area_size;
         }
     }
     return nullptr; // not found
 }
 
 
+//----------------------------------------------------------------------------
+// Locate a 3-byte pattern 00 00 xx into a memory area.
+//----------------------------------------------------------------------------
+
+const uint8_t* ts::LocateZeroZero(const void* area, size_t area_size, uint8_t xx_min, uint8_t xx_max)
+{
+    if (area == nullptr || area_size < 3 || xx_min > xx_max) {
+        return nullptr;
+    }
+
+    const uint8_t* const p = reinterpret_cast<const uint8_t*>(area);
+    size_t i = 0;
+
+#if defined(TS_MEM_SSE2)
+    // Check 16 positions at a time: a position i is a candidate when p[i] and p[i+1] are both zero.
+    // Blocks without candidate, by far the most frequent ones in video payloads, are skipped at once.
+    const __m128i zero = _mm_setzero_si128();
+    while (i + 18 <= area_size) {
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + 1));
+        const int candidates = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)));
+        if (candidates != 0) {
+            for (size_t k = 0; k < 16; ++k) {
+                if ((candidates & (1 << k)) != 0 && p[i + k + 2] >= xx_min && p[i + k + 2] <= xx_max) {
+                    return p + i + k;
+                }
+            }
+        }
+        i += 16;
+    }
+#endif
+
+    // Byte-oriented search, skipping up to 3 bytes when the third one cannot be part of a match.
+    while (i + 2 < area_size) {
+        if (p[i + 2] > xx_max) {
+            // Non-zero byte, no match can start at i, i+1 or i+2.
+            i += 3;
+        }
+        else if (p[i + 1] != 0) {
+            i += 2;
+        }
+        else if (p[i] != 0 || p[i + 2] < xx_min) {
+            i += 1;
+        }
+        else {
+            return p + i;
+        }
+    }
+    return nullptr;
+}
+
+
 //----------------------------------------------------------------------------
 // Check if a memory area contains all identical byte values.
 //----------------------------------------------------------------------------
@@ -78,6 +78,19 @@ namespace ts {
     //!
     TSDUCKDLL const uint8_t* LocatePattern(const void* area, size_t area_size, const void* pattern, size_t pattern_size);
 
+    //!
+    //! Locate a 3-byte pattern 00 00 xx into a memory area.
+    //! This is typically used to locate start code prefixes (00 00 01) in MPEG video
+    //! elementary streams or to locate the end of AVC, HEVC or VVC NALunits (00 00 00 or 00 00 01).
+    //! This function is optimized for large video payloads, where 00 00 sequences are rare.
+    //! @param [in] area Address of a memory area to check.
+    //! @param [in] area_size Size in bytes of the memory area.
+    //! @param [in] xx_min Minimum value of the third byte.
+    //! @param [in] xx_max Maximum value of the third byte.
+    //! @return Address of the first occurence of 00 00 xx in @a area, with @a xx_min <= xx <= @a xx_max, or zero if not found.
+    //!
+    TSDUCKDLL const uint8_t* LocateZeroZero(const void* area, size_t area_size, uint8_t xx_min = 0x01, uint8_t xx_max = 0x01);
+
     //!
     //! Check if a memory area contains all identical byte values.
     //! @param [in] area Address of a memory area to check.
@@ -50,9 +50,19 @@ namespace ts {
         //! Constructor, based on required amount of elements.
         //! Abort application if memory allocation fails.
         //! Do not abort if memory locking fails.
+        //!
+        //! On Linux, the buffer can be allocated in huge pages and bound to a NUMA node.
+        //! When huge pages cannot be allocated (none reserved in the system for instance),
+        //! the buffer falls back to normal pages and transparent huge pages are requested.
+        //! On other systems, @a huge_page_size and @a numa_node are ignored.
+        //!
         //! @param [in] elem_count Number of @a T elements.
+        //! @param [in] huge_page_size Size in bytes of huge pages to use, typically 2 MB or 1 GB.
+        //! When zero (the default), use normal memory pages.
+        //! @param [in] numa_node Index of the NUMA node on which the memory shall be allocated.
+        //! When negative (the default), use the default memory policy of the process.
         //!
-        ResidentBuffer(size_t elem_count);
+        ResidentBuffer(size_t elem_count, size_t huge_page_size = 0, int numa_node = -1);
 
         //!
         //! Destructor.
@@ -77,6 +87,24 @@ namespace ts {
             return _error_code;
         }
 
+        //!
+        //! Check if the buffer is actually allocated in huge pages.
+        //! @return True if the buffer is allocated in huge pages of the requested size.
+        //!
+        bool isHugePages() const
+        {
+            return _is_huge;
+        }
+
+        //!
+        //! Get error code when the NUMA binding failed.
+        //! @return The system error code when binding the buffer to the requested NUMA node failed.
+        //!
+        SysErrorCode numaErrorCode() const
+        {
+            return _numa_error;
+        }
+
         //!
         //! Return base address of the buffer.
         //! @return The address of the first @a T element in the buffer.
@@ -103,7 +131,10 @@ namespace ts {
         size_t    _locked_size;      // Locked size (mlock, multiple of page size)
         size_t    _elem_count;       // Element count in locked region
         bool      _is_locked;        // False if mlock failed.
-        SysErrorCode _error_code;       // Lock error code
+        bool      _is_mapped;        // True if allocated using mmap(), false if new[].
+        bool      _is_huge;          // True if allocated in huge pages.
+        SysErrorCode _error_code;    // Lock error code
+        SysErrorCode _numa_error;    // NUMA binding error code
     };
 }
 
@@ -35,17 +35,19 @@
 #pragma once
 #include "tsIntegerUtils.h"
 #include "tsSysInfo.h"
+#include "tsMemory.h"
 #include "tsFatal.h"
 
 
 //----------------------------------------------------------------------------
 // Constructor, based on required amount of T elements.
+// Optionally use huge pages and NUMA binding.
 // Abort application is memory allocation fails.
 // Do not abort is memory locking fails.
 //----------------------------------------------------------------------------
 
 template <typename T>
-ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
+ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count, size_t huge_page_size, int numa_node) :
     _allocated_base(nullptr),
     _locked_base(nullptr),
     _base(nullptr),
@@ -53,24 +55,96 @@ ts::ResidentBuffer<T>::ResidentBuffer(size_t elem_count) :
     _locked_size(0),
     _elem_count(elem_count),
     _is_locked(false),
-    _error_code(SYS_SUCCESS)
+    _is_mapped(false),
+    _is_huge(false),
+    _error_code(SYS_SUCCESS),
+    _numa_error(SYS_SUCCESS)
 {
     const size_t requested_size = elem_count * sizeof(T);
     const size_t page_size = SysInfo::Instance()->memoryPageSize();
 
-    // Allocate enough space to include memory pages around the requested size
+#if defined(TS_LINUX)
+
+    // With huge pages or NUMA binding, use an anonymous memory mapping.
+    // The memory policy must be set before the pages are first accessed.
+
+    if (huge_page_size > 0 || numa_node >= 0) {
+        void* addr = MAP_FAILED;
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+        if (huge_page_size > page_size) {
+            // The size of huge pages is encoded as a power of 2 in the mmap flags.
+            int shift = 0;
+            while ((size_t(1) << shift) < huge_page_size) {
+                shift++;
+            }
+            _allocated_size = RoundUp(requested_size, size_t(1) << shift);
+            addr = ::mmap(nullptr, _allocated_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (shift << MAP_HUGE_SHIFT), -1, 0);
+            _is_huge = addr != MAP_FAILED;
+        }
+#endif
+        if (addr == MAP_FAILED) {
+            // No huge page available, fallback to normal pages.
+            _allocated_size = RoundUp(requested_size, page_size);
+            addr = ::mmap(nullptr, _allocated_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#if defined(MADV_HUGEPAGE)
+            if (addr != MAP_FAILED && huge_page_size > 0) {
+                // Try transparent huge pages, ignore errors.
+                ::madvise(addr, _allocated_size, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        if (addr != MAP_FAILED && numa_node >= 0) {
+            // Bind the memory area to the NUMA node (MPOL_BIND policy, as defined in <numaif.h>).
+            // Use the system call directly to avoid a dependency on libnuma.
+            constexpr int mpol_bind = 2;
+            constexpr size_t ulong_bits = 8 * sizeof(unsigned long);
+            unsigned long nodemask[16];
+            TS_ZERO(nodemask);
+            if (size_t(numa_node) >= 8 * sizeof(nodemask)) {
+                _numa_error = EINVAL;
+            }
+            else {
+                nodemask[size_t(numa_node) / ulong_bits] = 1UL << (size_t(numa_node) % ulong_bits);
+                if (::syscall(SYS_mbind, addr, _allocated_size, mpol_bind, nodemask, 8 * sizeof(nodemask) + 1, 0) != 0) {
+                    _numa_error = LastSysErrorCode();
+                }
+            }
+        }
+        if (addr != MAP_FAILED) {
+            _is_mapped = true;
+            _allocated_base = _locked_base = char_ptr(addr);
+            _locked_size = _allocated_size;
+        }
+        else {
+            // Give up, use the normal allocation below.
+            _allocated_size = 0;
+            _is_huge = false;
+        }
+    }
+
+#else
+
+    // Huge pages and NUMA binding are not implemented on this platform.
+    TS_UNUSED const bool ignored = huge_page_size > 0 || numa_node >= 0;
+
+#endif
+
+    if (!_is_mapped) {
 
-    _allocated_size = requested_size + 2 * page_size;
-    _allocated_base = new char[_allocated_size];
+        // Allocate enough space to include memory pages around the requested size
 
-    // Locked space starts at next page boundary after allocated base:
-    // Its size is the next multiple of page size after requested_size:
-    // Be sure to use size_t (unsigned) instead of ptrdiff_t (signed)
-    // to perform arithmetics on pointers because we use modulo operations.
+        _allocated_size = requested_size + 2 * page_size;
+        _allocated_base = new char[_allocated_size];
 
-    assert(sizeof(size_t) == sizeof(char_ptr));
-    _locked_base = char_ptr(RoundUp(size_t(_allocated_base), page_size));
-    _locked_size = RoundUp(requested_size, page_size);
+        // Locked space starts at next page boundary after allocated base:
+        // Its size is the next multiple of page size after requested_size:
+        // Be sure to use size_t (unsigned) instead of ptrdiff_t (signed)
+        // to perform arithmetics on pointers because we use modulo operations.
+
+        assert(sizeof(size_t) == sizeof(char_ptr));
+        _locked_base = char_ptr(RoundUp(size_t(_allocated_base), page_size));
+        _locked_size = RoundUp(requested_size, page_size);
+    }
 
     _base = new (_locked_base) T[elem_count];
 
@@ -138,7 +212,12 @@ ts::ResidentBuffer<T>::~ResidentBuffer<T>()
     }
 
     // Free memory
-    if (_allocated_base != nullptr) {
+    if (_allocated_base != nullptr && _is_mapped) {
+#if defined(TS_LINUX)
+        ::munmap(_allocated_base, _allocated_size);
+#endif
+    }
+    else if (_allocated_base != nullptr) {
         delete[] _allocated_base;
     }
 
@@ -150,4 +229,6 @@ ts::ResidentBuffer<T>::~ResidentBuffer<T>()
     _locked_size = 0;
     _elem_count = 0;
     _is_locked = false;
+    _is_mapped = false;
+    _is_huge = false;
 }
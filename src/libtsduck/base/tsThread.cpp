@@ -228,6 +228,20 @@ bool ts::Thread::start()
         return false;
     }
 
+    // Set the CPU affinity. Only the first 64 CPU's can be used in an affinity mask.
+    if (!_attributes._affinity.empty()) {
+        ::DWORD_PTR mask = 0;
+        for (auto it = _attributes._affinity.begin(); it != _attributes._affinity.end(); ++it) {
+            if (*it < 8 * sizeof(mask)) {
+                mask |= ::DWORD_PTR(1) << *it;
+            }
+        }
+        if (mask == 0 || ::SetThreadAffinityMask(_handle, mask) == 0) {
+            ::CloseHandle(_handle);
+            return false;
+        }
+    }
+
     // Release the thread
     if (::ResumeThread(_handle) == ::DWORD(-1)) {
         ::CloseHandle(_handle);
@@ -275,6 +289,23 @@ bool ts::Thread::start()
         return false;
     }
 
+#if defined(TS_LINUX)
+    // Set the CPU affinity.
+    if (!_attributes._affinity.empty()) {
+        ::cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        for (auto it = _attributes._affinity.begin(); it != _attributes._affinity.end(); ++it) {
+            if (*it < CPU_SETSIZE) {
+                CPU_SET(*it, &cpus);
+            }
+        }
+        if (CPU_COUNT(&cpus) == 0 || ::pthread_attr_setaffinity_np(&attr, sizeof(cpus), &cpus) != 0) {
+            ::pthread_attr_destroy(&attr);
+            return false;
+        }
+    }
+#endif
+
     // Create the thread
     if (::pthread_create(&_pthread, &attr, Thread::ThreadProc, this) != 0) {
         ::pthread_attr_destroy(&attr);
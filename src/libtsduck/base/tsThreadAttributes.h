@@ -184,6 +184,38 @@ namespace ts {
             return _priority;
         }
 
+        //!
+        //! Set the CPU affinity of the thread.
+        //!
+        //! The thread will run only on the specified set of CPU's (logical processors).
+        //! CPU's are identified by their index in the system, starting at zero.
+        //! An empty set means no specific affinity, the thread can run on any CPU.
+        //! This is the default.
+        //!
+        //! The CPU affinity is currently implemented on Linux and Windows only.
+        //! On Windows, only the first 64 CPU's can be used. On other operating
+        //! systems, the affinity is ignored.
+        //!
+        //! @param [in] cpus Set of CPU indexes on which the thread is allowed to run.
+        //! @return A reference to this object.
+        //!
+        ThreadAttributes& setAffinity(const std::set<size_t>& cpus)
+        {
+            _affinity = cpus;
+            return *this;
+        }
+
+        //!
+        //! Get the CPU affinity of the thread.
+        //! @return A constant reference to the set of CPU indexes on which the thread
+        //! is allowed to run. An empty set means no specific affinity.
+        //! @see setAffinity()
+        //!
+        const std::set<size_t>& getAffinity() const
+        {
+            return _affinity;
+        }
+
         //!
         //! Get the minimum priority for a thread in this context of the operating system.
         //! @return The minimum priority for a thread.
@@ -241,6 +273,7 @@ namespace ts {
         size_t _stackSize;
         bool _deleteWhenTerminated;
         int _priority;
+        std::set<size_t> _affinity;
 
         //
         // These fields describe the operating system priority range.
@@ -38,6 +38,12 @@
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
 
+// SSE2 is always available on x86_64 and used for ASCII fast paths in UTF conversions.
+#if defined(TS_X86_64) || defined(__SSE2__)
+    #define TS_UTF_SSE2 1
+    #include <emmintrin.h>
+#endif
+
 // The UTF-8 Byte Order Mark
 const char* const ts::UString::UTF8_BOM = "\xEF\xBB\xBF";
 
@@ -89,6 +95,80 @@ const ::WCHAR* ts::UString::wc_str() const
 #endif
 
 
+//----------------------------------------------------------------------------
+// ASCII fast paths for UTF conversions. Most strings in TSDuck are pure ASCII
+// or mostly ASCII (names, options, XML, JSON). These functions convert blocks
+// of ASCII characters at once and return the number of converted characters.
+// They stop at the first block containing a non-ASCII character, which is
+// left to the general byte-oriented conversion loop.
+//----------------------------------------------------------------------------
+
+namespace {
+    size_t AsciiUTF16ToUTF8(const ts::UChar* in, size_t inSize, char* out, size_t outSize)
+    {
+        const size_t size = std::min(inSize, outSize);
+        size_t count = 0;
+#if defined(TS_UTF_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mask = _mm_set1_epi16(int16_t(0xFF80));
+        while (count + 16 <= size) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + count));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + count + 8));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(_mm_or_si128(a, b), mask), zero)) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), _mm_packus_epi16(a, b));
+            count += 16;
+        }
+#else
+        while (count + 4 <= size) {
+            uint64_t chars = 0;
+            ::memcpy(&chars, in + count, sizeof(chars));
+            if ((chars & TS_UCONST64(0xFF80FF80FF80FF80)) != 0) {
+                break;
+            }
+            for (size_t i = 0; i < 4; ++i) {
+                out[count + i] = char(in[count + i]);
+            }
+            count += 4;
+        }
+#endif
+        return count;
+    }
+
+    size_t AsciiUTF8ToUTF16(const char* in, size_t inSize, ts::UChar* out, size_t outSize)
+    {
+        const size_t size = std::min(inSize, outSize);
+        size_t count = 0;
+#if defined(TS_UTF_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        while (count + 16 <= size) {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + count));
+            if (_mm_movemask_epi8(a) != 0) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), _mm_unpacklo_epi8(a, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count + 8), _mm_unpackhi_epi8(a, zero));
+            count += 16;
+        }
+#else
+        while (count + 8 <= size) {
+            uint64_t bytes = 0;
+            ::memcpy(&bytes, in + count, sizeof(bytes));
+            if ((bytes & TS_UCONST64(0x8080808080808080)) != 0) {
+                break;
+            }
+            for (size_t i = 0; i < 8; ++i) {
+                out[count + i] = ts::UChar(in[count + i]);
+            }
+            count += 8;
+        }
+#endif
+        return count;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // General routine to convert from UTF-16 to UTF-8.
 //----------------------------------------------------------------------------
@@ -148,6 +228,10 @@ void ts::UString::ConvertUTF16ToUTF8(const UChar*& inStart, const UChar* inEnd,
             if (code < 0x0080) {
                 // ASCII compatible value, one byte encoding.
                 *outStart++ = char(code);
+                // Try to convert the next characters as a block of ASCII.
+                const size_t count = AsciiUTF16ToUTF8(inStart, inEnd - inStart, outStart, outEnd - outStart);
+                inStart += count;
+                outStart += count;
             }
             else if (code < 0x800 && outStart + 1 < outEnd) {
                 // 2 bytes encoding.
@@ -221,6 +305,10 @@ void ts::UString::ConvertUTF8ToUTF16(const char*& inStart, const char* inEnd, UC
         if (code < 0x80) {
             // 0xxx xxxx, ASCII compatible value, one byte encoding.
             *outStart++ = uint16_t(code);
+            // Try to convert the next characters as a block of ASCII.
+            const size_t count = AsciiUTF8ToUTF16(inStart, inEnd - inStart, outStart, outEnd - outStart);
+            inStart += count;
+            outStart += count;
         }
         else if ((code & 0xE0) == 0xC0) {
             // 110x xxx, 2 byte encoding.
@@ -361,14 +449,26 @@ ts::UString& ts::UString::assignFromUTF8(const char* utf8, size_type count)
 
 void ts::UString::toUTF8(std::string& utf8) const
 {
-    // The maximum number of UTF-8 bytes is 3 times the number of UTF-16 codes.
-    utf8.resize(3 * size());
-
+    // First assume that the string is mostly ASCII, one UTF-8 byte per UTF-16 code.
+    // If this is not the case, the conversion stops when the output buffer is full.
+    // The buffer is then extended once for the worst case of the rest of the string:
+    // 3 UTF-8 bytes per UTF-16 code.
     const UChar* inStart = data();
-    char* outStart = const_cast<char*>(utf8.data());
-    ConvertUTF16ToUTF8(inStart, inStart + size(), outStart, outStart + utf8.size());
+    const UChar* const inEnd = inStart + size();
+    size_t outSize = 0;
+    utf8.resize(size());
 
-    utf8.resize(outStart - utf8.data());
+    for (;;) {
+        char* const outBase = &utf8[0];
+        char* outStart = outBase + outSize;
+        ConvertUTF16ToUTF8(inStart, inEnd, outStart, outBase + utf8.size());
+        outSize = outStart - outBase;
+        if (inStart >= inEnd) {
+            break;
+        }
+        utf8.resize(outSize + 3 * (inEnd - inStart));
+    }
+    utf8.resize(outSize);
 }
 
 std::string ts::UString::toUTF8() const
@@ -0,0 +1,368 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlCompiledModel.h"
+#include "tsxmlModelDocument.h"
+#include "tsxmlElement.h"
+#include "tsGuard.h"
+TSDUCK_SOURCE;
+
+// References in XML model files.
+// Example: <_any in="_descriptors"/>
+// means: accept all children of <_descriptors> in root of document.
+
+namespace {
+    const ts::UString TSXML_REF_NODE(u"_any");
+    const ts::UString TSXML_REF_ATTR(u"in");
+
+    // Process-wide cache of compiled models.
+    struct ModelCache
+    {
+        ts::Mutex mutex;
+        std::map<ts::UString, ts::xml::CompiledModelPtr> models;
+        ModelCache() : mutex(), models() {}
+    };
+
+    ModelCache& TheModelCache()
+    {
+        static ModelCache cache;
+        return cache;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::xml::CompiledModel::CompiledModel() :
+    _nodes()
+{
+}
+
+ts::xml::CompiledModel::ModelNode::ModelNode() :
+    name(),
+    attributes(),
+    children(),
+    refs(),
+    hexa_text(false)
+{
+}
+
+void ts::xml::CompiledModel::clear()
+{
+    _nodes.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Build an index key from an element name.
+//----------------------------------------------------------------------------
+
+ts::UString ts::xml::CompiledModel::NameKey(const UString& name)
+{
+    UString key;
+    key.reserve(name.length());
+    for (size_t i = 0; i < name.length(); ++i) {
+        if (!IsSpace(name[i])) {
+            key.push_back(ToLower(name[i]));
+        }
+    }
+    return key;
+}
+
+
+//----------------------------------------------------------------------------
+// Compile an XML model document.
+//----------------------------------------------------------------------------
+
+bool ts::xml::CompiledModel::compile(const Document& model, Report& report)
+{
+    clear();
+
+    const Element* root = model.rootElement();
+    if (root == nullptr) {
+        report.error(u"invalid XML model, no root element");
+        return false;
+    }
+
+    // Compile all elements, starting at the root (index 0).
+    std::map<const Element*, size_t> index;
+    bool success = true;
+    compileElement(root, index, success, report);
+
+    // Resolve references transitively so that lookups never recurse.
+    for (size_t i = 0; success && i < _nodes.size(); ++i) {
+        std::vector<size_t> refs;
+        std::set<size_t> visited;
+        visited.insert(i);
+        flattenReferences(i, refs, visited);
+        _nodes[i].refs.swap(refs);
+    }
+
+    if (!success) {
+        clear();
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Compile an element and its subtree, return its index in _nodes.
+//----------------------------------------------------------------------------
+
+size_t ts::xml::CompiledModel::compileElement(const Element* model, std::map<const Element*, size_t>& index, bool& success, Report& report)
+{
+    // Each model element is compiled only once, even when referenced several times.
+    const auto it = index.find(model);
+    if (it != index.end()) {
+        return it->second;
+    }
+
+    // Allocate the new node. Always use its index since _nodes may be reallocated.
+    const size_t id = _nodes.size();
+    _nodes.push_back(ModelNode());
+    index[model] = id;
+    _nodes[id].name = model->name();
+
+    UStringList names;
+    model->getAttributesNames(names);
+    for (const auto& attr : names) {
+        // Same interpretation of the attribute description as JSONConverter.
+        UString description(model->attribute(attr).value());
+        description.trim(true, false, false);
+        ValueType type = ValueType::STRING;
+        if (description.startWith(u"uint", CASE_INSENSITIVE) || description.startWith(u"int", CASE_INSENSITIVE)) {
+            type = ValueType::INTEGER;
+        }
+        else if (description.startWith(u"bool", CASE_INSENSITIVE)) {
+            type = ValueType::BOOLEAN;
+        }
+        _nodes[id].attributes[attr.toLower()] = type;
+    }
+    UString text;
+    model->getText(text, true);
+    _nodes[id].hexa_text = text.startWith(u"hexa", CASE_INSENSITIVE);
+
+    for (const Element* child = model->firstChildElement(); child != nullptr; child = child->nextSiblingElement()) {
+        if (child->name().similar(TSXML_REF_NODE)) {
+            // The model contains a reference to a child of the root of the document.
+            const UString refName(child->attribute(TSXML_REF_ATTR).value());
+            const Document* document = model->document();
+            const Element* root = document == nullptr ? nullptr : document->rootElement();
+            const Element* refElem = root == nullptr || refName.empty() ? nullptr : root->findFirstChild(refName, true);
+            if (refName.empty()) {
+                report.error(u"invalid XML model, missing or empty attribute 'in' for <%s> at line %d", {child->name(), child->lineNumber()});
+                success = false;
+            }
+            else if (refElem == nullptr) {
+                report.error(u"invalid XML model, <%s> not found in model root, referenced in line %d", {refName, child->attribute(TSXML_REF_ATTR).lineNumber()});
+                success = false;
+            }
+            else {
+                const size_t ref = compileElement(refElem, index, success, report);
+                _nodes[id].refs.push_back(ref);
+            }
+        }
+        else {
+            // Keep the first definition of a name, as a linear search would do.
+            const UString key(NameKey(child->name()));
+            if (_nodes[id].children.find(key) == _nodes[id].children.end()) {
+                const size_t sub = compileElement(child, index, success, report);
+                _nodes[id].children[key] = sub;
+            }
+        }
+    }
+    return id;
+}
+
+
+//----------------------------------------------------------------------------
+// Flatten references transitively, remove duplicates.
+//----------------------------------------------------------------------------
+
+void ts::xml::CompiledModel::flattenReferences(size_t node, std::vector<size_t>& refs, std::set<size_t>& visited) const
+{
+    for (const auto ref : _nodes[node].refs) {
+        if (visited.insert(ref).second) {
+            refs.push_back(ref);
+            flattenReferences(ref, refs, visited);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Find a child model in a compiled node.
+//----------------------------------------------------------------------------
+
+size_t ts::xml::CompiledModel::findChild(size_t node, const UString& key) const
+{
+    // Explicit children first, then all referenced nodes, in order.
+    auto it = _nodes[node].children.find(key);
+    if (it != _nodes[node].children.end()) {
+        return it->second;
+    }
+    for (const auto ref : _nodes[node].refs) {
+        it = _nodes[ref].children.find(key);
+        if (it != _nodes[ref].children.end()) {
+            return it->second;
+        }
+    }
+    return NPOS;
+}
+
+
+//----------------------------------------------------------------------------
+// Navigation in the compiled model.
+//----------------------------------------------------------------------------
+
+size_t ts::xml::CompiledModel::rootNode(const UString& name) const
+{
+    return !_nodes.empty() && NameKey(_nodes[0].name) == NameKey(name) ? 0 : NPOS;
+}
+
+size_t ts::xml::CompiledModel::childNode(size_t node, const UString& name) const
+{
+    return node < _nodes.size() ? findChild(node, NameKey(name)) : NPOS;
+}
+
+ts::xml::CompiledModel::ValueType ts::xml::CompiledModel::attributeType(size_t node, const UString& name) const
+{
+    if (node < _nodes.size()) {
+        const auto it = _nodes[node].attributes.find(name.toLower());
+        if (it != _nodes[node].attributes.end()) {
+            return it->second;
+        }
+    }
+    return ValueType::STRING;
+}
+
+
+//----------------------------------------------------------------------------
+// Validate an XML document.
+//----------------------------------------------------------------------------
+
+bool ts::xml::CompiledModel::validate(const Document& doc) const
+{
+    const Element* docRoot = doc.rootElement();
+
+    if (_nodes.empty()) {
+        doc.report().error(u"invalid XML model, no root element");
+        return false;
+    }
+    else if (docRoot == nullptr) {
+        doc.report().error(u"invalid XML document, no root element");
+        return false;
+    }
+    else if (NameKey(_nodes[0].name) == NameKey(docRoot->name())) {
+        return validateElement(0, docRoot);
+    }
+    else {
+        doc.report().error(u"invalid XML document, expected <%s> as root, found <%s>", {_nodes[0].name, docRoot->name()});
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Validate an XML tree of elements, used by validate().
+//----------------------------------------------------------------------------
+
+bool ts::xml::CompiledModel::validateElement(size_t model, const Element* doc) const
+{
+    Report& report(doc->report());
+    const ModelNode& node(_nodes[model]);
+
+    // Report all errors, return final status at the end.
+    bool success = true;
+
+    // Check that all attributes in doc exist in model.
+    UStringList names;
+    doc->getAttributesNames(names);
+    for (const auto& name : names) {
+        if (node.attributes.find(name.toLower()) == node.attributes.end()) {
+            const Attribute& attr(doc->attribute(name));
+            report.error(u"unexpected attribute '%s' in <%s>, line %d", {attr.name(), doc->name(), attr.lineNumber()});
+            success = false;
+        }
+    }
+
+    // Check that all children elements in doc exist in model.
+    for (const Element* docChild = doc->firstChildElement(); docChild != nullptr; docChild = docChild->nextSiblingElement()) {
+        const size_t modelChild = findChild(model, NameKey(docChild->name()));
+        if (modelChild == NPOS) {
+            report.error(u"unexpected node <%s> in <%s>, line %d", {docChild->name(), doc->name(), docChild->lineNumber()});
+            success = false;
+        }
+        else if (!validateElement(modelChild, docChild)) {
+            success = false;
+        }
+    }
+
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Process-wide cache of compiled models.
+//----------------------------------------------------------------------------
+
+ts::xml::CompiledModelPtr ts::xml::CompiledModel::Cached(const UString& file_name, Report& report)
+{
+    return Cached(file_name, nullptr, report);
+}
+
+ts::xml::CompiledModelPtr ts::xml::CompiledModel::Cached(const UString& key, ModelLoader loader, Report& report)
+{
+    ModelCache& cache(TheModelCache());
+    Guard lock(cache.mutex);
+
+    const auto it = cache.models.find(key);
+    if (it != cache.models.end()) {
+        return it->second;
+    }
+
+    // First use of this model: load, compile and keep it. Errors are not cached.
+    // Without explicit loader, the key is the model file name, searched in TSDuck directory.
+    ModelDocument doc(report);
+    CompiledModelPtr model(new CompiledModel);
+    if (!(loader == nullptr ? doc.load(key, true) : loader(doc)) || !model->compile(doc, report)) {
+        return CompiledModelPtr();
+    }
+    cache.models[key] = model;
+    return model;
+}
+
+void ts::xml::CompiledModel::ClearCache()
+{
+    ModelCache& cache(TheModelCache());
+    Guard lock(cache.mutex);
+    cache.models.clear();
+}
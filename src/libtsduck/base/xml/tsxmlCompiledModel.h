@@ -0,0 +1,200 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Compiled and cached representation of the model of an XML document.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlDocument.h"
+#include "tsSafePtr.h"
+#include "tsMutex.h"
+
+namespace ts {
+    namespace xml {
+
+        class CompiledModel;
+
+        //!
+        //! Safe pointer to a compiled XML model (thread-safe).
+        //!
+        typedef SafePtr<CompiledModel, Mutex> CompiledModelPtr;
+
+        //!
+        //! Compiled representation of the model of an XML document.
+        //! @ingroup xml
+        //!
+        //! A compiled model is built from an XML model document (see ModelDocument) and
+        //! validates documents with the same rules. All element names are indexed,
+        //! all <code>&lt;_any in="..."&gt;</code> references are resolved once for all,
+        //! so that the validation of a document does not need to browse the model tree.
+        //!
+        //! Once compiled, an instance is immutable and can be shared between threads.
+        //! The static methods Cached() maintain a process-wide cache of compiled models
+        //! so that a given model file is loaded and compiled only once per process.
+        //!
+        class TSDUCKDLL CompiledModel
+        {
+            TS_NOCOPY(CompiledModel);
+        public:
+            //!
+            //! Constructor.
+            //!
+            CompiledModel();
+
+            //!
+            //! Clear the content of the compiled model.
+            //!
+            void clear();
+
+            //!
+            //! Check if the compiled model is valid.
+            //! @return True if the model is valid.
+            //!
+            bool isValid() const { return !_nodes.empty(); }
+
+            //!
+            //! Compile an XML model document.
+            //! @param [in] model The XML model document (typically a ModelDocument).
+            //! @param [in,out] report Where to report errors.
+            //! @return True on success, false on invalid model.
+            //!
+            bool compile(const Document& model, Report& report = NULLREP);
+
+            //!
+            //! Validate an XML document.
+            //! Errors are reported to the report of @a doc.
+            //! @param [in] doc The document to validate according to the model.
+            //! @return True if @a doc matches the model in this object, false if it does not.
+            //!
+            bool validate(const Document& doc) const;
+
+            //!
+            //! Type of attribute values, as described in the model.
+            //!
+            enum class ValueType {
+                STRING,   //!< Any string or unknown type.
+                INTEGER,  //!< Integer value ("int..." or "uint..." in the model).
+                BOOLEAN,  //!< Boolean value ("bool..." in the model).
+            };
+
+            //!
+            //! Get the model node of the root element of a document.
+            //! @param [in] name Name of the root element of the document.
+            //! @return Index of the model root node or NPOS if the model has a different root.
+            //!
+            size_t rootNode(const UString& name) const;
+
+            //!
+            //! Get the model node of a child element.
+            //! @param [in] node Index of the model node of the parent element, as returned by rootNode() or childNode().
+            //! @param [in] name Name of the child element.
+            //! @return Index of the model node of the child or NPOS if not found or @a node is NPOS.
+            //!
+            size_t childNode(size_t node, const UString& name) const;
+
+            //!
+            //! Get the type of an attribute value, as described in the model.
+            //! @param [in] node Index of the model node of the element.
+            //! @param [in] name Name of the attribute.
+            //! @return Type of the attribute. ValueType::STRING if not found or @a node is NPOS.
+            //!
+            ValueType attributeType(size_t node, const UString& name) const;
+
+            //!
+            //! Check if the text content of an element is described as hexadecimal data in the model.
+            //! @param [in] node Index of the model node of the element.
+            //! @return True if the text is hexadecimal data. False if it is not or @a node is NPOS.
+            //!
+            bool hexaText(size_t node) const { return node < _nodes.size() && _nodes[node].hexa_text; }
+
+            //!
+            //! Profile of a function which loads an XML model document.
+            //! @param [in,out] model The document to load the model into.
+            //! @return True on success, false on error.
+            //!
+            typedef bool (*ModelLoader)(Document& model);
+
+            //!
+            //! Get a compiled model from the process-wide cache.
+            //! The model file is loaded and compiled the first time only.
+            //! @param [in] file_name Name of the model file. Search it in TSDuck directory.
+            //! @param [in,out] report Where to report errors.
+            //! @return A safe pointer to the compiled model or a null pointer on error.
+            //!
+            static CompiledModelPtr Cached(const UString& file_name, Report& report);
+
+            //!
+            //! Get a compiled model from the process-wide cache, using a custom loader.
+            //! @param [in] key Cache key. Must uniquely identify the model which is built by @a loader.
+            //! @param [in] loader Function which loads the model document the first time.
+            //! @param [in,out] report Where to report errors.
+            //! @return A safe pointer to the compiled model or a null pointer on error.
+            //!
+            static CompiledModelPtr Cached(const UString& key, ModelLoader loader, Report& report);
+
+            //!
+            //! Remove all compiled models from the process-wide cache.
+            //! Models which are currently referenced remain valid.
+            //!
+            static void ClearCache();
+
+        private:
+            // A compiled model element. Child elements and references are indexes in _nodes.
+            // Referenced nodes are searched in order, after the explicit children.
+            struct ModelNode
+            {
+                ModelNode();
+                UString                      name;        // Element name, for error messages.
+                std::map<UString, ValueType> attributes;  // Attribute types, indexed by lower case names.
+                std::map<UString, size_t>    children;    // Child elements, indexed by NameKey().
+                std::vector<size_t>          refs;        // Resolved <_any in="..."/> references.
+                bool                         hexa_text;   // The text content is hexadecimal data.
+            };
+
+            std::vector<ModelNode> _nodes;  // All compiled nodes, index 0 is the root.
+
+            // Compile an element and its subtree, return its index in _nodes.
+            size_t compileElement(const Element* model, std::map<const Element*, size_t>& index, bool& success, Report& report);
+
+            // Flatten references transitively, remove duplicates.
+            void flattenReferences(size_t node, std::vector<size_t>& refs, std::set<size_t>& visited) const;
+
+            // Find a child model in a compiled node, NPOS if not found.
+            size_t findChild(size_t node, const UString& key) const;
+
+            // Validate an XML tree of elements, used by validate().
+            bool validateElement(size_t model, const Element* doc) const;
+
+            // Build an index key from an element name (case-insensitive, ignore spaces, same as UString::similar()).
+            static UString NameKey(const UString& name);
+        };
+    }
+}
@@ -350,35 +350,65 @@ ts::UString ts::xml::Element::attributeKey(const UString& attributeName) const
     return _attributeCase == CASE_SENSITIVE ? attributeName : attributeName.toLower();
 }
 
-ts::xml::Element::AttributeMap::const_iterator ts::xml::Element::findAttribute(const UString& attributeName) const
+const ts::xml::Attribute* ts::xml::Element::findAttribute(const UString& attributeName) const
 {
-    return _attributes.find(attributeKey(attributeName));
+    const size_t len = attributeName.length();
+    for (auto it = _attributes.begin(); it != _attributes.end(); ++it) {
+        const UString& name(it->name());
+        if (name.length() == len) {
+            size_t i = 0;
+            while (i < len && Match(name[i], attributeName[i], _attributeCase)) {
+                ++i;
+            }
+            if (i == len) {
+                return &*it;
+            }
+        }
+    }
+    return nullptr;
+}
+
+ts::xml::Attribute* ts::xml::Element::findAttribute(const UString& attributeName)
+{
+    return const_cast<Attribute*>(static_cast<const Element*>(this)->findAttribute(attributeName));
 }
 
 void ts::xml::Element::setAttribute(const UString& name, const UString& value, bool onlyIfNotEmpty)
 {
     if (!onlyIfNotEmpty || !value.empty()) {
-        _attributes[attributeKey(name)] = Attribute(name, value);
+        Attribute* const attr = findAttribute(name);
+        if (attr != nullptr) {
+            *attr = Attribute(name, value);
+        }
+        else {
+            _attributes.push_back(Attribute(name, value));
+        }
     }
 }
 
 void ts::xml::Element::deleteAttribute(const UString& name)
 {
-    const auto it = _attributes.find(attributeKey(name));
-    if (it != _attributes.end()) {
-        _attributes.erase(it);
+    const Attribute* const attr = findAttribute(name);
+    if (attr != nullptr) {
+        _attributes.erase(_attributes.begin() + (attr - _attributes.data()));
     }
 }
 
 bool ts::xml::Element::hasAttribute(const UString& name) const
 {
-    return findAttribute(name) != _attributes.end();
+    return findAttribute(name) != nullptr;
 }
 
 ts::xml::Attribute& ts::xml::Element::refAttribute(const UString& name)
 {
-    const auto it = _attributes.find(attributeKey(name));
-    return it == _attributes.end() ? (_attributes[attributeKey(name)] = Attribute(name, u"")) : it->second;
+    Attribute* const attr = findAttribute(name);
+    if (attr != nullptr) {
+        return *attr;
+    }
+    else {
+        _attributes.push_back(Attribute(name, u""));
+        return _attributes.back();
+    }
 }
 
 
@@ -388,10 +418,10 @@ ts::xml::Attribute& ts::xml::Element::refAttribute(const UString& name)
 
 const ts::xml::Attribute& ts::xml::Element::attribute(const UString& attributeName, bool silent) const
 {
-    const auto it = findAttribute(attributeName);
-    if (it != _attributes.end()) {
+    const Attribute* const attr = findAttribute(attributeName);
+    if (attr != nullptr) {
         // Found the real attribute.
-        return it->second;
+        return *attr;
     }
     if (!silent) {
         report().error(u"attribute '%s' not found in <%s>, line %d", {attributeName, name(), lineNumber()});
@@ -700,9 +730,14 @@ bool ts::xml::Element::getMACAttribute(MACAddress& value, const UString& name, b
 
 void ts::xml::Element::getAttributesNames(UStringList& names) const
 {
-    names.clear();
+    // Sorted by attribute key, as returned by getAttributes().
+    std::map<UString, UString> sorted;
     for (auto it = _attributes.begin(); it != _attributes.end(); ++it) {
-        names.push_back(it->second.name());
+        sorted.insert(std::make_pair(attributeKey(it->name()), it->name()));
+    }
+    names.clear();
+    for (auto it = sorted.begin(); it != sorted.end(); ++it) {
+        names.push_back(it->second);
     }
 }
 
@@ -715,7 +750,7 @@ void ts::xml::Element::getAttributes(std::map<UString,UString>& attr) const
 {
     attr.clear();
     for (auto it = _attributes.begin(); it != _attributes.end(); ++it) {
-        attr[it->first] = it->second.value();
+        attr[attributeKey(it->name())] = it->value();
     }
 }
 
@@ -732,7 +767,7 @@ void ts::xml::Element::getAttributesNamesInModificationOrder(UStringList& names)
 
     // Read all names and build a map indexed by sequence number.
     for (auto it = _attributes.begin(); it != _attributes.end(); ++it) {
-        nameMap.insert(std::make_pair(it->second.sequence(), it->second.name()));
+        nameMap.insert(std::make_pair(it->sequence(), it->name()));
     }
 
     // Then build the name list, ordered by sequence number.
@@ -752,14 +787,17 @@ void ts::xml::Element::print(TextFormatter& output, bool keepNodeOpen) const
     // Output element name.
     output << "<" << name();
 
-    // Get all attributes names, by modification order.
-    UStringList names;
-    getAttributesNamesInModificationOrder(names);
+    // Get all attributes, by modification order.
+    std::vector<const Attribute*> attrs;
+    attrs.reserve(_attributes.size());
+    for (auto it = _attributes.begin(); it != _attributes.end(); ++it) {
+        attrs.push_back(&*it);
+    }
+    std::sort(attrs.begin(), attrs.end(), [](const Attribute* a1, const Attribute* a2) { return a1->sequence() < a2->sequence(); });
 
     // Loop on all attributes.
-    for (UStringList::const_iterator it = names.begin(); it != names.end(); ++it) {
-        const Attribute& attr(attribute(*it));
-        output << " " << attr.name() << "=" << attr.formattedValue(tweaks());
+    for (auto it = attrs.begin(); it != attrs.end(); ++it) {
+        output << " " << (*it)->name() << "=" << (*it)->formattedValue(tweaks());
     }
 
     // Close the tag and return if nothing else to output.
@@ -878,7 +916,7 @@ bool ts::xml::Element::parseNode(TextParser& parser, const Node* parent)
                 ok = false;
             }
             else {
-                _attributes[attributeKey(attrName)] = Attribute(attrName, attrValue, line);
+                _attributes.push_back(Attribute(attrName, attrValue, line));
             }
         }
         else {
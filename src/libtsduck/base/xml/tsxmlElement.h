@@ -62,8 +62,10 @@ namespace ts {
         class TSDUCKDLL Element: public Node
         {
         private:
-            // Attributes are stored indexed by case-(in)sensitive name.
-            typedef std::map<UString, Attribute> AttributeMap;
+            // Attributes are stored in a flat vector, in creation order. Elements usually have
+            // a few attributes only and a linear search with a case-(in)sensitive comparison of
+            // names is faster than a map, without building a lowercase key for each lookup.
+            typedef std::vector<Attribute> AttributeVector;
 
         public:
             //!
@@ -761,13 +763,14 @@ namespace ts {
 
         private:
             CaseSensitivity _attributeCase;  //!< For attribute names.
-            AttributeMap    _attributes;     //!< Map of attributes.
+            AttributeVector _attributes;     //!< Vector of attributes.
 
-            // Compute the key in the attribute map.
+            // Compute the sort key of an attribute name.
             UString attributeKey(const UString& attributeName) const;
 
-            // Find a key in the attribute map.
-            AttributeMap::const_iterator findAttribute(const UString& attributeName) const;
+            // Find an attribute by name, return nullptr if not found.
+            const Attribute* findAttribute(const UString& attributeName) const;
+            Attribute* findAttribute(const UString& attributeName);
 
             // Get a modifiable reference to an attribute, create if does not exist.
             Attribute& refAttribute(const UString& attributeName);
@@ -0,0 +1,381 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsxmlStreamWriter.h"
+#include "tsxmlDocument.h"
+#include "tsxmlElement.h"
+#include "tsxmlText.h"
+#include "tsxmlDeclaration.h"
+#include "tsxmlComment.h"
+#include "tsxmlUnknown.h"
+TSDUCK_SOURCE;
+
+// Characters to escape in XML texts and attributes.
+namespace {
+    const ts::UChar XML_ESCAPE_ALL[] = u"<>&'\"";
+    const ts::UChar XML_ESCAPE_TEXT[] = u"<>&";
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::xml::StreamWriter::StreamWriter(Format format) :
+    _format(format),
+    _tweaks(),
+    _model(),
+    _out(),
+    _stack()
+{
+}
+
+ts::xml::StreamWriter::Level::Level(const UString& n, size_t m) :
+    name(n),
+    model(m),
+    open_tag(true),
+    children(false),
+    sticky(false)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the writer.
+//----------------------------------------------------------------------------
+
+void ts::xml::StreamWriter::reset()
+{
+    // Keep the allocated capacity of the buffers.
+    _out.clear();
+    _stack.clear();
+}
+
+void ts::xml::StreamWriter::setFormat(Format format)
+{
+    _format = format;
+    reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Common processing before a child node of the current element.
+//----------------------------------------------------------------------------
+
+void ts::xml::StreamWriter::beforeChild(bool sticky)
+{
+    if (!_stack.empty()) {
+        Level& level(_stack.back());
+        if (_format == Format::JSON) {
+            _out.append(level.children ? "," : ",\"#nodes\":[");
+        }
+        else {
+            if (level.open_tag) {
+                _out.push_back('>');
+                level.open_tag = false;
+            }
+            // Same spacing as Element::print() on a one-liner text formatter.
+            if (!level.sticky && !sticky) {
+                _out.push_back(' ');
+            }
+        }
+        level.children = true;
+        level.sticky = sticky;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Serialization events.
+//----------------------------------------------------------------------------
+
+void ts::xml::StreamWriter::declaration(const UString& value)
+{
+    if (_format == Format::XML) {
+        beforeChild(false);
+        _out.append("<?");
+        appendUTF8(value);
+        _out.append("?>");
+    }
+}
+
+void ts::xml::StreamWriter::comment(const UString& value)
+{
+    if (_format == Format::XML) {
+        beforeChild(false);
+        _out.append("<!--");
+        appendUTF8(value);
+        _out.append("-->");
+    }
+}
+
+void ts::xml::StreamWriter::startElement(const UString& name)
+{
+    beforeChild(false);
+    if (_format == Format::JSON) {
+        _out.append("{\"#name\":\"");
+        appendJSON(name);
+        _out.push_back('"');
+    }
+    else {
+        _out.push_back('<');
+        appendUTF8(name);
+    }
+    // Locate the element in the model, used to type the JSON attributes.
+    size_t model = NPOS;
+    if (_format == Format::JSON && !_model.isNull()) {
+        model = _stack.empty() ? _model->rootNode(name) : _model->childNode(_stack.back().model, name);
+    }
+    _stack.push_back(Level(name, model));
+}
+
+void ts::xml::StreamWriter::attribute(const UString& name, const UString& value)
+{
+    if (_format == Format::JSON) {
+        _out.append(",\"");
+        appendJSON(name);
+        _out.append("\":");
+        // Same typing rules as JSONConverter: use a string when the value does not match the model.
+        const CompiledModel::ValueType type = _model.isNull() || _stack.empty() ? CompiledModel::ValueType::STRING : _model->attributeType(_stack.back().model, name);
+        int64_t int_value = 0;
+        bool bool_value = false;
+        if (type == CompiledModel::ValueType::INTEGER && value.toInteger(int_value, UString::DEFAULT_THOUSANDS_SEPARATOR)) {
+            appendUTF8(UString::Decimal(int_value, 0, true, UString()));
+        }
+        else if (type == CompiledModel::ValueType::BOOLEAN && value.toBool(bool_value)) {
+            _out.append(bool_value ? "true" : "false");
+        }
+        else {
+            _out.push_back('"');
+            appendJSON(value);
+            _out.push_back('"');
+        }
+    }
+    else {
+        // Same quoting and escaping rules as Attribute::formattedValue().
+        UChar quote = _tweaks.attributeValueQuote();
+        UChar escape[4] = {AMPERSAND, CHAR_NULL, CHAR_NULL, CHAR_NULL};
+        const UChar* esc = escape;
+        if (_tweaks.strictAttributeFormatting) {
+            esc = XML_ESCAPE_ALL;
+        }
+        else if (value.find(quote) != NPOS) {
+            const UChar other = _tweaks.attributeValueOtherQuote();
+            if (value.find(other) == NPOS) {
+                quote = other;
+            }
+            else {
+                escape[1] = quote;
+            }
+        }
+        _out.push_back(' ');
+        appendUTF8(name);
+        _out.push_back('=');
+        _out.push_back(char(quote));
+        appendXML(value, esc);
+        _out.push_back(char(quote));
+    }
+}
+
+void ts::xml::StreamWriter::text(const UString& value, bool cdata, bool trimmable)
+{
+    // Same as Text::stickyOutput().
+    beforeChild(!cdata);
+
+    if (cdata && _format == Format::XML) {
+        _out.append("<![CDATA[");
+        appendUTF8(value);
+        _out.append("]]>");
+    }
+    else {
+        // On one-liners, trim all spaces when allowed. In JSON, hexadecimal texts
+        // from the model are always trimmed, as JSONConverter does.
+        UString str(value);
+        if ((trimmable && !cdata) || (_format == Format::JSON && !_model.isNull() && !_stack.empty() && _model->hexaText(_stack.back().model))) {
+            str.trim(true, true, true);
+        }
+        if (_format == Format::JSON) {
+            _out.push_back('"');
+            appendJSON(str);
+            _out.push_back('"');
+        }
+        else {
+            appendXML(str, _tweaks.strictTextNodeFormatting ? XML_ESCAPE_ALL : XML_ESCAPE_TEXT);
+        }
+    }
+}
+
+void ts::xml::StreamWriter::endElement()
+{
+    if (!_stack.empty()) {
+        const Level& level(_stack.back());
+        if (_format == Format::JSON) {
+            _out.append(level.children ? "]}" : "}");
+        }
+        else if (!level.children) {
+            _out.append("/>");
+        }
+        else {
+            if (!level.sticky) {
+                _out.push_back(' ');
+            }
+            _out.append("</");
+            appendUTF8(level.name);
+            _out.push_back('>');
+        }
+        _stack.pop_back();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Serialize existing XML structures.
+//----------------------------------------------------------------------------
+
+void ts::xml::StreamWriter::write(const Document& doc)
+{
+    if (_format == Format::JSON) {
+        write(doc.rootElement());
+    }
+    else {
+        // Same as Document::print(), each top-level node is followed by an end of line (a space on one-liners).
+        for (const Node* node = doc.firstChild(); node != nullptr; node = node->nextSibling()) {
+            write(node);
+            _out.push_back(' ');
+        }
+    }
+}
+
+void ts::xml::StreamWriter::write(const Node* node)
+{
+    const Element* elem = dynamic_cast<const Element*>(node);
+    const Text* txt = nullptr;
+
+    if (elem != nullptr) {
+        startElement(elem->name());
+        UStringList names;
+        elem->getAttributesNamesInModificationOrder(names);
+        for (const auto& name : names) {
+            const Attribute& attr(elem->attribute(name));
+            attribute(attr.name(), attr.value());
+        }
+        for (const Node* child = elem->firstChild(); child != nullptr; child = child->nextSibling()) {
+            write(child);
+        }
+        endElement();
+    }
+    else if ((txt = dynamic_cast<const Text*>(node)) != nullptr) {
+        text(txt->value(), txt->isCData(), txt->isTrimmable());
+    }
+    else if (dynamic_cast<const Declaration*>(node) != nullptr) {
+        declaration(node->value());
+    }
+    else if (dynamic_cast<const Comment*>(node) != nullptr) {
+        comment(node->value());
+    }
+    else if (dynamic_cast<const Unknown*>(node) != nullptr && _format == Format::XML) {
+        beforeChild(false);
+        _out.append("<!");
+        appendXML(node->value(), XML_ESCAPE_ALL);
+        _out.push_back('>');
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Append strings in UTF-8 with escaping.
+//----------------------------------------------------------------------------
+
+void ts::xml::StreamWriter::appendUTF8(const UChar* str, size_t size)
+{
+    // Convert directly at the end of the buffer. The maximum number of UTF-8 bytes is 3 times the number of UTF-16 codes.
+    if (size > 0) {
+        const size_t start = _out.size();
+        _out.resize(start + 3 * size);
+        char* out = &_out[start];
+        UString::ConvertUTF16ToUTF8(str, str + size, out, &_out[0] + _out.size());
+        _out.resize(out - _out.data());
+    }
+}
+
+void ts::xml::StreamWriter::appendXML(const UString& str, const UChar* escape)
+{
+    size_t start = 0;
+    for (size_t i = 0; i < str.size(); ++i) {
+        const UChar c = str[i];
+        bool convert = false;
+        for (const UChar* e = escape; !convert && *e != CHAR_NULL; ++e) {
+            convert = *e == c;
+        }
+        if (convert) {
+            // Flush the previous unmodified characters, then the entity.
+            appendUTF8(str.data() + start, i - start);
+            switch (c) {
+                case u'<': _out.append("&lt;"); break;
+                case u'>': _out.append("&gt;"); break;
+                case u'&': _out.append("&amp;"); break;
+                case u'\'': _out.append("&apos;"); break;
+                case u'"': _out.append("&quot;"); break;
+                default: _out.push_back(char(c)); break;
+            }
+            start = i + 1;
+        }
+    }
+    appendUTF8(str.data() + start, str.size() - start);
+}
+
+void ts::xml::StreamWriter::appendJSON(const UString& str)
+{
+    // Same encoding as UString::toJSON(): the result is pure ASCII.
+    static const char hex[] = "0123456789ABCDEF";
+    for (size_t i = 0; i < str.size(); ++i) {
+        const UChar c = str[i];
+        switch (c) {
+            case QUOTATION_MARK: _out.append("\\\""); break;
+            case REVERSE_SOLIDUS: _out.append("\\\\"); break;
+            case BACKSPACE: _out.append("\\b"); break;
+            case FORM_FEED: _out.append("\\f"); break;
+            case LINE_FEED: _out.append("\\n"); break;
+            case CARRIAGE_RETURN: _out.append("\\r"); break;
+            case HORIZONTAL_TABULATION: _out.append("\\t"); break;
+            default:
+                if (c >= 0x0020 && c <= 0x007E) {
+                    _out.push_back(char(c));
+                }
+                else {
+                    _out.append("\\u");
+                    _out.push_back(hex[(c >> 12) & 0x0F]);
+                    _out.push_back(hex[(c >> 8) & 0x0F]);
+                    _out.push_back(hex[(c >> 4) & 0x0F]);
+                    _out.push_back(hex[c & 0x0F]);
+                }
+                break;
+        }
+    }
+}
@@ -0,0 +1,223 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Streaming serializer of XML structures into UTF-8 XML or JSON text.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsxmlTweaks.h"
+#include "tsxmlCompiledModel.h"
+#include "tsUString.h"
+
+namespace ts {
+    namespace xml {
+
+        class Document;
+        class Element;
+        class Node;
+
+        //!
+        //! Streaming serializer of XML structures into UTF-8 XML or JSON text.
+        //! @ingroup xml
+        //!
+        //! This is a SAX-style writer: the structure is described as a sequence of events
+        //! (start of element, attribute, text, end of element) and directly serialized
+        //! as a single line of UTF-8 text into an internal buffer. No intermediate tree
+        //! of nodes is built and no JSON object is created. The buffer is kept allocated
+        //! after reset() so that a writer can be reused for each new object to serialize
+        //! with no memory allocation in steady state.
+        //!
+        //! In XML format, the output is identical to the print of the same structure
+        //! on a one-line TextFormatter (see TextFormatter::EndOfLineMode::SPACING).
+        //!
+        //! In JSON format, the output follows the same conventions as JSONConverter: each
+        //! element is an object with a "#name" field, one field per attribute and a "#nodes"
+        //! array for children elements and texts. Declarations and comments are ignored.
+        //! Without model, all attribute values are strings. When a compiled model is set,
+        //! the attributes which are described as integers or booleans in the model are
+        //! output as JSON numbers or booleans, as JSONConverter does with the same model.
+        //! Unlike JSONConverter, the root element is always included in the output.
+        //!
+        class TSDUCKDLL StreamWriter
+        {
+            TS_NOCOPY(StreamWriter);
+        public:
+            //!
+            //! Output format of the writer.
+            //!
+            enum class Format {
+                XML,   //!< One-line XML text.
+                JSON,  //!< One-line JSON text.
+            };
+
+            //!
+            //! Constructor.
+            //! @param [in] format Output format.
+            //!
+            explicit StreamWriter(Format format = Format::XML);
+
+            //!
+            //! Set the output format.
+            //! Must be set before the first event, the current output is reset.
+            //! @param [in] format Output format.
+            //!
+            void setFormat(Format format);
+
+            //!
+            //! Get the output format.
+            //! @return The output format.
+            //!
+            Format format() const { return _format; }
+
+            //!
+            //! Set the formatting tweaks of the XML output.
+            //! @param [in] tweaks XML tweaks.
+            //!
+            void setTweaks(const Tweaks& tweaks) { _tweaks = tweaks; }
+
+            //!
+            //! Get the formatting tweaks of the XML output.
+            //! @return A constant reference to the XML tweaks.
+            //!
+            const Tweaks& tweaks() const { return _tweaks; }
+
+            //!
+            //! Set the model which is used to type the JSON values of attributes.
+            //! Must be set before the first event.
+            //! @param [in] model Compiled XML model. If null, all attributes are strings.
+            //!
+            void setModel(const CompiledModelPtr& model) { _model = model; }
+
+            //!
+            //! Reset the writer and clear the output.
+            //! The memory of the output buffer is kept for reuse.
+            //!
+            void reset();
+
+            //!
+            //! Get the UTF-8 text which was produced so far.
+            //! @return A constant reference to the internal buffer.
+            //!
+            const std::string& utf8() const { return _out; }
+
+            //!
+            //! Get the text which was produced so far as a string.
+            //! @return The output text.
+            //!
+            UString toString() const { return UString::FromUTF8(_out); }
+
+            //!
+            //! Get the current depth of open elements.
+            //! @return The number of elements which were started and not yet ended.
+            //!
+            size_t depth() const { return _stack.size(); }
+
+            //!
+            //! Output an XML declaration. Ignored in JSON format.
+            //! @param [in] value Content of the declaration, without the surrounding "<?" and "?>".
+            //!
+            void declaration(const UString& value);
+
+            //!
+            //! Output a comment. Ignored in JSON format.
+            //! @param [in] value Content of the comment.
+            //!
+            void comment(const UString& value);
+
+            //!
+            //! Start a new element, inside the current element if any.
+            //! @param [in] name Element name.
+            //!
+            void startElement(const UString& name);
+
+            //!
+            //! Output an attribute of the current element.
+            //! Must be called after startElement() and before any child of the element.
+            //! @param [in] name Attribute name.
+            //! @param [in] value Attribute value.
+            //!
+            void attribute(const UString& name, const UString& value);
+
+            //!
+            //! Output a text node inside the current element.
+            //! @param [in] value Text content.
+            //! @param [in] cdata If true, this is a CDATA section which is output as is.
+            //! @param [in] trimmable If true, leading and trailing spaces are removed and inner spaces are collapsed.
+            //!
+            void text(const UString& value, bool cdata = false, bool trimmable = true);
+
+            //!
+            //! End the current element.
+            //!
+            void endElement();
+
+            //!
+            //! Serialize a complete document.
+            //! In XML format, all top-level nodes are serialized. In JSON format, the root element only is serialized.
+            //! @param [in] doc The document to serialize.
+            //!
+            void write(const Document& doc);
+
+            //!
+            //! Serialize an XML node and all its children.
+            //! @param [in] node The node to serialize.
+            //!
+            void write(const Node* node);
+
+        private:
+            // Description of an open element.
+            struct Level
+            {
+                Level(const UString& n, size_t m);
+                UString name;        // Element name.
+                size_t  model;       // Index of the element in the compiled model, NPOS if none.
+                bool    open_tag;    // The start tag is not yet terminated.
+                bool    children;    // At least one child was output.
+                bool    sticky;      // The last child was sticky (XML only).
+            };
+
+            Format             _format;
+            Tweaks             _tweaks;
+            CompiledModelPtr   _model;
+            std::string        _out;
+            std::vector<Level> _stack;
+
+            // Common processing before a child node of the current element, if any.
+            void beforeChild(bool sticky);
+
+            // Append a string in UTF-8, with XML or JSON escaping of some characters.
+            void appendUTF8(const UString& str) { appendUTF8(str.data(), str.size()); }
+            void appendUTF8(const UChar* str, size_t size);
+            void appendXML(const UString& str, const UChar* escape);
+            void appendJSON(const UString& str);
+        };
+    }
+}
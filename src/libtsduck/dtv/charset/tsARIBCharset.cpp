@@ -117,34 +117,116 @@
 #include "tsARIBCharset.h"
 #include "tsUString.h"
 #include "tsByteBlock.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 
 // Define single instance
 const ts::ARIBCharset ts::ARIBCharset::B24({u"ARIB-STD-B24", u"ARIB"});
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::ARIBCharset::DEFAULT_DECODE_CACHE_SIZE;
+constexpr size_t ts::ARIBCharset::MAX_DECODE_CACHE_BYTES;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------
 
 ts::ARIBCharset::ARIBCharset(std::initializer_list<const UChar*> names) :
-    Charset(names)
+    Charset(names),
+    _cacheMutex(),
+    _cacheMax(DEFAULT_DECODE_CACHE_SIZE),
+    _cacheList(),
+    _cacheIndex()
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Cache of decoded strings.
+//----------------------------------------------------------------------------
+
+uint64_t ts::ARIBCharset::CacheHash(const uint8_t* data, size_t size)
+{
+    uint64_t hash = TS_UCONST64(0xCBF29CE484222325);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= TS_UCONST64(0x00000100000001B3);
+    }
+    return hash;
+}
+
+void ts::ARIBCharset::setDecodeCacheSize(size_t count) const
+{
+    Guard lock(_cacheMutex);
+    _cacheMax = count;
+    trimCache();
+}
+
+size_t ts::ARIBCharset::decodeCacheSize() const
+{
+    Guard lock(_cacheMutex);
+    return _cacheMax;
+}
+
+void ts::ARIBCharset::trimCache() const
+{
+    while (_cacheList.size() > _cacheMax) {
+        // Remove the index entry which points to the last string, then the string.
+        const CachedStringList::iterator last(std::prev(_cacheList.end()));
+        const auto range(_cacheIndex.equal_range(last->hash));
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == last) {
+                _cacheIndex.erase(it);
+                break;
+            }
+        }
+        _cacheList.pop_back();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Decode a string from the specified byte buffer.
 //----------------------------------------------------------------------------
 
 bool ts::ARIBCharset::decode(UString& str, const uint8_t* data, size_t size) const
 {
+    // Look for a recently decoded identical string.
+    const bool cacheable = data != nullptr && size <= MAX_DECODE_CACHE_BYTES;
+    const uint64_t hash = cacheable ? CacheHash(data, size) : 0;
+    if (cacheable) {
+        Guard lock(_cacheMutex);
+        const auto range(_cacheIndex.equal_range(hash));
+        for (auto it = range.first; it != range.second; ++it) {
+            const CachedStringList::iterator entry(it->second);
+            if (entry->data.size() == size && (size == 0 || ::memcmp(entry->data.data(), data, size) == 0)) {
+                // Found, move it at head of the LRU list.
+                _cacheList.splice(_cacheList.begin(), _cacheList, entry);
+                str = entry->str;
+                return entry->success;
+            }
+        }
+    }
+
     // Try to minimize reallocation.
     str.clear();
     str.reserve(size);
 
     // Perform decoding.
     Decoder dec(str, data, size);
+
+    // Keep the decoded string in the cache. If another thread decoded the same string
+    // in the meantime, the duplicate entry is harmless and eventually dropped.
+    if (cacheable) {
+        Guard lock(_cacheMutex);
+        if (_cacheMax > 0) {
+            _cacheList.push_front(CachedString{hash, ByteBlock(data, size), str, dec.success()});
+            _cacheIndex.insert(std::make_pair(hash, _cacheList.begin()));
+            trimCache();
+        }
+    }
     return dec.success();
 }
 
@@ -34,6 +34,8 @@
 
 #pragma once
 #include "tsCharset.h"
+#include "tsByteBlock.h"
+#include "tsMutex.h"
 
 namespace ts {
     //!
@@ -68,10 +70,60 @@ namespace ts {
         virtual bool canEncode(const UString& str, size_t start = 0, size_t count = NPOS) const override;
         virtual size_t encode(uint8_t*& buffer, size_t& size, const UString& str, size_t start = 0, size_t count = NPOS) const override;
 
+        //!
+        //! Default maximum number of strings in the cache of decoded strings.
+        //!
+        static constexpr size_t DEFAULT_DECODE_CACHE_SIZE = 256;
+
+        //!
+        //! Maximum size in bytes of an encoded string which can be stored in the cache of decoded strings.
+        //!
+        static constexpr size_t MAX_DECODE_CACHE_BYTES = 255;
+
+        //!
+        //! Set the maximum number of strings in the cache of decoded strings.
+        //!
+        //! Decoding ARIB STD-B24 strings is expensive (escape sequences, shifts, macros).
+        //! The same strings are frequently decoded again (service names, repeated event titles).
+        //! The most recently decoded strings are consequently kept in a small LRU cache, indexed
+        //! by their binary representation. The cache is shared by all threads.
+        //! @param [in] count Maximum number of strings in the cache. Zero disables the cache.
+        //!
+        void setDecodeCacheSize(size_t count) const;
+
+        //!
+        //! Get the maximum number of strings in the cache of decoded strings.
+        //! @return The maximum number of strings in the cache. Zero means disabled.
+        //!
+        size_t decodeCacheSize() const;
+
     private:
         // Private constructor since only one instance is available.
         ARIBCharset(std::initializer_list<const UChar*> names);
 
+        // An entry in the cache of decoded strings.
+        struct CachedString
+        {
+            uint64_t  hash;     // Hash of the binary representation.
+            ByteBlock data;     // Binary representation.
+            UString   str;      // Decoded string.
+            bool      success;  // Decoding status.
+        };
+        typedef std::list<CachedString> CachedStringList;
+        typedef std::multimap<uint64_t, CachedStringList::iterator> CachedStringIndex;
+
+        // Cache of decoded strings, most recently used first. Logically const, protected by the mutex.
+        mutable Mutex             _cacheMutex;
+        mutable size_t            _cacheMax;
+        mutable CachedStringList  _cacheList;
+        mutable CachedStringIndex _cacheIndex;
+
+        // Compute the hash of a binary representation (64-bit FNV-1a).
+        static uint64_t CacheHash(const uint8_t* data, size_t size);
+
+        // Drop the least recently used strings in excess in the cache. Must be called with mutex held.
+        void trimCache() const;
+
         // The decoding tables are manually crafted from the ARIB STD-24 standard.
         // The encoding tables are generated by a tool named aribb24 (see src/utils/aribb24.cpp).
         // Give it access to the decoding tables.
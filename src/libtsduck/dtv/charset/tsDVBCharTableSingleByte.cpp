@@ -33,6 +33,12 @@
 #include "tsAlgorithm.h"
 TSDUCK_SOURCE;
 
+// SSE2 is always available on x86_64 and used for ASCII fast paths.
+#if defined(TS_X86_64) || defined(__SSE2__)
+    #define TS_DVB_SSE2 1
+    #include <emmintrin.h>
+#endif
+
 // Static instances of corresponding DVB charsets.
 const ts::DVBCharset ts::DVBCharTableSingleByte::DVB_ISO_6937(u"ISO-6937", &RAW_ISO_6937);
 const ts::DVBCharset ts::DVBCharTableSingleByte::DVB_ISO_8859_1(u"ISO-8859-1", &RAW_ISO_8859_1);
@@ -57,36 +63,76 @@ const ts::DVBCharset ts::DVBCharTableSingleByte::DVB_ISO_8859_15(u"ISO-8859-15",
 
 ts::DVBCharTableSingleByte::DVBCharTableSingleByte(const UChar* name, uint32_t tableCode, std::initializer_list<uint16_t> init, std::initializer_list<uint8_t> revDiac) :
     DVBCharTable(name, tableCode),
-    _upperCodePoints(init),
+    _decodeTable(),
+    _combiningDiacritical(),
     _bytesMap(),
     _reversedDiacritical()
 {
     // Check the size of the upper code point table.
-    if (_upperCodePoints.size() != (0x100 - 0xA0)) {
+    if (init.size() != (0x100 - 0xA0)) {
         unregister();
-        throw InvalidCharset(UString::Format(u"%s (%d entries)", {name, _upperCodePoints.size()}));
+        throw InvalidCharset(UString::Format(u"%s (%d entries)", {name, init.size()}));
     }
 
-    // Code point to byte mapping for ASCII range
+    // Decoding table: ASCII range is identity, 0x8A is a new line, 0xA0-0xFF from the initializer list.
+    _decodeTable.fill(0);
     for (size_t i = 0x20; i <= 0x7E; i++) {
-        _bytesMap.insert(std::make_pair(UChar(i), uint8_t(i)));
+        _decodeTable[i] = UChar(i);
+    }
+    _decodeTable[DVB_SINGLE_BYTE_CRLF] = LINE_FEED;
+    size_t index = 0xA0;
+    for (auto it = init.begin(); it != init.end(); ++it) {
+        _decodeTable[index++] = UChar(*it);
     }
 
-    // Control codes
-    _bytesMap.insert(std::make_pair(LINE_FEED, DVB_SINGLE_BYTE_CRLF));
-
-    // Code point to byte mapping for 0xA0-0xFF range
-    for (size_t i = 0; i < _upperCodePoints.size(); i++) {
-        if (_upperCodePoints[i] != 0) {
-            _bytesMap.insert(std::make_pair(UChar(_upperCodePoints[i]), uint8_t(0xA0 + i)));
+    // Code point to byte mapping, from the decoding table.
+    for (size_t i = 0; i < _decodeTable.size(); i++) {
+        if (_decodeTable[i] != 0) {
+            _bytesMap.insert(std::make_pair(_decodeTable[i], uint8_t(i)));
+            _combiningDiacritical.set(i, IsCombiningDiacritical(_decodeTable[i]));
         }
     }
 
     // Combining diacritical marks which precede their base letter (and must be reversed from Unicode).
     for (auto it = revDiac.begin(); it != revDiac.end(); ++it) {
         if (*it >= 0xA0) {
-            _reversedDiacritical.set(*it - 0xA0);
+            _reversedDiacritical.set(*it);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Length of the leading run of ASCII printable characters (0x20-0x7E) in a
+// buffer. These characters are identical in all single-byte tables and are
+// copied as they are into the UTF-16 output. Most DVB strings (service names,
+// event titles in latin scripts) are mainly made of such characters.
+//----------------------------------------------------------------------------
+
+namespace {
+    size_t AsciiRun(const uint8_t* in, size_t size, ts::UChar* out)
+    {
+        size_t count = 0;
+#if defined(TS_DVB_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i low = _mm_set1_epi8(0x1F);
+        const __m128i high = _mm_set1_epi8(0x7F);
+        while (count + 16 <= size) {
+            // Signed comparisons: bytes 0x80-0xFF are negative and fail the first test.
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + count));
+            if (_mm_movemask_epi8(_mm_and_si128(_mm_cmpgt_epi8(a, low), _mm_cmplt_epi8(a, high))) != 0xFFFF) {
+                break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), _mm_unpacklo_epi8(a, zero));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count + 8), _mm_unpackhi_epi8(a, zero));
+            count += 16;
         }
+#endif
+        while (count < size && in[count] >= 0x20 && in[count] <= 0x7E) {
+            out[count] = ts::UChar(in[count]);
+            count++;
+        }
+        return count;
     }
 }
 
@@ -98,45 +144,54 @@ ts::DVBCharTableSingleByte::DVBCharTableSingleByte(const UChar* name, uint32_t t
 bool ts::DVBCharTableSingleByte::decode(UString& str, const uint8_t* dvb, size_t dvbSize) const
 {
     str.clear();
-    str.reserve(dvbSize);
+    if (dvb == nullptr || dvbSize == 0) {
+        return true;
+    }
+
+    // Each byte produces at most one character. Decode directly in the string buffer.
+    str.resize(dvbSize);
+    UChar* const out = &str[0];
+    size_t len = 0;
     bool status = true;
     bool reverseNext = false;  // after decoding next character, it shall be swapped with previous one.
     bool hasDiacritical = false;
 
-    for (; dvb != nullptr && dvbSize > 0; --dvbSize) {
-        // Get next byte
-        const uint8_t b = *dvb++;
-        // Convert it to a code point
-        uint16_t cp = 0;
-        if (b >= 0x20 && b <= 0x7E) {
-            cp = b; // ASCII range = identity
-        }
-        else if (b >= 0xA0) {
-            cp = _upperCodePoints[b - 0xA0];
-        }
-        else if (b == DVB_SINGLE_BYTE_CRLF) {
-            cp = LINE_FEED;
+    for (size_t i = 0; i < dvbSize; ) {
+        // Fast path for runs of ASCII characters, when there is no pending reversed diacritical mark.
+        if (!reverseNext) {
+            const size_t count = AsciiRun(dvb + i, dvbSize - i, out + len);
+            i += count;
+            len += count;
+            if (i >= dvbSize) {
+                break;
+            }
         }
+        // Get next byte and convert it to a code point.
+        const uint8_t b = dvb[i++];
+        const UChar cp = _decodeTable[b];
         // Add in result if no error.
         if (cp == 0) {
             // Untranslatable character.
             status = false;
         }
-        else if (reverseNext && !str.empty()) {
+        else if (reverseNext && len > 0) {
             // Insert decoded character before the previous one.
             // This is typically a letter coming after a reversable diacritical mark.
             // In Unicode, the letter must preceed the diacritical mark.
-            str.insert(str.length() - 1, 1, UChar(cp));
+            out[len] = out[len - 1];
+            out[len - 1] = cp;
+            len++;
         }
         else {
             // Simply add the decoded character.
-            str.push_back(UChar(cp));
+            out[len++] = cp;
         }
         // Try the presence of diacritical, reversable or not.
-        hasDiacritical = hasDiacritical || IsCombiningDiacritical(UChar(cp));
+        hasDiacritical = hasDiacritical || _combiningDiacritical.test(b);
         // Shall we perform mark/letter swap next time?
-        reverseNext = b >= 0xA0 && _reversedDiacritical.test(b - 0xA0);
+        reverseNext = _reversedDiacritical.test(b);
     }
+    str.resize(len);
 
     // If some diacritical mark was found, try to combine them.
     if (hasDiacritical) {
@@ -183,7 +238,7 @@ size_t ts::DVBCharTableSingleByte::encode(uint8_t*& buffer, size_t& size, const
             size--;
             result++;
             // Reverse letter and diacritical mark when necessary.
-            if (buffer > base && *buffer >= 0xA0 && _reversedDiacritical.test(*buffer - 0xA0)) {
+            if (buffer > base && _reversedDiacritical.test(*buffer)) {
                 // Reverse order of letter/mark into mark/letter.
                 std::swap(buffer[-1], buffer[0]);
             }
@@ -105,15 +105,19 @@ namespace ts {
         //!
         DVBCharTableSingleByte(const UChar* name, uint32_t tableCode, std::initializer_list<uint16_t> init, std::initializer_list<uint8_t> revDiac = std::initializer_list<uint8_t>());
 
-        // List of code points for byte values 0xA0-0xFF. Always contain 96 values.
-        const std::vector<uint16_t> _upperCodePoints;
+        // Flat decoding table for all 256 byte values, precomputed in the constructor.
+        // A zero value means untranslatable byte.
+        std::array<UChar, 256> _decodeTable;
+
+        // Bitmap of byte values which decode into a combining diacritical mark.
+        std::bitset<256> _combiningDiacritical;
 
         // Reverse mapping for complete character set (key = code point, value = byte rep).
         std::map<UChar, uint8_t> _bytesMap;
 
         // Bitmap of combining diacritical marks which precede their base letter (and must be reversed from Unicode).
-        // This only applies to byte values 0xA0-0xFF (96 values).
-        std::bitset<96> _reversedDiacritical;
+        // Indexed by byte value, only set in range 0xA0-0xFF.
+        std::bitset<256> _reversedDiacritical;
     };
 }
 
@@ -53,11 +53,12 @@ ts::DVBCharTableUTF16::DVBCharTableUTF16(const UChar* name) :
 bool ts::DVBCharTableUTF16::decode(UString& str, const uint8_t* dvb, size_t dvbSize) const
 {
     // We simply copy 2 bytes per character.
-    str.clear();
-    str.reserve(dvbSize / 2);
-    for (size_t i = 0; dvb != nullptr && i + 1 < dvbSize; i += 2) {
-        const uint16_t cp = GetUInt16(dvb + i);
-        str.push_back(cp == DVB_CODEPOINT_CRLF ? ts::LINE_FEED : UChar(cp));
+    // The string is sized once and filled in place.
+    const size_t len = dvb == nullptr ? 0 : dvbSize / 2;
+    str.resize(len);
+    for (size_t i = 0; i < len; ++i) {
+        const uint16_t cp = GetUInt16(dvb + 2 * i);
+        str[i] = cp == DVB_CODEPOINT_CRLF ? ts::LINE_FEED : UChar(cp);
     }
 
     // Truncated string if odd number of bytes.
@@ -30,7 +30,7 @@
 #include "tsChannelFile.h"
 #include "tsModulation.h"
 #include "tsLegacyBandWidth.h"
-#include "tsxmlModelDocument.h"
+#include "tsxmlCompiledModel.h"
 #include "tsxmlElement.h"
 #include "tsSysUtils.h"
 TSDUCK_SOURCE;
@@ -408,15 +408,15 @@ bool ts::ChannelFile::parse(const UString& text, Report& report)
 
 bool ts::ChannelFile::parseDocument(const xml::Document& doc)
 {
-    // Load the XML model for TSDuck files. Search it in TSDuck directory.
-    xml::ModelDocument model(doc.report());
-    if (!model.load(u"tsduck.channels.model.xml", true)) {
+    // Get the compiled XML model for TSDuck files, loaded once per process. Search it in TSDuck directory.
+    const xml::CompiledModelPtr model(xml::CompiledModel::Cached(u"tsduck.channels.model.xml", doc.report()));
+    if (model.isNull()) {
         doc.report().error(u"Model for TSDuck channels XML files not found");
         return false;
     }
 
     // Validate the input document according to the model.
-    if (!model.validate(doc)) {
+    if (!model->validate(doc)) {
         return false;
     }
 
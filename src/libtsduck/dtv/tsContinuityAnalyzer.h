@@ -93,6 +93,27 @@ namespace ts {
         //!
         bool feedPacket(TSPacket& pkt) { return feedPacketInternal(&pkt, true); }
 
+        //!
+        //! Process a contiguous span of constant TS packets.
+        //! Can be used only to report discontinuity errors.
+        //! This is equivalent to calling feedPacket() on each packet, in sequence, but faster.
+        //! @param [in] pkt Address of the first transport stream packet.
+        //! @param [in] count Number of consecutive packets to process.
+        //! @return True if all packets have no discontinuity error. False if at least one packet has an error.
+        //!
+        bool feedPackets(const TSPacket* pkt, size_t count) { return feedPacketsInternal(const_cast<TSPacket*>(pkt), count, false); }
+
+        //!
+        //! Process or modify a contiguous span of TS packets.
+        //! This is equivalent to calling feedPacket() on each packet, in sequence, but faster.
+        //! @param [in,out] pkt Address of the first transport stream packet.
+        //! The packets can be modified only when error fixing or generator mode is activated.
+        //! @param [in] count Number of consecutive packets to process.
+        //! @return True if all packets had no discontinuity error and are unmodified.
+        //! False if at least one packet had an error or was modified.
+        //!
+        bool feedPackets(TSPacket* pkt, size_t count) { return feedPacketsInternal(pkt, count, true); }
+
         //!
         //! Get the total number of TS packets.
         //! @return The total number of TS packets.
@@ -246,32 +267,47 @@ namespace ts {
         {
         public:
             PIDState();            // Constructor
+            PID      pid;          // PID value (index in _pid_index).
             uint8_t  first_cc;     // First CC value in a PID.
             uint8_t  last_cc_out;  // Last output CC value in a PID.
             size_t   dup_count;    // Consecutive duplicate count.
             TSPacket last_pkt_in;  // Last input packet (before modification, if any).
         };
 
-        // A map of PID state, indexed by PID.
-        typedef std::map<PID,PIDState> PIDStateMap;
+        // The PID states are stored in a flat vector. A PID-indexed table
+        // contains the index of the state of each PID in the vector.
+        typedef std::vector<PIDState> PIDStateVector;
+        typedef std::array<uint16_t, PID_MAX> PIDIndexArray;
+        static constexpr uint16_t NO_STATE = 0xFFFF;
 
         // Private members.
-        Report*       _report;            // Where to report errors, never null.
-        int           _severity;          // Severity level for error messages.
-        bool          _display_errors;    // Display discontinuity errors.
-        bool          _fix_errors;        // Fix discontinuity errors.
-        bool          _generator;         // Use generator mode.
-        UString       _prefix;            // Message prefix.
-        PacketCounter _total_packets;     // Total number of packets.
-        PacketCounter _processed_packets; // Number of processed packets.
-        PacketCounter _fix_count;         // Number of fixed (modified) packets.
-        PacketCounter _error_count;       // Number of discontinuity errors.
-        PIDSet        _pid_filter;        // Current set of filtered PID's.
-        PIDStateMap   _pid_states;        // State of all PID's.
-
-        // Internal version of feedPacket.
-        // The packet is modified only is update is true.
+        Report*        _report;            // Where to report errors, never null.
+        int            _severity;          // Severity level for error messages.
+        bool           _display_errors;    // Display discontinuity errors.
+        bool           _fix_errors;        // Fix discontinuity errors.
+        bool           _generator;         // Use generator mode.
+        UString        _prefix;            // Message prefix.
+        PacketCounter  _total_packets;     // Total number of packets.
+        PacketCounter  _processed_packets; // Number of processed packets.
+        PacketCounter  _fix_count;         // Number of fixed (modified) packets.
+        PacketCounter  _error_count;       // Number of discontinuity errors.
+        PIDSet         _pid_filter;        // Current set of filtered PID's.
+        PIDStateVector _pid_states;        // State of all PID's.
+        PIDIndexArray  _pid_index;         // Index of each PID in _pid_states, NO_STATE if none.
+
+        // Internal version of feedPacket and feedPackets.
+        // The packets are modified only is update is true.
         bool feedPacketInternal(TSPacket* pkt, bool update);
+        bool feedPacketsInternal(TSPacket* pkt, size_t count, bool update);
+
+        // Access the state of a PID. Return null if there is none.
+        const PIDState* findState(PID pid) const;
+
+        // Get or create the state of a PID.
+        PIDState& getState(PID pid);
+
+        // Remove the state of a PID.
+        void eraseState(PID pid);
 
         // Build the first part of an error message.
         UString linePrefix(PID pid) const;
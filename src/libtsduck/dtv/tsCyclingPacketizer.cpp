@@ -191,8 +191,9 @@ void ts::CyclingPacketizer::addSection(const SectionPtr& sect, MilliSecond rep_r
 
 void ts::CyclingPacketizer::removeSections(TID tid)
 {
-    removeSections(_sched_sections, tid, 0, false, true);
-    removeSections(_other_sections, tid, 0, false, false);
+    const auto match = [tid](const Section& sect) { return sect.tableId() == tid; };
+    removeSections(_sched_sections, true, match);
+    removeSections(_other_sections, false, match);
 }
 
 
@@ -202,22 +203,45 @@ void ts::CyclingPacketizer::removeSections(TID tid)
 
 void ts::CyclingPacketizer::removeSections(TID tid, uint16_t tid_ext)
 {
-    removeSections(_sched_sections, tid, tid_ext, true, true);
-    removeSections(_other_sections, tid, tid_ext, true, false);
+    const auto match = [tid, tid_ext](const Section& sect) { return sect.tableId() == tid && sect.tableIdExtension() == tid_ext; };
+    removeSections(_sched_sections, true, match);
+    removeSections(_other_sections, false, match);
 }
 
 
 //----------------------------------------------------------------------------
-// Remove all sections with the specified tid/tid_ext in the specified list.
+// Remove some specific sections, identified by their smart pointers.
 //----------------------------------------------------------------------------
 
-void ts::CyclingPacketizer::removeSections(SectionDescList& list, TID tid, uint16_t tid_ext, bool use_tid_ext, bool scheduled)
+void ts::CyclingPacketizer::removeSections(const SectionPtrVector& sections)
+{
+    if (!sections.empty()) {
+        // Sorted addresses of the sections to remove, for fast lookup.
+        std::vector<const Section*> addresses;
+        addresses.reserve(sections.size());
+        for (const auto& sp : sections) {
+            addresses.push_back(sp.pointer());
+        }
+        std::sort(addresses.begin(), addresses.end());
+        const auto match = [&addresses](const Section& sect) { return std::binary_search(addresses.begin(), addresses.end(), &sect); };
+        removeSections(_sched_sections, true, match);
+        removeSections(_other_sections, false, match);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Remove all sections matching a predicate in the specified list.
+//----------------------------------------------------------------------------
+
+template <class PREDICATE>
+void ts::CyclingPacketizer::removeSections(SectionDescList& list, bool scheduled, PREDICATE match)
 {
     SectionDescList::iterator it(list.begin());
     while (it != list.end()) {
         const SectionDescPtr& sp(*it);
         const Section& sect(*sp->section);
-        if (sect.tableId() == tid && (!use_tid_ext || sect.tableIdExtension() == tid_ext)) {
+        if (match(sect)) {
             // Section match, remove it
             assert(_section_count > 0);
             _section_count--;
@@ -186,6 +186,16 @@ namespace ts {
         //!
         void removeSections(TID tid, uint16_t tid_ext);
 
+        //!
+        //! Remove some specific sections from the packetizer.
+        //! The sections are identified by their smart pointers, as previously added in the packetizer,
+        //! not by their content. This is typically used to update only the modified sections of a
+        //! large set of sections, while the unmodified ones keep their position in the cycle.
+        //! If one such section is currently being packetized, the rest of the section will be packetized.
+        //! @param [in] sections The sections to remove.
+        //!
+        void removeSections(const SectionPtrVector& sections);
+
         //!
         //! Remove all sections in the packetizer.
         //! If a section is currently being packetized, the rest of the section will be packetized.
@@ -257,8 +267,9 @@ namespace ts {
         // Insert a scheduled section in the list, sorted by due_packet.
         void addScheduledSection(const SectionDescPtr&);
 
-        // Remove all sections with the specified tid/tid_ext in the specified list.
-        void removeSections(SectionDescList&, TID, uint16_t tid_ext, bool use_tid_ext, bool scheduled);
+        // Remove all sections matching a predicate on SectionDesc in the specified list.
+        template <class PREDICATE>
+        void removeSections(SectionDescList&, bool scheduled, PREDICATE match);
 
         // Inherited from SectionProviderInterface
         virtual void provideSection(SectionCounter, SectionPtr&) override;
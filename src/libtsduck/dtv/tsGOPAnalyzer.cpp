@@ -0,0 +1,446 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsGOPAnalyzer.h"
+#include "tsAVC.h"
+#include "tsHEVC.h"
+#include "tsVVC.h"
+#include "tsAccessUnitIterator.h"
+#include "tsAVCAccessUnitDelimiter.h"
+#include "tsHEVCAccessUnitDelimiter.h"
+#include "tsVVCAccessUnitDelimiter.h"
+#include "tsAVCParser.h"
+#include "tsMemory.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::GOPAnalyzer::RAP_INTERVAL_BINS;
+constexpr size_t ts::GOPAnalyzer::MAX_GOP_STRUCTURE;
+constexpr size_t ts::GOPAnalyzer::HEVC_MAX_PPS;
+constexpr uint8_t ts::GOPAnalyzer::HEVC_UNKNOWN_PPS;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::GOPAnalyzer::GOPAnalyzer() :
+    _pids()
+{
+}
+
+ts::GOPAnalyzer::Statistics::Statistics() :
+    codec(CodecType::UNDEFINED),
+    i_frames(0),
+    p_frames(0),
+    b_frames(0),
+    other_frames(0),
+    gop_count(0),
+    gop_frames(0),
+    gop_min(0),
+    gop_max(0),
+    gop_structure(),
+    i_size_min(0),
+    i_size_max(0),
+    i_size_total(0)
+{
+    TS_ZERO(rap_intervals);
+}
+
+ts::GOPAnalyzer::PIDContext::PIDContext() :
+    stats(),
+    stream_type(ST_NULL),
+    frame_open(false),
+    frame_slices(false),
+    in_gop(false),
+    frame_type(FrameType::OTHER),
+    frame_size(0),
+    frame_pts(INVALID_PTS),
+    last_rap_pts(INVALID_PTS),
+    gop_length(0),
+    gop_structure(),
+    hevc_extra_bits()
+{
+    hevc_extra_bits.fill(HEVC_UNKNOWN_PPS);
+}
+
+
+//----------------------------------------------------------------------------
+// Reset all analysis contexts.
+//----------------------------------------------------------------------------
+
+void ts::GOPAnalyzer::reset()
+{
+    _pids.clear();
+}
+
+void ts::GOPAnalyzer::setStreamType(PID pid, uint8_t stream_type)
+{
+    if (StreamTypeIsVideo(stream_type)) {
+        _pids[pid].stream_type = stream_type;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Access to the statistics.
+//----------------------------------------------------------------------------
+
+void ts::GOPAnalyzer::getPIDs(std::vector<PID>& pids) const
+{
+    pids.clear();
+    for (auto it = _pids.begin(); it != _pids.end(); ++it) {
+        if (it->second.stats.frames() > 0) {
+            pids.push_back(it->first);
+        }
+    }
+}
+
+const ts::GOPAnalyzer::Statistics* ts::GOPAnalyzer::statistics(PID pid) const
+{
+    const auto it = _pids.find(pid);
+    return it == _pids.end() ? nullptr : &it->second.stats;
+}
+
+
+//----------------------------------------------------------------------------
+// Check if a TS packet starts a PES packet with an intra-coded image.
+//----------------------------------------------------------------------------
+
+bool ts::GOPAnalyzer::isIntraImageStart(const TSPacket& pkt) const
+{
+    // Only known video PID's are checked.
+    if (!pkt.getPUSI() || !pkt.hasPayload()) {
+        return false;
+    }
+    const auto it = _pids.find(pkt.getPID());
+    return it != _pids.end() && PESPacket::FindIntraImage(pkt.getPayload(), pkt.getPayloadSize(), it->second.stream_type, it->second.stats.codec) != NPOS;
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze a PES packet.
+//----------------------------------------------------------------------------
+
+void ts::GOPAnalyzer::feedPES(const PESPacket& pes)
+{
+    const PID pid = pes.getSourcePID();
+    const uint8_t* const pl_data = pes.payload();
+    const size_t pl_size = pes.payloadSize();
+
+    // Do not create a PID context for non-video PES packets.
+    auto it = _pids.find(pid);
+    const uint8_t stream_type = pes.getStreamType() != ST_NULL ? pes.getStreamType() : (it == _pids.end() ? uint8_t(ST_NULL) : it->second.stream_type);
+    const CodecType default_codec = pes.getCodec() != CodecType::UNDEFINED ? pes.getCodec() : (it == _pids.end() ? CodecType::UNDEFINED : it->second.stats.codec);
+    AccessUnitIterator au_iter(pl_data, pl_size, stream_type, default_codec);
+    const bool mpeg2 = !au_iter.isValid() && (pes.isMPEG2Video() || PESPacket::IsMPEG2Video(pes.content(), pes.size(), stream_type));
+    if (!au_iter.isValid() && !mpeg2) {
+        return;
+    }
+    if (it == _pids.end()) {
+        it = _pids.insert(std::make_pair(pid, PIDContext())).first;
+    }
+    PIDContext& pc(it->second);
+    if (stream_type != ST_NULL) {
+        pc.stream_type = stream_type;
+    }
+    pc.stats.codec = mpeg2 ? CodecType::MPEG2_VIDEO : au_iter.videoFormat();
+
+    // The PTS of the PES packet applies to the first frame which starts in the PES packet.
+    uint64_t pts = pes.getPTS();
+
+    // Offset in payload of the first byte which is not yet accounted in a frame.
+    size_t accounted = 0;
+
+    if (mpeg2) {
+        // Locate all MPEG-1/2 start codes. The beginning of the payload is already a start code prefix.
+        for (size_t offset = 0; offset + 3 < pl_size; ) {
+            const uint8_t* pnext = LocateZeroZero(pl_data + offset + 1, pl_size - offset - 1, 0x01, 0x01);
+            const size_t next = pnext == nullptr ? pl_size : pnext - pl_data;
+            const uint8_t code = pl_data[offset + 3];
+            // A sequence header or a GOP header starts a new frame, the next picture belongs to it.
+            if (code == 0xB3 || code == 0xB8 || code == 0x00) {
+                if (!pc.frame_open || pc.frame_slices) {
+                    pc.frame_size += offset - accounted;
+                    accounted = offset;
+                    startFrame(pc, FrameType::OTHER, pts);
+                    pts = INVALID_PTS;
+                }
+                if (code == 0x00 && offset + 5 < next) {
+                    // Picture header: picture_coding_type is 3 bits after the 10-bit temporal_reference.
+                    const uint8_t coding_type = (pl_data[offset + 5] >> 3) & 0x07;
+                    mergeFrameType(pc, coding_type == 1 ? FrameType::I : (coding_type == 2 ? FrameType::P : (coding_type == 3 ? FrameType::B : FrameType::OTHER)));
+                    pc.frame_slices = true;
+                }
+            }
+            offset = next;
+        }
+    }
+    else {
+        // Loop on all AVC/HEVC/VVC access units.
+        const CodecType codec = au_iter.videoFormat();
+        for (; !au_iter.atEnd(); au_iter.next()) {
+            const size_t offset = au_iter.currentAccessUnitOffset();
+            // The start code prefix and the leading zero bytes belong to the access unit.
+            size_t start = offset >= 3 ? offset - 3 : 0;
+            while (start > accounted && pl_data[start - 1] == 0x00) {
+                start--;
+            }
+            FrameType type = FrameType::OTHER;
+            bool slice = false;
+            if (analyzeAccessUnit(pc, codec, au_iter.currentAccessUnit(), au_iter.currentAccessUnitSize(), au_iter.currentAccessUnitType(), type, slice)) {
+                pc.frame_size += start - std::min(start, accounted);
+                accounted = std::max(start, accounted);
+                startFrame(pc, type, pts);
+                pts = INVALID_PTS;
+            }
+            else if (type != FrameType::OTHER) {
+                mergeFrameType(pc, type);
+            }
+            pc.frame_slices = pc.frame_slices || slice;
+        }
+    }
+
+    // The rest of the PES payload, including the truncated part, belongs to the last frame.
+    if (pc.frame_open) {
+        pc.frame_size += pl_size - accounted + (pes.fullSize() - pes.size());
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Analyze one AVC/HEVC/VVC access unit.
+//----------------------------------------------------------------------------
+
+bool ts::GOPAnalyzer::analyzeAccessUnit(PIDContext& pc, CodecType codec, const uint8_t* data, size_t size, uint8_t type, FrameType& frame_type, bool& slice)
+{
+    frame_type = FrameType::OTHER;
+    slice = false;
+
+    if (codec == CodecType::AVC) {
+        if (type == AVC_AUT_DELIMITER) {
+            const AVCAccessUnitDelimiter aud(data, size);
+            if (aud.valid && (aud.primary_pic_type == AVC_PIC_TYPE_I || aud.primary_pic_type == AVC_PIC_TYPE_SI || aud.primary_pic_type == AVC_PIC_TYPE_I_SI)) {
+                frame_type = FrameType::I;
+            }
+            return true;
+        }
+        else if ((type == AVC_AUT_NON_IDR || type == AVC_AUT_SLICE_A || type == AVC_AUT_IDR) && size > 1) {
+            // Slice header: first_mb_in_slice, slice_type (H.264, 7.3.3).
+            AVCParser parser(data + 1, size - 1);
+            uint32_t first_mb = 0;
+            uint32_t slice_type = 0;
+            if (parser.ue(first_mb) && parser.ue(slice_type)) {
+                slice = true;
+                frame_type = type == AVC_AUT_IDR ? FrameType::I : AVCSliceType(slice_type);
+                // Without access unit delimiter, the first slice of a picture starts a new frame.
+                return first_mb == 0 && (!pc.frame_open || pc.frame_slices);
+            }
+        }
+    }
+    else if (codec == CodecType::HEVC) {
+        if (type == HEVC_AUT_AUD_NUT) {
+            const HEVCAccessUnitDelimiter aud(data, size);
+            if (aud.valid && aud.pic_type == HEVC_PIC_TYPE_I) {
+                frame_type = FrameType::I;
+            }
+            return true;
+        }
+        else if (type == HEVC_AUT_PPS_NUT && size > 2) {
+            // Picture parameter set (H.265, 7.3.2.3.1): keep the number of extra bits in the slice headers.
+            AVCParser parser(data + 2, size - 2);
+            uint32_t pps_id = 0;
+            uint32_t sps_id = 0;
+            uint8_t flags = 0;
+            uint8_t extra_bits = 0;
+            if (parser.ue(pps_id) && parser.ue(sps_id) && parser.u(flags, 2) && parser.u(extra_bits, 3) && pps_id < HEVC_MAX_PPS) {
+                pc.hevc_extra_bits[pps_id] = extra_bits;
+            }
+        }
+        else if (type <= HEVC_AUT_RSV_VCL31 && size > 2) {
+            // Slice segment header (H.265, 7.3.6.1). Only the first slice of a picture is analyzed.
+            slice = true;
+            const bool irap = type >= HEVC_AUT_BLA_W_LP && type <= HEVC_AUT_RSV_IRAP_VCL23;
+            AVCParser parser(data + 2, size - 2);
+            uint8_t first_slice = 0;
+            uint32_t pps_id = 0;
+            uint32_t slice_type = 0;
+            if (parser.u(first_slice, 1) && first_slice != 0) {
+                if (irap) {
+                    frame_type = FrameType::I;
+                }
+                else if (parser.ue(pps_id) && pps_id < HEVC_MAX_PPS && pc.hevc_extra_bits[pps_id] != HEVC_UNKNOWN_PPS) {
+                    // In the first slice of a non-IRAP picture, slice_type follows the extra bits from the PPS.
+                    // With an unknown PPS, the frame type remains OTHER, unless set by an access unit delimiter.
+                    uint32_t extra = 0;
+                    if (parser.u(extra, pc.hevc_extra_bits[pps_id]) && parser.ue(slice_type)) {
+                        frame_type = HEVCSliceType(slice_type);
+                    }
+                }
+                return !pc.frame_open || pc.frame_slices;
+            }
+        }
+    }
+    else if (codec == CodecType::VVC) {
+        if (type == VVC_AUT_AUD_NUT) {
+            const VVCAccessUnitDelimiter aud(data, size);
+            if (aud.valid && aud.aud_pic_type == VVC_PIC_TYPE_I) {
+                frame_type = FrameType::I;
+            }
+            return true;
+        }
+        else if (type == VVC_AUT_IDR_W_RADL || type == VVC_AUT_IDR_N_LP || type == VVC_AUT_CRA_NUT) {
+            slice = true;
+            frame_type = FrameType::I;
+        }
+    }
+    return false;
+}
+
+
+//----------------------------------------------------------------------------
+// Frame type from the slice type in AVC or HEVC slice headers.
+//----------------------------------------------------------------------------
+
+ts::GOPAnalyzer::FrameType ts::GOPAnalyzer::AVCSliceType(uint32_t slice_type)
+{
+    // H.264, table 7-6: 0=P, 1=B, 2=I, 3=SP, 4=SI, 5-9 same as 0-4.
+    switch (slice_type % 5) {
+        case 0:
+        case 3:
+            return FrameType::P;
+        case 1:
+            return FrameType::B;
+        default:
+            return FrameType::I;
+    }
+}
+
+ts::GOPAnalyzer::FrameType ts::GOPAnalyzer::HEVCSliceType(uint32_t slice_type)
+{
+    // H.265, table 7-7: 0=B, 1=P, 2=I.
+    switch (slice_type) {
+        case 0:
+            return FrameType::B;
+        case 1:
+            return FrameType::P;
+        case 2:
+            return FrameType::I;
+        default:
+            return FrameType::OTHER;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Frame management.
+//----------------------------------------------------------------------------
+
+void ts::GOPAnalyzer::startFrame(PIDContext& pc, FrameType type, uint64_t pts)
+{
+    closeFrame(pc);
+    pc.frame_open = true;
+    pc.frame_slices = false;
+    pc.frame_type = type;
+    pc.frame_size = 0;
+    pc.frame_pts = pts;
+}
+
+void ts::GOPAnalyzer::mergeFrameType(PIDContext& pc, FrameType type)
+{
+    // A frame is typed after its "least intra" slice: I < P < B.
+    if (pc.frame_open && type != FrameType::OTHER && (pc.frame_type == FrameType::OTHER || int(type) > int(pc.frame_type))) {
+        pc.frame_type = type;
+    }
+}
+
+void ts::GOPAnalyzer::closeFrame(PIDContext& pc)
+{
+    if (!pc.frame_open) {
+        return;
+    }
+    pc.frame_open = false;
+    Statistics& st(pc.stats);
+
+    UChar code = u'?';
+    if (pc.frame_type == FrameType::I) {
+        code = u'I';
+        st.i_frames++;
+    }
+    else if (pc.frame_type == FrameType::P) {
+        code = u'P';
+        st.p_frames++;
+    }
+    else if (pc.frame_type == FrameType::B) {
+        code = u'B';
+        st.b_frames++;
+    }
+    else {
+        st.other_frames++;
+    }
+
+    if (pc.frame_type == FrameType::I) {
+        // I-frame sizes.
+        st.i_size_min = st.i_frames == 1 ? pc.frame_size : std::min(st.i_size_min, pc.frame_size);
+        st.i_size_max = std::max(st.i_size_max, pc.frame_size);
+        st.i_size_total += pc.frame_size;
+
+        // An I-frame terminates the previous GOP and starts a new one.
+        if (pc.in_gop) {
+            st.gop_min = st.gop_count == 0 ? pc.gop_length : std::min(st.gop_min, pc.gop_length);
+            st.gop_max = std::max(st.gop_max, pc.gop_length);
+            st.gop_count++;
+            st.gop_frames += pc.gop_length;
+            st.gop_structure = pc.gop_structure;
+        }
+        pc.in_gop = true;
+        pc.gop_length = 0;
+        pc.gop_structure.clear();
+
+        // Interval between random access points, when both have a PTS.
+        if (pc.frame_pts != INVALID_PTS && pc.last_rap_pts != INVALID_PTS) {
+            const uint64_t ms = (DiffPTS(pc.last_rap_pts, pc.frame_pts) * 1000) / SYSTEM_CLOCK_SUBFREQ;
+            size_t bin = 0;
+            while (bin + 1 < RAP_INTERVAL_BINS && (ms >> (bin + 1)) != 0) {
+                bin++;
+            }
+            st.rap_intervals[bin]++;
+        }
+        pc.last_rap_pts = pc.frame_pts;
+    }
+
+    // Build the structure of the current GOP.
+    if (pc.in_gop) {
+        pc.gop_length++;
+        if (pc.gop_structure.size() < MAX_GOP_STRUCTURE) {
+            pc.gop_structure.push_back(code);
+        }
+    }
+}
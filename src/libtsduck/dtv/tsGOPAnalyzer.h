@@ -0,0 +1,222 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Streaming analysis of the GOP structure of video PID's.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsPESPacket.h"
+#include "tsTSPacket.h"
+#include "tsCodecType.h"
+#include "tsUString.h"
+
+namespace ts {
+    //!
+    //! Streaming analysis of the GOP structure of video PID's.
+    //! @ingroup mpeg
+    //!
+    //! This class is fed with complete (or truncated) PES packets from video PID's.
+    //! It locates the start of all pictures using AccessUnitIterator for AVC, HEVC and
+    //! VVC and using start codes for MPEG-1/2 video. It maintains, per PID, the number
+    //! of frames per type, the length and structure of the GOP's, the sizes of the
+    //! I-frames and a histogram of the intervals between random access points.
+    //!
+    //! The statistics are updated incrementally and the memory usage per PID is bounded.
+    //! Here, a random access point is the start of an I-frame and a GOP is the sequence
+    //! of frames between two I-frames.
+    //!
+    //! Limitations: The frame type of AVC and HEVC pictures comes from the access unit
+    //! delimiter or the header of the first slice. For HEVC, the slice header of a non-IRAP
+    //! picture can be parsed only after its PPS was found in the stream; before that, the
+    //! frame type comes from the access unit delimiter only, OTHER if there is none. For
+    //! VVC, only the access unit delimiters and the IRAP slices are used, other frames are
+    //! reported as OTHER.
+    //!
+    class TSDUCKDLL GOPAnalyzer
+    {
+        TS_NOCOPY(GOPAnalyzer);
+    public:
+        //!
+        //! Number of bins in the histogram of intervals between random access points.
+        //! Bin @e n contains the intervals in the range 2^n to 2^(n+1)-1 milliseconds.
+        //! Bin 0 also contains null intervals. The last bin contains all larger intervals.
+        //!
+        static constexpr size_t RAP_INTERVAL_BINS = 16;
+
+        //!
+        //! Maximum number of frames in the description of the structure of a GOP.
+        //!
+        static constexpr size_t MAX_GOP_STRUCTURE = 64;
+
+        //!
+        //! Type of video frame.
+        //!
+        enum class FrameType {
+            I,      //!< Intra-coded frame.
+            P,      //!< Predicted frame.
+            B,      //!< Bidirectional frame.
+            OTHER,  //!< Other or undetermined frame type.
+        };
+
+        //!
+        //! GOP statistics of one video PID.
+        //!
+        class TSDUCKDLL Statistics
+        {
+        public:
+            Statistics();                   //!< Constructor.
+            CodecType codec;                //!< Video codec.
+            uint64_t  i_frames;             //!< Number of I-frames.
+            uint64_t  p_frames;             //!< Number of P-frames.
+            uint64_t  b_frames;             //!< Number of B-frames.
+            uint64_t  other_frames;         //!< Number of other frames.
+            uint64_t  gop_count;            //!< Number of complete GOP's.
+            uint64_t  gop_frames;           //!< Total number of frames in complete GOP's.
+            size_t    gop_min;              //!< Minimum GOP length in frames.
+            size_t    gop_max;              //!< Maximum GOP length in frames.
+            UString   gop_structure;        //!< Structure of the last complete GOP (e.g. "IBBPBBP"), truncated to MAX_GOP_STRUCTURE frames.
+            uint64_t  i_size_min;           //!< Minimum I-frame size in bytes.
+            uint64_t  i_size_max;           //!< Maximum I-frame size in bytes.
+            uint64_t  i_size_total;         //!< Total size of all I-frames in bytes.
+            uint64_t  rap_intervals[RAP_INTERVAL_BINS];  //!< Histogram of intervals between random access points.
+
+            //!
+            //! Get the total number of frames.
+            //! @return The total number of frames.
+            //!
+            uint64_t frames() const { return i_frames + p_frames + b_frames + other_frames; }
+
+            //!
+            //! Get the average GOP length in frames.
+            //! @return The average GOP length in frames, zero if no GOP was complete.
+            //!
+            uint64_t gopAverage() const { return gop_count == 0 ? 0 : (gop_frames + gop_count / 2) / gop_count; }
+
+            //!
+            //! Get the average I-frame size in bytes.
+            //! @return The average I-frame size in bytes, zero if there is no I-frame.
+            //!
+            uint64_t iSizeAverage() const { return i_frames == 0 ? 0 : (i_size_total + i_frames / 2) / i_frames; }
+        };
+
+        //!
+        //! Constructor.
+        //!
+        GOPAnalyzer();
+
+        //!
+        //! Reset all analysis contexts.
+        //!
+        void reset();
+
+        //!
+        //! Declare the stream type of a PID, as found in a PMT.
+        //! This is required only when the first PES packets do not have a recognizable format.
+        //! @param [in] pid The PID.
+        //! @param [in] stream_type Stream type of the PID.
+        //!
+        void setStreamType(PID pid, uint8_t stream_type);
+
+        //!
+        //! Analyze a PES packet.
+        //! Nothing is done if the PES packet does not contain video.
+        //! @param [in] pes A PES packet, possibly truncated.
+        //!
+        void feedPES(const PESPacket& pes);
+
+        //!
+        //! Check if a TS packet contains the start of a PES packet with an intra-coded image.
+        //! Only the TS packet is checked, it must contain the PES header and the start of
+        //! the intra-coded image.
+        //! @param [in] pkt A TS packet.
+        //! @return True if @a pkt starts a PES packet with an intra-coded image.
+        //!
+        bool isIntraImageStart(const TSPacket& pkt) const;
+
+        //!
+        //! Get the list of PID's with statistics.
+        //! @param [out] pids The returned list of PID's with at least one frame.
+        //!
+        void getPIDs(std::vector<PID>& pids) const;
+
+        //!
+        //! Get the statistics of a PID.
+        //! @param [in] pid The PID.
+        //! @return A pointer to the statistics of @a pid or the null pointer if the PID is unknown.
+        //! The pointer remains valid until the next call to reset() or feedPES().
+        //!
+        const Statistics* statistics(PID pid) const;
+
+    private:
+        // Maximum number of HEVC PPS and marker of unknown PPS.
+        static constexpr size_t HEVC_MAX_PPS = 64;
+        static constexpr uint8_t HEVC_UNKNOWN_PPS = 0xFF;
+
+        // Analysis context of one PID.
+        class PIDContext
+        {
+        public:
+            PIDContext();
+            Statistics stats;          // Public statistics.
+            uint8_t    stream_type;    // Stream type from PMT or PES packets.
+            bool       frame_open;     // A frame is in progress.
+            bool       frame_slices;   // The frame in progress has received slices.
+            bool       in_gop;         // A GOP is in progress (an I-frame was found).
+            FrameType  frame_type;     // Type of frame in progress.
+            uint64_t   frame_size;     // Size of frame in progress.
+            uint64_t   frame_pts;      // PTS of frame in progress, if any.
+            uint64_t   last_rap_pts;   // PTS of the previous random access point.
+            size_t     gop_length;     // Number of frames in GOP in progress.
+            UString    gop_structure;  // Structure of GOP in progress.
+            std::array<uint8_t, HEVC_MAX_PPS> hevc_extra_bits;  // HEVC num_extra_slice_header_bits per PPS id, HEVC_UNKNOWN_PPS if unknown.
+        };
+
+        std::map<PID, PIDContext> _pids;
+
+        // Start a new frame, close the previous one.
+        void startFrame(PIDContext& pc, FrameType type, uint64_t pts);
+
+        // Update the type of the frame in progress with the type of a new slice.
+        static void mergeFrameType(PIDContext& pc, FrameType type);
+
+        // Close the frame in progress, update the statistics.
+        void closeFrame(PIDContext& pc);
+
+        // Analyze one AVC/HEVC/VVC access unit. Return true if it starts a frame.
+        // Also return the frame type it indicates (OTHER if none) and if it is a slice.
+        // Also collect the HEVC PPS information which is needed to parse the slice headers.
+        static bool analyzeAccessUnit(PIDContext& pc, CodecType codec, const uint8_t* data, size_t size, uint8_t type, FrameType& frame_type, bool& slice);
+
+        // Frame type from the slice type in an AVC or HEVC slice header.
+        static FrameType AVCSliceType(uint32_t slice_type);
+        static FrameType HEVCSliceType(uint32_t slice_type);
+    };
+}
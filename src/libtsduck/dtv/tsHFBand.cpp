@@ -30,7 +30,7 @@
 #include "tsHFBand.h"
 #include "tsDuckConfigFile.h"
 #include "tsGuard.h"
-#include "tsxmlModelDocument.h"
+#include "tsxmlCompiledModel.h"
 #include "tsxmlElement.h"
 #include "tsAlgorithm.h"
 TSDUCK_SOURCE;
@@ -502,15 +502,15 @@ bool ts::HFBand::HFBandRepository::load(Report& report)
         return false;
     }
 
-    // Load the XML model. Search it in TSDuck directory.
-    xml::ModelDocument model(report);
-    if (!model.load(u"tsduck.hfbands.model.xml", true)) {
+    // Get the compiled XML model, loaded once per process. Search it in TSDuck directory.
+    const xml::CompiledModelPtr model(xml::CompiledModel::Cached(u"tsduck.hfbands.model.xml", report));
+    if (model.isNull()) {
         report.error(u"Model for TSDuck HF Band XML files not found");
         return false;
     }
 
     // Validate the input document according to the model.
-    if (!model.validate(doc)) {
+    if (!model->validate(doc)) {
         return false;
     }
 
@@ -28,7 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsKeyTable.h"
-#include "tsxmlModelDocument.h"
+#include "tsxmlCompiledModel.h"
 #include "tsxmlElement.h"
 #include "tsAlgorithm.h"
 TSDUCK_SOURCE;
@@ -154,15 +154,15 @@ bool ts::KeyTable::loadFile(Report& report, const UString& filename, bool replac
 
 bool ts::KeyTable::parseXML(xml::Document& doc, bool replace, size_t id_size, size_t value_size)
 {
-    // Load the XML model. Search it in TSDuck directory.
-    xml::ModelDocument model(doc.report());
-    if (!model.load(u"tsduck.keytable.model.xml", true)) {
+    // Get the compiled XML model, loaded once per process. Search it in TSDuck directory.
+    const xml::CompiledModelPtr model(xml::CompiledModel::Cached(u"tsduck.keytable.model.xml", doc.report()));
+    if (model.isNull()) {
         doc.report().error(u"Model for TSDuck key table XML files not found");
         return false;
     }
 
     // Validate the input document according to the model.
-    if (!model.validate(doc)) {
+    if (!model->validate(doc)) {
         return false;
     }
 
@@ -30,7 +30,7 @@
 #include "tsLNB.h"
 #include "tsGuard.h"
 #include "tsAlgorithm.h"
-#include "tsxmlModelDocument.h"
+#include "tsxmlCompiledModel.h"
 #include "tsxmlElement.h"
 #include "tsDuckConfigFile.h"
 TSDUCK_SOURCE;
@@ -371,15 +371,15 @@ bool ts::LNB::LNBRepository::load(Report& report)
         return false;
     }
 
-    // Load the XML model. Search it in TSDuck directory.
-    xml::ModelDocument model(report);
-    if (!model.load(u"tsduck.lnbs.model.xml", true)) {
+    // Get the compiled XML model, loaded once per process. Search it in TSDuck directory.
+    const xml::CompiledModelPtr model(xml::CompiledModel::Cached(u"tsduck.lnbs.model.xml", report));
+    if (model.isNull()) {
         report.error(u"Model for TSDuck LNB XML files not found");
         return false;
     }
 
     // Validate the input document according to the model.
-    if (!model.validate(doc)) {
+    if (!model->validate(doc)) {
         return false;
     }
 
@@ -47,7 +47,8 @@ ts::MPEDemux::MPEDemux(DuckContext& duck, MPEHandlerInterface* mpe_handler, cons
     _ts_id(0),
     _pmts(),
     _new_pids(),
-    _int_tags()
+    _int_tags(),
+    _mpe()
 {
     immediateReset();
 }
@@ -132,13 +133,14 @@ void ts::MPEDemux::handleSection(SectionDemux& demux, const Section& section)
     if (section.tableId() == TID_DSMCC_PD && _pid_filter.test(section.sourcePID())) {
 
         // Build the corresponding MPE packet.
-        MPEPacket mpe(section);
-        if (mpe.isValid() && _handler != nullptr) {
+        // The datagram buffer of the previous packet is reused if the application did not keep it.
+        _mpe.copy(section);
+        if (_mpe.isValid() && _handler != nullptr) {
 
             // Send the MPE packet to the application.
             beforeCallingHandler(section.sourcePID());
             try {
-                _handler->handleMPEPacket(*this, mpe);
+                _handler->handleMPEPacket(*this, _mpe);
             }
             catch (...) {
                 afterCallingHandler(false);
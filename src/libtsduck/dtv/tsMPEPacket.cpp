@@ -220,6 +220,9 @@ ts::MPEPacket& ts::MPEPacket::copy(const MPEPacket& other)
 
 ts::MPEPacket& ts::MPEPacket::copy(const Section& section)
 {
+    // Keep the previous datagram buffer for reuse if it is not shared with another packet.
+    ByteBlockPtr buffer(_datagram.count() == 1 ? _datagram : ByteBlockPtr());
+
     // Clear previous content.
     clear();
 
@@ -246,7 +249,14 @@ ts::MPEPacket& ts::MPEPacket::copy(const Section& section)
 
     // Get the datagram from the rest of the section.
     // Do not include trailing 4 bytes (checksum or CRC32).
-    _datagram = new ByteBlock(data + 12, size - 16);
+    if (buffer.isNull()) {
+        buffer = new ByteBlock(data + 12, size - 16);
+        CheckNonNull(buffer.pointer());
+    }
+    else {
+        buffer->copy(data + 12, size - 16);
+    }
+    _datagram = buffer;
 
     // Check that the datagram contains a UDP/IP packet.
     _is_valid = true;
@@ -35,6 +35,10 @@
 #include "tsPSIRepository.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr ts::Names::SectionHandle ts::Names::NO_SECTION;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Configuration instances.
@@ -57,7 +61,7 @@ ts::UString ts::names::TID(const DuckContext& duck, uint8_t tid, uint16_t cas, F
 {
     // Where to search table ids.
     const Names* const repo = NamesMain::Instance();
-    const UString section(u"TableId");
+    static const Names::SectionHandle section = repo->section(u"TableId");
 
     // Check without standard, then with all known standards in TSDuck context.
     // In all cases, use version with CAS first, then without CAS.
@@ -112,11 +116,19 @@ ts::UString ts::names::TID(const DuckContext& duck, uint8_t tid, uint16_t cas, F
 // Descriptor ids: specific processing for table-specific descriptors.
 //----------------------------------------------------------------------------
 
+namespace {
+    ts::Names::SectionHandle DescriptorIdSection()
+    {
+        static const ts::Names::SectionHandle section = ts::NamesMain::Instance()->section(u"DescriptorId");
+        return section;
+    }
+}
+
 bool ts::names::HasTableSpecificName(uint8_t did, uint8_t tid)
 {
     return tid != TID_NULL &&
         did < 0x80 &&
-        NamesMain::Instance()->nameExists(u"DescriptorId", (Names::Value(tid) << 40) | TS_UCONST64(0x000000FFFFFFFF00) | Names::Value(did));
+        NamesMain::Instance()->nameExists(DescriptorIdSection(), (Names::Value(tid) << 40) | TS_UCONST64(0x000000FFFFFFFF00) | Names::Value(did));
 }
 
 ts::UString ts::names::DID(uint8_t did, uint32_t pds, uint8_t tid, Flags flags)
@@ -124,15 +136,15 @@ ts::UString ts::names::DID(uint8_t did, uint32_t pds, uint8_t tid, Flags flags)
     if (did >= 0x80 && pds != 0 && pds != PDS_NULL) {
         // If this is a private descriptor, only consider the private value.
         // Do not fallback because the same value with PDS == 0 can be different.
-        return NamesMain::Instance()->nameFromSection(u"DescriptorId", (Names::Value(pds) << 8) | Names::Value(did), flags, 8);
+        return NamesMain::Instance()->nameFromSection(DescriptorIdSection(), (Names::Value(pds) << 8) | Names::Value(did), flags, 8);
     }
     else if (tid != 0xFF) {
         // Could be a table-specific descriptor.
         const Names::Value fullValue = (Names::Value(tid) << 40) | TS_UCONST64(0x000000FFFFFFFF00) | Names::Value(did);
-        return NamesMain::Instance()->nameFromSectionWithFallback(u"DescriptorId", fullValue, Names::Value(did), flags, 8);
+        return NamesMain::Instance()->nameFromSectionWithFallback(DescriptorIdSection(), fullValue, Names::Value(did), flags, 8);
     }
     else {
-        return NamesMain::Instance()->nameFromSection(u"DescriptorId", Names::Value(did), flags, 8);
+        return NamesMain::Instance()->nameFromSection(DescriptorIdSection(), Names::Value(did), flags, 8);
     }
 }
 
@@ -142,93 +154,112 @@ ts::UString ts::names::DID(uint8_t did, uint32_t pds, uint8_t tid, Flags flags)
 
 ts::UString ts::names::EDID(uint8_t edid, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"DVBExtendedDescriptorId", Names::Value(edid), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"DVBExtendedDescriptorId");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(edid), flags, 8);
 }
 
 ts::UString ts::names::StreamType(uint8_t type, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"StreamType", Names::Value(type), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"StreamType");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(type), flags, 8);
 }
 
 ts::UString ts::names::PrivateDataSpecifier(uint32_t pds, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"PrivateDataSpecifier", Names::Value(pds), flags, 32);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"PrivateDataSpecifier");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(pds), flags, 32);
 }
 
 ts::UString ts::names::CASFamily(ts::CASFamily cas)
 {
-    return NamesMain::Instance()->nameFromSection(u"CASFamily", Names::Value(cas), NAME | DECIMAL);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"CASFamily");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(cas), NAME | DECIMAL);
 }
 
 ts::UString ts::names::CASId(const DuckContext& duck, uint16_t id, Flags flags)
 {
-    const UChar* section = (duck.standards() & Standards::ISDB) == Standards::ISDB ? u"ARIBCASystemId" : u"CASystemId";
+    static const Names::SectionHandle dvb = NamesMain::Instance()->section(u"CASystemId");
+    static const Names::SectionHandle arib = NamesMain::Instance()->section(u"ARIBCASystemId");
+    const Names::SectionHandle section = (duck.standards() & Standards::ISDB) == Standards::ISDB ? arib : dvb;
     return NamesMain::Instance()->nameFromSection(section, Names::Value(id), flags, 16);
 }
 
 ts::UString ts::names::BouquetId(uint16_t id, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"BouquetId", Names::Value(id), flags, 16);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"BouquetId");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(id), flags, 16);
 }
 
 ts::UString ts::names::OriginalNetworkId(uint16_t id, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"OriginalNetworkId", Names::Value(id), flags, 16);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"OriginalNetworkId");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(id), flags, 16);
 }
 
 ts::UString ts::names::NetworkId(uint16_t id, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"NetworkId", Names::Value(id), flags, 16);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"NetworkId");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(id), flags, 16);
 }
 
 ts::UString ts::names::PlatformId(uint32_t id, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"PlatformId", Names::Value(id), flags, 24);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"PlatformId");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(id), flags, 24);
 }
 
 ts::UString ts::names::DataBroadcastId(uint16_t id, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"DataBroadcastId", Names::Value(id), flags, 16);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"DataBroadcastId");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(id), flags, 16);
 }
 
 ts::UString ts::names::OUI(uint32_t oui, Flags flags)
 {
-    return NamesOUI::Instance()->nameFromSection(u"OUI", Names::Value(oui), flags, 24);
+    static const Names::SectionHandle section = NamesOUI::Instance()->section(u"OUI");
+    return NamesOUI::Instance()->nameFromSection(section, Names::Value(oui), flags, 24);
 }
 
 ts::UString ts::names::StreamId(uint8_t sid, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"StreamId", Names::Value(sid), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"StreamId");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(sid), flags, 8);
 }
 
 ts::UString ts::names::PESStartCode(uint8_t code, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"PESStartCode", Names::Value(code), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"PESStartCode");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(code), flags, 8);
 }
 
 ts::UString ts::names::AspectRatio(uint8_t ar, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"AspectRatio", Names::Value(ar), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"AspectRatio");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(ar), flags, 8);
 }
 
 ts::UString ts::names::ChromaFormat(uint8_t cf, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"ChromaFormat", Names::Value(cf), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"ChromaFormat");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(cf), flags, 8);
 }
 
 ts::UString ts::names::AccessUnitType(CodecType codec, uint8_t type, Flags flags)
 {
-    const UChar* table = nullptr;
+    static const Names::SectionHandle avc = NamesMain::Instance()->section(u"AVCUnitType");
+    static const Names::SectionHandle hevc = NamesMain::Instance()->section(u"HEVCUnitType");
+    static const Names::SectionHandle vvc = NamesMain::Instance()->section(u"VVCUnitType");
+    Names::SectionHandle table = Names::NO_SECTION;
     if (codec == CodecType::AVC) {
-        table = u"AVCUnitType";
+        table = avc;
     }
     else if (codec == CodecType::HEVC) {
-        table = u"HEVCUnitType";
+        table = hevc;
     }
     else if (codec == CodecType::VVC) {
-        table = u"VVCUnitType";
+        table = vvc;
     }
-    if (table != nullptr) {
+    if (table != Names::NO_SECTION) {
         return NamesMain::Instance()->nameFromSection(table, Names::Value(type), flags, 8);
     }
     else {
@@ -238,67 +269,80 @@ ts::UString ts::names::AccessUnitType(CodecType codec, uint8_t type, Flags flags
 
 ts::UString ts::names::AVCProfile(int profile, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"AVCProfile", Names::Value(profile), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"AVCProfile");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(profile), flags, 8);
 }
 
 ts::UString ts::names::ServiceType(uint8_t type, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"ServiceType", Names::Value(type), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"ServiceType");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(type), flags, 8);
 }
 
 ts::UString ts::names::LinkageType(uint8_t type, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"LinkageType", Names::Value(type), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"LinkageType");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(type), flags, 8);
 }
 
 ts::UString ts::names::TeletextType(uint8_t type, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"TeletextType", Names::Value(type), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"TeletextType");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(type), flags, 8);
 }
 
 ts::UString ts::names::RunningStatus(uint8_t status, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"RunningStatus", Names::Value(status), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"RunningStatus");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(status), flags, 8);
 }
 
 ts::UString ts::names::AudioType(uint8_t type, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"AudioType", Names::Value(type), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"AudioType");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(type), flags, 8);
 }
 
 ts::UString ts::names::SubtitlingType(uint8_t type, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"SubtitlingType", Names::Value(type), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"SubtitlingType");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(type), flags, 8);
 }
 
 ts::UString ts::names::DTSSampleRateCode(uint8_t x, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"DTSSampleRate", Names::Value(x), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"DTSSampleRate");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(x), flags, 8);
 }
 
 ts::UString ts::names::DTSBitRateCode(uint8_t x, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"DTSBitRate", Names::Value(x), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"DTSBitRate");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(x), flags, 8);
 }
 
 ts::UString ts::names::DTSSurroundMode(uint8_t x, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"DTSSurroundMode", Names::Value(x), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"DTSSurroundMode");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(x), flags, 8);
 }
 
 ts::UString ts::names::DTSExtendedSurroundMode(uint8_t x, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"DTSExtendedSurroundMode", Names::Value(x), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"DTSExtendedSurroundMode");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(x), flags, 8);
 }
 
 ts::UString ts::names::ScramblingControl(uint8_t scv, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"ScramblingControl", Names::Value(scv), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"ScramblingControl");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(scv), flags, 8);
 }
 
 ts::UString ts::names::T2MIPacketType(uint8_t type, Flags flags)
 {
-    return NamesMain::Instance()->nameFromSection(u"T2MIPacketType", Names::Value(type), flags, 8);
+    static const Names::SectionHandle section = NamesMain::Instance()->section(u"T2MIPacketType");
+    return NamesMain::Instance()->nameFromSection(section, Names::Value(type), flags, 8);
 }
 
 
@@ -333,9 +377,12 @@ ts::UString ts::names::ComponentType(const DuckContext& duck, uint16_t type, Fla
     // Value to display:
     const uint16_t dType = sc >= 1 && sc <= 8 ? (type & 0x0FFF) : type;
 
+    static const Names::SectionHandle dvb = NamesMain::Instance()->section(u"ComponentType");
+    static const Names::SectionHandle japan = NamesMain::Instance()->section(u"ComponentTypeJapan");
+
     if ((duck.standards() & Standards::JAPAN) == Standards::JAPAN) {
         // Japan / ISDB uses a completely different mapping.
-        return NamesMain::Instance()->nameFromSection(u"ComponentTypeJapan", Names::Value(nType), flags | names::ALTERNATE, 16, dType);
+        return NamesMain::Instance()->nameFromSection(japan, Names::Value(nType), flags | names::ALTERNATE, 16, dType);
     }
     else if ((nType & 0xFF00) == 0x3F00) {
         return SubtitlingType(nType & 0x00FF, flags);
@@ -344,7 +391,7 @@ ts::UString ts::names::ComponentType(const DuckContext& duck, uint16_t type, Fla
         return AC3ComponentType(nType & 0x00FF, flags);
     }
     else {
-        return NamesMain::Instance()->nameFromSection(u"ComponentType", Names::Value(nType), flags | names::ALTERNATE, 16, dType);
+        return NamesMain::Instance()->nameFromSection(dvb, Names::Value(nType), flags | names::ALTERNATE, 16, dType);
     }
 }
 
@@ -355,17 +402,21 @@ ts::UString ts::names::ComponentType(const DuckContext& duck, uint16_t type, Fla
 
 ts::UString ts::names::Content(const DuckContext& duck, uint8_t x, Flags flags)
 {
+    static const Names::SectionHandle dvb = NamesMain::Instance()->section(u"ContentId");
+    static const Names::SectionHandle japan = NamesMain::Instance()->section(u"ContentIdJapan");
+    static const Names::SectionHandle abnt = NamesMain::Instance()->section(u"ContentIdABNT");
+
     if ((duck.standards() & Standards::JAPAN) == Standards::JAPAN) {
         // Japan / ISDB uses a completely different mapping.
-        return NamesMain::Instance()->nameFromSection(u"ContentIdJapan", Names::Value(x), flags, 8);
+        return NamesMain::Instance()->nameFromSection(japan, Names::Value(x), flags, 8);
     }
     else if ((duck.standards() & Standards::ABNT) == Standards::ABNT) {
         // ABNT (Brazil) / ISDB uses a completely different mapping.
-        return NamesMain::Instance()->nameFromSection(u"ContentIdABNT", Names::Value(x), flags, 8);
+        return NamesMain::Instance()->nameFromSection(abnt, Names::Value(x), flags, 8);
     }
     else {
         // Standard DVB mapping.
-        return NamesMain::Instance()->nameFromSection(u"ContentId", Names::Value(x), flags, 8);
+        return NamesMain::Instance()->nameFromSection(dvb, Names::Value(x), flags, 8);
     }
 }
 
@@ -416,6 +467,7 @@ ts::Names::Names(const UString& fileName, bool mergeExtensions) :
     _log(CERR),
     _configFile(SearchConfigurationFile(fileName)),
     _configErrors(0),
+    _sectionNames(),
     _sections()
 {
     // Locate the configuration file.
@@ -442,6 +494,11 @@ ts::Names::Names(const UString& fileName, bool mergeExtensions) :
             }
         }
     }
+
+    // Compile all sections into compact sorted vectors for faster lookup.
+    for (auto& sec : _sections) {
+        sec.compile();
+    }
 }
 
 
@@ -477,15 +534,15 @@ void ts::Names::loadFile(const UString& fileName)
             line.convertToLower();
 
             // Get or create associated section.
-            ConfigSectionMap::iterator it = _sections.find(line);
-            if (it != _sections.end()) {
-                section = it->second;
+            ConfigSectionMap::iterator it = _sectionNames.find(line);
+            if (it != _sectionNames.end()) {
+                section = &_sections[it->second];
             }
             else {
                 // Create new section.
-                section = new ConfigSection;
-                CheckNonNull(section);
-                _sections.insert(std::make_pair(line, section));
+                _sectionNames.insert(std::make_pair(line, _sections.size()));
+                _sections.push_back(ConfigSection());
+                section = &_sections.back();
             }
         }
         else if (!decodeDefinition(line, section)) {
@@ -563,11 +620,6 @@ bool ts::Names::decodeDefinition(const UString& line, ConfigSection* section)
 
 ts::Names::~Names()
 {
-    // Deallocate all configuration sections.
-    for (ConfigSectionMap::iterator it = _sections.begin(); it != _sections.end(); ++it) {
-        delete it->second;
-    }
-    _sections.clear();
 }
 
 
@@ -575,7 +627,8 @@ ts::Names::~Names()
 // Configuration entry.
 //----------------------------------------------------------------------------
 
-ts::Names::ConfigEntry::ConfigEntry(Value l, const UString& n) :
+ts::Names::ConfigEntry::ConfigEntry(Value f, Value l, const UString& n) :
+    first(f),
     last(l),
     name(n)
 {
@@ -588,19 +641,11 @@ ts::Names::ConfigEntry::ConfigEntry(Value l, const UString& n) :
 
 ts::Names::ConfigSection::ConfigSection() :
     bits(0),
-    entries()
+    entries(),
+    ranges()
 {
 }
 
-ts::Names::ConfigSection::~ConfigSection()
-{
-    // Deallocate all configuration entries.
-    for (ConfigEntryMap::iterator it = entries.begin(); it != entries.end(); ++it) {
-        delete it->second;
-    }
-    entries.clear();
-}
-
 
 //----------------------------------------------------------------------------
 // Check if a range is free, ie no value is defined in the range.
@@ -617,7 +662,7 @@ bool ts::Names::ConfigSection::freeRange(Value first, Value last) const
         return false;
     }
 
-    if (it != entries.begin() && (--it)->second->last >= first) {
+    if (it != entries.begin() && (--it)->second.last >= first) {
         // The previous range ends inside [first..last].
         assert(it->first < first);
         return false;
@@ -634,37 +679,40 @@ bool ts::Names::ConfigSection::freeRange(Value first, Value last) const
 
 void ts::Names::ConfigSection::addEntry(Value first, Value last, const UString& name)
 {
-    ConfigEntry* entry = new ConfigEntry(last, name);
-    CheckNonNull(entry);
-    entries.insert(std::make_pair(first, entry));
+    entries.insert(std::make_pair(first, ConfigEntry(first, last, name)));
 }
 
 
 //----------------------------------------------------------------------------
-// Get a name from a value, empty if not found.
+// Move all entries from the map into the vector of ranges.
 //----------------------------------------------------------------------------
 
-ts::UString ts::Names::ConfigSection::getName(Value val) const
+void ts::Names::ConfigSection::compile()
 {
-    // Eliminate trivial cases which would cause issues with code below.
-    if (entries.empty()) {
-        return UString();
+    // The map is sorted by first value, the vector is built in the same order.
+    ranges.clear();
+    ranges.reserve(entries.size());
+    for (auto& it : entries) {
+        ranges.push_back(it.second);
     }
+    entries.clear();
+}
 
-    // The key in the 'entries' map is the _first_ value of a range.
-    // Get an iterator pointing to the first element that is "not less" than 'val'.
-    ConfigEntryMap::const_iterator it = entries.lower_bound(val);
 
-    if (it == entries.end() || (it != entries.begin() && it->first != val)) {
-        // There is no entry with a value range starting at 'val'.
-        // Maybe 'val' is in the range of the previous entry.
-        --it;
-    }
-
-    assert(it != entries.end());
-    assert(it->second != nullptr);
+//----------------------------------------------------------------------------
+// Get a name from a value, null if not found or empty.
+//----------------------------------------------------------------------------
 
-    return val >= it->first && val <= it->second->last ? it->second->name : UString();
+const ts::UString* ts::Names::ConfigSection::getName(Value val) const
+{
+    // Find the first range which starts after 'val'. Since ranges do not overlap,
+    // 'val' can only be in the range which precedes it.
+    const auto it = std::upper_bound(ranges.begin(), ranges.end(), val, [](Value v, const ConfigEntry& e) { return v < e.first; });
+    if (it == ranges.begin()) {
+        return nullptr;
+    }
+    const ConfigEntry& entry(*(it - 1));
+    return val <= entry.last && !entry.name.empty() ? &entry.name : nullptr;
 }
 
 
@@ -762,15 +810,25 @@ ts::UString ts::Names::Formatted(Value value, const UString& name, names::Flags
 }
 
 
+//----------------------------------------------------------------------------
+// Get a precomputed handle to a section.
+//----------------------------------------------------------------------------
+
+ts::Names::SectionHandle ts::Names::section(const UString& sectionName) const
+{
+    // Normalize the section name.
+    const ConfigSectionMap::const_iterator it = _sectionNames.find(sectionName.toTrimmed().toLower());
+    return it == _sectionNames.end() ? NO_SECTION : it->second;
+}
+
+
 //----------------------------------------------------------------------------
 // Check if a name exists in a specified section.
 //----------------------------------------------------------------------------
 
-bool ts::Names::nameExists(const UString& sectionName, Value value) const
+bool ts::Names::nameExists(SectionHandle section, Value value) const
 {
-    // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    return it != _sections.end() && !it->second->getName(value).empty();
+    return section < _sections.size() && _sections[section].getName(value) != nullptr;
 }
 
 
@@ -778,18 +836,16 @@ bool ts::Names::nameExists(const UString& sectionName, Value value) const
 // Get a name from a specified section.
 //----------------------------------------------------------------------------
 
-ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value, names::Flags flags, size_t bits, Value alternateValue) const
+ts::UString ts::Names::nameFromSection(SectionHandle section, Value value, names::Flags flags, size_t bits, Value alternateValue) const
 {
-    // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? nullptr : it->second;
-
-    if (section == nullptr) {
+    if (section >= _sections.size()) {
         // Non-existent section, no name.
         return Formatted(value, UString(), flags, bits, alternateValue);
     }
     else {
-        return Formatted(value, section->getName(value), flags, bits != 0 ? bits : section->bits, alternateValue);
+        const ConfigSection& sec(_sections[section]);
+        const UString* name = sec.getName(value);
+        return Formatted(value, name == nullptr ? UString() : *name, flags, bits != 0 ? bits : sec.bits, alternateValue);
     }
 }
 
@@ -798,25 +854,23 @@ ts::UString ts::Names::nameFromSection(const UString& sectionName, Value value,
 // Get a name from a specified section, with alternate fallback value.
 //----------------------------------------------------------------------------
 
-ts::UString ts::Names::nameFromSectionWithFallback(const UString& sectionName, Value value1, Value value2, names::Flags flags, size_t bits, Value alternateValue) const
+ts::UString ts::Names::nameFromSectionWithFallback(SectionHandle section, Value value1, Value value2, names::Flags flags, size_t bits, Value alternateValue) const
 {
-    // Get the section, normalize the section name.
-    ConfigSectionMap::const_iterator it = _sections.find(sectionName.toTrimmed().toLower());
-    const ConfigSection* section = it == _sections.end() ? nullptr : it->second;
-
-    if (section == nullptr) {
+    if (section >= _sections.size()) {
         // Non-existent section, no name.
         return Formatted(value1, UString(), flags, bits, alternateValue);
     }
     else {
-        const UString name(section->getName(value1));
-        if (!name.empty()) {
+        const ConfigSection& sec(_sections[section]);
+        const UString* name = sec.getName(value1);
+        if (name != nullptr) {
             // value1 has a name
-            return Formatted(value1, name, flags, bits != 0 ? bits : section->bits, alternateValue);
+            return Formatted(value1, *name, flags, bits != 0 ? bits : sec.bits, alternateValue);
         }
         else {
             // value1 has no name, use value2.
-            return Formatted(value2, section->getName(value2), flags, bits != 0 ? bits : section->bits, alternateValue);
+            name = sec.getName(value2);
+            return Formatted(value2, name == nullptr ? UString() : *name, flags, bits != 0 ? bits : sec.bits, alternateValue);
         }
     }
 }
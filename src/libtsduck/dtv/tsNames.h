@@ -387,6 +387,19 @@ namespace ts {
         //!
         typedef uint64_t Value;
 
+        //!
+        //! Precomputed handle to a section of names.
+        //! Using a handle avoids the normalization and lookup of the section name on each call.
+        //! A handle is an index in the list of sections, in the order of the configuration files.
+        //! It remains valid as long as the same configuration files are loaded.
+        //!
+        typedef size_t SectionHandle;
+
+        //!
+        //! Invalid section handle, for non-existent sections.
+        //!
+        static constexpr SectionHandle NO_SECTION = std::numeric_limits<SectionHandle>::max();
+
         //!
         //! Get the complete path of the configuration file from which the names were loaded.
         //! @return The complete path of the configuration file. Empty if does not exist.
@@ -411,7 +424,25 @@ namespace ts {
         //! @param [in] value Value to get the name for.
         //! @return True if a name exists for @a value in @a sectionName.
         //!
-        bool nameExists(const UString& sectionName, Value value) const;
+        bool nameExists(const UString& sectionName, Value value) const
+        {
+            return nameExists(section(sectionName), value);
+        }
+
+        //!
+        //! Get a precomputed handle to a section.
+        //! @param [in] sectionName Name of section to search. Not case-sensitive.
+        //! @return The section handle or NO_SECTION if the section does not exist.
+        //!
+        SectionHandle section(const UString& sectionName) const;
+
+        //!
+        //! Check if a name exists in a specified section.
+        //! @param [in] section Handle of section to search.
+        //! @param [in] value Value to get the name for.
+        //! @return True if a name exists for @a value in @a section.
+        //!
+        bool nameExists(SectionHandle section, Value value) const;
 
         //!
         //! Get a name from a specified section.
@@ -422,7 +453,21 @@ namespace ts {
         //! @param [in] alternateValue Display this integer value if flags ALTERNATE is set.
         //! @return The corresponding name.
         //!
-        UString nameFromSection(const UString& sectionName, Value value, names::Flags flags = names::NAME, size_t bits = 0, Value alternateValue = 0) const;
+        UString nameFromSection(const UString& sectionName, Value value, names::Flags flags = names::NAME, size_t bits = 0, Value alternateValue = 0) const
+        {
+            return nameFromSection(section(sectionName), value, flags, bits, alternateValue);
+        }
+
+        //!
+        //! Get a name from a specified section.
+        //! @param [in] section Handle of section to search.
+        //! @param [in] value Value to get the name for.
+        //! @param [in] flags Presentation flags.
+        //! @param [in] bits Nominal size in bits of the data, optional.
+        //! @param [in] alternateValue Display this integer value if flags ALTERNATE is set.
+        //! @return The corresponding name.
+        //!
+        UString nameFromSection(SectionHandle section, Value value, names::Flags flags = names::NAME, size_t bits = 0, Value alternateValue = 0) const;
 
         //!
         //! Get a name from a specified section, with alternate fallback value.
@@ -434,7 +479,22 @@ namespace ts {
         //! @param [in] alternateValue Display this integer value if flags ALTERNATE is set.
         //! @return The corresponding name.
         //!
-        UString nameFromSectionWithFallback(const UString& sectionName, Value value1, Value value2, names::Flags flags = names::NAME, size_t bits = 0, Value alternateValue = 0) const;
+        UString nameFromSectionWithFallback(const UString& sectionName, Value value1, Value value2, names::Flags flags = names::NAME, size_t bits = 0, Value alternateValue = 0) const
+        {
+            return nameFromSectionWithFallback(section(sectionName), value1, value2, flags, bits, alternateValue);
+        }
+
+        //!
+        //! Get a name from a specified section, with alternate fallback value.
+        //! @param [in] section Handle of section to search.
+        //! @param [in] value1 Value to get the name for.
+        //! @param [in] value2 Alternate value if no name is found for @a value1.
+        //! @param [in] flags Presentation flags.
+        //! @param [in] bits Nominal size in bits of the data, optional.
+        //! @param [in] alternateValue Display this integer value if flags ALTERNATE is set.
+        //! @return The corresponding name.
+        //!
+        UString nameFromSectionWithFallback(SectionHandle section, Value value1, Value value2, names::Flags flags = names::NAME, size_t bits = 0, Value alternateValue = 0) const;
 
         //!
         //! Format a name using flags.
@@ -448,30 +508,31 @@ namespace ts {
         static UString Formatted(Value value, const UString& name, names::Flags flags, size_t bits, Value alternateValue = 0);
 
     private:
-        // Description of a configuration entry.
-        // The first value of the range is the key in a map.
+        // Description of a configuration entry, a range of values.
         class ConfigEntry
         {
         public:
+            Value   first;  // First value in the range.
             Value   last;   // Last value in the range.
             UString name;   // Associated name.
 
-            ConfigEntry(Value l = 0, const UString& n = UString());
+            ConfigEntry(Value f = 0, Value l = 0, const UString& n = UString());
         };
 
-        // Map of configuration entries, indexed by first value of the range.
-        typedef std::map<Value, ConfigEntry*> ConfigEntryMap;
+        // Map of configuration entries, indexed by first value of the range, used during loading only.
+        typedef std::map<Value, ConfigEntry> ConfigEntryMap;
 
         // Description of a configuration section.
-        // The name of the section is the key in a map.
+        // While loading the configuration files, entries are accumulated in a map to check overlapping ranges.
+        // After loading, they are compiled into a compact vector of ranges, sorted by first value.
         class ConfigSection
         {
         public:
-            size_t          bits;     // Number of significant bits in values of the type.
-            ConfigEntryMap  entries;  // All entries, indexed by names.
+            size_t                   bits;     // Number of significant bits in values of the type.
+            ConfigEntryMap           entries;  // All entries during loading, indexed by first value.
+            std::vector<ConfigEntry> ranges;   // All entries after loading, sorted by first value.
 
             ConfigSection();
-            ~ConfigSection();
 
             // Check if a range is free, ie no value is defined in the range.
             bool freeRange(Value first, Value last) const;
@@ -479,12 +540,15 @@ namespace ts {
             // Add a new entry.
             void addEntry(Value first, Value last, const UString& name);
 
-            // Get a name from a value, empty if not found.
-            UString getName(Value val) const;
+            // Move all entries from the map into the vector of ranges.
+            void compile();
+
+            // Get a name from a value, null if not found or empty.
+            const UString* getName(Value val) const;
         };
 
-        // Map of configuration sections, indexed by name.
-        typedef std::map<UString, ConfigSection*> ConfigSectionMap;
+        // Map of configuration sections indexes, indexed by name.
+        typedef std::map<UString, SectionHandle> ConfigSectionMap;
 
         // Decode a line as "first[-last] = name". Return true on success, false on error.
         bool decodeDefinition(const UString& line, ConfigSection* section);
@@ -499,10 +563,11 @@ namespace ts {
         void loadFile(const UString& fileName);
 
         // Names private fields.
-        Report&          _log;           // Error logger.
-        const UString    _configFile;    // Configuration file path.
-        size_t           _configErrors;  // Number of errors in configuration file.
-        ConfigSectionMap _sections;      // Configuration sections.
+        Report&                    _log;           // Error logger.
+        const UString              _configFile;    // Configuration file path.
+        size_t                     _configErrors;  // Number of errors in configuration file.
+        ConfigSectionMap           _sectionNames;  // Configuration sections indexes, by name.
+        std::vector<ConfigSection> _sections;      // Configuration sections, indexed by handle.
     };
 
     //!
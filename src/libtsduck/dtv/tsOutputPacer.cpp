@@ -0,0 +1,417 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsOutputPacer.h"
+#include "tsGuardCondition.h"
+#include "tsGuard.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr ts::MilliSecond ts::OutputPacer::DEFAULT_LATENCY;
+constexpr ts::NanoSecond ts::OutputPacer::DEFAULT_SPIN_TIME;
+constexpr size_t ts::OutputPacer::DEFAULT_BUFFER_PACKETS;
+constexpr size_t ts::OutputPacer::HISTOGRAM_SIZE;
+#endif
+
+// When the timeline is late by more than this value, it is restarted from the current time.
+#define MAX_LATE_NS (NanoSecPerSec)
+
+// Max distance between two consecutive PCR's in a valid sequence.
+#define MAX_PCR_DIFF (2 * SYSTEM_CLOCK_FREQ)
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::OutputPacer::OutputPacer(OutputPacerHandlerInterface* handler, Report& report, int log_level) :
+    Thread(ThreadAttributes().setPriority(ThreadAttributes::GetHighPriority())),
+    _handler(handler),
+    _report(report),
+    _log_level(log_level),
+    _latency(DEFAULT_LATENCY),
+    _spin(DEFAULT_SPIN_TIME),
+    _lead(0),
+    _user_pid(PID_NULL),
+    _chunk_size(1),
+    _started(false),
+    _pid(PID_NULL),
+    _timeline(false),
+    _origin(),
+    _next_ns(0),
+    _last_pcr(INVALID_PCR),
+    _last_pcr_ns(0),
+    _last_due(),
+    _now(),
+    _timer(),
+    _mutex(),
+    _not_empty(),
+    _not_full(),
+    _packets(),
+    _chunks(),
+    _first(0),
+    _count(0),
+    _terminate(false),
+    _flush(true),
+    _error(false),
+    _sent_chunks(0),
+    _sent_packets(0),
+    _max_jitter(0),
+    _max_late(0),
+    _jitter_histo(),
+    _late_histo()
+{
+}
+
+ts::OutputPacer::~OutputPacer()
+{
+    stop(false);
+}
+
+
+//----------------------------------------------------------------------------
+// Start the pacer.
+//----------------------------------------------------------------------------
+
+bool ts::OutputPacer::start(size_t chunk_packets, size_t buffer_packets)
+{
+    if (_started) {
+        _report.error(u"output pacer already started");
+        return false;
+    }
+
+    // Allocate the queue of chunks.
+    _chunk_size = std::max<size_t>(1, chunk_packets);
+    const size_t chunk_count = std::max<size_t>(2, buffer_packets / _chunk_size);
+    _packets.resize(chunk_count * _chunk_size);
+    _chunks.resize(chunk_count);
+    _first = _count = 0;
+    _terminate = _error = false;
+    _flush = true;
+
+    // Reset the timeline.
+    _pid = _user_pid;
+    _timeline = false;
+    _last_pcr = INVALID_PCR;
+
+    // Reset statistics.
+    _sent_chunks = _sent_packets = 0;
+    _max_jitter = _max_late = 0;
+    _jitter_histo.fill(0);
+    _late_histo.fill(0);
+
+    _report.log(_log_level, u"output pacer: latency: %'d ms, busy-poll: %'d us, lead time: %'d us, %'d chunks of %'d packets",
+                {_latency, _spin / NanoSecPerMicroSec, _lead / NanoSecPerMicroSec, chunk_count, _chunk_size});
+
+    _started = Thread::start();
+    if (!_started) {
+        _report.error(u"cannot start output pacer thread");
+    }
+    return _started;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the pacer.
+//----------------------------------------------------------------------------
+
+void ts::OutputPacer::stop(bool flush)
+{
+    if (_started) {
+        {
+            GuardCondition lock(_mutex, _not_empty);
+            _terminate = true;
+            _flush = flush;
+            lock.signal();
+        }
+        waitForTermination();
+        _started = false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Queue packets for paced emission.
+//----------------------------------------------------------------------------
+
+bool ts::OutputPacer::push(const TSPacket* packets, size_t count, BitRate bitrate)
+{
+    if (!_started) {
+        return false;
+    }
+
+    while (count > 0) {
+        const size_t size = std::min(count, _chunk_size);
+
+        // Compute the due time of the chunk from the producer's timeline.
+        computeDueTime(packets, size, bitrate);
+
+        // Wait for a free chunk slot and fill it.
+        GuardCondition lock(_mutex, _not_full);
+        while (_count >= _chunks.size() && !_error) {
+            lock.waitCondition();
+        }
+        if (_error) {
+            return false;
+        }
+        const size_t index = (_first + _count) % _chunks.size();
+        TSPacket::Copy(&_packets[index * _chunk_size], packets, size);
+        _chunks[index].count = size;
+        _chunks[index].due = _last_due;
+        _count++;
+        _not_empty.signal();
+
+        packets += size;
+        count -= size;
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the due time of the next chunk (in _last_due).
+//----------------------------------------------------------------------------
+
+void ts::OutputPacer::computeDueTime(const TSPacket* packets, size_t count, BitRate bitrate)
+{
+    // Start the timeline at the first packet.
+    if (!_timeline) {
+        _timeline = true;
+        _origin.getSystemTime();
+        _origin += _latency * NanoSecPerMilliSec;
+        _last_due = _origin;
+        _next_ns = 0;
+        _last_pcr = INVALID_PCR;
+    }
+
+    // Duration of one packet, zero if the bitrate is unknown.
+    const NanoSecond packet_ns = bitrate == 0 ? 0 : (PKT_SIZE_BITS * NanoSecPerSec) / bitrate;
+
+    // Interpolated stream time of the first packet in the chunk.
+    NanoSecond start_ns = _next_ns;
+    bool synced = false;
+
+    // Resynchronize the timeline on the PCR's of the reference PID.
+    for (size_t i = 0; i < count; ++i) {
+        if (packets[i].hasPCR()) {
+            const PID pid = packets[i].getPID();
+            if (_pid == PID_NULL) {
+                _pid = pid;
+                _report.log(_log_level, u"output pacer: using PID 0x%X (%d) for PCR reference", {pid, pid});
+            }
+            if (pid == _pid) {
+                const uint64_t pcr = packets[i].getPCR();
+                NanoSecond pcr_ns = start_ns + NanoSecond(i) * packet_ns;
+                if (_last_pcr != INVALID_PCR) {
+                    // Distance from previous PCR, including wrap-down.
+                    const uint64_t diff = pcr >= _last_pcr ? pcr - _last_pcr : pcr + PCR_SCALE - _last_pcr;
+                    if (diff < MAX_PCR_DIFF) {
+                        pcr_ns = _last_pcr_ns + NanoSecond((NanoSecPerMicroSec * diff) / (SYSTEM_CLOCK_FREQ / MicroSecPerSec));
+                    }
+                    else {
+                        _report.debug(u"output pacer: out of sequence PCR, continuing timeline");
+                    }
+                }
+                // The first PCR in the chunk gives the time of the chunk.
+                if (!synced) {
+                    start_ns = pcr_ns - NanoSecond(i) * packet_ns;
+                    synced = true;
+                }
+                _last_pcr = pcr;
+                _last_pcr_ns = pcr_ns;
+            }
+        }
+    }
+    _next_ns = start_ns + NanoSecond(count) * packet_ns;
+
+    // Due time of the chunk, never before the previous chunk.
+    Monotonic due(_origin);
+    due += start_ns;
+    if (due > _last_due) {
+        _last_due = due;
+    }
+
+    // If the producer is too late (input stall for instance), restart the timeline from now.
+    _now.getSystemTime();
+    if (_now - _last_due > MAX_LATE_NS) {
+        const NanoSecond shift = (_now - _last_due) + _latency * NanoSecPerMilliSec;
+        _report.log(_log_level, u"output pacer: late by %'d ms, restarting timeline", {(_now - _last_due) / NanoSecPerMilliSec});
+        _origin += shift;
+        _last_due += shift;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Wait until a due time, using a hybrid sleep / busy-poll.
+//----------------------------------------------------------------------------
+
+void ts::OutputPacer::waitUntil(const Monotonic& due, Monotonic& now)
+{
+    now.getSystemTime();
+    if (now < due) {
+        // Sleep until shortly before due time.
+        if (due - now > _spin) {
+            _timer = due;
+            _timer -= _spin;
+            _timer.wait();
+            now.getSystemTime();
+        }
+        // Busy-poll until due time.
+        while (now < due) {
+            now.getSystemTime();
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Pacer thread.
+//----------------------------------------------------------------------------
+
+void ts::OutputPacer::main()
+{
+    Monotonic now;
+    Monotonic emit;
+    Monotonic prev_due;
+    Monotonic prev_sent;
+    bool first = true;
+
+    for (;;) {
+        // Wait for the next chunk.
+        size_t index = 0;
+        size_t count = 0;
+        {
+            GuardCondition lock(_mutex, _not_empty);
+            while (_count == 0 && !_terminate) {
+                lock.waitCondition();
+            }
+            if (_count == 0 || (_terminate && !_flush)) {
+                break;
+            }
+            index = _first;
+            count = _chunks[index].count;
+            emit = _chunks[index].due;
+        }
+
+        // The slot is owned by this thread until released. Wait for its due time.
+        const Monotonic due(emit);
+        emit -= _lead;
+        waitUntil(emit, now);
+        const bool ok = _handler->handlePacedPackets(*this, &_packets[index * _chunk_size], count, due);
+
+        // Account statistics and release the slot.
+        {
+            GuardCondition lock(_mutex, _not_full);
+            const NanoSecond late = now - emit;
+            _max_late = std::max(_max_late, late);
+            Feed(_late_histo, late);
+            if (!first) {
+                const NanoSecond jitter = std::abs((now - prev_sent) - (due - prev_due));
+                _max_jitter = std::max(_max_jitter, jitter);
+                Feed(_jitter_histo, jitter);
+            }
+            first = false;
+            prev_sent = now;
+            prev_due = due;
+            _sent_chunks++;
+            _sent_packets += count;
+            _first = (_first + 1) % _chunks.size();
+            _count--;
+            _error = !ok;
+            lock.signal();
+        }
+        if (!ok) {
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Logarithmic histograms.
+//----------------------------------------------------------------------------
+
+void ts::OutputPacer::Feed(Histogram& histo, NanoSecond value)
+{
+    uint64_t usec = value <= 0 ? 0 : uint64_t(value / NanoSecPerMicroSec);
+    size_t index = 0;
+    while (usec != 0 && index < HISTOGRAM_SIZE - 1) {
+        usec >>= 1;
+        index++;
+    }
+    histo[index]++;
+}
+
+ts::UString ts::OutputPacer::Format(const Histogram& histo)
+{
+    size_t size = HISTOGRAM_SIZE;
+    while (size > 0 && histo[size - 1] == 0) {
+        size--;
+    }
+    UString str;
+    for (size_t i = 0; i < size; ++i) {
+        if (!str.empty()) {
+            str.append(u", ");
+        }
+        if (i == 0) {
+            str.append(UString::Format(u"<1: %'d", {histo[i]}));
+        }
+        else {
+            str.append(UString::Format(u"%'d-%'d: %'d", {uint64_t(1) << (i - 1), uint64_t(1) << i, histo[i]}));
+        }
+    }
+    return str;
+}
+
+
+//----------------------------------------------------------------------------
+// Get statistics.
+//----------------------------------------------------------------------------
+
+void ts::OutputPacer::getJitterHistogram(Histogram& histo) const
+{
+    Guard lock(_mutex);
+    histo = _jitter_histo;
+}
+
+void ts::OutputPacer::getLatenessHistogram(Histogram& histo) const
+{
+    Guard lock(_mutex);
+    histo = _late_histo;
+}
+
+void ts::OutputPacer::reportStatistics(int severity) const
+{
+    Guard lock(_mutex);
+    _report.log(severity, u"output pacer: %'d packets in %'d chunks, max lateness: %'d us, max jitter: %'d us",
+                {_sent_packets, _sent_chunks, _max_late / NanoSecPerMicroSec, _max_jitter / NanoSecPerMicroSec});
+    _report.log(severity, u"output pacer: jitter histogram (us): %s", {Format(_jitter_histo)});
+    _report.log(severity, u"output pacer: lateness histogram (us): %s", {Format(_late_histo)});
+}
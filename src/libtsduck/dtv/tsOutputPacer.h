@@ -0,0 +1,245 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Pacing engine for TS packets output, based on PCR's.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsOutputPacerHandlerInterface.h"
+#include "tsThread.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsReport.h"
+
+namespace ts {
+    //!
+    //! Pacing engine for TS packets output, based on PCR's.
+    //! @ingroup mpeg
+    //! @see PCRRegulator
+    //!
+    //! Unlike PCRRegulator and BitRateRegulator which suspend the processing thread,
+    //! an OutputPacer queues the packets and emits them from a dedicated timer thread.
+    //! Each chunk of packets (typically one UDP datagram) is scheduled against a
+    //! timeline which is derived from the PCR's of a reference PID and interpolated
+    //! between PCR's using the bitrate of the stream.
+    //!
+    //! The timer thread uses a hybrid wait: it sleeps using the monotonic clock until
+    //! shortly before the due time of the next chunk and then busy-polls the clock
+    //! until the exact due time. The achieved inter-chunk jitter and the lateness of
+    //! each chunk are accumulated in logarithmic histograms.
+    //!
+    class TSDUCKDLL OutputPacer : private Thread
+    {
+        TS_NOBUILD_NOCOPY(OutputPacer);
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] handler The handler which is invoked to emit the packets.
+        //! @param [in,out] report Where to report errors.
+        //! @param [in] log_level Severity level for information messages.
+        //!
+        OutputPacer(OutputPacerHandlerInterface* handler, Report& report, int log_level = Severity::Verbose);
+
+        //!
+        //! Destructor.
+        //!
+        virtual ~OutputPacer() override;
+
+        //!
+        //! Default latency between the reception of the first packet and its emission.
+        //!
+        static constexpr MilliSecond DEFAULT_LATENCY = 100;
+
+        //!
+        //! Default duration of the final busy-poll before the due time of a chunk.
+        //!
+        static constexpr NanoSecond DEFAULT_SPIN_TIME = 200 * NanoSecPerMicroSec;
+
+        //!
+        //! Default maximum number of queued packets.
+        //!
+        static constexpr size_t DEFAULT_BUFFER_PACKETS = 16 * 1024;
+
+        //!
+        //! Number of buckets in the logarithmic histograms.
+        //!
+        static constexpr size_t HISTOGRAM_SIZE = 24;
+
+        //!
+        //! Logarithmic histogram: bucket N counts values in microseconds in the range [2^(N-1), 2^N[.
+        //!
+        typedef std::array<PacketCounter, HISTOGRAM_SIZE> Histogram;
+
+        //!
+        //! Set the latency between the reception of the first packet and its emission.
+        //! Must be called before start().
+        //! @param [in] latency Latency in milliseconds.
+        //!
+        void setLatency(MilliSecond latency) { _latency = latency; }
+
+        //!
+        //! Set the duration of the final busy-poll before the due time of a chunk.
+        //! Must be called before start().
+        //! @param [in] spin Busy-poll duration in nanoseconds. When zero, the timer thread
+        //! only sleeps on the monotonic clock, without busy-poll.
+        //!
+        void setSpinTime(NanoSecond spin) { _spin = spin; }
+
+        //!
+        //! Set the lead time of the emission of the chunks.
+        //! Must be called before start().
+        //! @param [in] lead Each chunk is passed to the handler this number of nanoseconds before
+        //! its due time. This is typically used when the handler delegates the precise emission
+        //! time to the system, using the SO_TXTIME socket option for instance.
+        //!
+        void setLeadTime(NanoSecond lead) { _lead = lead; }
+
+        //!
+        //! Set the PCR reference PID.
+        //! Must be called before start().
+        //! @param [in] pid Reference PID. If PID_NULL, use the first PID containing PCR's.
+        //!
+        void setReferencePID(PID pid) { _user_pid = pid; }
+
+        //!
+        //! Start the pacer.
+        //! @param [in] chunk_packets Maximum number of packets per chunk, per invocation of the handler.
+        //! @param [in] buffer_packets Maximum number of queued packets.
+        //! @return True on success, false on error.
+        //!
+        bool start(size_t chunk_packets, size_t buffer_packets = DEFAULT_BUFFER_PACKETS);
+
+        //!
+        //! Stop the pacer.
+        //! @param [in] flush If true, wait for the emission of all queued packets.
+        //! Otherwise, the queued packets are dropped.
+        //!
+        void stop(bool flush = true);
+
+        //!
+        //! Queue packets for paced emission.
+        //! The packets are split in chunks of the maximum chunk size which was specified in start().
+        //! The caller is suspended when the queue is full.
+        //! @param [in] packets Address of the first packet.
+        //! @param [in] count Number of packets.
+        //! @param [in] bitrate Current bitrate of the stream, used to interpolate the timeline between PCR's.
+        //! If zero, the packets between two PCR's are emitted at the same time.
+        //! @return True on success, false on error (including a previous error in the handler).
+        //!
+        bool push(const TSPacket* packets, size_t count, BitRate bitrate);
+
+        //!
+        //! Get the histogram of inter-chunk jitter.
+        //! The jitter is the absolute difference between the actual and expected intervals
+        //! between the emission of two consecutive chunks.
+        //! @param [out] histo Histogram of jitter in microseconds.
+        //!
+        void getJitterHistogram(Histogram& histo) const;
+
+        //!
+        //! Get the histogram of lateness.
+        //! The lateness is the difference between the actual emission time of a chunk and its due time.
+        //! @param [out] histo Histogram of lateness in microseconds.
+        //!
+        void getLatenessHistogram(Histogram& histo) const;
+
+        //!
+        //! Report the emission statistics.
+        //! @param [in] severity Severity level of the messages.
+        //!
+        void reportStatistics(int severity = Severity::Info) const;
+
+    private:
+        // Description of one queued chunk.
+        struct Chunk
+        {
+            size_t    count;  // Number of packets in the chunk.
+            Monotonic due;    // Due time of the first packet.
+            Chunk() : count(0), due() {}
+        };
+
+        OutputPacerHandlerInterface* _handler;
+        Report&        _report;
+        int            _log_level;
+        MilliSecond    _latency;        // Initial latency.
+        NanoSecond     _spin;           // Busy-poll duration.
+        NanoSecond     _lead;           // Lead time of emission.
+        PID            _user_pid;       // User-specified reference PID.
+        size_t         _chunk_size;     // Max number of packets per chunk.
+        bool           _started;        // The pacer thread is started.
+
+        // Timeline, used by the producer thread only.
+        PID            _pid;            // Current reference PID.
+        bool           _timeline;       // The timeline is started.
+        Monotonic      _origin;         // System time of the origin of the timeline.
+        NanoSecond     _next_ns;        // Stream time of next packet since origin of timeline.
+        uint64_t       _last_pcr;       // Last PCR value in reference PID.
+        NanoSecond     _last_pcr_ns;    // Stream time of last PCR.
+        Monotonic      _last_due;       // Due time of last queued chunk.
+        Monotonic      _now;            // Current time in producer thread.
+        Monotonic      _timer;          // Timer in pacer thread.
+
+        // Queue of chunks, protected by the mutex.
+        mutable Mutex  _mutex;
+        Condition      _not_empty;      // Signaled when a chunk is queued.
+        Condition      _not_full;       // Signaled when a chunk is released.
+        TSPacketVector _packets;        // Packets, _chunk_size per chunk slot.
+        std::vector<Chunk> _chunks;     // Circular queue of chunks.
+        size_t         _first;          // Index of first queued chunk.
+        size_t         _count;          // Number of queued chunks.
+        bool           _terminate;      // Request to terminate the pacer thread.
+        bool           _flush;          // Emit all queued packets before terminating.
+        bool           _error;          // Error in handler, pacer thread terminated.
+
+        // Statistics, protected by the mutex.
+        PacketCounter  _sent_chunks;
+        PacketCounter  _sent_packets;
+        NanoSecond     _max_jitter;
+        NanoSecond     _max_late;
+        Histogram      _jitter_histo;
+        Histogram      _late_histo;
+
+        // Add a value in microseconds in a logarithmic histogram.
+        static void Feed(Histogram& histo, NanoSecond value);
+
+        // Format a logarithmic histogram.
+        static UString Format(const Histogram& histo);
+
+        // Compute the due time of the next chunk (in _last_due), starting at the current stream time.
+        void computeDueTime(const TSPacket* packets, size_t count, BitRate bitrate);
+
+        // Wait until a due time, using a hybrid sleep / busy-poll.
+        void waitUntil(const Monotonic& due, Monotonic& now);
+
+        // Implementation of Thread.
+        virtual void main() override;
+    };
+}
@@ -0,0 +1,109 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsOutputPacerArgs.h"
+#include "tsArgs.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::OutputPacerArgs::OutputPacerArgs() :
+    pace(false),
+    latency(OutputPacer::DEFAULT_LATENCY),
+    spin(OutputPacer::DEFAULT_SPIN_TIME),
+    pcr_pid(PID_NULL)
+{
+}
+
+ts::OutputPacerArgs::~OutputPacerArgs()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Define command line options in an Args.
+//----------------------------------------------------------------------------
+
+void ts::OutputPacerArgs::defineArgs(Args& args) const
+{
+    args.option(u"pace");
+    args.help(u"pace",
+              u"Emit the packets from a dedicated high-priority timer thread, at the time which is "
+              u"derived from the PCR's of a reference PID and interpolated between PCR's using the "
+              u"bitrate of the stream. This reduces the output jitter, compared to the regulation "
+              u"in the processing thread (plugin \"regulate\"). The achieved jitter is reported "
+              u"in verbose mode at the end of the processing.");
+
+    args.option(u"pace-latency", 0, Args::POSITIVE);
+    args.help(u"pace-latency", u"milliseconds",
+              u"With --pace, specify the latency between the reception of the first packet and its emission. "
+              u"This is the amount of buffered data which absorbs the irregularities of the processing. "
+              u"The default is " + UString::Decimal(OutputPacer::DEFAULT_LATENCY) + u" milliseconds.");
+
+    args.option(u"pace-pcr-pid", 0, Args::PIDVAL);
+    args.help(u"pace-pcr-pid",
+              u"With --pace, specify the PID containing the PCR's which are used as time reference. "
+              u"By default, use the first PID containing PCR's.");
+
+    args.option(u"pace-spin", 0, Args::UNSIGNED);
+    args.help(u"pace-spin", u"microseconds",
+              u"With --pace, the timer thread sleeps until shortly before the due time of the packets "
+              u"and then busy-polls the clock until the exact due time. This option specifies the "
+              u"duration of the busy-poll. Zero means no busy-poll, only sleep. "
+              u"The default is " + UString::Decimal(OutputPacer::DEFAULT_SPIN_TIME / NanoSecPerMicroSec) + u" microseconds.");
+}
+
+
+//----------------------------------------------------------------------------
+// Load arguments from command line.
+//----------------------------------------------------------------------------
+
+bool ts::OutputPacerArgs::loadArgs(DuckContext& duck, Args& args)
+{
+    pace = args.present(u"pace");
+    args.getIntValue(latency, u"pace-latency", OutputPacer::DEFAULT_LATENCY);
+    args.getIntValue(pcr_pid, u"pace-pcr-pid", PID_NULL);
+    spin = NanoSecPerMicroSec * args.intValue<NanoSecond>(u"pace-spin", OutputPacer::DEFAULT_SPIN_TIME / NanoSecPerMicroSec);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Apply the options to an output pacer.
+//----------------------------------------------------------------------------
+
+void ts::OutputPacerArgs::configure(OutputPacer& pacer) const
+{
+    pacer.setLatency(latency);
+    pacer.setSpinTime(spin);
+    pacer.setReferencePID(pcr_pid);
+}
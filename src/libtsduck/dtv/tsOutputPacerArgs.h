@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Command line arguments for the paced output of TS packets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsArgsSupplierInterface.h"
+#include "tsOutputPacer.h"
+
+namespace ts {
+    //!
+    //! Command line arguments for the paced output of TS packets.
+    //! @ingroup cmd
+    //! @see OutputPacer
+    //!
+    class TSDUCKDLL OutputPacerArgs : public ArgsSupplierInterface
+    {
+    public:
+        //!
+        //! Constructor.
+        //!
+        OutputPacerArgs();
+
+        //!
+        //! Virtual destructor.
+        //!
+        virtual ~OutputPacerArgs() override;
+
+        // Public fields, by options.
+        bool        pace;     //!< Use an OutputPacer.
+        MilliSecond latency;  //!< Latency of the paced output.
+        NanoSecond  spin;     //!< Busy-poll duration before due time.
+        PID         pcr_pid;  //!< Reference PID for PCR's.
+
+        // Implementation of ArgsSupplierInterface.
+        virtual void defineArgs(Args& args) const override;
+        virtual bool loadArgs(DuckContext& duck, Args& args) override;
+
+        //!
+        //! Apply the options to an output pacer.
+        //! @param [in,out] pacer The output pacer to configure.
+        //!
+        void configure(OutputPacer& pacer) const;
+    };
+}
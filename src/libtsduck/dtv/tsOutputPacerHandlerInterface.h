@@ -0,0 +1,68 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Output pacer handler interface.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsMonotonic.h"
+
+namespace ts {
+
+    class OutputPacer;
+
+    //!
+    //! Output pacer handler interface.
+    //! @ingroup mpeg
+    //!
+    //! This abstract interface must be implemented by classes which emit
+    //! TS packets at a precise time using an OutputPacer.
+    //!
+    class TSDUCKDLL OutputPacerHandlerInterface
+    {
+    public:
+        //!
+        //! This hook is invoked in the context of the pacer thread when a chunk of packets is due.
+        //! @param [in,out] pacer A reference to the output pacer.
+        //! @param [in] packets Address of the first packet of the chunk.
+        //! @param [in] count Number of packets in the chunk.
+        //! @param [in] due Due time of the first packet of the chunk.
+        //! @return True on success, false on error. On error, the pacer stops.
+        //!
+        virtual bool handlePacedPackets(OutputPacer& pacer, const TSPacket* packets, size_t count, const Monotonic& due) = 0;
+
+        //!
+        //! Virtual destructor.
+        //!
+        virtual ~OutputPacerHandlerInterface();
+    };
+}
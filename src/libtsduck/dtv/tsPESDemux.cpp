@@ -44,6 +44,10 @@
 #include "tsVVCAccessUnitDelimiter.h"
 TSDUCK_SOURCE;
 
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::PESDemux::FULL_DEPTH;
+#endif
+
 
 //----------------------------------------------------------------------------
 // Constructors and destructors.
@@ -53,9 +57,11 @@ ts::PESDemux::PESDemux(DuckContext& duck, PESHandlerInterface* pes_handler, cons
     SuperClass(duck, pid_filter),
     _pes_handler(pes_handler),
     _default_codec(CodecType::UNDEFINED),
+    _default_depth(FULL_DEPTH),
     _pids(),
     _pid_types(),
-    _section_demux(_duck, this)
+    _section_demux(_duck, this),
+    _buffer_pool()
 {
     // Analyze the PAT, to get the PMT's, to get the stream types.
     _section_demux.addPID(PID_PAT);
@@ -72,7 +78,10 @@ ts::PESDemux::PIDContext::PIDContext() :
     first_pkt(0),
     last_pkt(0),
     pcr(INVALID_PCR),
-    ts(new ByteBlock()),
+    ts(),
+    pes_bytes(0),
+    max_size(NPOS),
+    pes_size(0),
     audio(),
     video(),
     avc(),
@@ -84,7 +93,9 @@ ts::PESDemux::PIDContext::PIDContext() :
 
 ts::PESDemux::PIDType::PIDType() :
     stream_type(ST_NULL),
-    default_codec(CodecType::UNDEFINED)
+    default_codec(CodecType::UNDEFINED),
+    has_depth(false),
+    depth(FULL_DEPTH)
 {
 }
 
@@ -96,6 +107,9 @@ ts::PESDemux::PIDType::PIDType() :
 void ts::PESDemux::immediateReset()
 {
     SuperClass::immediateReset();
+    for (auto& it : _pids) {
+        recycleBuffer(it.second.ts);
+    }
     _pids.clear();
     _pid_types.clear();
 
@@ -107,7 +121,7 @@ void ts::PESDemux::immediateReset()
 void ts::PESDemux::immediateResetPID(PID pid)
 {
     SuperClass::immediateResetPID(pid);
-    _pids.erase(pid);
+    erasePID(pid);
     _pid_types.erase(pid);
 }
 
@@ -128,6 +142,24 @@ ts::CodecType ts::PESDemux::getDefaultCodec(PID pid) const
 }
 
 
+//----------------------------------------------------------------------------
+// Set/get the reassembly depth of one specific PES PID's.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::setDepth(PID pid, size_t depth)
+{
+    PIDType& type(_pid_types[pid]);
+    type.has_depth = true;
+    type.depth = depth;
+}
+
+size_t ts::PESDemux::getDepth(PID pid) const
+{
+    const auto it = _pid_types.find(pid);
+    return it == _pid_types.end() || !it->second.has_depth ? _default_depth : it->second.depth;
+}
+
+
 //----------------------------------------------------------------------------
 // Get current audio/video attributes on the specified PID.
 // Check isValid() on returned object.
@@ -244,7 +276,7 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
     // for a while => release context.
     if (pkt.getScrambling() != SC_CLEAR) {
         if (pc_exists) {
-            _pids.erase(pid);
+            erasePID(pid);
         }
         return;
     }
@@ -262,14 +294,29 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
             PIDContext& pc(_pids[pid]);
             pc.continuity = pkt.getCC();
             pc.sync = true;
-            pc.ts->copy(pl, pl_size);
+            // Maximum number of bytes to keep, according to the reassembly depth of the PID.
+            // If the PES header is not complete in this TS packet, assume the largest PES header.
+            const size_t depth = getDepth(pid);
+            if (depth == FULL_DEPTH) {
+                pc.max_size = NPOS;
+            }
+            else {
+                const size_t header_size = PESPacket::HeaderSize(pl, pl_size);
+                pc.max_size = (header_size == 0 ? 9 + 255 : header_size) + std::min(depth, NPOS - 9 - 255);
+            }
+            // Size the reassembly buffer from the PES packet length when specified,
+            // from the largest previous unbounded PES packet on this PID otherwise.
+            const size_t len = pl_size >= 6 ? GetUInt16(pl + 4) : 0;
+            newBuffer(pc, std::min(pc.max_size, len != 0 ? 6 + len : pc.pes_size));
+            pc.ts->copy(pl, std::min(pl_size, pc.max_size));
+            pc.pes_bytes = pl_size;
             pc.first_pkt = _packet_count;
             pc.last_pkt = _packet_count;
             pc.pcr = pkt.getPCR(); // can be invalid
         }
         else if (pc_exists) {
             // This PID does not contain PES packet, reset context
-            _pids.erase(pid);
+            erasePID(pid);
         }
         // PUSI packet processing done.
         return;
@@ -294,7 +341,11 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
     }
     pc.continuity = pkt.getCC();
 
-    // Append the TS payload in PID context.
+    // Append the TS payload in PID context, up to the reassembly depth.
+    pc.pes_bytes += pl_size;
+    if (pc.ts->size() + pl_size > pc.max_size) {
+        pl_size = pc.max_size - std::min(pc.max_size, pc.ts->size());
+    }
     size_t capacity = pc.ts->capacity();
     if (pc.ts->size() + pl_size > capacity) {
         // Internal reallocation needed in ts buffer.
@@ -328,11 +379,15 @@ void ts::PESDemux::processPacket(const TSPacket& pkt)
         const size_t len = GetUInt16(pc.ts->data() + 4);
         // If the size is zero, the PES packet is "unbounded", meaning it ends at the next PUSI.
         // But if the PES packet size is specified, check if we have the complete PES packet.
-        if (len != 0 && pc.ts->size() >= 4 + len) {
+        if (len != 0 && pc.pes_bytes >= 4 + len) {
             // We have the complete PES packet.
             processPESPacket(pid, pc);
-            // Reset PES buffer.
-            pc.ts->clear();
+            // Wait for the next PES packet, if the PID context was not reset by a handler.
+            // The PES buffer is not cleared here since it may be still referenced by a handler.
+            pci = _pids.find(pid);
+            if (pci != _pids.end()) {
+                pci->second.sync = false;
+            }
         }
     }
 }
@@ -381,8 +436,14 @@ void ts::PESDemux::handleTable(SectionDemux& demux, const BinaryTable& table)
 
 void ts::PESDemux::processPESPacket(PID pid, PIDContext& pc)
 {
-    // Build a PES packet object around the TS buffer
-    PESPacket pes(pc.ts, pid);
+    // Keep track of the size of unbounded PES packets (typically video) to presize the next buffers.
+    if (pc.ts->size() >= 6 && GetUInt16(pc.ts->data() + 4) == 0) {
+        pc.pes_size = std::max(pc.pes_size, pc.ts->size());
+    }
+
+    // Build a PES packet object around the TS buffer, possibly truncated by the reassembly depth.
+    PESPacket pes(pid);
+    pes.initialize(pc.ts, pc.pes_bytes);
     if (!pes.isValid()) {
         return;
     }
@@ -424,6 +485,61 @@ void ts::PESDemux::processPESPacket(PID pid, PIDContext& pc)
 }
 
 
+//----------------------------------------------------------------------------
+// Management of the pool of reassembly buffers.
+//----------------------------------------------------------------------------
+
+void ts::PESDemux::newBuffer(PIDContext& pc, size_t size)
+{
+    // If the current buffer of the PID is no longer referenced by any PES packet, reuse it.
+    // Otherwise, a handler kept the previous PES packet and its buffer must remain untouched.
+    if (pc.ts.isNull() || pc.ts.count() > 1) {
+        recycleBuffer(pc.ts);
+        // Look for a buffer in the pool which is no longer referenced outside the pool.
+        for (auto it = _buffer_pool.begin(); it != _buffer_pool.end(); ++it) {
+            if (it->count() == 1) {
+                pc.ts = *it;
+                _buffer_pool.erase(it);
+                break;
+            }
+        }
+        if (pc.ts.isNull()) {
+            pc.ts = new ByteBlock;
+        }
+    }
+    pc.ts->clear();
+    pc.ts->reserve(size);
+}
+
+void ts::PESDemux::recycleBuffer(ByteBlockPtr& bbp)
+{
+    if (!bbp.isNull()) {
+        if (_buffer_pool.size() < MAX_POOL_SIZE) {
+            _buffer_pool.push_back(bbp);
+        }
+        else if (bbp.count() == 1) {
+            // Pool full, replace a buffer which is still referenced elsewhere, if any.
+            for (auto& it : _buffer_pool) {
+                if (it.count() > 1) {
+                    it = bbp;
+                    break;
+                }
+            }
+        }
+        bbp.clear();
+    }
+}
+
+void ts::PESDemux::erasePID(PID pid)
+{
+    const auto it = _pids.find(pid);
+    if (it != _pids.end()) {
+        recycleBuffer(it->second.ts);
+        _pids.erase(it);
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 // This hook is invoked when a complete PES packet is available.
 // This is a protected virtual method.
@@ -523,8 +639,7 @@ void ts::PESDemux::handlePESContent(PIDContext& pc, const PESPacket& pes)
         // The beginning of the payload is already a start code prefix.
         for (size_t offset = 0; offset < pl_size; ) {
             // Look for next start code
-            static const uint8_t StartCodePrefix[] = {0x00, 0x00, 0x01};
-            const uint8_t* pnext = LocatePattern(pl_data + offset + 1, pl_size - offset - 1, StartCodePrefix, sizeof(StartCodePrefix));
+            const uint8_t* pnext = LocateZeroZero(pl_data + offset + 1, pl_size - offset - 1, 0x01, 0x01);
             size_t next = pnext == nullptr ? pl_size : pnext - pl_data;
             // Invoke handler
             _pes_handler->handleVideoStartCode(*this, pes, pl_data[offset + 3], offset, next - offset);
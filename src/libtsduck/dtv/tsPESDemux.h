@@ -108,6 +108,42 @@ namespace ts {
         //!
         CodecType getDefaultCodec(PID pid) const;
 
+        //!
+        //! Depth value meaning that complete PES packets are reassembled.
+        //! @see setDepth()
+        //!
+        static constexpr size_t FULL_DEPTH = NPOS;
+
+        //!
+        //! Set the default reassembly depth of all PES PID's.
+        //! When only the PES headers and the beginning of the payloads are needed by the
+        //! application, limiting the depth avoids buffering the complete PES packets.
+        //! The demux stops copying data from the TS packets as soon as the requested depth
+        //! is reached. The PES packets are then passed truncated to the handlers.
+        //! The audio and video analysis of the demux is also limited to the truncated data.
+        //! @param [in] depth Maximum number of payload bytes which are kept after the PES header.
+        //! When zero, only the PES header is kept. The default is FULL_DEPTH.
+        //! @see PESPacket::isTruncated()
+        //!
+        void setDepth(size_t depth) { _default_depth = depth; }
+
+        //!
+        //! Set the reassembly depth of one specific PES PID.
+        //! This is the same as setDepth(size_t) for one specific PID.
+        //! @param [in] pid The PID to set.
+        //! @param [in] depth Maximum number of payload bytes which are kept after the PES header.
+        //! @see setDepth(size_t)
+        //!
+        void setDepth(PID pid, size_t depth);
+
+        //!
+        //! Get the reassembly depth of a given PID.
+        //! @param [in] pid The PID to check.
+        //! @return The maximum number of payload bytes which are kept after the PES header on @a pid.
+        //! @see setDepth()
+        //!
+        size_t getDepth(PID pid) const;
+
         //!
         //! Get the current audio attributes on the specified PID.
         //! @param [in] pid The PID to check.
@@ -164,6 +200,9 @@ namespace ts {
         //!
         //! This hook is invoked when a complete PES packet is available.
         //! Can be overloaded by subclasses to add intermediate processing.
+        //! The PES packet directly references the reassembly buffer of the demux, without copy.
+        //! A handler may keep a shared reference on the packet (using an assignment for instance),
+        //! the demux then reassembles the next PES packet of the PID in another buffer.
         //! @param [in] packet The PES packet.
         //!
         virtual void handlePESPacket(const PESPacket& packet);
@@ -183,6 +222,9 @@ namespace ts {
             PacketCounter        last_pkt;    // Index of last TS packet for current PES packet
             uint64_t             pcr;         // First PCR for current PES packet
             ByteBlockPtr         ts;          // TS payload buffer
+            size_t               pes_bytes;   // Total number of bytes in current PES packet, including bytes which are not kept in ts
+            size_t               max_size;    // Max number of bytes to keep in ts for current PES packet (reassembly depth)
+            size_t               pes_size;    // Largest observed size of unbounded PES packets, reassembly buffer size hint
             MPEG2AudioAttributes audio;       // Current audio attributes
             MPEG2VideoAttributes video;       // Current video attributes (MPEG-1, MPEG-2)
             AVCAttributes        avc;         // Current AVC attributes
@@ -193,8 +235,9 @@ namespace ts {
             // Default constructor:
             PIDContext();
 
-            // Called when packet synchronization is lost on the pid
-            void syncLost() {sync = false; ts->clear();}
+            // Called when packet synchronization is lost on the pid.
+            // The buffer is reset at the next unit start (it may be still referenced by a handler).
+            void syncLost() {sync = false;}
         };
 
         // Map of PID contexts, indexed by PID.
@@ -206,6 +249,8 @@ namespace ts {
         {
             uint8_t   stream_type;    // Stream type from PMT.
             CodecType default_codec;  // Default codec if not otherwise sepcified.
+            bool      has_depth;      // The reassembly depth was specified for this PID.
+            size_t    depth;          // Reassembly depth, when has_depth is true.
 
             // Default constructor:
             PIDType();
@@ -224,14 +269,23 @@ namespace ts {
         // Process all video/audio analysis on the PES packet.
         void handlePESContent(PIDContext&, const PESPacket&);
 
+        // Management of the pool of reassembly buffers.
+        // Buffers which are still referenced by PES packets which were kept by handlers stay in the pool until they are released.
+        static constexpr size_t MAX_POOL_SIZE = 16;
+        void newBuffer(PIDContext&, size_t size);
+        void recycleBuffer(ByteBlockPtr&);
+        void erasePID(PID);
+
         // Implementation of TableHandlerInterface.
         virtual void handleTable(SectionDemux& demux, const BinaryTable& table) override;
 
         // Private members:
         PESHandlerInterface* _pes_handler;
         CodecType            _default_codec;
+        size_t               _default_depth;
         PIDContextMap        _pids;
         PIDTypeMap           _pid_types;
         SectionDemux         _section_demux;
+        std::vector<ByteBlockPtr> _buffer_pool;
     };
 }
@@ -54,6 +54,7 @@ ts::PESPacket::PESPacket(PID source_pid) :
     _pcr(INVALID_PCR),
     _first_pkt(0),
     _last_pkt(0),
+    _full_size(0),
     _data()
 {
 }
@@ -67,6 +68,7 @@ ts::PESPacket::PESPacket(const PESPacket& pp, ShareMode mode) :
     _pcr(pp._pcr),
     _first_pkt(pp._first_pkt),
     _last_pkt(pp._last_pkt),
+    _full_size(pp._full_size),
     _data()
 {
     switch (mode) {
@@ -91,6 +93,7 @@ ts::PESPacket::PESPacket(PESPacket&& pp) noexcept :
     _pcr(pp._pcr),
     _first_pkt(pp._first_pkt),
     _last_pkt(pp._last_pkt),
+    _full_size(pp._full_size),
     _data(std::move(pp._data))
 {
 }
@@ -150,13 +153,14 @@ size_t ts::PESPacket::HeaderSize(const uint8_t* data, size_t size)
 // Initialize from a binary content.
 //----------------------------------------------------------------------------
 
-void ts::PESPacket::initialize(const ByteBlockPtr& bbp)
+void ts::PESPacket::initialize(const ByteBlockPtr& bbp, size_t full_size)
 {
     _is_valid = false;
     _header_size = 0;
     _pcr = INVALID_PCR;
     _first_pkt = 0;
     _last_pkt = 0;
+    _full_size = 0;
     _data.clear();
 
     if (bbp.isNull()) {
@@ -173,13 +177,15 @@ void ts::PESPacket::initialize(const ByteBlockPtr& bbp)
 
     // Check that the embedded size is either zero (unbounded) or within actual data size.
     // This field indicates the packet length _after_ that field (ie. after offset 6).
+    // A truncated packet is checked against its original size.
     const size_t psize = 6 + size_t(GetUInt16(data + 4));
-    if (psize != 6 && (psize < _header_size || psize > size)) {
+    if (psize != 6 && (psize < _header_size || psize > std::max(size, full_size))) {
         return;
     }
 
     // Passed all checks
     _is_valid = true;
+    _full_size = full_size > size ? full_size : 0;
     _data = bbp;
 }
 
@@ -198,6 +204,7 @@ void ts::PESPacket::clear()
     _pcr = INVALID_PCR;
     _first_pkt = 0;
     _last_pkt = 0;
+    _full_size = 0;
     _data.clear();
 }
 
@@ -255,6 +262,19 @@ size_t ts::PESPacket::size() const
 }
 
 
+size_t ts::PESPacket::fullSize() const
+{
+    if (!isTruncated()) {
+        return size();
+    }
+    else {
+        // Same logic as size(), on the original packet.
+        const size_t psize = GetUInt16(_data->data() + 4);
+        return psize == 0 ? _full_size : std::min(psize + 6, _full_size);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Stream id of the PES packet.
 //----------------------------------------------------------------------------
@@ -282,6 +302,25 @@ bool ts::PESPacket::hasLongHeader() const
 }
 
 
+//----------------------------------------------------------------------------
+// Presentation Time Stamp.
+//----------------------------------------------------------------------------
+
+bool ts::PESPacket::hasPTS() const
+{
+    return hasLongHeader() && _header_size >= 14 && ((*_data)[7] & 0x80) != 0;
+}
+
+uint64_t ts::PESPacket::getPTS() const
+{
+    if (!hasPTS()) {
+        return INVALID_PTS;
+    }
+    const uint8_t* const pts = _data->data() + 9;
+    return (uint64_t(pts[0] & 0x0E) << 29) | (uint64_t(GetUInt16(pts + 1) & 0xFFFE) << 14) | (uint64_t(GetUInt16(pts + 3)) >> 1);
+}
+
+
 //----------------------------------------------------------------------------
 // Assignment.
 //----------------------------------------------------------------------------
@@ -296,6 +335,7 @@ ts::PESPacket& ts::PESPacket::operator=(const PESPacket& pp)
     _pcr = pp._pcr;
     _first_pkt = pp._first_pkt;
     _last_pkt = pp._last_pkt;
+    _full_size = pp._full_size;
     _data = pp._data;
     return *this;
 }
@@ -310,6 +350,7 @@ ts::PESPacket& ts::PESPacket::operator=(PESPacket&& pp) noexcept
     _pcr = pp._pcr;
     _first_pkt = pp._first_pkt;
     _last_pkt = pp._last_pkt;
+    _full_size = pp._full_size;
     _data = std::move(pp._data);
     return *this;
 }
@@ -330,6 +371,7 @@ ts::PESPacket& ts::PESPacket::copy(const PESPacket& pp)
     _pcr = pp._pcr;
     _first_pkt = pp._first_pkt;
     _last_pkt = pp._last_pkt;
+    _full_size = pp._full_size;
     _data = pp._is_valid ? new ByteBlock(*pp._data) : nullptr;
     return *this;
 }
@@ -591,8 +633,7 @@ size_t ts::PESPacket::FindIntraImage(const uint8_t* data, size_t size, uint8_t s
         // The beginning of the PES payload is already a start code prefix in MPEG-1/2.
         while (pl_size > 0) {
             // Look for next start code
-            static const uint8_t StartCodePrefix[] = {0x00, 0x00, 0x01};
-            const uint8_t* pl_next = LocatePattern(pl_data + 1, pl_size - 1, StartCodePrefix, sizeof(StartCodePrefix));
+            const uint8_t* pl_next = LocateZeroZero(pl_data + 1, pl_size - 1, 0x01, 0x01);
             if (pl_next == nullptr) {
                 // No next start code, current one extends up to the end of the payload.
                 pl_next = pl_data + pl_size;
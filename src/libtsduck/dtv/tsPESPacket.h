@@ -324,6 +324,18 @@ namespace ts {
         //!
         bool hasLongHeader() const;
 
+        //!
+        //! Check if the PES packet contains a Presentation Time Stamp (PTS).
+        //! @return True if the PES packet contains a PTS.
+        //!
+        bool hasPTS() const;
+
+        //!
+        //! Get the Presentation Time Stamp (PTS) of the PES packet.
+        //! @return The PTS or INVALID_PTS if not found.
+        //!
+        uint64_t getPTS() const;
+
         //!
         //! Access to the full binary content of the packet.
         //! Do not modify content.
@@ -386,6 +398,27 @@ namespace ts {
             return _is_valid ? _data->size() - size() : 0;
         }
 
+        //!
+        //! Check if the PES packet is truncated.
+        //! A PESDemux returns truncated PES packets on PID's where the reassembly depth is limited.
+        //! Such packets contain only the first bytes of the original PES packet. The PES header
+        //! is unmodified and the PES_packet_length field still describes the original packet.
+        //! @return True if the PES packet is truncated.
+        //! @see PESDemux::setDepth()
+        //!
+        bool isTruncated() const
+        {
+            return _is_valid && _full_size > _data->size();
+        }
+
+        //!
+        //! Size of the original PES packet, before truncation.
+        //! @return Size of the original PES packet, in bytes. This is the same as size() when
+        //! the packet is not truncated.
+        //! @see isTruncated()
+        //!
+        size_t fullSize() const;
+
         //!
         //! Check if the PES packet contains MPEG-2 video.
         //! Also applies to MPEG-1 video.
@@ -522,10 +555,14 @@ namespace ts {
         uint64_t      _pcr;          // PCR value from TS packets (informational)
         PacketCounter _first_pkt;    // Index of first packet in stream
         PacketCounter _last_pkt;     // Index of last packet in stream
+        size_t        _full_size;    // Size of the original packet when truncated, zero otherwise
         ByteBlockPtr  _data;         // Full binary content of the packet
 
-        // Initialize from a binary content.
-        void initialize(const ByteBlockPtr&);
+        // Truncated packets are built by the PES demux.
+        friend class PESDemux;
+
+        // Initialize from a binary content, possibly truncated from a larger packet of full_size bytes.
+        void initialize(const ByteBlockPtr&, size_t full_size = 0);
 
         // Get the header size of the start of a PES packet. Return 0 on error.
         static size_t HeaderSize(const uint8_t* data, size_t size);
@@ -0,0 +1,385 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsPIDMetrics.h"
+#include "tsGuardCondition.h"
+#include "tsjsonObject.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::PIDMetrics::IPD_BINS;
+constexpr ts::PacketCounter ts::PIDMetrics::DEFAULT_WINDOW;
+constexpr uint16_t ts::PIDMetrics::NO_INDEX;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructors.
+//----------------------------------------------------------------------------
+
+ts::PIDMetrics::PIDMetrics(const PIDSet& pids) :
+    _pids(pids),
+    _labels(),
+    _window(DEFAULT_WINDOW),
+    _total_packets(0),
+    _window_start(0),
+    _ts_bitrate(0),
+    _counters(),
+    _index(),
+    _request(false),
+    _request_reset(false),
+    _ready(false),
+    _writer_buffer(),
+    _shared_buffer(),
+    _reader_buffer(),
+    _mutex(),
+    _published()
+{
+    _index.fill(NO_INDEX);
+}
+
+ts::PIDMetrics::Counters::Counters() :
+    index(0),
+    packets(0),
+    first_packet(0),
+    last_packet(0),
+    window_packets(0),
+    bitrate(0),
+    ipd(),
+    ipd_histogram()
+{
+    ipd_histogram.fill(0);
+}
+
+ts::PIDMetrics::Buffer::Buffer() :
+    labels(false),
+    total_packets(0),
+    ts_bitrate(0),
+    counters()
+{
+}
+
+ts::PIDMetrics::Snapshot::Snapshot() :
+    labels(false),
+    total_packets(0),
+    ts_bitrate(0),
+    categories()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Reset metrics.
+//----------------------------------------------------------------------------
+
+void ts::PIDMetrics::Counters::reset()
+{
+    packets = 0;
+    first_packet = 0;
+    last_packet = 0;
+    window_packets = 0;
+    bitrate = 0;
+    ipd.reset();
+    ipd_histogram.fill(0);
+}
+
+void ts::PIDMetrics::Snapshot::clear()
+{
+    labels = false;
+    total_packets = 0;
+    ts_bitrate = 0;
+    categories.clear();
+}
+
+void ts::PIDMetrics::reset()
+{
+    _total_packets = 0;
+    _window_start = 0;
+    _counters.clear();
+    _index.fill(NO_INDEX);
+}
+
+void ts::PIDMetrics::setPIDFilter(const PIDSet& pids)
+{
+    _pids = pids;
+    _labels.reset();
+    reset();
+}
+
+void ts::PIDMetrics::setLabelFilter(const TSPacketMetadata::LabelSet& labels)
+{
+    _labels = labels;
+    reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Feed the engine with a TS packet.
+//----------------------------------------------------------------------------
+
+void ts::PIDMetrics::feedPacket(const TSPacket& pkt, const TSPacketMetadata& mdata)
+{
+    if (_labels.none()) {
+        const PID pid = pkt.getPID();
+        if (_pids.test(pid)) {
+            feedCategory(pid);
+        }
+    }
+    else if (mdata.hasAnyLabel(_labels)) {
+        for (size_t label = 0; label < _labels.size(); ++label) {
+            if (_labels.test(label) && mdata.hasLabel(label)) {
+                feedCategory(label);
+            }
+        }
+    }
+
+    // Count packets and compute bitrates at the end of each window.
+    if (++_total_packets - _window_start >= _window) {
+        closeWindow();
+    }
+
+    // Serve a snapshot request from a reader thread, if any.
+    if (_request.load(std::memory_order_relaxed)) {
+        publishSnapshot();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Account the current packet in a category.
+//----------------------------------------------------------------------------
+
+void ts::PIDMetrics::feedCategory(size_t index)
+{
+    // Get or create the metrics of this category.
+    if (_index[index] == NO_INDEX) {
+        _index[index] = uint16_t(_counters.size());
+        _counters.emplace_back();
+        _counters.back().index = index;
+    }
+    Counters& cnt(_counters[_index[index]]);
+
+    // Inter-packet distance, starting at the second packet.
+    if (cnt.packets == 0) {
+        cnt.first_packet = _total_packets;
+    }
+    else {
+        const uint64_t distance = _total_packets - cnt.last_packet;
+        cnt.ipd.feed(distance);
+        size_t bin = 0;
+        for (uint64_t d = distance; d > 1 && bin < IPD_BINS - 1; d >>= 1) {
+            bin++;
+        }
+        cnt.ipd_histogram[bin]++;
+    }
+
+    cnt.packets++;
+    cnt.window_packets++;
+    cnt.last_packet = _total_packets;
+}
+
+
+//----------------------------------------------------------------------------
+// Compute rolling bitrates at the end of a window.
+//----------------------------------------------------------------------------
+
+void ts::PIDMetrics::closeWindow()
+{
+    const PacketCounter window = _total_packets - _window_start;
+    for (auto& cnt : _counters) {
+        cnt.bitrate = _ts_bitrate == 0 || window == 0 ? 0 : BitRate((uint64_t(_ts_bitrate) * cnt.window_packets) / window);
+        cnt.window_packets = 0;
+    }
+    _window_start = _total_packets;
+}
+
+
+//----------------------------------------------------------------------------
+// Snapshots.
+//----------------------------------------------------------------------------
+
+void ts::PIDMetrics::BuildSnapshot(Snapshot& snapshot, bool labels, PacketCounter total_packets, BitRate ts_bitrate, const CountersVector& counters)
+{
+    snapshot.clear();
+    snapshot.labels = labels;
+    snapshot.total_packets = total_packets;
+    snapshot.ts_bitrate = ts_bitrate;
+    for (const auto& cnt : counters) {
+        snapshot.categories[cnt.index] = cnt;
+    }
+}
+
+void ts::PIDMetrics::getSnapshot(Snapshot& snapshot, bool reset_metrics)
+{
+    BuildSnapshot(snapshot, _labels.any(), _total_packets, _ts_bitrate, _counters);
+    if (reset_metrics) {
+        reset();
+    }
+}
+
+void ts::PIDMetrics::publishSnapshot()
+{
+    // Copy the metrics outside the mutex. The vector assignment reuses the
+    // capacity of the buffer and does not allocate in the steady state.
+    _writer_buffer.labels = _labels.any();
+    _writer_buffer.total_packets = _total_packets;
+    _writer_buffer.ts_bitrate = _ts_bitrate;
+    _writer_buffer.counters = _counters;
+
+    // Publish the copy. The mutex is held only to swap buffers.
+    bool reset_metrics = false;
+    {
+        GuardCondition lock(_mutex, _published);
+        if (_request) {
+            std::swap(_writer_buffer, _shared_buffer);
+            reset_metrics = _request_reset;
+            _request = false;
+            _ready = true;
+            lock.signal();
+        }
+    }
+    if (reset_metrics) {
+        reset();
+    }
+}
+
+bool ts::PIDMetrics::waitSnapshot(Snapshot& snapshot, MilliSecond timeout, bool reset_metrics)
+{
+    {
+        GuardCondition lock(_mutex, _published);
+
+        // Post the request, served by the writer thread at the next packet.
+        _ready = false;
+        _request_reset = reset_metrics;
+        _request = true;
+
+        while (!_ready && lock.waitCondition(timeout)) {
+        }
+
+        if (!_ready) {
+            // Timeout, cancel the request.
+            _request = false;
+            return false;
+        }
+
+        // Get the published copy without copy, the writer thread will reuse our previous buffer.
+        std::swap(_shared_buffer, _reader_buffer);
+        _ready = false;
+    }
+
+    // Build the snapshot map outside the mutex, in the reader thread.
+    BuildSnapshot(snapshot, _reader_buffer.labels, _reader_buffer.total_packets, _reader_buffer.ts_bitrate, _reader_buffer.counters);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Export the snapshot in a JSON object.
+//----------------------------------------------------------------------------
+
+void ts::PIDMetrics::Snapshot::toJSON(json::Value& root) const
+{
+    root.add(u"packets", total_packets);
+    root.add(u"bitrate", ts_bitrate);
+    json::Value& list(root.query(labels ? u"labels" : u"pids", true, json::TypeArray));
+    for (const auto& it : categories) {
+        const Counters& cnt(it.second);
+        json::ValuePtr jv(new json::Object);
+        jv->add(u"id", cnt.index);
+        jv->add(u"packets", cnt.packets);
+        jv->add(u"first-packet", cnt.first_packet);
+        jv->add(u"last-packet", cnt.last_packet);
+        jv->add(u"bitrate", cnt.bitrate);
+        if (cnt.ipd.count() > 0) {
+            json::Value& ipd(jv->query(u"ipd", true));
+            ipd.add(u"min", cnt.ipd.minimum());
+            ipd.add(u"max", cnt.ipd.maximum());
+            // JSON numbers are integers only, use a decimal string for floating point values.
+            ipd.add(u"mean", cnt.ipd.meanString());
+            ipd.add(u"std-dev", cnt.ipd.standardDeviationString());
+            json::Value& histo(ipd.query(u"histogram", true, json::TypeArray));
+            for (size_t bin = 0; bin < IPD_BINS; ++bin) {
+                histo.set(cnt.ipd_histogram[bin]);
+            }
+        }
+        list.set(jv);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Export the snapshot in Prometheus text exposition format.
+//----------------------------------------------------------------------------
+
+void ts::PIDMetrics::Snapshot::toPrometheus(std::ostream& strm, const UString& prefix) const
+{
+    const UString label(labels ? u"label" : u"pid");
+    const UString cat(labels ? u"label" : u"PID");
+
+    strm << "# HELP " << prefix << "_packets_total Total number of TS packets." << std::endl
+         << "# TYPE " << prefix << "_packets_total counter" << std::endl
+         << prefix << "_packets_total " << total_packets << std::endl
+         << "# HELP " << prefix << "_bitrate TS bitrate in bits/second." << std::endl
+         << "# TYPE " << prefix << "_bitrate gauge" << std::endl
+         << prefix << "_bitrate " << ts_bitrate << std::endl;
+
+    strm << "# HELP " << prefix << "_" << label << "_packets_total Number of TS packets per " << cat << "." << std::endl
+         << "# TYPE " << prefix << "_" << label << "_packets_total counter" << std::endl;
+    for (const auto& it : categories) {
+        strm << prefix << "_" << label << "_packets_total{" << label << "=\"" << it.first << "\"} " << it.second.packets << std::endl;
+    }
+
+    strm << "# HELP " << prefix << "_" << label << "_bitrate Bitrate per " << cat << " in bits/second." << std::endl
+         << "# TYPE " << prefix << "_" << label << "_bitrate gauge" << std::endl;
+    for (const auto& it : categories) {
+        strm << prefix << "_" << label << "_bitrate{" << label << "=\"" << it.first << "\"} " << it.second.bitrate << std::endl;
+    }
+
+    strm << "# HELP " << prefix << "_" << label << "_ipd Inter-packet distance per " << cat << " in packets." << std::endl
+         << "# TYPE " << prefix << "_" << label << "_ipd histogram" << std::endl;
+    for (const auto& it : categories) {
+        const Counters& cnt(it.second);
+        const UString name(UString::Format(u"%s_%s_ipd", {prefix, label}));
+        const UString id(UString::Format(u"%s=\"%d\"", {label, it.first}));
+        PacketCounter count = 0;
+        for (size_t bin = 0; bin < IPD_BINS; ++bin) {
+            count += cnt.ipd_histogram[bin];
+            strm << name << "_bucket{" << id << ",le=\"";
+            if (bin < IPD_BINS - 1) {
+                strm << ((uint64_t(2) << bin) - 1);
+            }
+            else {
+                strm << "+Inf";
+            }
+            strm << "\"} " << count << std::endl;
+        }
+        strm << name << "_sum{" << id << "} " << UString::Float(cnt.ipd.mean() * double(cnt.ipd.count()), 0, 0) << std::endl
+             << name << "_count{" << id << "} " << cnt.ipd.count() << std::endl;
+    }
+}
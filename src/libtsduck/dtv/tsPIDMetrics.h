@@ -0,0 +1,252 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Low-overhead per-PID statistics engine.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsTSPacketMetadata.h"
+#include "tsSingleDataStatistics.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include "tsjsonValue.h"
+#include <atomic>
+
+namespace ts {
+    //!
+    //! Low-overhead per-PID statistics engine.
+    //! @ingroup mpeg
+    //!
+    //! This class collects packet counts, inter-packet distances (with histograms)
+    //! and rolling bitrates, either per PID or per packet label. The packet processing
+    //! thread (the "writer" thread) feeds all packets using feedPacket(). All counters
+    //! are stored in flat arrays and updated with plain stores.
+    //!
+    //! Another thread (the "reader" thread) may collect consistent snapshots of the
+    //! metrics using waitSnapshot(). The reader posts a request which is served by the
+    //! writer thread at the next packet. The writer thread copies its flat array of
+    //! metrics into a preallocated buffer, without waiting for the reader, and exchanges
+    //! buffers with the reader under a mutex. The conversion into a Snapshot map is done
+    //! by the reader thread. The snapshots can be exported in JSON or Prometheus text
+    //! format.
+    //!
+    class TSDUCKDLL PIDMetrics
+    {
+        TS_NOCOPY(PIDMetrics);
+    public:
+        //!
+        //! Number of bins in the inter-packet distance histograms.
+        //! Bin @e n contains the distances in the range 2^n to 2^(n+1)-1.
+        //! The last bin contains all larger distances.
+        //!
+        static constexpr size_t IPD_BINS = 16;
+
+        //!
+        //! Default size in packets of the window for rolling bitrates.
+        //!
+        static constexpr PacketCounter DEFAULT_WINDOW = 10000;
+
+        //!
+        //! Metrics of one category of packets (PID or label).
+        //!
+        class TSDUCKDLL Counters
+        {
+        public:
+            Counters();                     //!< Constructor.
+            void reset();                   //!< Reset all counters.
+            size_t        index;            //!< PID or label.
+            PacketCounter packets;          //!< Total number of packets.
+            PacketCounter first_packet;     //!< Index of the first packet in the stream.
+            PacketCounter last_packet;      //!< Index of the last packet in the stream.
+            PacketCounter window_packets;   //!< Number of packets in the current bitrate window.
+            BitRate       bitrate;          //!< Bitrate over the last complete window, zero if unknown.
+            SingleDataStatistics<uint64_t> ipd;                   //!< Inter-packet distance statistics.
+            std::array<PacketCounter, IPD_BINS> ipd_histogram;    //!< Inter-packet distance histogram.
+        };
+
+        //!
+        //! Map of metrics, indexed by PID or label.
+        //!
+        typedef std::map<size_t, Counters> CountersMap;
+
+        //!
+        //! Snapshot of the metrics.
+        //!
+        class TSDUCKDLL Snapshot
+        {
+        public:
+            Snapshot();                     //!< Constructor.
+            void clear();                   //!< Clear the content of the snapshot.
+            bool          labels;           //!< The categories are labels, not PID's.
+            PacketCounter total_packets;    //!< Total number of packets in the stream.
+            BitRate       ts_bitrate;       //!< Last known TS bitrate, zero if unknown.
+            CountersMap   categories;       //!< Metrics of all categories with packets.
+
+            //!
+            //! Export the snapshot in a JSON object.
+            //! @param [in,out] root JSON object where the metrics are added.
+            //!
+            void toJSON(json::Value& root) const;
+
+            //!
+            //! Export the snapshot in Prometheus text exposition format.
+            //! @param [in,out] strm Output text stream.
+            //! @param [in] prefix Prefix of all metric names.
+            //!
+            void toPrometheus(std::ostream& strm, const UString& prefix = u"tsduck") const;
+        };
+
+        //!
+        //! Constructor.
+        //! @param [in] pids Set of PID's to analyze.
+        //!
+        explicit PIDMetrics(const PIDSet& pids = AllPIDs);
+
+        //!
+        //! Set the PID's to analyze.
+        //! Must be called from the writer thread or when no packet is processed.
+        //! Also reset all metrics.
+        //! @param [in] pids Set of PID's to analyze.
+        //!
+        void setPIDFilter(const PIDSet& pids);
+
+        //!
+        //! Analyze packets labels instead of PID's.
+        //! Must be called from the writer thread or when no packet is processed.
+        //! Also reset all metrics.
+        //! @param [in] labels Set of labels to analyze. If empty, analyze PID's again.
+        //!
+        void setLabelFilter(const TSPacketMetadata::LabelSet& labels);
+
+        //!
+        //! Set the size of the window for rolling bitrates.
+        //! @param [in] packets Size of the window in packets.
+        //!
+        void setBitrateWindow(PacketCounter packets) { _window = std::max<PacketCounter>(1, packets); }
+
+        //!
+        //! Set the current TS bitrate.
+        //! Must be called from the writer thread.
+        //! @param [in] bitrate Current TS bitrate, zero if unknown.
+        //!
+        void setBitrate(BitRate bitrate) { _ts_bitrate = bitrate; }
+
+        //!
+        //! Reset all metrics.
+        //! Must be called from the writer thread or when no packet is processed.
+        //!
+        void reset();
+
+        //!
+        //! Feed the engine with a TS packet.
+        //! Must be called from the writer thread.
+        //! @param [in] pkt A TS packet.
+        //! @param [in] mdata Packet metadata, used when labels are analyzed.
+        //!
+        void feedPacket(const TSPacket& pkt, const TSPacketMetadata& mdata);
+
+        //!
+        //! Feed the engine with a TS packet without metadata.
+        //! Must be called from the writer thread.
+        //! @param [in] pkt A TS packet.
+        //!
+        void feedPacket(const TSPacket& pkt) { feedPacket(pkt, TSPacketMetadata()); }
+
+        //!
+        //! Get a snapshot of the metrics, directly from the writer thread.
+        //! Must be called from the writer thread or when no packet is processed.
+        //! @param [out] snapshot Returned snapshot.
+        //! @param [in] reset If true, reset the metrics after the snapshot.
+        //!
+        void getSnapshot(Snapshot& snapshot, bool reset = false);
+
+        //!
+        //! Get a snapshot of the metrics from a reader thread.
+        //! The metrics are copied by the writer thread when it processes the next packet.
+        //! Only one reader thread at a time may call this method.
+        //! @param [out] snapshot Returned snapshot.
+        //! @param [in] timeout Maximum time to wait for the writer thread.
+        //! @param [in] reset If true, the writer thread resets the metrics after the snapshot.
+        //! @return True on success, false on timeout (no packet was processed).
+        //!
+        bool waitSnapshot(Snapshot& snapshot, MilliSecond timeout = Infinite, bool reset = false);
+
+    private:
+        typedef std::vector<Counters> CountersVector;
+        typedef std::array<uint16_t, PID_MAX> IndexArray;
+        static constexpr uint16_t NO_INDEX = 0xFFFF;
+
+        // Accessed by the writer thread only.
+        PIDSet                     _pids;           // PID's to analyze.
+        TSPacketMetadata::LabelSet _labels;         // Labels to analyze, if any.
+        PacketCounter              _window;         // Bitrate window size in packets.
+        PacketCounter              _total_packets;  // Total number of packets.
+        PacketCounter              _window_start;   // First packet of current bitrate window.
+        BitRate                    _ts_bitrate;     // TS bitrate.
+        CountersVector             _counters;       // Flat array of metrics of active categories.
+        IndexArray                 _index;          // Index of each PID or label in _counters.
+
+        // Flat copy of the metrics, exchanged between the writer and reader threads.
+        // The buffers are swapped, never reallocated once they reached their maximum size.
+        class Buffer
+        {
+        public:
+            Buffer();
+            bool           labels;
+            PacketCounter  total_packets;
+            BitRate        ts_bitrate;
+            CountersVector counters;
+        };
+
+        // Snapshot exchange with the reader thread.
+        std::atomic<bool> _request;        // A reader thread requested a snapshot.
+        bool              _request_reset;  // Reset metrics after snapshot.
+        bool              _ready;          // The published buffer is ready.
+        Buffer            _writer_buffer;  // Copy of the metrics, owned by the writer thread.
+        Buffer            _shared_buffer;  // Published copy of the metrics, protected by the mutex.
+        Buffer            _reader_buffer;  // Copy of the metrics, owned by the reader thread.
+        Mutex             _mutex;          // Protect the snapshot exchange.
+        Condition         _published;      // Signaled when a snapshot is ready.
+
+        // Account a packet in a category.
+        void feedCategory(size_t index);
+
+        // Compute rolling bitrates at the end of a window.
+        void closeWindow();
+
+        // Build a snapshot from a flat array of metrics.
+        static void BuildSnapshot(Snapshot& snapshot, bool labels, PacketCounter total_packets, BitRate ts_bitrate, const CountersVector& counters);
+
+        // Serve a pending snapshot request.
+        void publishSnapshot();
+    };
+}
@@ -65,6 +65,7 @@ ts::PSILogger::PSILogger(TablesDisplay& display) :
     _duck(_display.duck()),
     _report(_duck.report()),
     _xml_doc(_report),
+    _line_writer(),
     _abort(false),
     _pat_ok(_cat_only),
     _cat_ok(_clear),
@@ -507,16 +508,10 @@ void ts::PSILogger::displayTable(const BinaryTable& table)
         // Convert the table into an XML structure.
         xml::Element* elem = table.toXML(_duck, doc.rootElement(), xml_opt);
         if (elem != nullptr) {
-            // Initialize a text formatter for one-liner.
-            TextFormatter text(_report);
-            text.setString();
-            text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
-
-            // Serialize the XML object inside the text formatter.
-            doc.print(text);
-
-            // Log the XML line.
-            _report.info(_log_xml_prefix + text.toString());
+            // Serialize the XML document directly in UTF-8 and log the XML line.
+            _line_writer.reset();
+            _line_writer.write(doc);
+            _report.info(_log_xml_prefix + _line_writer.toString());
         }
     }
 }
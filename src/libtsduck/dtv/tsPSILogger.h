@@ -38,6 +38,7 @@
 #include "tsSectionDemux.h"
 #include "tsTextFormatter.h"
 #include "tsxmlRunningDocument.h"
+#include "tsxmlStreamWriter.h"
 
 namespace ts {
     //!
@@ -128,6 +129,7 @@ namespace ts {
         DuckContext&         _duck;
         Report&              _report;
         xml::RunningDocument _xml_doc;       // XML root document.
+        xml::StreamWriter    _line_writer;   // Serializer of XML one-liners.
         bool                 _abort;
         bool                 _pat_ok;        // Got a PAT
         bool                 _cat_ok;        // Got a CAT or not interested in CAT
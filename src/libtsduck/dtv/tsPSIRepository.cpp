@@ -30,8 +30,8 @@
 #include "tsPSIRepository.h"
 #include "tsDuckContext.h"
 #include "tsVersionInfo.h"
-#include "tsAlgorithm.h"
 #include "tsNames.h"
+#include "tsGuard.h"
 TSDUCK_SOURCE;
 
 TS_DEFINE_SINGLETON(ts::PSIRepository);
@@ -42,15 +42,34 @@ TS_DEFINE_SINGLETON(ts::PSIRepository);
 //----------------------------------------------------------------------------
 
 ts::PSIRepository::PSIRepository() :
-    _tables(),
-    _descriptors(),
-    _tableNames(),
-    _descriptorNames(),
-    _descriptorTablesIds(),
-    _casIdDescriptorDisplays(),
+    _mutex(),
+    _tableRegs(),
+    _tidPool(),
+    _descriptorRegs(),
+    _casRegs(),
+    _namePool(),
     _xmlModelFiles(),
-    _namesFiles()
+    _namesFiles(),
+    _dirty(true),
+    _indexes(nullptr),
+    _allIndexes()
 {
+    // Avoid reallocations during the static registration of all tables and descriptors.
+    _tableRegs.reserve(256);
+    _tidPool.reserve(512);
+    _descriptorRegs.reserve(1024);
+}
+
+ts::PSIRepository::Indexes::Indexes() :
+    tables(),
+    tableIndex(),
+    descriptors(),
+    tableNames(),
+    descriptorNames(),
+    descriptorTablesIds(),
+    casDisplays()
+{
+    tableIndex.fill(0);
 }
 
 ts::PSIRepository::TableDescription::TableDescription() :
@@ -67,9 +86,20 @@ ts::PSIRepository::TableDescription::TableDescription() :
     }
 }
 
-ts::PSIRepository::DescriptorDescription::DescriptorDescription(DescriptorFactory fact, DisplayDescriptorFunction disp) :
+ts::PSIRepository::DescriptorDescription::DescriptorDescription(const EDID& id, DescriptorFactory fact, DisplayDescriptorFunction disp, const UChar* name, const UChar* legacy) :
+    edid(id),
     factory(fact),
-    display(disp)
+    display(disp),
+    xmlName(name),
+    xmlLegacy(legacy)
+{
+}
+
+template <typename VALUE>
+ts::PSIRepository::NameEntry<VALUE>::NameEntry(const UChar* n, VALUE v) :
+    key(n == nullptr ? UString() : NameKey(n)),
+    name(n),
+    value(v)
 {
 }
 
@@ -111,6 +141,125 @@ void ts::PSIRepository::TableDescription::addPIDs(const std::initializer_list<PI
 }
 
 
+//----------------------------------------------------------------------------
+// Build the key of a name index: "similar" names have identical keys.
+//----------------------------------------------------------------------------
+
+ts::UString ts::PSIRepository::NameKey(const UString& name)
+{
+    UString key;
+    key.reserve(name.size());
+    for (size_t i = 0; i < name.size(); ++i) {
+        if (!IsSpace(name[i])) {
+            key.push_back(ToLower(name[i]));
+        }
+    }
+    return key;
+}
+
+
+//----------------------------------------------------------------------------
+// Find the range of entries with a "similar" name in a name index.
+//----------------------------------------------------------------------------
+
+template <typename VALUE>
+std::pair<typename std::vector<ts::PSIRepository::NameEntry<VALUE>>::const_iterator, typename std::vector<ts::PSIRepository::NameEntry<VALUE>>::const_iterator>
+    ts::PSIRepository::FindSimilar(const std::vector<NameEntry<VALUE>>& index, const UString& name)
+{
+    NameEntry<VALUE> ref;
+    ref.key = NameKey(name);
+    return std::equal_range(index.begin(), index.end(), ref);
+}
+
+
+//----------------------------------------------------------------------------
+// Copy an XML name in the repository.
+//----------------------------------------------------------------------------
+
+const ts::UChar* ts::PSIRepository::storeName(const UChar* name)
+{
+    if (name == nullptr || name[0] == CHAR_NULL) {
+        return nullptr;
+    }
+    _namePool.push_back(UString(name));
+    return _namePool.back().c_str();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the lookup indexes, rebuild them if new items were registered.
+//----------------------------------------------------------------------------
+
+const ts::PSIRepository::Indexes& ts::PSIRepository::indexes() const
+{
+    // Fast path, no lock, when the indexes are up to date.
+    if (!_dirty.load(std::memory_order_acquire)) {
+        return *_indexes.load(std::memory_order_acquire);
+    }
+
+    Guard lock(_mutex);
+
+    // Check again, another thread may have rebuilt the indexes while we waited for the mutex.
+    if (!_dirty.load(std::memory_order_relaxed)) {
+        return *_indexes.load(std::memory_order_relaxed);
+    }
+
+    // Build new indexes. The previous ones may still be in use by other threads, don't touch them.
+    _allIndexes.emplace_back();
+    Indexes& idx(_allIndexes.back());
+
+    // Table descriptions: counting sort by table id, keeping the registration order for each table id.
+    for (const auto& reg : _tableRegs) {
+        for (size_t i = 0; i < reg.tidCount; ++i) {
+            idx.tableIndex[_tidPool[reg.tidIndex + i] + 1]++;
+        }
+    }
+    for (size_t tid = 1; tid < idx.tableIndex.size(); ++tid) {
+        idx.tableIndex[tid] += idx.tableIndex[tid - 1];
+    }
+    std::array<size_t,257> next(idx.tableIndex);
+    idx.tables.resize(idx.tableIndex.back());
+    for (const auto& reg : _tableRegs) {
+        for (size_t i = 0; i < reg.tidCount; ++i) {
+            idx.tables[next[_tidPool[reg.tidIndex + i]]++] = reg.desc;
+        }
+        if (reg.xmlName != nullptr && reg.xmlName[0] != CHAR_NULL) {
+            idx.tableNames.push_back(NameEntry<TableFactory>(reg.xmlName, reg.desc.factory));
+        }
+    }
+
+    // Descriptors: only one description per extended id, the first registration wins.
+    idx.descriptors = _descriptorRegs;
+    std::stable_sort(idx.descriptors.begin(), idx.descriptors.end(), [](const DescriptorDescription& a, const DescriptorDescription& b) { return a.edid < b.edid; });
+    idx.descriptors.erase(std::unique(idx.descriptors.begin(), idx.descriptors.end(), [](const DescriptorDescription& a, const DescriptorDescription& b) { return a.edid == b.edid; }), idx.descriptors.end());
+
+    // XML names of descriptors. Table-specific descriptors are recorded in all registrations.
+    for (const auto& reg : _descriptorRegs) {
+        for (const UChar* name : {reg.xmlName, reg.xmlLegacy}) {
+            if (name != nullptr && name[0] != CHAR_NULL) {
+                idx.descriptorNames.push_back(NameEntry<DescriptorFactory>(name, reg.factory));
+                if (reg.edid.isTableSpecific()) {
+                    idx.descriptorTablesIds.push_back(NameEntry<TID>(name, reg.edid.tableId()));
+                }
+            }
+        }
+    }
+
+    // CA_descriptor display functions, searched in registration order.
+    idx.casDisplays = _casRegs;
+
+    // Sort name indexes. Keep the first registration of each name.
+    std::stable_sort(idx.tableNames.begin(), idx.tableNames.end());
+    std::stable_sort(idx.descriptorNames.begin(), idx.descriptorNames.end());
+    std::stable_sort(idx.descriptorTablesIds.begin(), idx.descriptorTablesIds.end());
+
+    // Publish the new indexes.
+    _indexes.store(&idx, std::memory_order_release);
+    _dirty.store(false, std::memory_order_release);
+    return idx;
+}
+
+
 //----------------------------------------------------------------------------
 // Lookup a table function by table id, using standards and CAS id.
 //----------------------------------------------------------------------------
@@ -123,29 +272,32 @@ FUNCTION ts::PSIRepository::getTableFunction(TID tid, Standards standards, PID p
     FUNCTION fallbackFunc = nullptr;
     size_t fallbackCount = 0;
 
+    const Indexes& idx(indexes());
+
     // Look for an exact match.
-    for (auto it = _tables.lower_bound(tid); it != _tables.end() && it->first == tid; ++it) {
+    for (size_t i = idx.tableIndex[tid]; i < idx.tableIndex[tid + 1]; ++i) {
+        const TableDescription& desc(idx.tables[i]);
         // Ignore entris for which the searched function is not present.
-        if (it->second.*member != nullptr) {
+        if (desc.*member != nullptr) {
 
             // If the table in a standard PID, this is an exact match.
-            if (it->second.hasPID(pid)) {
-                return it->second.*member;
+            if (desc.hasPID(pid)) {
+                return desc.*member;
             }
 
             // CAS match: either a CAS is specified and is in range, or no CAS specified and CAS-agnostic table (all CASID_NULL).
-            const bool casMatch = cas >= it->second.minCAS && cas <= it->second.maxCAS;
+            const bool casMatch = cas >= desc.minCAS && cas <= desc.maxCAS;
 
             // Standard match: at least one standard of the table is current, or standard-agnostic table (Standards::NONE).
-            const bool stdMatch = (standards & it->second.standards) != Standards::NONE || it->second.standards == Standards::NONE;
+            const bool stdMatch = (standards & desc.standards) != Standards::NONE || desc.standards == Standards::NONE;
 
             if (stdMatch && casMatch) {
                 // Found an exact match, no need to search further.
-                return it->second.*member;
+                return desc.*member;
             }
-            else if (it->second.minCAS == CASID_NULL) {
+            else if (desc.minCAS == CASID_NULL) {
                 // Not the right standard but a CAS-agnostic table, use as potential fallback.
-                fallbackFunc = it->second.*member;
+                fallbackFunc = desc.*member;
                 fallbackCount++;
             }
         }
@@ -163,22 +315,31 @@ FUNCTION ts::PSIRepository::getTableFunction(TID tid, Standards standards, PID p
 template <typename FUNCTION, typename std::enable_if<std::is_pointer<FUNCTION>::value>::type*>
 FUNCTION ts::PSIRepository::getDescriptorFunction(const EDID& edid, TID tid, FUNCTION DescriptorDescription::* member) const
 {
-    auto it(_descriptors.end());
+    const Indexes& idx(indexes());
+    const auto end = idx.descriptors.end();
+
+    // Binary search of an extended descriptor id.
+    const auto find = [&idx, end](const EDID& id) {
+        const auto it = std::lower_bound(idx.descriptors.begin(), end, id, [](const DescriptorDescription& desc, const EDID& e) { return desc.edid < e; });
+        return it != end && it->edid == id ? it : end;
+    };
+
+    auto it(end);
 
     if (edid.isStandard() && tid != TID_NULL) {
         // For standard descriptors, first search a table-specific descriptor.
-        it = _descriptors.find(EDID::TableSpecific(edid.did(), tid));
+        it = find(EDID::TableSpecific(edid.did(), tid));
         // If not found and there is a table-specific name for the descriptor,
         // do not fallback to non-table-specific function for this descriptor.
-        if (it == _descriptors.end() && (edid.isTableSpecific() || names::HasTableSpecificName(edid.did(), tid))) {
+        if (it == end && (edid.isTableSpecific() || names::HasTableSpecificName(edid.did(), tid))) {
             return nullptr;
         }
     }
-    if (it == _descriptors.end()) {
+    if (it == end) {
         // If non-standard or no table-specific descriptor found, use direct lookup.
-        it = _descriptors.find(edid);
+        it = find(edid);
     }
-    return it != _descriptors.end() ? it->second.*member : nullptr;
+    return it != end ? (*it).*member : nullptr;
 }
 
 
@@ -190,7 +351,9 @@ ts::PSIRepository::RegisterXML::RegisterXML(int libversion, const UString& filen
 {
     CERR.debug(u"registering XML file %s", {filename});
     if (VersionInfo::CheckLibraryVersion(libversion)) {
-        PSIRepository::Instance()->_xmlModelFiles.push_back(filename);
+        PSIRepository* const repo = PSIRepository::Instance();
+        Guard lock(repo->_mutex);
+        repo->_xmlModelFiles.push_back(filename);
     }
 }
 
@@ -198,7 +361,9 @@ ts::PSIRepository::RegisterNames::RegisterNames(int libversion, const UString& f
 {
     CERR.debug(u"registering names file %s", {filename});
     if (VersionInfo::CheckLibraryVersion(libversion)) {
-        PSIRepository::Instance()->_namesFiles.push_back(filename);
+        PSIRepository* const repo = PSIRepository::Instance();
+        Guard lock(repo->_mutex);
+        repo->_namesFiles.push_back(filename);
     }
 }
 
@@ -207,43 +372,39 @@ ts::PSIRepository::RegisterNames::RegisterNames(int libversion, const UString& f
 // Constructors to register a fully or partially implemented table.
 //----------------------------------------------------------------------------
 
-ts::PSIRepository::RegisterTable::RegisterTable(int libversion,
+void ts::PSIRepository::RegisterTable::Register(int libversion,
                                                 TableFactory factory,
                                                 const std::vector<TID>& tids,
                                                 Standards standards,
-                                                const UString& xmlName,
+                                                const UChar* xmlName,
+                                                bool copyName,
                                                 DisplaySectionFunction displayFunction,
                                                 LogSectionFunction logFunction,
                                                 const std::initializer_list<PID>& pids,
                                                 uint16_t minCAS,
                                                 uint16_t maxCAS)
 {
-    CERR.log(2, u"registering table <%s>", {xmlName});
-
     if (VersionInfo::CheckLibraryVersion(libversion)) {
 
         PSIRepository* const repo = PSIRepository::Instance();
-
-        // XML names are recorded independently.
-        if (!xmlName.empty()) {
-            repo->_tableNames.insert(std::make_pair(xmlName, factory));
-        }
-
-        // Build a table description for this table.
-        TableDescription desc;
-        desc.standards = standards;
-        desc.minCAS = minCAS;
-        desc.maxCAS = maxCAS;
-        desc.factory = factory;
-        desc.display = displayFunction;
-        desc.log = logFunction;
-        desc.addPIDs(pids);
-
-        // Store a copy of the table description for each table id.
-        // This is a multimap, distinct definitions for the same table id accumulate.
-        for (auto it = tids.begin(); it != tids.end(); ++it) {
-            PSIRepository::Instance()->_tables.insert(std::make_pair(*it, desc));
-        }
+        Guard lock(repo->_mutex);
+
+        // Build a table registration. The indexes will be built later, when needed.
+        TableRegistration reg;
+        reg.desc.standards = standards;
+        reg.desc.minCAS = minCAS;
+        reg.desc.maxCAS = maxCAS;
+        reg.desc.factory = factory;
+        reg.desc.display = displayFunction;
+        reg.desc.log = logFunction;
+        reg.desc.addPIDs(pids);
+        reg.xmlName = copyName ? repo->storeName(xmlName) : xmlName;
+        reg.tidIndex = repo->_tidPool.size();
+        reg.tidCount = tids.size();
+
+        repo->_tidPool.insert(repo->_tidPool.end(), tids.begin(), tids.end());
+        repo->_tableRegs.push_back(reg);
+        repo->invalidateIndexes();
     }
 }
 
@@ -256,8 +417,7 @@ ts::PSIRepository::RegisterTable::RegisterTable(int libversion,
                                                 uint16_t minCAS,
                                                 uint16_t maxCAS)
 {
-    // Use the complete constructor for actual registration.
-    RegisterTable reg(libversion, nullptr, tids, standards, UString(), displayFunction, logFunction, pids, minCAS, maxCAS);
+    Register(libversion, nullptr, tids, standards, nullptr, false, displayFunction, logFunction, pids, minCAS, maxCAS);
 }
 
 
@@ -265,34 +425,23 @@ ts::PSIRepository::RegisterTable::RegisterTable(int libversion,
 // Constructors to register a fully or partially implemented descriptor.
 //----------------------------------------------------------------------------
 
-ts::PSIRepository::RegisterDescriptor::RegisterDescriptor(int libversion,
-                                                          DescriptorFactory factory,
-                                                          const EDID& edid,
-                                                          const UString& xmlName,
-                                                          DisplayDescriptorFunction displayFunction,
-                                                          const UString& xmlNameLegacy)
+void ts::PSIRepository::RegisterDescriptor::Register(int libversion,
+                                                     DescriptorFactory factory,
+                                                     const EDID& edid,
+                                                     const UChar* xmlName,
+                                                     DisplayDescriptorFunction displayFunction,
+                                                     const UChar* xmlNameLegacy,
+                                                     bool copyNames)
 {
     if (VersionInfo::CheckLibraryVersion(libversion)) {
-        registerXML(factory, edid, xmlName, xmlNameLegacy);
-        PSIRepository::Instance()->_descriptors.insert(std::make_pair(edid, DescriptorDescription(factory, displayFunction)));
-    }
-}
-
-void ts::PSIRepository::RegisterDescriptor::registerXML(DescriptorFactory factory, const EDID& edid, const UString& xmlName, const UString& xmlNameLegacy)
-{
-    PSIRepository* const repo = PSIRepository::Instance();
-
-    if (!xmlName.empty()) {
-        repo->_descriptorNames.insert(std::make_pair(xmlName, factory));
-        if (edid.isTableSpecific()) {
-            repo->_descriptorTablesIds.insert(std::make_pair(xmlName, edid.tableId()));
-        }
-    }
-    if (!xmlNameLegacy.empty()) {
-        repo->_descriptorNames.insert(std::make_pair(xmlNameLegacy, factory));
-        if (edid.isTableSpecific()) {
-            repo->_descriptorTablesIds.insert(std::make_pair(xmlNameLegacy, edid.tableId()));
+        PSIRepository* const repo = PSIRepository::Instance();
+        Guard lock(repo->_mutex);
+        if (copyNames) {
+            xmlName = repo->storeName(xmlName);
+            xmlNameLegacy = repo->storeName(xmlNameLegacy);
         }
+        repo->_descriptorRegs.push_back(DescriptorDescription(edid, factory, displayFunction, xmlName, xmlNameLegacy));
+        repo->invalidateIndexes();
     }
 }
 
@@ -300,9 +449,9 @@ ts::PSIRepository::RegisterDescriptor::RegisterDescriptor(int libversion, Displa
 {
     if (displayFunction != nullptr && VersionInfo::CheckLibraryVersion(libversion)) {
         PSIRepository* const repo = PSIRepository::Instance();
-        do {
-            repo->_casIdDescriptorDisplays.insert(std::make_pair(minCAS, displayFunction));
-        } while (minCAS++ < maxCAS);
+        Guard lock(repo->_mutex);
+        repo->_casRegs.push_back(CADescriptorRegistration(minCAS, std::max(minCAS, maxCAS), displayFunction));
+        repo->invalidateIndexes();
     }
 }
 
@@ -328,14 +477,16 @@ ts::LogSectionFunction ts::PSIRepository::getSectionLog(TID id, Standards standa
 
 ts::PSIRepository::TableFactory ts::PSIRepository::getTableFactory(const UString& node_name) const
 {
-    const auto it = node_name.findSimilar(_tableNames);
-    return it != _tableNames.end() ? it->second : nullptr;
+    const Indexes& idx(indexes());
+    const auto range = FindSimilar(idx.tableNames, node_name);
+    return range.first != range.second ? range.first->value : nullptr;
 }
 
 ts::PSIRepository::DescriptorFactory ts::PSIRepository::getDescriptorFactory(const UString& node_name) const
 {
-    const auto it = node_name.findSimilar(_descriptorNames);
-    return it != _descriptorNames.end() ? it->second : nullptr;
+    const Indexes& idx(indexes());
+    const auto range = FindSimilar(idx.descriptorNames, node_name);
+    return range.first != range.second ? range.first->value : nullptr;
 }
 
 ts::PSIRepository::DescriptorFactory ts::PSIRepository::getDescriptorFactory(const EDID& edid, TID tid) const
@@ -350,8 +501,14 @@ ts::DisplayDescriptorFunction ts::PSIRepository::getDescriptorDisplay(const EDID
 
 ts::DisplayCADescriptorFunction ts::PSIRepository::getCADescriptorDisplay(uint16_t cas_id) const
 {
-    const auto it = _casIdDescriptorDisplays.find(cas_id);
-    return it != _casIdDescriptorDisplays.end() ? it->second : nullptr;
+    // Very few CAS registrations, a linear search in registration order is sufficient.
+    const Indexes& idx(indexes());
+    for (const auto& reg : idx.casDisplays) {
+        if (cas_id >= reg.minCAS && cas_id <= reg.maxCAS) {
+            return reg.display;
+        }
+    }
+    return nullptr;
 }
 
 
@@ -363,18 +520,20 @@ ts::Standards ts::PSIRepository::getTableStandards(TID tid, PID pid) const
 {
     // Accumulate the common subset of all standards for this table id.
     Standards standards = Standards::NONE;
-    for (auto it = _tables.lower_bound(tid); it != _tables.end() && it->first == tid; ++it) {
-        if (it->second.hasPID(pid)) {
+    const Indexes& idx(indexes());
+    for (size_t i = idx.tableIndex[tid]; i < idx.tableIndex[tid + 1]; ++i) {
+        const TableDescription& desc(idx.tables[i]);
+        if (desc.hasPID(pid)) {
             // We are in a standard PID for this table id, return the corresponding standards only.
-            return it->second.standards;
+            return desc.standards;
         }
         else if (standards == Standards::NONE) {
             // No standard found yet, use all standards from first definition.
-            standards = it->second.standards;
+            standards = desc.standards;
         }
         else {
             // Some standards were already found, keep only the common subset.
-            standards &= it->second.standards;
+            standards &= desc.standards;
         }
     }
     return standards;
@@ -387,19 +546,20 @@ ts::Standards ts::PSIRepository::getTableStandards(TID tid, PID pid) const
 
 bool ts::PSIRepository::isDescriptorAllowed(const UString& desc_node_name, TID table_id) const
 {
-    auto it = desc_node_name.findSimilar(_descriptorTablesIds);
-    if (it == _descriptorTablesIds.end()) {
+    const Indexes& idx(indexes());
+    const auto range = FindSimilar(idx.descriptorTablesIds, desc_node_name);
+    if (range.first == range.second) {
         // Not a table-specific descriptor, allowed anywhere
         return true;
     }
     else {
         // Table specific descriptor, the table needs to be listed.
-        do {
-            if (table_id == it->second) {
+        for (auto it = range.first; it != range.second; ++it) {
+            if (table_id == it->value) {
                 // The table is explicitly allowed.
                 return true;
             }
-        } while (++it != _descriptorTablesIds.end() && desc_node_name.similar(it->first));
+        }
         // The requested table if was not found.
         return false;
     }
@@ -412,15 +572,15 @@ bool ts::PSIRepository::isDescriptorAllowed(const UString& desc_node_name, TID t
 
 ts::UString ts::PSIRepository::descriptorTables(const DuckContext& duck, const UString& desc_node_name) const
 {
-    auto it = desc_node_name.findSimilar(_descriptorTablesIds);
+    const Indexes& idx(indexes());
+    const auto range = FindSimilar(idx.descriptorTablesIds, desc_node_name);
     UString result;
 
-    while (it != _descriptorTablesIds.end() && desc_node_name.similar(it->first)) {
+    for (auto it = range.first; it != range.second; ++it) {
         if (!result.empty()) {
             result.append(u", ");
         }
-        result.append(names::TID(duck, it->second, CASID_NULL, names::NAME | names::HEXA));
-        ++it;
+        result.append(names::TID(duck, it->value, CASID_NULL, names::NAME | names::HEXA));
     }
 
     return result;
@@ -434,12 +594,10 @@ ts::UString ts::PSIRepository::descriptorTables(const DuckContext& duck, const U
 void ts::PSIRepository::getRegisteredTableIds(std::vector<TID>& ids) const
 {
     ids.clear();
-    TID previous = TID_NULL;
-    for (auto it = _tables.begin(); it != _tables.end(); ++it) {
-        // This is a multimap, the same key can be reused, use it once only.
-        if (it->first != previous) {
-            ids.push_back(it->first);
-            previous = it->first;
+    const Indexes& idx(indexes());
+    for (size_t tid = 0; tid < idx.tableIndex.size() - 1; ++tid) {
+        if (idx.tableIndex[tid] < idx.tableIndex[tid + 1]) {
+            ids.push_back(TID(tid));
         }
     }
 }
@@ -447,27 +605,58 @@ void ts::PSIRepository::getRegisteredTableIds(std::vector<TID>& ids) const
 void ts::PSIRepository::getRegisteredDescriptorIds(std::vector<EDID>& ids) const
 {
     ids.clear();
-    for (auto it = _descriptors.begin(); it != _descriptors.end(); ++it) {
-        ids.push_back(it->first);
+    const Indexes& idx(indexes());
+    for (const auto& desc : idx.descriptors) {
+        ids.push_back(desc.edid);
+    }
+}
+
+// Get the sorted list of unique names in a name index.
+template <typename VALUE>
+void ts::PSIRepository::GetNames(UStringList& names, const std::vector<NameEntry<VALUE>>& index)
+{
+    std::set<UString> sorted;
+    for (const auto& entry : index) {
+        sorted.insert(entry.name);
     }
+    names.assign(sorted.begin(), sorted.end());
 }
 
 void ts::PSIRepository::getRegisteredTableNames(UStringList& names) const
 {
-    names = MapKeys(_tableNames);
+    const Indexes& idx(indexes());
+    GetNames(names, idx.tableNames);
 }
 
 void ts::PSIRepository::getRegisteredDescriptorNames(UStringList& names) const
 {
-    names = MapKeys(_descriptorNames);
+    const Indexes& idx(indexes());
+    GetNames(names, idx.descriptorNames);
 }
 
 void ts::PSIRepository::getRegisteredTablesModels(UStringList& names) const
 {
+    Guard lock(_mutex);
     names = _xmlModelFiles;
 }
 
 void ts::PSIRepository::getRegisteredNamesFiles(UStringList &names) const
 {
+    Guard lock(_mutex);
     names = _namesFiles;
 }
+
+
+//----------------------------------------------------------------------------
+// Remove all registrations of a descriptor.
+//----------------------------------------------------------------------------
+
+void ts::PSIRepository::unregisterDescriptor(const EDID& edid)
+{
+    Guard lock(_mutex);
+    const auto end = std::remove_if(_descriptorRegs.begin(), _descriptorRegs.end(), [&edid](const DescriptorDescription& desc) { return desc.edid == edid; });
+    if (end != _descriptorRegs.end()) {
+        _descriptorRegs.erase(end, _descriptorRegs.end());
+        invalidateIndexes();
+    }
+}
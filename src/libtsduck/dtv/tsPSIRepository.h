@@ -38,6 +38,8 @@
 #include "tsTablesPtr.h"
 #include "tsSingletonManager.h"
 #include "tsLibraryVersion.h"
+#include "tsMutex.h"
+#include <atomic>
 
 namespace ts {
 
@@ -53,7 +55,18 @@ namespace ts {
     //! Multi-threading considerations: The singleton is built and modified using static
     //! registration instances during the initialization of the application (ie. in one
     //! single thread). Then, the singleton is only read during the execution of the
-    //! application. So, no explicit synchronization is required.
+    //! application.
+    //!
+    //! Registration is kept as cheap as possible because it is executed by all applications,
+    //! even short-lived ones which never use most tables and descriptors. Each registration
+    //! only appends a compact record, without building strings or map nodes. The lookup
+    //! indexes (by table id, descriptor id, XML name) are built on first use and rebuilt
+    //! after new registrations (typically when a shared library is loaded).
+    //!
+    //! The indexes are built under a mutex into a new immutable structure which is then
+    //! published using an atomic pointer. Lookups take no lock when no registration occurred
+    //! since the last build. A lookup which runs concurrently with a rebuild keeps using the
+    //! previous indexes. Previous indexes are never freed before the repository itself.
     //!
     //! @ingroup mpeg
     //!
@@ -221,6 +234,14 @@ namespace ts {
         //!
         void getRegisteredNamesFiles(UStringList& names) const;
 
+        //!
+        //! Remove all registrations of a descriptor.
+        //! Registrations are normally permanent. This method is intended for unitary tests
+        //! which need to undo a temporary registration.
+        //! @param [in] edid Extended descriptor id.
+        //!
+        void unregisterDescriptor(const EDID& edid);
+
         //!
         //! A class to register fully implemented tables.
         //! The registration is performed using constructors.
@@ -236,13 +257,12 @@ namespace ts {
             //! @param [in] factory Function which creates a table of this type.
             //! @param [in] tids List of table ids for this type. Usually there is only one (notable exception: EIT, SDT, NIT).
             //! @param [in] standards List of standards which define this table.
-            //! @param [in] xmlName XML node name for this table type.
+            //! @param [in] xmlName XML node name for this table type. The name is copied in the repository.
             //! @param [in] displayFunction Display function for the corresponding sections. Can be null.
             //! @param [in] logFunction Log function for the corresponding sections. Can be null.
             //! @param [in] pids List of PID's which are defined by the standards for this table.
             //! @param [in] minCAS First CA_system_id if the display function applies to one CAS only.
             //! @param [in] maxCAS Last CA_system_id if the display function applies to one CAS only. Same as @a minCAS when set as CASID_NULL.
-            //! @see TS_REGISTER_TABLE
             //!
             RegisterTable(int libversion,
                           TableFactory factory,
@@ -253,7 +273,42 @@ namespace ts {
                           LogSectionFunction logFunction = nullptr,
                           const std::initializer_list<PID>& pids = std::initializer_list<PID>(),
                           uint16_t minCAS = CASID_NULL,
-                          uint16_t maxCAS = CASID_NULL);
+                          uint16_t maxCAS = CASID_NULL)
+            {
+                Register(libversion, factory, tids, standards, xmlName.c_str(), true, displayFunction, logFunction, pids, minCAS, maxCAS);
+            }
+
+            //!
+            //! Register a fully implemented table with a string literal as XML name.
+            //! This is the form which is used by TS_REGISTER_TABLE. The XML name is not copied,
+            //! the literal must remain valid as long as the code of the caller is loaded.
+            //! @tparam N Size of the string literal.
+            //! @param [in] libversion The value of TS_LIBRARY_VERSION during the compilation of the caller.
+            //! @param [in] factory Function which creates a table of this type.
+            //! @param [in] tids List of table ids for this type. Usually there is only one (notable exception: EIT, SDT, NIT).
+            //! @param [in] standards List of standards which define this table.
+            //! @param [in] xmlName XML node name for this table type, as a string literal.
+            //! @param [in] displayFunction Display function for the corresponding sections. Can be null.
+            //! @param [in] logFunction Log function for the corresponding sections. Can be null.
+            //! @param [in] pids List of PID's which are defined by the standards for this table.
+            //! @param [in] minCAS First CA_system_id if the display function applies to one CAS only.
+            //! @param [in] maxCAS Last CA_system_id if the display function applies to one CAS only. Same as @a minCAS when set as CASID_NULL.
+            //! @see TS_REGISTER_TABLE
+            //!
+            template <size_t N>
+            RegisterTable(int libversion,
+                          TableFactory factory,
+                          const std::vector<TID>& tids,
+                          Standards standards,
+                          const UChar (&xmlName)[N],
+                          DisplaySectionFunction displayFunction = nullptr,
+                          LogSectionFunction logFunction = nullptr,
+                          const std::initializer_list<PID>& pids = std::initializer_list<PID>(),
+                          uint16_t minCAS = CASID_NULL,
+                          uint16_t maxCAS = CASID_NULL)
+            {
+                Register(libversion, factory, tids, standards, xmlName, false, displayFunction, logFunction, pids, minCAS, maxCAS);
+            }
 
             //!
             //! Register a known table with display functions but no full C++ class.
@@ -275,6 +330,20 @@ namespace ts {
                           const std::initializer_list<PID>& pids = std::initializer_list<PID>(),
                           uint16_t minCAS = CASID_NULL,
                           uint16_t maxCAS = CASID_NULL);
+
+        private:
+            // Common registration code. When copyName is true, the XML name is copied in the repository.
+            static void Register(int libversion,
+                                 TableFactory factory,
+                                 const std::vector<TID>& tids,
+                                 Standards standards,
+                                 const UChar* xmlName,
+                                 bool copyName,
+                                 DisplaySectionFunction displayFunction,
+                                 LogSectionFunction logFunction,
+                                 const std::initializer_list<PID>& pids,
+                                 uint16_t minCAS,
+                                 uint16_t maxCAS);
         };
 
         //!
@@ -291,17 +360,66 @@ namespace ts {
             //! @param [in] libversion The value of TS_LIBRARY_VERSION during the compilation of the caller.
             //! @param [in] factory Function which creates a descriptor of this type.
             //! @param [in] edid Exended descriptor id.
-            //! @param [in] xmlName XML node name for this descriptor type.
+            //! @param [in] xmlName XML node name for this descriptor type. The name is copied in the repository.
             //! @param [in] displayFunction Display function for the corresponding descriptors. Can be null.
             //! @param [in] xmlNameLegacy Legacy XML node name for this descriptor type (optional).
-            //! @see TS_REGISTER_DESCRIPTOR
             //!
             RegisterDescriptor(int libversion,
                                DescriptorFactory factory,
                                const EDID& edid,
                                const UString& xmlName,
                                DisplayDescriptorFunction displayFunction = nullptr,
-                               const UString& xmlNameLegacy = UString());
+                               const UString& xmlNameLegacy = UString())
+            {
+                Register(libversion, factory, edid, xmlName.c_str(), displayFunction, xmlNameLegacy.c_str(), true);
+            }
+
+            //!
+            //! Register a descriptor factory with a string literal as XML name.
+            //! This is the form which is used by TS_REGISTER_DESCRIPTOR. The XML name is not copied,
+            //! the literal must remain valid as long as the code of the caller is loaded.
+            //! @tparam N Size of the string literal.
+            //! @param [in] libversion The value of TS_LIBRARY_VERSION during the compilation of the caller.
+            //! @param [in] factory Function which creates a descriptor of this type.
+            //! @param [in] edid Exended descriptor id.
+            //! @param [in] xmlName XML node name for this descriptor type, as a string literal.
+            //! @param [in] displayFunction Display function for the corresponding descriptors. Can be null.
+            //! @see TS_REGISTER_DESCRIPTOR
+            //!
+            template <size_t N>
+            RegisterDescriptor(int libversion,
+                               DescriptorFactory factory,
+                               const EDID& edid,
+                               const UChar (&xmlName)[N],
+                               DisplayDescriptorFunction displayFunction = nullptr)
+            {
+                Register(libversion, factory, edid, xmlName, displayFunction, nullptr, false);
+            }
+
+            //!
+            //! Register a descriptor factory with string literals as XML name and legacy XML name.
+            //! This is the form which is used by TS_REGISTER_DESCRIPTOR. The XML names are not copied,
+            //! the literals must remain valid as long as the code of the caller is loaded.
+            //! @tparam N Size of the string literal for the XML name.
+            //! @tparam NL Size of the string literal for the legacy XML name.
+            //! @param [in] libversion The value of TS_LIBRARY_VERSION during the compilation of the caller.
+            //! @param [in] factory Function which creates a descriptor of this type.
+            //! @param [in] edid Exended descriptor id.
+            //! @param [in] xmlName XML node name for this descriptor type, as a string literal.
+            //! @param [in] displayFunction Display function for the corresponding descriptors. Can be null.
+            //! @param [in] xmlNameLegacy Legacy XML node name for this descriptor type, as a string literal.
+            //! @see TS_REGISTER_DESCRIPTOR
+            //!
+            template <size_t N, size_t NL>
+            RegisterDescriptor(int libversion,
+                               DescriptorFactory factory,
+                               const EDID& edid,
+                               const UChar (&xmlName)[N],
+                               DisplayDescriptorFunction displayFunction,
+                               const UChar (&xmlNameLegacy)[NL])
+            {
+                Register(libversion, factory, edid, xmlName, displayFunction, xmlNameLegacy, false);
+            }
 
             //!
             //! Registers a CA_descriptor display function for a given range of CA_system_id.
@@ -315,7 +433,14 @@ namespace ts {
             RegisterDescriptor(int libversion, DisplayCADescriptorFunction displayFunction, uint16_t minCAS, uint16_t maxCAS = CASID_NULL);
 
         private:
-            void registerXML(DescriptorFactory factory, const EDID& edid, const UString& xmlName, const UString& xmlNameLegacy);
+            // Common registration code. When copyNames is true, the XML names are copied in the repository.
+            static void Register(int libversion,
+                                 DescriptorFactory factory,
+                                 const EDID& edid,
+                                 const UChar* xmlName,
+                                 DisplayDescriptorFunction displayFunction,
+                                 const UChar* xmlNameLegacy,
+                                 bool copyNames);
         };
 
         //!
@@ -392,22 +517,117 @@ namespace ts {
         class DescriptorDescription
         {
         public:
+            EDID                      edid;       // Extended descriptor id.
             DescriptorFactory         factory;    // Function to build an instance of the descriptor.
             DisplayDescriptorFunction display;    // Function to display a descriptor.
+            const UChar*              xmlName;    // XML node name, can be null.
+            const UChar*              xmlLegacy;  // Legacy XML node name, can be null.
+
+            // Constructor.
+            DescriptorDescription(const EDID& id = EDID(), DescriptorFactory fact = nullptr, DisplayDescriptorFunction disp = nullptr, const UChar* name = nullptr, const UChar* legacy = nullptr);
+        };
+
+        // Registration of a table, as recorded by RegisterTable.
+        // The table ids are stored in a common pool to avoid one allocation per registration.
+        class TableRegistration
+        {
+        public:
+            TableDescription desc;      // Description of the table.
+            const UChar*     xmlName;   // XML node name, can be null.
+            size_t           tidIndex;  // Index of first table id in _tidPool.
+            size_t           tidCount;  // Number of table ids.
+
+            // Constructor.
+            TableRegistration() : desc(), xmlName(nullptr), tidIndex(0), tidCount(0) {}
+        };
+
+        // Registration of a CA_descriptor display function for a range of CA_system_id.
+        class CADescriptorRegistration
+        {
+        public:
+            uint16_t                    minCAS;   // First CA_system_id.
+            uint16_t                    maxCAS;   // Last CA_system_id.
+            DisplayCADescriptorFunction display;  // Display function.
+
+            // Constructor.
+            CADescriptorRegistration(uint16_t min, uint16_t max, DisplayCADescriptorFunction disp) : minCAS(min), maxCAS(max), display(disp) {}
+        };
+
+        // An entry in an index by XML name. The key is the lower-case name without spaces
+        // so that a sorted vector of entries can be searched for "similar" names.
+        template <typename VALUE>
+        class NameEntry
+        {
+        public:
+            UString      key;    // Lower-case name without spaces.
+            const UChar* name;   // Registered XML name.
+            VALUE        value;  // Associated value.
+
+            // Constructors and assignments.
+            NameEntry(const UChar* n = nullptr, VALUE v = VALUE());
+            NameEntry(const NameEntry&) = default;
+            NameEntry(NameEntry&&) = default;
+            NameEntry& operator=(const NameEntry&) = default;
+            NameEntry& operator=(NameEntry&&) = default;
+
+            // Comparison for sort: by key only, registration order is kept by stable sort.
+            bool operator<(const NameEntry& other) const { return key < other.key; }
+        };
+
+        // Lookup indexes, built from registered items. An instance is never modified after publication.
+        class Indexes
+        {
+        public:
+            std::vector<TableDescription>             tables;               // All table descriptions, grouped by table id, in registration order.
+            std::array<size_t,257>                    tableIndex;           // Descriptions for table id 'tid' are tables[tableIndex[tid]] to tables[tableIndex[tid+1]-1].
+            std::vector<DescriptorDescription>        descriptors;          // All descriptor descriptions, sorted by extended id, one per id.
+            std::vector<NameEntry<TableFactory>>      tableNames;           // XML table name to table factory.
+            std::vector<NameEntry<DescriptorFactory>> descriptorNames;      // XML descriptor name to descriptor factory.
+            std::vector<NameEntry<TID>>               descriptorTablesIds;  // XML descriptor name to table id for table-specific descriptors.
+            std::vector<CADescriptorRegistration>     casDisplays;          // CA_descriptor display functions.
 
             // Constructor.
-            DescriptorDescription(DescriptorFactory fact = nullptr, DisplayDescriptorFunction disp = nullptr);
+            Indexes();
         };
 
-        // PSIRepository instance private members.
-        std::multimap<TID, TableDescription>            _tables;                   // Description of all table ids, potential multiple entries per table idx
-        std::map<EDID, DescriptorDescription>           _descriptors;              // Description of all descriptors, by extended id.
-        std::map<UString, TableFactory>                 _tableNames;               // XML table name to table factory
-        std::map<UString, DescriptorFactory>            _descriptorNames;          // XML descriptor name to descriptor factory
-        std::multimap<UString, TID>                     _descriptorTablesIds;      // XML descriptor name to table id for table-specific descriptors
-        std::map<uint16_t, DisplayCADescriptorFunction> _casIdDescriptorDisplays;  // CA_system_id to display function for CA_descriptor.
-        UStringList                                     _xmlModelFiles;            // Additional XML model files for tables.
-        UStringList                                     _namesFiles;               // Additional names files.
+        // Registered items, filled by the static registration instances.
+        // Registration only appends to these vectors. Access is protected by _mutex.
+        mutable Mutex                         _mutex;           // Protect registration and construction of indexes.
+        std::vector<TableRegistration>        _tableRegs;       // All table registrations, in registration order.
+        std::vector<TID>                      _tidPool;         // Pool of table ids for _tableRegs.
+        std::vector<DescriptorDescription>    _descriptorRegs;  // All descriptor registrations, in registration order.
+        std::vector<CADescriptorRegistration> _casRegs;         // All CA_descriptor registrations, in registration order.
+        UStringList                           _namePool;        // Copies of XML names which were not registered as literals.
+        UStringList                           _xmlModelFiles;   // Additional XML model files for tables.
+        UStringList                           _namesFiles;      // Additional names files.
+
+        // Lookup indexes, lazily built from registered items. Previous versions of the indexes
+        // are kept in _allIndexes because concurrent lookups may still use them.
+        mutable std::atomic<bool>                   _dirty;       // Indexes need to be rebuilt.
+        mutable std::atomic<const Indexes*>         _indexes;     // Current indexes, null until first build.
+        mutable std::list<Indexes>                  _allIndexes;  // All built indexes, protected by _mutex.
+
+        // Get the current lookup indexes, rebuild them if new items were registered since last time.
+        // Must be called first by all lookup functions.
+        const Indexes& indexes() const;
+
+        // Copy an XML name in the repository. Must be called with _mutex held.
+        const UChar* storeName(const UChar* name);
+
+        // Mark the indexes as obsolete after a registration. Must be called with _mutex held.
+        void invalidateIndexes() { _dirty.store(true, std::memory_order_release); }
+
+        // Build the key of a name index.
+        static UString NameKey(const UString& name);
+
+        // Find the range of a "similar" name in an index.
+        template <typename VALUE>
+        static std::pair<typename std::vector<NameEntry<VALUE>>::const_iterator, typename std::vector<NameEntry<VALUE>>::const_iterator>
+            FindSimilar(const std::vector<NameEntry<VALUE>>& index, const UString& name);
+
+        // Get the sorted list of unique names in a name index.
+        template <typename VALUE>
+        static void GetNames(UStringList& names, const std::vector<NameEntry<VALUE>>& index);
 
         // Common code to lookup a table function.
         template <typename FUNCTION, typename std::enable_if<std::is_pointer<FUNCTION>::value>::type* = nullptr>
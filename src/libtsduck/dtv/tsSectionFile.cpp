@@ -34,8 +34,11 @@
 #include "tsTablesDisplay.h"
 #include "tsPSIRepository.h"
 #include "tsDuckContext.h"
-#include "tsxmlModelDocument.h"
+#include "tsxmlCompiledModel.h"
 #include "tsSysUtils.h"
+#include "tsVersionInfo.h"
+#include "tsCharset.h"
+#include "tsSHA256.h"
 #include "tsEIT.h"
 TSDUCK_SOURCE;
 
@@ -50,7 +53,8 @@ ts::SectionFile::SectionFile(DuckContext& duck) :
     _sections(),
     _orphanSections(),
     _xmlTweaks(),
-    _crc_op(CRC32::IGNORE)
+    _crc_op(CRC32::IGNORE),
+    _cacheDirectory(GetEnvironment(u"TSDUCK_SECTION_CACHE"))
 {
 }
 
@@ -465,9 +469,32 @@ bool ts::SectionFile::LoadModel(xml::Document& doc)
 bool ts::SectionFile::loadXML(const UString& file_name, Report& report)
 {
     clear();
+
+    // Try the compiled-section cache first.
+    UString cache_file;
+    if (!_cacheDirectory.empty()) {
+        if (xml::Document::IsInlineXML(file_name)) {
+            const std::string utf8(file_name.toUTF8());
+            cache_file = cacheFileName(utf8.data(), utf8.size());
+        }
+        else {
+            ByteBlock content;
+            if (content.loadFromFile(file_name)) {
+                cache_file = cacheFileName(content.data(), content.size());
+            }
+        }
+        if (!cache_file.empty() && loadCache(cache_file, report)) {
+            return true;
+        }
+    }
+
     xml::Document doc(report);
     doc.setTweaks(_xmlTweaks);
-    return doc.load(file_name, false) && parseDocument(doc);
+    const bool success = doc.load(file_name, false) && parseDocument(doc);
+    if (success && !cache_file.empty()) {
+        saveCache(cache_file, report);
+    }
+    return success;
 }
 
 bool ts::SectionFile::loadXML(std::istream& strm, Report& report)
@@ -481,21 +508,131 @@ bool ts::SectionFile::loadXML(std::istream& strm, Report& report)
 bool ts::SectionFile::parseXML(const UString& xml_content, Report& report)
 {
     clear();
+
+    // Try the compiled-section cache first.
+    UString cache_file;
+    if (!_cacheDirectory.empty()) {
+        const std::string utf8(xml_content.toUTF8());
+        cache_file = cacheFileName(utf8.data(), utf8.size());
+        if (loadCache(cache_file, report)) {
+            return true;
+        }
+    }
+
     xml::Document doc(report);
     doc.setTweaks(_xmlTweaks);
-    return doc.parse(xml_content) && parseDocument(doc);
+    const bool success = doc.parse(xml_content) && parseDocument(doc);
+    if (success && !cache_file.empty()) {
+        saveCache(cache_file, report);
+    }
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Build the name of the cache file for an XML content.
+//----------------------------------------------------------------------------
+
+ts::UString ts::SectionFile::cacheFileName(const void* content, size_t size) const
+{
+    if (_cacheDirectory.empty()) {
+        return UString();
+    }
+
+    // The sections which are generated from an XML content depend on the TSDuck version
+    // (build date for development versions), the extension models and a few context
+    // parameters. They are all hashed with the XML content.
+    UStringList context;
+    PSIRepository::Instance()->getRegisteredTablesModels(context);
+    context.push_front(VersionInfo::GetVersion(VersionInfo::Format::DATE));
+    context.push_front(VersionInfo::GetVersion(VersionInfo::Format::SHORT));
+    context.push_back(_duck.charsetOut()->name());
+    context.push_back(UString::Decimal(_duck.timeReferenceOffset()));
+    const std::string prefix(UString::Join(context, u"\n").toUTF8());
+
+    SHA256 hash;
+    uint8_t digest[SHA256::HASH_SIZE];
+    if (!hash.init() || !hash.add(prefix.data(), prefix.size() + 1) || !hash.add(content, size) || !hash.getHash(digest, sizeof(digest))) {
+        return UString();
+    }
+    return _cacheDirectory + PathSeparator + UString::Dump(digest, sizeof(digest), UString::COMPACT).toLower() + TS_DEFAULT_BINARY_SECTION_FILE_SUFFIX;
+}
+
+
+//----------------------------------------------------------------------------
+// Load the sections from a cache file.
+//----------------------------------------------------------------------------
+
+bool ts::SectionFile::loadCache(const UString& cache_file, Report& report)
+{
+    ByteBlock data;
+    if (!FileExists(cache_file) || !data.loadFromFile(cache_file)) {
+        return false;
+    }
+
+    // The sections were generated by ourselves, no need to check the CRC32.
+    // The file must contain only complete and valid sections.
+    bool valid = true;
+    size_t index = 0;
+    while (valid && index < data.size()) {
+        const size_t size = index + SHORT_SECTION_HEADER_SIZE > data.size() ? 0 : SHORT_SECTION_HEADER_SIZE + (GetUInt16(&data[index + 1]) & 0x0FFF);
+        valid = size > 0 && index + size <= data.size();
+        if (valid) {
+            const SectionPtr sp(new Section(&data[index], size, PID_NULL, CRC32::IGNORE));
+            valid = sp->isValid();
+            add(sp);
+            index += size;
+        }
+    }
+
+    // Fall back to the XML content if the cache file is corrupted.
+    if (!valid || !_orphanSections.empty()) {
+        report.debug(u"invalid section cache file %s", {cache_file});
+        clear();
+        return false;
+    }
+    report.debug(u"loaded %d sections from cache file %s", {_sections.size(), cache_file});
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Save the sections in a cache file.
+//----------------------------------------------------------------------------
+
+void ts::SectionFile::saveCache(const UString& cache_file, Report& report) const
+{
+    // Several processes may load the same XML file at the same time.
+    // Write a temporary file and rename it, the cache file is always complete.
+    const UString temp_file(UString::Format(u"%s.%d.tmp", {cache_file, CurrentProcessId()}));
+    if (saveBinary(temp_file, NULLREP) && RenameFile(temp_file, cache_file) == SYS_SUCCESS) {
+        report.debug(u"saved %d sections in cache file %s", {_sections.size(), cache_file});
+    }
+    else {
+        report.debug(u"error creating section cache file %s", {cache_file});
+        DeleteFile(temp_file);
+    }
+}
+
+ts::xml::CompiledModelPtr ts::SectionFile::CompiledTablesModel(Report& report)
+{
+    // The cache key includes the extension models which were registered so far.
+    UStringList extfiles;
+    PSIRepository::Instance()->getRegisteredTablesModels(extfiles);
+    extfiles.push_front(TS_XML_TABLES_MODEL);
+    return xml::CompiledModel::Cached(UString::Join(extfiles, u"|"), LoadModel, report);
 }
 
 bool ts::SectionFile::parseDocument(const xml::Document& doc)
 {
-    // Load the XML model for TSDuck files. Search it in TSDuck directory.
-    xml::ModelDocument model(doc.report());
-    if (!LoadModel(model)) {
+    // Get the compiled XML model for TSDuck files, loaded once per process.
+    const xml::CompiledModelPtr model(CompiledTablesModel(doc.report()));
+    if (model.isNull()) {
         return false;
     }
 
     // Validate the input document according to the model.
-    if (!model.validate(doc)) {
+    if (!model->validate(doc)) {
         return false;
     }
 
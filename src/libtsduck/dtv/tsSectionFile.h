@@ -40,6 +40,7 @@
 #include "tsUString.h"
 #include "tsDVBCharTable.h"
 #include "tsxmlTweaks.h"
+#include "tsxmlCompiledModel.h"
 #include "tsTablesPtr.h"
 #include "tsCerrReport.h"
 
@@ -110,6 +111,23 @@ namespace ts {
     //! Each XML node describes a complete table. As a consequence, an XML section
     //! file contains complete tables only. There is no orphan section.
     //!
+    //! Compiled-section cache
+    //! ----------------------
+    //!
+    //! Loading an XML file means parsing the XML text, validating it against the model
+    //! and deserializing all tables. With large files, this can be slow. When a cache
+    //! directory is defined, the binary sections which are produced from an XML content
+    //! are saved in this directory. When the same XML content is loaded again later, the
+    //! sections are directly loaded from the cache. The cache files are named after a
+    //! SHA-256 hash of the XML content, the TSDuck version and the context parameters
+    //! which may influence the serialization of the tables. Therefore, a modified XML
+    //! file or a new TSDuck version never uses outdated sections.
+    //!
+    //! By default, the cache directory is the value of the environment variable
+    //! @c TSDUCK_SECTION_CACHE. There is no cache when this variable is undefined.
+    //! The directory must exist. Obsolete cache files are never deleted, this is the
+    //! responsibility of the user.
+    //!
     class TSDUCKDLL SectionFile
     {
         TS_NOBUILD_NOCOPY(SectionFile);
@@ -256,6 +274,25 @@ namespace ts {
         //!
         bool saveBinary(const UString& file_name, Report& report = CERR) const;
 
+        //!
+        //! Set the directory of the compiled-section cache for XML contents.
+        //! @param [in] directory Name of an existing directory. Empty to disable the cache.
+        //! @see @ref SectionFile "Compiled-section cache"
+        //!
+        void setCacheDirectory(const UString& directory)
+        {
+            _cacheDirectory = directory;
+        }
+
+        //!
+        //! Get the directory of the compiled-section cache for XML contents.
+        //! @return Name of the cache directory. Empty when the cache is disabled.
+        //!
+        const UString& cacheDirectory() const
+        {
+            return _cacheDirectory;
+        }
+
         //!
         //! Fast access to the list of loaded tables.
         //! @return A constant reference to the internal list of loaded tables.
@@ -378,6 +415,14 @@ namespace ts {
         //!
         static bool LoadModel(xml::Document& doc);
 
+        //!
+        //! Get the compiled XML model for tables and descriptors.
+        //! The model is loaded and compiled once per process and per set of registered extensions.
+        //! @param [in,out] report Where to report errors.
+        //! @return A safe pointer to the compiled model or a null pointer on error.
+        //!
+        static xml::CompiledModelPtr CompiledTablesModel(Report& report);
+
     private:
         DuckContext&         _duck;            //!< Reference to TSDuck execution context.
         BinaryTablePtrVector _tables;          //!< Loaded tables.
@@ -385,6 +430,7 @@ namespace ts {
         SectionPtrVector     _orphanSections;  //!< Sections which do not belong to any table.
         xml::Tweaks          _xmlTweaks;       //!< XML formatting and parsing tweaks.
         CRC32::Validation    _crc_op;          //!< Processing of CRC32 when loading sections.
+        UString              _cacheDirectory;  //!< Directory of the compiled-section cache, empty if none.
 
         //!
         //! Rebuild _tables and _orphanSections from _sections.
@@ -398,6 +444,29 @@ namespace ts {
         //!
         bool parseDocument(const xml::Document& doc);
 
+        //!
+        //! Build the name of the cache file for an XML content.
+        //! @param [in] content Address of the raw XML content.
+        //! @param [in] size Size in bytes of the raw XML content.
+        //! @return Cache file name or an empty string if there is no cache.
+        //!
+        UString cacheFileName(const void* content, size_t size) const;
+
+        //!
+        //! Load the sections from a cache file.
+        //! @param [in] cache_file Cache file name.
+        //! @param [in,out] report Where to report debug messages.
+        //! @return True on success, false if the cache file does not exist or is invalid.
+        //!
+        bool loadCache(const UString& cache_file, Report& report);
+
+        //!
+        //! Save the sections in a cache file.
+        //! @param [in] cache_file Cache file name.
+        //! @param [in,out] report Where to report debug messages.
+        //!
+        void saveCache(const UString& cache_file, Report& report) const;
+
         //!
         //! Generate an XML document.
         //! @param [in,out] doc XML document.
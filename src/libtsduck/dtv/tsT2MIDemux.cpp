@@ -42,10 +42,16 @@ TSDUCK_SOURCE;
 ts::T2MIDemux::PLPContext::PLPContext() :
     first_packet(true),
     ts(),
-    ts_next(0)
+    ts_size(0)
 {
 }
 
+void ts::T2MIDemux::PLPContext::reset()
+{
+    first_packet = true;
+    ts_size = 0;
+}
+
 ts::T2MIDemux::PIDContext::PIDContext() :
     continuity(0),
     sync(false),
@@ -58,6 +64,7 @@ ts::T2MIDemux::T2MIDemux(DuckContext& duck, T2MIHandlerInterface* t2mi_handler,
     SuperClass(duck, pid_filter),
     _handler(t2mi_handler),
     _pids(),
+    _t2mi_data(),
     _psi_demux(duck, this)
 {
     immediateReset();
@@ -170,8 +177,14 @@ void ts::T2MIDemux::feedPacket(const TSPacket& pkt)
 void ts::T2MIDemux::PIDContext::lostSync()
 {
     t2mi.clear();   // accumulated T2-MI packet buffer.
-    plps.clear();   // we also lose partially demuxed PLP's.
     sync = false;
+
+    // We also lose partially demuxed PLP's. Keep the contexts for later reuse.
+    for (auto& plp : plps) {
+        if (!plp.isNull()) {
+            plp->reset();
+        }
+    }
 }
 
 
@@ -201,8 +214,14 @@ void ts::T2MIDemux::processT2MI(PID pid, PIDContext& pc)
                 break;
             }
 
-            // Build a T2-MI packet.
-            T2MIPacket pkt(pc.t2mi.data() + start, packet_size, pid);
+            // Build a T2-MI packet. Reuse the previous data buffer when the
+            // application did not keep a reference to the previous packet.
+            if (_t2mi_data.isNull() || _t2mi_data.count() > 1) {
+                _t2mi_data = new ByteBlock;
+                CheckNonNull(_t2mi_data.pointer());
+            }
+            _t2mi_data->copy(pc.t2mi.data() + start, packet_size);
+            T2MIPacket pkt(_t2mi_data, pid);
             if (pkt.isValid()) {
 
                 // Notify the application.
@@ -276,72 +295,73 @@ void ts::T2MIDemux::demuxTS(PID pid, PIDContext& pc, const T2MIPacket& pkt)
     }
 
     // Get / create PLP context.
-    const uint8_t plp = pkt.plp();
-    PLPContextPtr& plpp(pc.plps[plp]);
+    PLPContextPtr& plpp(pc.plps[pkt.plp()]);
     if (plpp.isNull()) {
         plpp = new PLPContext;
         CheckNonNull(plpp.pointer());
     }
+    PLPContext& plp(*plpp);
 
     if (syncd == 0xFFFF) {
         // No user packet in data field
-        plpp->ts.append(data, dfl);
+        appendTS(plp, pkt, data, dfl);
     }
     else {
         // Synchronization distance in bytes, bounded by data field size.
         syncd = std::min(syncd / 8, dfl);
 
         // Process end of previous packet.
-        if (!plpp->first_packet && syncd > 0) {
-            if (plpp->ts.size() % PKT_SIZE == 0) {
-                plpp->ts.append(SYNC_BYTE);
+        if (!plp.first_packet && syncd > 0) {
+            if (plp.ts_size == 0) {
+                appendTS(plp, pkt, SYNC_BYTE);
             }
-            plpp->ts.append(data, syncd - npd);
+            appendTS(plp, pkt, data, syncd - npd);
         }
-        plpp->first_packet = false;
+        plp.first_packet = false;
         data += syncd;
         dfl -= syncd;
 
         // Process subsequent complete packets.
         while (dfl >= PKT_SIZE - 1) {
-            plpp->ts.append(SYNC_BYTE);
-            plpp->ts.append(data, PKT_SIZE - 1);
+            appendTS(plp, pkt, SYNC_BYTE);
+            appendTS(plp, pkt, data, PKT_SIZE - 1);
             data += PKT_SIZE - 1;
             dfl -= PKT_SIZE - 1;
         }
 
         // Process optional trailing truncated packet.
         if (dfl > 0) {
-            plpp->ts.append(SYNC_BYTE);
-            plpp->ts.append(data, dfl);
+            appendTS(plp, pkt, SYNC_BYTE);
+            appendTS(plp, pkt, data, dfl);
         }
     }
+}
 
-    // Now process each complete TS packet.
-    while (plpp->ts_next + PKT_SIZE <= plpp->ts.size()) {
 
-        // Build the TS packet.
-        TSPacket tsPkt;
-        ::memcpy(tsPkt.b, &plpp->ts[plpp->ts_next], PKT_SIZE);
-        plpp->ts_next += PKT_SIZE;
+//----------------------------------------------------------------------------
+// Append extracted TS data in a PLP context.
+//----------------------------------------------------------------------------
 
-        // Notify the application. Note that we are already in a protected section.
-        if (_handler != nullptr) {
-            _handler->handleTSPacket(*this, pkt, tsPkt);
+void ts::T2MIDemux::appendTS(PLPContext& plp, const T2MIPacket& pkt, const uint8_t* data, size_t size)
+{
+    while (size > 0) {
+
+        // Fill the TS packet being rebuilt.
+        const size_t chunk = std::min(size, PKT_SIZE - plp.ts_size);
+        ::memcpy(plp.ts.b + plp.ts_size, data, chunk);
+        plp.ts_size += chunk;
+        data += chunk;
+        size -= chunk;
+
+        // Notify the application with each complete TS packet.
+        // Note that we are already in a protected section.
+        if (plp.ts_size == PKT_SIZE) {
+            plp.ts_size = 0;
+            if (_handler != nullptr) {
+                _handler->handleTSPacket(*this, pkt, plp.ts);
+            }
         }
     }
-
-    // Compress or cleanup the TS buffer.
-    if (plpp->ts_next >= plpp->ts.size()) {
-        // No more packet to output, cleanup.
-        plpp->ts.clear();
-        plpp->ts_next = 0;
-    }
-    else if (plpp->ts_next >= 100 * PKT_SIZE) {
-        // TS buffer has many unused packets, compress it.
-        plpp->ts.erase(0, plpp->ts_next);
-        plpp->ts_next = 0;
-    }
 }
 
 
@@ -94,27 +94,32 @@ namespace ts {
 
     private:
         // Analysis context for one PLP inside one T2-MI stream.
+        // The extracted TS packets are directly rebuilt in a packet buffer,
+        // without intermediate buffer or allocation.
         struct PLPContext
         {
-            bool      first_packet;  // First T2-MI packet not yet processed
-            ByteBlock ts;            // Buffer to accumulate extracted TS packets.
-            size_t    ts_next;       // Next packet to output.
+            bool     first_packet;  // First T2-MI packet not yet processed
+            TSPacket ts;            // TS packet being rebuilt.
+            size_t   ts_size;       // Number of bytes already in ts.
 
             // Default constructor
             PLPContext();
+
+            // Reset after lost of synchronization.
+            void reset();
         };
 
-        // Map of safe pointers to PLPContext, indexed by PLP id.
+        // Array of safe pointers to PLPContext, indexed by PLP id.
         typedef SafePtr<PLPContext, NullMutex> PLPContextPtr;
-        typedef std::map<uint8_t, PLPContextPtr> PLPContextMap;
+        typedef std::array<PLPContextPtr, 256> PLPContextArray;
 
         // Analysis context for one PID.
         struct PIDContext
         {
-            uint8_t       continuity;  // Last continuity counter
-            bool          sync;        // We are synchronous in this PID
-            ByteBlock     t2mi;        // Buffer containing the T2-MI data.
-            PLPContextMap plps;        // Map of PLP context per PID.
+            uint8_t         continuity;  // Last continuity counter
+            bool            sync;        // We are synchronous in this PID
+            ByteBlock       t2mi;        // Buffer containing the T2-MI data.
+            PLPContextArray plps;        // PLP contexts in this PID, allocated on first use.
 
             // Default constructor
             PIDContext();
@@ -136,12 +141,17 @@ namespace ts {
         // Demux all encapsulated TS packets from a T2-MI packet.
         void demuxTS(PID pid, PIDContext& pc, const T2MIPacket& pkt);
 
+        // Append extracted TS data in a PLP context, notify the application for each complete TS packet.
+        void appendTS(PLPContext& plp, const T2MIPacket& pkt, const uint8_t* data, size_t size);
+        void appendTS(PLPContext& plp, const T2MIPacket& pkt, uint8_t byte) { appendTS(plp, pkt, &byte, 1); }
+
         // Process a PMT.
         void processPMT(const PMT& pmt);
 
         // Private members:
         T2MIHandlerInterface* _handler;    // Application-defined handler
         PIDContextMap         _pids;       // Map of PID contexts.
+        ByteBlockPtr          _t2mi_data;  // Reusable buffer for T2-MI packets, unless still referenced by the application.
         SectionDemux          _psi_demux;  // Demux for PSI parsing.
     };
 }
@@ -86,6 +86,7 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, BitRate bitrate_hint) :
     _tid_present(),
     _pids(),
     _services(),
+    _gop(),
     _modified(false),
     _ts_bitrate_sum(0),
     _ts_bitrate_cnt(0),
@@ -97,6 +98,9 @@ ts::TSAnalyzer::TSAnalyzer(DuckContext& duck, BitRate bitrate_hint) :
     _pes_demux(_duck, this),
     _t2mi_demux(_duck, this)
 {
+    // The audio and video attributes are located at the beginning of the PES payloads.
+    // Do not reassemble complete video PES packets, this is useless and costly on high bitrates.
+    _pes_demux.setDepth(64 * 1024);
     resetSectionDemux();
 }
 
@@ -159,6 +163,7 @@ void ts::TSAnalyzer::reset()
     _tid_present.reset();
     _pids.clear();
     _services.clear();
+    _gop.reset();
     _ts_bitrate_sum = 0;
     _ts_bitrate_cnt = 0;
     _preceding_errors = 0;
@@ -688,6 +693,7 @@ void ts::TSAnalyzer::analyzePMT(PID pid, const PMT& pmt)
         ps->addService(pmt.service_id);
         ps->carry_audio = ps->carry_audio || StreamTypeIsAudio(stream.stream_type);
         ps->carry_video = ps->carry_video || StreamTypeIsVideo(stream.stream_type);
+        _gop.setStreamType(it->first, stream.stream_type);
         ps->carry_pes = ps->carry_pes || StreamTypeIsPES(stream.stream_type);
         if (!ps->carry_section && !ps->carry_t2mi && StreamTypeIsSection(stream.stream_type)) {
             ps->carry_section = true;
@@ -1256,6 +1262,18 @@ void ts::TSAnalyzer::analyzeCADescriptor(const Descriptor& desc, ServiceContext*
 }
 
 
+//----------------------------------------------------------------------------
+// This hook is invoked when a complete PES packet is available
+// (Implementation of PESHandlerInterface).
+//----------------------------------------------------------------------------
+
+void ts::TSAnalyzer::handlePESPacket(PESDemux&, const PESPacket& pkt)
+{
+    // The GOP analysis ignores non-video PES packets.
+    _gop.feedPES(pkt);
+}
+
+
 //----------------------------------------------------------------------------
 // This hook is invoked when new audio attributes are found in an audio PID
 // (Implementation of PESHandlerInterface).
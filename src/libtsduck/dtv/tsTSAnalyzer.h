@@ -36,6 +36,7 @@
 #include "tsTSPacket.h"
 #include "tsSectionDemux.h"
 #include "tsPESDemux.h"
+#include "tsGOPAnalyzer.h"
 #include "tsT2MIDemux.h"
 #include "tsPAT.h"
 #include "tsCAT.h"
@@ -161,6 +162,17 @@ namespace ts {
         //!
         void getPIDsWithPES(std::vector<PID>& list);
 
+        //!
+        //! Check if the last TS packet which was passed to feedPacket() starts an intra-coded image.
+        //! Only video PID's which were already identified by the analysis are checked.
+        //! @param [in] packet The last TS packet which was passed to feedPacket().
+        //! @return True if @a packet starts a PES packet with an intra-coded image.
+        //!
+        bool isIntraImageStart(const TSPacket& packet) const
+        {
+            return _gop.isIntraImageStart(packet);
+        }
+
     protected:
 
         // -------------------
@@ -473,6 +485,7 @@ namespace ts {
         std::bitset<TID_MAX> _tid_present;    //!< Array of detected tables.
         PIDContextMap        _pids;           //!< Description of PIDs.
         ServiceContextMap    _services;       //!< Description of services, map key: service id..
+        GOPAnalyzer          _gop;            //!< GOP analysis of video PID's.
 
     private:
         // Constant string "Unreferenced"
@@ -510,6 +523,7 @@ namespace ts {
         virtual void handleSection(SectionDemux&, const Section&) override;
 
         // Implementation of PESHandlerInterface
+        virtual void handlePESPacket(PESDemux&, const PESPacket&) override;
         virtual void handleNewMPEG2AudioAttributes(PESDemux&, const PESPacket&, const MPEG2AudioAttributes&) override;
         virtual void handleNewMPEG2VideoAttributes(PESDemux&, const PESPacket&, const MPEG2VideoAttributes&) override;
         virtual void handleNewAVCAttributes(PESDemux&, const PESPacket&, const AVCAttributes&) override;
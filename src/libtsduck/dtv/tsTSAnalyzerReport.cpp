@@ -1242,6 +1242,36 @@ void ts::TSAnalyzerReport::reportJSON(const TSAnalyzerOptions& opt, std::ostream
         else {
             jv.add(u"unit-start", pc.unit_start_cnt);
         }
+        const GOPAnalyzer::Statistics* gop = _gop.statistics(pc.pid);
+        if (gop != nullptr && gop->frames() > 0) {
+            json::Value& jg(jv.query(u"gop", true));
+            json::Value& jf(jg.query(u"frames", true));
+            jf.add(u"total", gop->frames());
+            jf.add(u"i", gop->i_frames);
+            jf.add(u"p", gop->p_frames);
+            jf.add(u"b", gop->b_frames);
+            jf.add(u"other", gop->other_frames);
+            jg.add(u"count", gop->gop_count);
+            if (gop->gop_count > 0) {
+                jg.add(u"min-length", gop->gop_min);
+                jg.add(u"max-length", gop->gop_max);
+                jg.add(u"average-length", gop->gopAverage());
+                jg.add(u"structure", gop->gop_structure);
+            }
+            if (gop->i_frames > 0) {
+                json::Value& ji(jg.query(u"i-frame-size", true));
+                ji.add(u"min", gop->i_size_min);
+                ji.add(u"max", gop->i_size_max);
+                ji.add(u"average", gop->iSizeAverage());
+            }
+            for (size_t bin = 0; bin < GOPAnalyzer::RAP_INTERVAL_BINS; ++bin) {
+                if (gop->rap_intervals[bin] > 0) {
+                    json::Value& jr(jg.query(u"rap-intervals[]", true));
+                    jr.add(u"min-ms", bin == 0 ? 0 : (1 << bin));
+                    jr.add(u"count", gop->rap_intervals[bin]);
+                }
+            }
+        }
     }
 
     // One node per table
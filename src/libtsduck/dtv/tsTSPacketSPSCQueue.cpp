@@ -0,0 +1,270 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketSPSCQueue.h"
+#include "tsGuardCondition.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::TSPacketSPSCQueue::DEFAULT_SIZE;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructors.
+//----------------------------------------------------------------------------
+
+ts::TSPacketSPSCQueue::TSPacketSPSCQueue(size_t size) :
+    _buffer(std::max<size_t>(size, 1)),
+    _write(0),
+    _read(0),
+    _eof(false),
+    _stopped(false),
+    _writer_waiting(false),
+    _reader_waiting(false),
+    _bitrate(0),
+    _pcr_bitrate(0),
+    _pcr(1, 12),
+    _mutex(),
+    _enqueued(),
+    _dequeued()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Reset and resize the buffer.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketSPSCQueue::reset(size_t size)
+{
+    // Resize the buffer if requested.
+    if (size != NPOS) {
+        // Refuse to shrink too much. Keep at least one packet.
+        _buffer.resize(std::max<size_t>(size, 1));
+    }
+
+    _write = 0;
+    _read = 0;
+    _eof = false;
+    _stopped = false;
+    _writer_waiting = false;
+    _reader_waiting = false;
+    _bitrate = 0;
+    _pcr_bitrate = 0;
+    _pcr.reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the writer thread to reserve a writable range of slots.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketSPSCQueue::reserveWrite(TSPacket*& buffer, size_t& buffer_size, size_t min_size)
+{
+    const size_t size = _buffer.size();
+    const size_t write = _write.load(std::memory_order_relaxed);  // only modified by this thread
+    const size_t index = write % size;
+
+    // We cannot ask for more than the distance to the end of the buffer.
+    // But we also need to wait for at least one packet.
+    const size_t contiguous = size - index;
+    min_size = std::max<size_t>(1, std::min(min_size, contiguous));
+
+    // Wait until we get enough free space. Use the mutex only when we need to wait.
+    size_t free = size - (write - _read);
+    if (free < min_size && !_stopped) {
+        GuardCondition lock(_mutex, _dequeued);
+        // The waiting flag must be set before checking the read position again,
+        // so that the reader thread either sees the flag or we see its new position.
+        _writer_waiting = true;
+        while (!_stopped && (free = size - (write - _read)) < min_size) {
+            lock.waitCondition();
+        }
+        _writer_waiting = false;
+    }
+
+    // Return the write window, only its first contiguous part.
+    buffer = &_buffer[index];
+    buffer_size = _stopped ? 0 : std::min(free, contiguous);
+
+    // A write range is returned only when the reader thread does not want to terminate.
+    return !_stopped;
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the writer thread to commit packets in the reserved range.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketSPSCQueue::commitWrite(size_t count)
+{
+    const size_t size = _buffer.size();
+    const size_t write = _write.load(std::memory_order_relaxed);  // only modified by this thread
+    const size_t index = write % size;
+    const size_t max_count = std::min(size - (write - _read), size - index);
+
+    // This is a bug in the application to specify more than the max size.
+    // When assertions are disabled, simply reduce.
+    assert(count <= max_count);
+    count = std::min(count, max_count);
+
+    // When the writer thread did not specify a bitrate, analyze PCR's.
+    if (_bitrate == 0) {
+        for (size_t i = 0; i < count; ++i) {
+            _pcr.feedPacket(_buffer[index + i]);
+        }
+        if (_pcr.bitrateIsValid()) {
+            _pcr_bitrate = _pcr.bitrate188();
+        }
+    }
+
+    // Make the packets visible to the reader thread.
+    _write = write + count;
+
+    // Wake up the reader thread only if it waits for packets.
+    if (_reader_waiting) {
+        GuardCondition lock(_mutex, _enqueued);
+        lock.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the writer thread to report the input bitrate.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketSPSCQueue::setBitrate(BitRate bitrate)
+{
+    _bitrate = bitrate;
+
+    // If a specific value is given, reset PCR analysis.
+    if (bitrate > 0) {
+        _pcr.reset();
+        _pcr_bitrate = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the writer thread to report the end of input thread.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketSPSCQueue::setEOF()
+{
+    GuardCondition lock(_mutex, _enqueued);
+    _eof = true;
+
+    // We did not really enqueue packets but if a reader thread is waiting we need to wake it up.
+    lock.signal();
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the reader thread to borrow a readable span of packets.
+//----------------------------------------------------------------------------
+
+bool ts::TSPacketSPSCQueue::borrowRead(const TSPacket*& buffer, size_t& count, BitRate& bitrate, bool wait)
+{
+    const size_t size = _buffer.size();
+    const size_t read = _read.load(std::memory_order_relaxed);  // only modified by this thread
+    const size_t index = read % size;
+
+    // Wait until there is some packet in the buffer. Use the mutex only when we need to wait.
+    size_t available = _write - read;
+    if (available == 0 && wait && !_eof && !_stopped) {
+        GuardCondition lock(_mutex, _enqueued);
+        // The waiting flag must be set before checking the write position again,
+        // so that the writer thread either sees the flag or we see its new position.
+        _reader_waiting = true;
+        while ((available = _write - read) == 0 && !_eof && !_stopped) {
+            lock.waitCondition();
+        }
+        _reader_waiting = false;
+    }
+
+    // The writer thread may commit its last packets and report the end of file between
+    // our load of the write position and our check of the end of file. Once the end of
+    // file or stop condition is seen, the write position is final: read it again.
+    if (available == 0 && (_eof || _stopped)) {
+        available = _write - read;
+    }
+
+    // Get bitrate, either from writer thread or from PCR analysis.
+    const BitRate user_bitrate = _bitrate;
+    bitrate = user_bitrate != 0 ? user_bitrate : BitRate(_pcr_bitrate);
+
+    // Return only the first contiguous part of the available packets.
+    buffer = &_buffer[index];
+    count = std::min(available, size - index);
+    return count > 0;
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the reader thread to release borrowed packets.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketSPSCQueue::releaseRead(size_t count)
+{
+    const size_t size = _buffer.size();
+    const size_t read = _read.load(std::memory_order_relaxed);  // only modified by this thread
+    const size_t max_count = std::min(size_t(_write - read), size - read % size);
+
+    // This is a bug in the application to specify more than the max size.
+    assert(count <= max_count);
+    count = std::min(count, max_count);
+
+    // Make the slots available to the writer thread.
+    _read = read + count;
+
+    // Wake up the writer thread only if it waits for free space.
+    if (_writer_waiting) {
+        GuardCondition lock(_mutex, _dequeued);
+        lock.signal();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Called by the reader thread to tell the writer thread to stop immediately.
+//----------------------------------------------------------------------------
+
+void ts::TSPacketSPSCQueue::stop()
+{
+    GuardCondition lock(_mutex, _dequeued);
+
+    // Report a stop condition.
+    _stopped = true;
+
+    // Wake up the writer thread if it waits for free space and the reader thread
+    // if it waits for packets (when stop() is invoked from another thread).
+    lock.signal();
+    _enqueued.signal();
+}
@@ -0,0 +1,188 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Lock-free single-producer single-consumer queue of TS packets.
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsTSPacket.h"
+#include "tsPCRAnalyzer.h"
+#include "tsMutex.h"
+#include "tsCondition.h"
+#include <atomic>
+
+namespace ts {
+    //!
+    //! Lock-free single-producer single-consumer queue of TS packets.
+    //! @ingroup mpeg
+    //! @see TSPacketQueue
+    //!
+    //! This is a variant of TSPacketQueue for exactly one writer thread and one
+    //! reader thread. The packets are never copied by the queue itself.
+    //!
+    //! The writer thread invokes reserveWrite() to get a writable range of slots
+    //! inside the buffer, writes the packets there and invokes commitWrite().
+    //! The reader thread invokes borrowRead() to get a readable span of packets
+    //! inside the buffer, uses them in place and invokes releaseRead().
+    //!
+    //! As long as the queue is neither empty nor full, no mutex is used: the read
+    //! and write positions are atomic counters. A mutex and conditions are used
+    //! only to suspend a thread which waits for free space or for packets.
+    //!
+    //! The input bitrate, if known, is transmitted to the reader thread. If the
+    //! writer thread is aware of the exact bitrate, it calls setBitrate() and
+    //! the specified value is returned to the reader thread. If the input bitrate
+    //! is unknown, the writer side automatically computes it based on PCR's.
+    //!
+    class TSDUCKDLL TSPacketSPSCQueue
+    {
+        TS_NOCOPY(TSPacketSPSCQueue);
+    public:
+        //!
+        //! Default size in packets of the buffer.
+        //!
+        static constexpr size_t DEFAULT_SIZE = 1000;
+
+        //!
+        //! Default constructor.
+        //! @param [in] size Size of the buffer in packets.
+        //!
+        TSPacketSPSCQueue(size_t size = DEFAULT_SIZE);
+
+        //!
+        //! Reset and resize the buffer.
+        //! It is illegal to reset the buffer while the writer or reader thread is using it.
+        //! This is not enforced by this class. It is the responsibility of the application to check this.
+        //! @param [in] size New size of the buffer in packets. By default, when set to NPOS,
+        //! reset the queue without resizing the buffer.
+        //!
+        void reset(size_t size = NPOS);
+
+        //!
+        //! Get the size of the buffer in packets.
+        //! @return The size of the buffer in packets.
+        //!
+        size_t bufferSize() const { return _buffer.size(); }
+
+        //!
+        //! Get the current number of packets in the buffer.
+        //! @return The current number of packets in the buffer.
+        //!
+        size_t currentSize() const { return _write - _read; }
+
+        //!
+        //! Called by the writer thread to reserve a writable range of slots.
+        //! The writer thread is suspended until enough free space is made in the buffer
+        //! or the reader thread triggers a stop condition.
+        //! @param [out] buffer Address of the first writable slot.
+        //! @param [out] buffer_size Number of contiguous writable slots.
+        //! @param [in] min_size Minimum number of free slots to get. This is just a
+        //! hint. The returned size can be smaller, for instance when the write window
+        //! of the circular buffer is close to the end of the buffer.
+        //! @return True when the write range is correctly available.
+        //! False when the reader thread has signalled a stop condition.
+        //!
+        bool reserveWrite(TSPacket*& buffer, size_t& buffer_size, size_t min_size = 1);
+
+        //!
+        //! Called by the writer thread to commit packets in the reserved range.
+        //! The packets become visible to the reader thread.
+        //! @param [in] count Number of packets which were written in the reserved range.
+        //! Must be no greater than the size which was returned by reserveWrite().
+        //!
+        void commitWrite(size_t count);
+
+        //!
+        //! Called by the writer thread to report the input bitrate.
+        //! @param [in] bitrate Input bitrate. If zero, the input bitrate is unknown
+        //! and will be computed from PCR's.
+        //!
+        void setBitrate(BitRate bitrate);
+
+        //!
+        //! Called by the writer thread to report the end of input thread.
+        //!
+        void setEOF();
+
+        //!
+        //! Check if the reader thread has reported a stop condition.
+        //! @return True if the reader thread has reported a stop condition.
+        //!
+        bool stopped() const { return _stopped; }
+
+        //!
+        //! Called by the reader thread to borrow a readable span of packets.
+        //! The packets remain in the buffer until releaseRead() is called.
+        //! @param [out] buffer Address of the first readable packet.
+        //! @param [out] count Number of contiguous readable packets.
+        //! @param [out] bitrate Input bitrate or zero if unknown.
+        //! @param [in] wait If true, the reader thread is suspended until at least one packet
+        //! is available or an end of file or stop condition occurs. If false, return immediately.
+        //! @return True if at least one packet was returned. False if none was available
+        //! or an end of file occured.
+        //!
+        bool borrowRead(const TSPacket*& buffer, size_t& count, BitRate& bitrate, bool wait = true);
+
+        //!
+        //! Called by the reader thread to release packets which were borrowed using borrowRead().
+        //! @param [in] count Number of packets to release. Must be no greater than the size
+        //! which was returned by borrowRead().
+        //!
+        void releaseRead(size_t count);
+
+        //!
+        //! Check if the writer thread has reported an end of file condition.
+        //! @return True if the writer thread has reported an end of file condition
+        //! and all packets were read.
+        //!
+        bool eof() const { return _eof && _write == _read; }
+
+        //!
+        //! Called by the reader thread to tell the writer thread to stop immediately.
+        //!
+        void stop();
+
+    private:
+        TSPacketVector       _buffer;          // The packet buffer.
+        std::atomic<size_t>  _write;           // Total number of committed packets (modulo size_t).
+        std::atomic<size_t>  _read;            // Total number of released packets (modulo size_t).
+        std::atomic<bool>    _eof;             // The writer thread has reported an end of file.
+        std::atomic<bool>    _stopped;         // The reader thread has reported a stop condition.
+        std::atomic<bool>    _writer_waiting;  // The writer thread is waiting for free space.
+        std::atomic<bool>    _reader_waiting;  // The reader thread is waiting for packets.
+        std::atomic<BitRate> _bitrate;         // Bitrate as set by the writer thread.
+        std::atomic<BitRate> _pcr_bitrate;     // Bitrate from PCR analysis.
+        PCRAnalyzer          _pcr;             // PCR analyzer, used by the writer thread only.
+        Mutex                _mutex;           // Used only to suspend the threads.
+        Condition            _enqueued;        // Signaled when packets are committed.
+        Condition            _dequeued;        // Signaled when packets are released.
+    };
+}
@@ -38,6 +38,7 @@
 #include "tsDuckProtocol.h"
 #include "tsxmlComment.h"
 #include "tsxmlElement.h"
+#include "tsSectionFile.h"
 TSDUCK_SOURCE;
 
 #if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
@@ -67,6 +68,8 @@ ts::TablesLogger::TablesLogger(TablesDisplay& display) :
     _rewrite_binary(false),
     _log_xml_line(false),
     _log_xml_prefix(),
+    _log_json_line(false),
+    _log_json_prefix(),
     _udp_local(),
     _udp_ttl(0),
     _udp_raw(false),
@@ -96,6 +99,7 @@ ts::TablesLogger::TablesLogger(TablesDisplay& display) :
     _demux(_duck),
     _cas_mapper(_duck),
     _xml_doc(_report),
+    _line_writer(),
     _bin_file(),
     _sock(false, _report),
     _short_sections(),
@@ -179,6 +183,14 @@ void ts::TablesLogger::defineArgs(Args& args) const
     args.option(u"log", 0);
     args.help(u"log", u"Display a short one-line log of each table instead of full table display.");
 
+    args.option(u"log-json-line", 0, Args::STRING, 0, 1, 0, Args::UNLIMITED_VALUE, true);
+    args.help(u"log-json-line", u"'prefix'",
+              u"Log each table as one single JSON line in the message logger instead of an output file. "
+              u"The table is formatted as XML and automated XML-to-JSON conversion is applied, "
+              u"using the XML model of the tables to produce numbers and booleans. "
+              u"The optional string parameter specifies a prefix to prepend on the log "
+              u"line before the JSON text to locate the appropriate line in the logs.");
+
     args.option(u"log-size", 0, Args::UNSIGNED);
     args.help(u"log-size",
               u"With option --log, specify how many bytes are displayed at the "
@@ -288,7 +300,8 @@ bool ts::TablesLogger::loadArgs(DuckContext& duck, Args& args)
     _use_binary = args.present(u"binary-output");
     _use_udp = args.present(u"ip-udp");
     _log_xml_line = args.present(u"log-xml-line");
-    _use_text = args.present(u"output-file") || args.present(u"text-output") || (!_use_xml && !_use_binary && !_use_udp && !_log_xml_line);
+    _log_json_line = args.present(u"log-json-line");
+    _use_text = args.present(u"output-file") || args.present(u"text-output") || (!_use_xml && !_use_binary && !_use_udp && !_log_xml_line && !_log_json_line);
 
     // --output-file and --text-output are synonyms.
     if (args.present(u"output-file") && args.present(u"text-output")) {
@@ -313,6 +326,7 @@ bool ts::TablesLogger::loadArgs(DuckContext& duck, Args& args)
     _rewrite_binary = args.present(u"rewrite-binary");
     _rewrite_xml = args.present(u"rewrite-xml");
     args.getValue(_log_xml_prefix, u"log-xml-line");
+    args.getValue(_log_json_prefix, u"log-json-line");
     _flush = args.present(u"flush");
     _udp_local = args.value(u"local-udp");
     args.getIntValue(_udp_ttl, u"ttl", 0);
@@ -405,6 +419,11 @@ bool ts::TablesLogger::open()
     // Set XML options in document.
     _xml_doc.setTweaks(_xml_tweaks);
 
+    // The tables model types the values in --log-json-line, as JSONConverter does.
+    if (_log_json_line) {
+        _line_writer.setModel(SectionFile::CompiledTablesModel(_report));
+    }
+
     // Open/create the XML output.
     if (_use_xml && !_rewrite_xml && !createXML(_xml_destination)) {
         _abort = true;
@@ -555,7 +574,7 @@ void ts::TablesLogger::handleTable(SectionDemux&, const BinaryTable& table)
         }
     }
 
-    if (_log_xml_line) {
+    if (_log_xml_line || _log_json_line) {
         logXML(table);
     }
 
@@ -674,7 +693,7 @@ void ts::TablesLogger::handleSection(SectionDemux& demux, const Section& sect)
 
 
 //----------------------------------------------------------------------------
-// Log XML one-liners.
+// Log XML and JSON one-liners.
 //----------------------------------------------------------------------------
 
 void ts::TablesLogger::logXML(const BinaryTable& table)
@@ -688,16 +707,17 @@ void ts::TablesLogger::logXML(const BinaryTable& table)
         return;
     }
 
-    // Initialize a text formatter for one-liner.
-    TextFormatter text(_report);
-    text.setString();
-    text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
-
-    // Serialize the XML object inside the text formatter.
-    doc.print(text);
-
-    // Log the XML line.
-    _report.info(_log_xml_prefix + text.toString());
+    // Serialize the XML document directly in UTF-8 in a reused buffer, without text formatter or JSON object.
+    if (_log_xml_line) {
+        _line_writer.setFormat(xml::StreamWriter::Format::XML);
+        _line_writer.write(doc);
+        _report.info(_log_xml_prefix + _line_writer.toString());
+    }
+    if (_log_json_line) {
+        _line_writer.setFormat(xml::StreamWriter::Format::JSON);
+        _line_writer.write(doc);
+        _report.info(_log_json_prefix + _line_writer.toString());
+    }
 }
 
 
@@ -46,6 +46,7 @@
 #include "tsCASMapper.h"
 #include "tsxmlTweaks.h"
 #include "tsxmlRunningDocument.h"
+#include "tsxmlStreamWriter.h"
 
 namespace ts {
     //!
@@ -159,6 +160,8 @@ namespace ts {
         bool                     _rewrite_binary;    // Rewrite a new binary file for each table.
         bool                     _log_xml_line;      // Log tables as one XML line in the system message log.
         UString                  _log_xml_prefix;    // Prefix before XML log line.
+        bool                     _log_json_line;     // Log tables as one JSON line in the system message log.
+        UString                  _log_json_prefix;   // Prefix before JSON log line.
         UString                  _udp_local;         // Name of outgoing local address (empty if unspecified).
         int                      _udp_ttl;           // Time-to-live socket option.
         bool                     _udp_raw;           // UDP messages contain raw sections, not structured messages.
@@ -190,6 +193,7 @@ namespace ts {
         SectionDemux             _demux;
         CASMapper                _cas_mapper;
         xml::RunningDocument     _xml_doc;           // XML root document.
+        xml::StreamWriter        _line_writer;       // Serializer of XML and JSON one-liners.
         std::ofstream            _bin_file;          // Binary output file.
         UDPSocket                _sock;              // Output socket.
         std::map<PID,SectionPtr> _short_sections;    // Tracking duplicate short sections by PID.
@@ -208,7 +212,7 @@ namespace ts {
         void saveXML(const BinaryTable& table);
         void closeXML();
 
-        // Log XML one-liners.
+        // Log XML and JSON one-liners.
         void logXML(const BinaryTable& table);
 
         // Send UDP table and section.
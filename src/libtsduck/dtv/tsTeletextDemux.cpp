@@ -166,6 +166,7 @@ ts::TeletextDemux::TeletextDemux(DuckContext& duck, TeletextHandlerInterface* ha
     SuperClass(duck, nullptr, pidFilter),
     _txtHandler(handler),
     _pids(),
+    _subscriptions(),
     _addColors(false)
 {
 }
@@ -180,9 +181,12 @@ ts::TeletextDemux::TeletextPage::TeletextPage() :
     showTimestamp(0),
     hideTimestamp(0),
     tainted(false),
-    charset()
+    charset(),
+    renderedLines(),
+    renderedColors(false)
 {
     TS_ZERO(text);
+    TS_ZERO(renderedText);
 }
 
 void ts::TeletextDemux::TeletextPage::reset(MilliSecond timestamp)
@@ -201,6 +205,12 @@ ts::TeletextDemux::PIDContext::PIDContext() :
 {
 }
 
+ts::TeletextDemux::Subscription::Subscription() :
+    magazines(0),
+    pages()
+{
+}
+
 
 //-----------------------------------------------------------------------------
 // Reset the analysis context (partially built TELETEXT packets).
@@ -219,6 +229,58 @@ void ts::TeletextDemux::immediateResetPID(PID pid)
 }
 
 
+//-----------------------------------------------------------------------------
+// Page subscriptions.
+//-----------------------------------------------------------------------------
+
+void ts::TeletextDemux::addPage(PID pid, int page, TeletextHandlerInterface* handler)
+{
+    // Internally, Teletext page numbers are stored in Binary-Coded Decimal.
+    const int bcdPage = pageBinaryToBcd(page);
+    Subscription& sub(_subscriptions[pid]);
+    sub.pages[bcdPage] = handler;
+    sub.magazines |= uint16_t(1 << magazineOf(bcdPage));
+
+    // Drop the working buffers of pages which are no longer decoded.
+    const PIDContextMap::iterator itPid = _pids.find(pid);
+    if (itPid != _pids.end()) {
+        TeletextPageMap& pages(itPid->second.pages);
+        for (TeletextPageMap::iterator it = pages.begin(); it != pages.end(); ) {
+            if (sub.pages.count(it->first) == 0) {
+                it = pages.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+    }
+}
+
+void ts::TeletextDemux::removePage(PID pid, int page)
+{
+    const SubscriptionMap::iterator itSub = _subscriptions.find(pid);
+    if (itSub != _subscriptions.end()) {
+        Subscription& sub(itSub->second);
+        sub.pages.erase(pageBinaryToBcd(page));
+        if (sub.pages.empty()) {
+            _subscriptions.erase(itSub);
+        }
+        else {
+            // Recompute the mask of magazines.
+            sub.magazines = 0;
+            for (PageHandlerMap::const_iterator it = sub.pages.begin(); it != sub.pages.end(); ++it) {
+                sub.magazines |= uint16_t(1 << magazineOf(it->first));
+            }
+        }
+    }
+}
+
+void ts::TeletextDemux::clearPages()
+{
+    _subscriptions.clear();
+}
+
+
 //-----------------------------------------------------------------------------
 // This hook is invoked when a complete PES packet is available.
 //-----------------------------------------------------------------------------
@@ -232,6 +294,10 @@ void ts::TeletextDemux::handlePESPacket(const PESPacket& packet)
     const PID pid = packet.getSourcePID();
     PIDContext& pc(_pids[pid]);
 
+    // Page subscriptions in this PID, if any.
+    const SubscriptionMap::const_iterator itSub = _subscriptions.find(pid);
+    const Subscription* sub = itSub == _subscriptions.end() ? nullptr : &itSub->second;
+
     // Explore PES payload.
     const uint8_t* pl = packet.payload();
     size_t plSize = packet.payloadSize();
@@ -258,12 +324,22 @@ void ts::TeletextDemux::handlePESPacket(const PESPacket& packet)
             unitSize == TELETEXT_PACKET_SIZE &&
             (unitId == TeletextDataUnitId::NON_SUBTITLE || unitId == TeletextDataUnitId::SUBTITLE))
         {
-            // Reverse bitwise endianess of each data byte via lookup table, ETS 300 706, chapter 7.1.
-            uint8_t pkt[TELETEXT_PACKET_SIZE];
-            for (int i = 0; i < unitSize; ++i) {
-                pkt[i] = REVERSE_8[pl[i]];
+            // When pages are subscribed, drop non-header packets from other magazines before decoding.
+            // Header packets (Y=0) are always processed since they terminate the pages in progress.
+            bool decode = true;
+            if (sub != nullptr) {
+                const uint8_t address = uint8_t(unham_8_4(REVERSE_8[pl[3]]) << 4) | unham_8_4(REVERSE_8[pl[2]]);
+                const int m = (address & 0x07) == 0 ? 8 : (address & 0x07);
+                decode = (address >> 3) == 0 || sub->hasMagazine(m);
+            }
+            if (decode) {
+                // Reverse bitwise endianess of each data byte via lookup table, ETS 300 706, chapter 7.1.
+                uint8_t pkt[TELETEXT_PACKET_SIZE];
+                for (int i = 0; i < unitSize; ++i) {
+                    pkt[i] = REVERSE_8[pl[i]];
+                }
+                processTeletextPacket(pid, pc, sub, unitId, pkt);
             }
-            processTeletextPacket(pid, pc, unitId, pkt);
         }
 
         // Point to next data unit.
@@ -277,7 +353,7 @@ void ts::TeletextDemux::handlePESPacket(const PESPacket& packet)
 // Process one Teletext packet.
 //-----------------------------------------------------------------------------
 
-void ts::TeletextDemux::processTeletextPacket(PID pid, PIDContext& pc, TeletextDataUnitId dataUnitId, const uint8_t* pkt)
+void ts::TeletextDemux::processTeletextPacket(PID pid, PIDContext& pc, const Subscription* sub, TeletextDataUnitId dataUnitId, const uint8_t* pkt)
 {
     // Structure of a Teletext packet. See ETSI 300 706, section 7.1.
     // - Clock run-in: 1 byte
@@ -321,6 +397,14 @@ void ts::TeletextDemux::processTeletextPacket(PID pid, PIDContext& pc, TeletextD
             return;
         }
 
+        // Header of a page which is not subscribed: it terminates the current page, if any, but is not decoded.
+        if (sub != nullptr && sub->pages.count(pageNumber) == 0) {
+            if (pc.transMode == TRANSMODE_SERIAL || m == magazineOf(pc.currentPage)) {
+                pc.receivingData = false;
+            }
+            return;
+        }
+
         if (pc.receivingData &&
             ((pc.transMode == TRANSMODE_SERIAL && pageOf(pageNumber) != pageOf(pc.currentPage)) ||
              (pc.transMode == TRANSMODE_PARALLEL && pageOf(pageNumber) != pageOf(pc.currentPage) && m == magazineOf(pc.currentPage))))
@@ -478,131 +562,154 @@ void ts::TeletextDemux::processTeletextPage(PID pid, PIDContext& pc, int pageNum
     // Prepare the Teletext frame.
     TeletextFrame frame(pid, pageBcdToBinary(pageNumber), page.frameCount, page.showTimestamp, page.hideTimestamp);
 
-    // Process page data.
+    // Process page data. Only the rows which changed since the previous frame are rendered again.
+    const bool colorsChanged = page.renderedColors != _addColors;
+    page.renderedColors = _addColors;
     for (int row = 1; row < 25; row++) {
-        UString line;
-
-        // Anchors for string trimming purpose
-        int colStart = 40;
-        int colStop = 40;
+        if (colorsChanged || ::memcmp(page.renderedText[row], page.text[row], sizeof(page.text[row])) != 0) {
+            ::memcpy(page.renderedText[row], page.text[row], sizeof(page.text[row]));
+            renderRow(page.text[row], page.renderedLines[row]);
+        }
+        if (!page.renderedLines[row].empty()) {
+            frame.addLine(page.renderedLines[row]);
+        }
+    }
 
-        for (int col = 39; col >= 0; col--) {
-            if (page.text[row][col] == 0x0B) {
-                colStart = col;
-                break;
-            }
+    // Now call the page-specific handler or the user-specified handler.
+    // Note that the super class PESDemux has already placed us in "handler context".
+    TeletextHandlerInterface* handler = _txtHandler;
+    const SubscriptionMap::const_iterator itSub = _subscriptions.find(pid);
+    if (itSub != _subscriptions.end()) {
+        const PageHandlerMap::const_iterator itPage = itSub->second.pages.find(pageNumber);
+        if (itPage != itSub->second.pages.end() && itPage->second != nullptr) {
+            handler = itPage->second;
         }
-        if (colStart > 39) {
-            // Line is empty
-            continue;
+    }
+    if (handler != nullptr) {
+        handler->handleTeletextMessage(*this, frame);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Render one row of a Teletext page as a subtitle line.
+//-----------------------------------------------------------------------------
+
+void ts::TeletextDemux::renderRow(const UChar* text, UString& line) const
+{
+    line.clear();
+
+    // Anchors for string trimming purpose
+    int colStart = 40;
+    int colStop = 40;
+
+    for (int col = 39; col >= 0; col--) {
+        if (text[col] == 0x0B) {
+            colStart = col;
+            break;
         }
+    }
+    if (colStart > 39) {
+        // Line is empty
+        return;
+    }
 
-        for (int col = colStart + 1; col <= 39; col++) {
-            if (page.text[row][col] > 0x20) {
-                if (colStop > 39) {
-                    colStart = col;
-                }
-                colStop = col;
-            }
-            if (page.text[row][col] == 0x0A) {
-                break;
+    for (int col = colStart + 1; col <= 39; col++) {
+        if (text[col] > 0x20) {
+            if (colStop > 39) {
+                colStart = col;
             }
+            colStop = col;
         }
-        if (colStop > 39) {
-            // Line is empty
-            continue;
+        if (text[col] == 0x0A) {
+            break;
         }
+    }
+    if (colStop > 39) {
+        // Line is empty
+        return;
+    }
 
-        // ETS 300 706, chapter 12.2: Alpha White ("Set-After") - Start-of-row default condition.
-        // used for colour changes _before_ start box mark
-        // white is default as stated in ETS 300 706, chapter 12.2
-        // black(0), red(1), green(2), yellow(3), blue(4), magenta(5), cyan(6), white(7)
-        uint16_t foregroundColor = 0x07;
-        bool fontTagOpened = false;
+    // ETS 300 706, chapter 12.2: Alpha White ("Set-After") - Start-of-row default condition.
+    // used for colour changes _before_ start box mark
+    // white is default as stated in ETS 300 706, chapter 12.2
+    // black(0), red(1), green(2), yellow(3), blue(4), magenta(5), cyan(6), white(7)
+    uint16_t foregroundColor = 0x07;
+    bool fontTagOpened = false;
 
-        for (int col = 0; col <= colStop; col++) {
-            // v is just a shortcut
-            UChar v = page.text[row][col];
+    for (int col = 0; col <= colStop; col++) {
+        // v is just a shortcut
+        UChar v = text[col];
 
-            if (col < colStart) {
-                if (v <= 0x7) {
-                    foregroundColor = v;
-                }
+        if (col < colStart) {
+            if (v <= 0x7) {
+                foregroundColor = v;
             }
+        }
 
-            if (col == colStart) {
-                if (foregroundColor != 0x7 && _addColors) {
-                    line.append(u"<font color=\"");
-                    line.append(TELETEXT_COLORS[foregroundColor]);
-                    line.append(u"\">");
-                    fontTagOpened = true;
-                }
+        if (col == colStart) {
+            if (foregroundColor != 0x7 && _addColors) {
+                line.append(u"<font color=\"");
+                line.append(TELETEXT_COLORS[foregroundColor]);
+                line.append(u"\">");
+                fontTagOpened = true;
             }
+        }
 
-            if (col >= colStart) {
-                if (v <= 0x7) {
-                    // ETS 300 706, chapter 12.2: Unless operating in "Hold Mosaics" mode,
-                    // each character space occupied by a spacing attribute is displayed as a SPACE.
-                    if (_addColors) {
-                        if (fontTagOpened) {
-                            line.append(u"</font> ");
-                            fontTagOpened = false;
-                        }
-
-                        // <font/> tags only when needed
-                        if (v > 0x00 && v < 0x07) {
-                            line.append(u"<font color=\"");
-                            line.append(TELETEXT_COLORS[v]);
-                            line.append(u"\">");
-                            fontTagOpened = true;
-                        }
+        if (col >= colStart) {
+            if (v <= 0x7) {
+                // ETS 300 706, chapter 12.2: Unless operating in "Hold Mosaics" mode,
+                // each character space occupied by a spacing attribute is displayed as a SPACE.
+                if (_addColors) {
+                    if (fontTagOpened) {
+                        line.append(u"</font> ");
+                        fontTagOpened = false;
                     }
-                    else {
-                        v = 0x20;
-                    }
-                }
 
-                // Translate some chars into entities, if in colour mode, to replace unsafe HTML tag chars
-                if (v >= 0x20 && _addColors) {
-                    struct HtmlEntity {
-                        UChar character;
-                        const UChar* entity;
-                    };
-                    static const HtmlEntity entities[] = {
-                        {u'<', u"&lt;"},
-                        {u'>', u"&gt;"},
-                        {u'&', u"&amp;"},
-                        {0, nullptr}
-                    };
-                    for (const HtmlEntity* p = entities; p->entity != nullptr; ++p) {
-                        if (v == p->character) {
-                            line.append(p->entity);
-                            v = 0;  // v < 0x20 won't be printed in next block
-                            break;
-                        }
+                    // <font/> tags only when needed
+                    if (v > 0x00 && v < 0x07) {
+                        line.append(u"<font color=\"");
+                        line.append(TELETEXT_COLORS[v]);
+                        line.append(u"\">");
+                        fontTagOpened = true;
                     }
                 }
+                else {
+                    v = 0x20;
+                }
+            }
 
-                if (v >= 0x20) {
-                    line.append(v);
+            // Translate some chars into entities, if in colour mode, to replace unsafe HTML tag chars
+            if (v >= 0x20 && _addColors) {
+                struct HtmlEntity {
+                    UChar character;
+                    const UChar* entity;
+                };
+                static const HtmlEntity entities[] = {
+                    {u'<', u"&lt;"},
+                    {u'>', u"&gt;"},
+                    {u'&', u"&amp;"},
+                    {0, nullptr}
+                };
+                for (const HtmlEntity* p = entities; p->entity != nullptr; ++p) {
+                    if (v == p->character) {
+                        line.append(p->entity);
+                        v = 0;  // v < 0x20 won't be printed in next block
+                        break;
+                    }
                 }
             }
-        }
 
-        // No tag will be left opened!
-        if (_addColors && fontTagOpened) {
-            line.append(u"</font>");
-            fontTagOpened = false;
+            if (v >= 0x20) {
+                line.append(v);
+            }
         }
-
-        // Line is now complete.
-        frame.addLine(line);
     }
 
-    // Now call the user-specified handler.
-    // Note that the super class PESDemux has already placed us in "handler context".
-    if (_txtHandler != nullptr) {
-        _txtHandler->handleTeletextMessage(*this, frame);
+    // No tag will be left opened!
+    if (_addColors && fontTagOpened) {
+        line.append(u"</font>");
+        fontTagOpened = false;
     }
 }
 
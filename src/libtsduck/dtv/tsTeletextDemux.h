@@ -108,6 +108,32 @@ namespace ts {
         //!
         int frameCount(int page, PID pid = PID_NULL) const;
 
+        //!
+        //! Subscribe to a Teletext page in a PID.
+        //! As long as no page is subscribed in a PID, all pages of that PID are decoded and
+        //! reported to the Teletext handler. Once at least one page is subscribed in a PID,
+        //! the Teletext packets from all other pages and magazines of that PID are dropped
+        //! before decoding.
+        //! @param [in] pid Teletext PID.
+        //! @param [in] page Teletext page number (binary, 100 to 899).
+        //! @param [in] handler Specific handler for this page. When null, the frames of
+        //! this page are reported to the handler of the demux.
+        //!
+        void addPage(PID pid, int page, TeletextHandlerInterface* handler = nullptr);
+
+        //!
+        //! Unsubscribe from a Teletext page in a PID.
+        //! When the last page of a PID is unsubscribed, all pages of that PID are decoded again.
+        //! @param [in] pid Teletext PID.
+        //! @param [in] page Teletext page number (binary, 100 to 899).
+        //!
+        void removePage(PID pid, int page);
+
+        //!
+        //! Unsubscribe from all Teletext pages in all PID's.
+        //!
+        void clearPages();
+
     protected:
         // Inherited methods
         virtual void immediateReset() override;
@@ -136,6 +162,9 @@ namespace ts {
             bool            tainted;       //!< True if text variable contains any data.
             TeletextCharset charset;       //!< Charset to use.
             UChar           text[25][40];  //!< 25 lines x 40 cols (1 screen/page) of wide chars.
+            UChar           renderedText[25][40];  //!< Content of text[][] when renderedLines[] were built.
+            UString         renderedLines[25];     //!< Cached rendered rows, empty when the row has no subtitle.
+            bool            renderedColors;        //!< Value of the "add colors" option when renderedLines[] were built.
             //!
             //! Default constructor.
             //!
@@ -173,14 +202,45 @@ namespace ts {
         //!
         typedef std::map<PID, PIDContext> PIDContextMap;
 
+        //!
+        //! Map of page handlers, indexed by BCD page number.
+        //!
+        typedef std::map<int, TeletextHandlerInterface*> PageHandlerMap;
+
+        //!
+        //! Subscribed pages in one PID.
+        //!
+        class Subscription
+        {
+        public:
+            uint16_t       magazines;  //!< Bit mask of subscribed magazines, bit 1 to 8 for magazine 1 to 8.
+            PageHandlerMap pages;      //!< Subscribed pages with their specific handlers.
+            //!
+            //! Default constructor.
+            //!
+            Subscription();
+            //!
+            //! Check if a Teletext packet from a magazine shall be decoded.
+            //! @param [in] magazine Magazine number, 1 to 8.
+            //! @return True if the packet shall be decoded.
+            //!
+            bool hasMagazine(int magazine) const { return (magazines & (1 << magazine)) != 0; }
+        };
+
+        //!
+        //! Map of subscriptions, indexed by PID value.
+        //!
+        typedef std::map<PID, Subscription> SubscriptionMap;
+
         //!
         //! Process one Teletext packet.
         //! @param [in] pid PID number.
         //! @param [in,out] pc PID context.
+        //! @param [in] sub Page subscriptions in this PID, null if all pages are decoded.
         //! @param [in] dataUnitId Teletext packet data unit id.
         //! @param [in] pkt Address of Teletext packet (44 bytes, TELETEXT_PACKET_SIZE).
         //!
-        void processTeletextPacket(PID pid, PIDContext& pc, TeletextDataUnitId dataUnitId, const uint8_t* pkt);
+        void processTeletextPacket(PID pid, PIDContext& pc, const Subscription* sub, TeletextDataUnitId dataUnitId, const uint8_t* pkt);
 
         //!
         //! Process one Teletext page.
@@ -190,6 +250,13 @@ namespace ts {
         //!
         void processTeletextPage(PID pid, PIDContext& pc, int pageNumber);
 
+        //!
+        //! Render one row of a Teletext page as a subtitle line.
+        //! @param [in] text The 40 characters of the row.
+        //! @param [out] line The rendered line, empty if the row contains no subtitle.
+        //!
+        void renderRow(const UChar* text, UString& line) const;
+
         //!
         //! Remove 8/4 Hamming code.
         //! @param [in] a Hamming-encoded byte.
@@ -245,6 +312,7 @@ namespace ts {
         // Private members:
         TeletextHandlerInterface* _txtHandler;    //!< User handler.
         PIDContextMap             _pids;          //!< Map of PID analysis contexts.
+        SubscriptionMap           _subscriptions; //!< Subscribed pages per PID, persistent across resets.
         bool                      _addColors;     //!< Add font color tags.
     };
 }
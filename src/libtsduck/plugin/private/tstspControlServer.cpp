@@ -35,6 +35,7 @@
 #include "tsTelnetConnection.h"
 #include "tsGuard.h"
 #include "tsSysUtils.h"
+#include "tsTextFormatter.h"
 TSDUCK_SOURCE;
 
 
@@ -58,7 +59,8 @@ ts::tsp::ControlServer::ControlServer(TSProcessorArgs& options, Report& log, Mut
               {TSPControlCommand::CMD_LIST,    &ControlServer::executeList},
               {TSPControlCommand::CMD_SUSPEND, &ControlServer::executeSuspend},
               {TSPControlCommand::CMD_RESUME,  &ControlServer::executeResume},
-              {TSPControlCommand::CMD_RESTART, &ControlServer::executeRestart}}
+              {TSPControlCommand::CMD_RESTART, &ControlServer::executeRestart},
+              {TSPControlCommand::CMD_STATS,   &ControlServer::executeStats}}
 {
     // Locate output plugin, count packet processor plugins.
     if (_input != nullptr) {
@@ -356,3 +358,31 @@ void ts::tsp::ControlServer::executeRestart(const Args* args, Report& response)
         plugin->restart(params, response);
     }
 }
+
+
+//----------------------------------------------------------------------------
+// Statistics command.
+//----------------------------------------------------------------------------
+
+void ts::tsp::ControlServer::executeStats(const Args* args, Report& response)
+{
+    const bool reset = args->present(u"reset");
+
+    if (args->present(u"json")) {
+        TextFormatter text(response);
+        text.setString();
+        text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+        PluginStatistics::AllToJSON(_input, reset)->print(text);
+        response.info(text.toString());
+    }
+    else {
+        size_t index = 0;
+        PluginExecutor* proc = _input;
+        do {
+            response.info(u"%2d: %s, packets: %'d, %s", {index++, proc->pluginName(), proc->pluginPackets(), proc->statistics().toText()});
+            if (reset) {
+                proc->statistics().reset();
+            }
+        } while ((proc = proc->ringNext<PluginExecutor>()) != _input);
+    }
+}
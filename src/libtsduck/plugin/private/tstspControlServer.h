@@ -106,6 +106,7 @@ namespace ts {
             void executeResume(const Args*, Report&);
             void executeSuspendResume(bool state, const Args*, Report&);
             void executeRestart(const Args*, Report&);
+            void executeStats(const Args*, Report&);
         };
     }
 }
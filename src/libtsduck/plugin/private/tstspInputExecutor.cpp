@@ -252,7 +252,9 @@ size_t ts::tsp::InputExecutor::receiveAndValidate(size_t index, size_t max_packe
     if (_use_watchdog) {
         _watchdog.restart();
     }
+    const Monotonic receive_start(true);
     size_t count = _input->receive(pkt, data, max_packets);
+    _stats.addProcessing(Monotonic(true) - receive_start, count);
     if (_use_watchdog) {
         _watchdog.suspend();
     }
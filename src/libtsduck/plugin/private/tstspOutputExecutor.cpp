@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tstspOutputExecutor.h"
+#include "tsMonotonic.h"
 TSDUCK_SOURCE;
 
 
@@ -148,15 +149,20 @@ void ts::tsp::OutputExecutor::main()
                     // Don't output packet when the plugin is suspended.
                     addNonPluginPackets(out_cnt);
                 }
-                else if (_output->send(pkt, data, out_cnt)) {
-                    // Packet successfully sent.
-                    addPluginPackets(out_cnt);
-                    output_packets += out_cnt;
-                }
                 else {
-                    // Send error.
-                    aborted = true;
-                    break;
+                    const Monotonic send_start(true);
+                    const bool sent = _output->send(pkt, data, out_cnt);
+                    _stats.addProcessing(Monotonic(true) - send_start, out_cnt);
+                    if (sent) {
+                        // Packet successfully sent.
+                        addPluginPackets(out_cnt);
+                        output_packets += out_cnt;
+                    }
+                    else {
+                        // Send error.
+                        aborted = true;
+                        break;
+                    }
                 }
                 pkt += out_cnt;
                 data += out_cnt;
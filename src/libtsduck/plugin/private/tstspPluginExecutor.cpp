@@ -31,6 +31,7 @@
 #include "tsPluginRepository.h"
 #include "tsGuardCondition.h"
 #include "tsGuard.h"
+#include "tsMonotonic.h"
 TSDUCK_SOURCE;
 
 
@@ -51,12 +52,14 @@ ts::tsp::PluginExecutor::PluginExecutor(const TSProcessorArgs& options,
     _buffer(nullptr),
     _metadata(nullptr),
     _suspended(false),
+    _stats(),
     _handlers(handlers),
     _to_do(),
     _pkt_first(0),
     _pkt_cnt(0),
     _input_end(false),
     _bitrate(0),
+    _pending_since(),
     _restart(false),
     _restart_data()
 {
@@ -168,9 +171,20 @@ bool ts::tsp::PluginExecutor::passPackets(size_t count, BitRate bitrate, bool in
     next->_input_end = next->_input_end || input_end;
 
     // Wake the next processor when there is some new input data or end of input.
-    if (count > 0 || input_end) {
+    // With wake-up batching, wake it only when it had no packet (it will then wait
+    // for more packets up to the latency bound) or when the batch is complete.
+    if (input_end || (count > 0 && _options.wakeup_packets <= 1)) {
         next->_to_do.signal();
     }
+    else if (count > 0) {
+        if (next->_pkt_cnt == count) {
+            next->_pending_since.getSystemTime();
+            next->_to_do.signal();
+        }
+        else if (next->_pkt_cnt >= _options.wakeup_packets) {
+            next->_to_do.signal();
+        }
+    }
 
     // Force to abort our processor when the next one is aborting. Already done in waitWork() but force immediately.
     // Don't do that if current is output and next is input because there is no propagation of packets from output back to input.
@@ -207,16 +221,31 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     GuardCondition lock(_global_mutex, _to_do);
 
     PluginExecutor* next = ringNext<PluginExecutor>();
+    const Monotonic wait_start(true);
     timeout = false;
 
+    // With wake-up batching, try to get a complete batch of packets, within the latency bound.
+    const size_t batch_pkt_cnt = std::min(std::max(min_pkt_cnt, _options.wakeup_packets), _buffer->count());
+
     // Loop until enough packets are available (or some error condition).
-    while (_pkt_cnt < min_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
-        // If packet area for this processor is empty, wait for some packet.
-        // The mutex is implicitely released, we wait for the condition
-        // '_to_do' and, once we get it, implicitely relock the mutex.
-        // We loop on this until packets are actually available.
-        // If there is a timeout in the packet reception, call the plugin handler.
-        timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+    while (_pkt_cnt < batch_pkt_cnt && !_input_end && !timeout && !next->_tsp_aborting) {
+        if (_pkt_cnt < min_pkt_cnt) {
+            // If packet area for this processor is empty, wait for some packet.
+            // The mutex is implicitely released, we wait for the condition
+            // '_to_do' and, once we get it, implicitely relock the mutex.
+            // We loop on this until packets are actually available.
+            // If there is a timeout in the packet reception, call the plugin handler.
+            timeout = !lock.waitCondition(_tsp_timeout) && !plugin()->handlePacketTimeout();
+        }
+        else {
+            // Enough packets for the plugin but the batch is incomplete.
+            // Wait for more packets, until the oldest pending packet reaches the latency bound.
+            const MilliSecond remain = _options.wakeup_latency - (Monotonic(true) - _pending_since) / NanoSecPerMilliSec;
+            if (remain <= 0) {
+                break;
+            }
+            lock.waitCondition(remain);
+        }
     }
 
     // The number of returned packets is limited up to the wrap-up point of the circular buffer,
@@ -243,6 +272,9 @@ void ts::tsp::PluginExecutor::waitWork(size_t min_pkt_cnt, size_t& pkt_first, si
     // there is no propagation of packets from output back to input.
     aborted = plugin()->type() != PluginType::OUTPUT && next->_tsp_aborting;
 
+    // Account the time which was spent waiting and the state of the buffer.
+    _stats.addWakeUp(Monotonic(true) - wait_start, pkt_cnt, _pkt_cnt);
+
     log(10, u"waitWork(min_pkt_cnt = %'d, pkt_first = %'d, pkt_cnt = %'d, bitrate = %'d, input_end = %s, aborted = %s, timeout = %s)",
         {min_pkt_cnt, pkt_first, pkt_cnt, bitrate, input_end, aborted, timeout});
 }
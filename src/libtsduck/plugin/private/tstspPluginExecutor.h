@@ -34,6 +34,7 @@
 
 #pragma once
 #include "tstspJointTermination.h"
+#include "tstspPluginStatistics.h"
 #include "tsRingNode.h"
 #include "tsTSProcessorArgs.h"
 #include "tsPluginEventHandlerRegistry.h"
@@ -42,6 +43,7 @@
 #include "tsCondition.h"
 #include "tsMutex.h"
 #include "tsThread.h"
+#include "tsMonotonic.h"
 
 namespace ts {
     namespace tsp {
@@ -143,6 +145,12 @@ namespace ts {
             //!
             void restart(Report& report);
 
+            //!
+            //! Access the performance statistics of this plugin executor.
+            //! @return A reference to the performance statistics.
+            //!
+            PluginStatistics& statistics() { return _stats; }
+
             // Implementation of TSP virtual methods.
             virtual size_t pluginCount() const override;
             virtual void signalPluginEvent(uint32_t event_code, Object* plugin_data = nullptr) const override;
@@ -151,6 +159,7 @@ namespace ts {
             PacketBuffer*         _buffer;    //!< Description of shared packet buffer.
             PacketMetadataBuffer* _metadata;  //!< Description of shared packet metadata buffer.
             volatile bool         _suspended; //!< The plugin is suspended / resumed.
+            PluginStatistics      _stats;     //!< Performance statistics of this plugin executor.
 
             //!
             //! Pass processed packets to the next packet processor.
@@ -227,6 +236,7 @@ namespace ts {
             size_t         _pkt_cnt;       // Size of packets area [*]
             bool           _input_end;     // No more packet after current ones [*]
             BitRate        _bitrate;       // Input bitrate (set by previous plugin) [*]
+            Monotonic      _pending_since; // Time of the first pending packet when wake-up batching is used [*]
             bool           _restart;       // Restart the plugin asap using _restart_data
             RestartDataPtr _restart_data;  // How to restart the plugin
 
@@ -0,0 +1,215 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspPluginStatistics.h"
+#include "tstspPluginExecutor.h"
+#include "tsjsonArray.h"
+#include "tsjsonNumber.h"
+#include "tsjsonString.h"
+#include "tsGuard.h"
+TSDUCK_SOURCE;
+
+#if defined(TS_NEED_STATIC_CONST_DEFINITIONS)
+constexpr size_t ts::tsp::PluginStatistics::HISTOGRAM_SIZE;
+#endif
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::PluginStatistics::PluginStatistics() :
+    _mutex(),
+    _start(),
+    _wakeups(0),
+    _wakeup_packets(0),
+    _wait_time(0),
+    _process_count(0),
+    _process_packets(0),
+    _process_time(0),
+    _occupancy(),
+    _wait_histo(),
+    _process_histo(),
+    _batch_histo()
+{
+    reset();
+}
+
+
+//----------------------------------------------------------------------------
+// Reset all statistics.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginStatistics::reset()
+{
+    Guard lock(_mutex);
+    _start.getSystemTime();
+    _wakeups = 0;
+    _wakeup_packets = 0;
+    _wait_time = 0;
+    _process_count = 0;
+    _process_packets = 0;
+    _process_time = 0;
+    _occupancy.reset();
+    _wait_histo.fill(0);
+    _process_histo.fill(0);
+    _batch_histo.fill(0);
+}
+
+
+//----------------------------------------------------------------------------
+// Add a value in a logarithmic histogram.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginStatistics::Feed(Histogram& histo, uint64_t value)
+{
+    size_t index = 0;
+    while (value != 0 && index < HISTOGRAM_SIZE - 1) {
+        value >>= 1;
+        index++;
+    }
+    histo[index]++;
+}
+
+
+//----------------------------------------------------------------------------
+// Account wake-ups and processing.
+//----------------------------------------------------------------------------
+
+void ts::tsp::PluginStatistics::addWakeUp(NanoSecond duration, size_t packets, size_t occupancy)
+{
+    Guard lock(_mutex);
+    _wakeups++;
+    _wakeup_packets += packets;
+    _wait_time += duration;
+    _occupancy.feed(occupancy);
+    Feed(_wait_histo, uint64_t(duration / NanoSecPerMicroSec));
+    Feed(_batch_histo, packets);
+}
+
+void ts::tsp::PluginStatistics::addProcessing(NanoSecond duration, size_t packets)
+{
+    Guard lock(_mutex);
+    _process_count++;
+    _process_packets += packets;
+    _process_time += duration;
+    Feed(_process_histo, uint64_t(duration / NanoSecPerMicroSec));
+}
+
+
+//----------------------------------------------------------------------------
+// Observed wake-up rate per second since last reset (mutex must be held).
+//----------------------------------------------------------------------------
+
+ts::PacketCounter ts::tsp::PluginStatistics::wakeUpRate() const
+{
+    const NanoSecond duration = Monotonic(true) - _start;
+    return duration <= 0 ? 0 : PacketCounter((_wakeups * NanoSecPerSec) / duration);
+}
+
+
+//----------------------------------------------------------------------------
+// Build JSON or text representations.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::tsp::PluginStatistics::ToJSON(const Histogram& histo)
+{
+    json::ValuePtr arr(new json::Array);
+    size_t size = HISTOGRAM_SIZE;
+    while (size > 0 && histo[size - 1] == 0) {
+        size--;
+    }
+    for (size_t i = 0; i < size; ++i) {
+        arr->set(int64_t(histo[i]));
+    }
+    return arr;
+}
+
+ts::json::ValuePtr ts::tsp::PluginStatistics::toJSON() const
+{
+    Guard lock(_mutex);
+    json::ValuePtr root(new json::Object);
+    root->add(u"wakeups", int64_t(_wakeups));
+    root->add(u"wakeup-packets", int64_t(_wakeup_packets));
+    root->add(u"wakeups-per-second", int64_t(wakeUpRate()));
+    root->add(u"wait-ns", int64_t(_wait_time));
+    root->add(u"process-count", int64_t(_process_count));
+    root->add(u"process-packets", int64_t(_process_packets));
+    root->add(u"process-ns", int64_t(_process_time));
+    root->add(u"process-ns-per-packet", _process_packets == 0 ? 0 : int64_t(_process_time / NanoSecond(_process_packets)));
+    json::Value& occ(root->value(u"occupancy", true));
+    occ.add(u"min", int64_t(_occupancy.minimum()));
+    occ.add(u"max", int64_t(_occupancy.maximum()));
+    occ.add(u"mean", int64_t(_occupancy.meanRound()));
+    root->add(u"wait-us-log2-histogram", ToJSON(_wait_histo));
+    root->add(u"process-us-log2-histogram", ToJSON(_process_histo));
+    root->add(u"packets-per-wakeup-log2-histogram", ToJSON(_batch_histo));
+    return root;
+}
+
+ts::UString ts::tsp::PluginStatistics::toText() const
+{
+    Guard lock(_mutex);
+    const NanoSecond total = _wait_time + _process_time;
+    return UString::Format(u"wake-ups: %'d (%'d/s), packets/wake-up: %'d, wait: %'d ms (%d%%), process: %'d ms (%d%%), %'d ns/packet, occupancy: %'d (max: %'d)", {
+        _wakeups,
+        wakeUpRate(),
+        _wakeups == 0 ? 0 : _wakeup_packets / _wakeups,
+        _wait_time / NanoSecPerMilliSec,
+        total == 0 ? 0 : (100 * _wait_time) / total,
+        _process_time / NanoSecPerMilliSec,
+        total == 0 ? 0 : (100 * _process_time) / total,
+        _process_packets == 0 ? 0 : _process_time / NanoSecond(_process_packets),
+        _occupancy.meanRound(),
+        _occupancy.maximum()});
+}
+
+
+//----------------------------------------------------------------------------
+// Build a JSON object containing the statistics of all plugins in a chain.
+//----------------------------------------------------------------------------
+
+ts::json::ValuePtr ts::tsp::PluginStatistics::AllToJSON(PluginExecutor* input, bool reset)
+{
+    json::ValuePtr root(new json::Object);
+    json::Value& plugins(root->value(u"plugins", true, json::TypeArray));
+    PluginExecutor* proc = input;
+    do {
+        json::ValuePtr jv(proc->statistics().toJSON());
+        jv->add(u"index", int64_t(proc->pluginIndex()));
+        jv->add(u"name", proc->pluginName());
+        jv->add(u"plugin-packets", int64_t(proc->pluginPackets()));
+        jv->add(u"total-packets", int64_t(proc->totalPacketsInThread()));
+        plugins.set(jv);
+        if (reset) {
+            proc->statistics().reset();
+        }
+    } while ((proc = proc->ringNext<PluginExecutor>()) != input);
+    return root;
+}
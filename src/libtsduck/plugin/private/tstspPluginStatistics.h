@@ -0,0 +1,136 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//!  @file
+//!  Transport stream processor: Performance statistics of a plugin executor
+//!
+//----------------------------------------------------------------------------
+
+#pragma once
+#include "tsSingleDataStatistics.h"
+#include "tsTS.h"
+#include "tsjsonObject.h"
+#include "tsMutex.h"
+#include "tsMonotonic.h"
+
+namespace ts {
+    namespace tsp {
+
+        class PluginExecutor;
+
+        //!
+        //! Performance statistics of a plugin executor in the Transport stream processor.
+        //! All counters are updated by the plugin thread and can be read from any other thread.
+        //! This class is internal to the TSDuck library and cannot be called by applications.
+        //! @ingroup plugin
+        //!
+        class PluginStatistics
+        {
+            TS_NOCOPY(PluginStatistics);
+        public:
+            //!
+            //! Number of buckets in the logarithmic histograms.
+            //! Bucket 0 is for zero values, bucket N for values in the range 2^(N-1) to 2^N - 1.
+            //! The last bucket is for all larger values.
+            //!
+            static constexpr size_t HISTOGRAM_SIZE = 32;
+
+            //!
+            //! Constructor.
+            //!
+            PluginStatistics();
+
+            //!
+            //! Reset all statistics.
+            //!
+            void reset();
+
+            //!
+            //! Account the end of a wait for work (waitWork() in the executor).
+            //! @param [in] duration Time during which the plugin thread was blocked.
+            //! @param [in] packets Number of packets which are returned to the plugin.
+            //! @param [in] occupancy Number of packets in the slice of buffer of the plugin.
+            //!
+            void addWakeUp(NanoSecond duration, size_t packets, size_t occupancy);
+
+            //!
+            //! Account a processing operation in the plugin.
+            //! This is the time spent in processPacket(), processPacketWindow(), send() or receive().
+            //! @param [in] duration Time spent in the plugin.
+            //! @param [in] packets Number of processed packets.
+            //!
+            void addProcessing(NanoSecond duration, size_t packets);
+
+            //!
+            //! Build a JSON object containing the statistics.
+            //! @return A safe pointer to a JSON object.
+            //!
+            json::ValuePtr toJSON() const;
+
+            //!
+            //! Build a one-line text summary of the statistics.
+            //! @return A summary string.
+            //!
+            UString toText() const;
+
+            //!
+            //! Build a JSON object containing the statistics of all plugins in a chain.
+            //! @param [in] input The input plugin executor, the first one in the ring of executors.
+            //! @param [in] reset If true, reset the statistics of all plugins after collecting them.
+            //! @return A safe pointer to a JSON object.
+            //!
+            static json::ValuePtr AllToJSON(PluginExecutor* input, bool reset = false);
+
+        private:
+            typedef std::array<PacketCounter, HISTOGRAM_SIZE> Histogram;
+
+            mutable Mutex _mutex;            // Protect all fields.
+            Monotonic     _start;            // Start time of statistics collection.
+            PacketCounter _wakeups;          // Number of returns from waitWork().
+            PacketCounter _wakeup_packets;   // Total number of packets returned by waitWork().
+            NanoSecond    _wait_time;        // Total time blocked in waitWork().
+            PacketCounter _process_count;    // Number of processing operations.
+            PacketCounter _process_packets;  // Total number of processed packets.
+            NanoSecond    _process_time;     // Total time spent in the plugin.
+            SingleDataStatistics<size_t> _occupancy;  // Occupancy of the buffer slice at each wake-up.
+            Histogram     _wait_histo;       // Wait times in microseconds.
+            Histogram     _process_histo;    // Processing times in microseconds.
+            Histogram     _batch_histo;      // Number of packets per wake-up.
+
+            // Add a value in a logarithmic histogram.
+            static void Feed(Histogram& histo, uint64_t value);
+
+            // Build a JSON array from a histogram, without trailing empty buckets.
+            static json::ValuePtr ToJSON(const Histogram& histo);
+
+            // Observed wake-up rate per second since last reset (mutex must be held).
+            PacketCounter wakeUpRate() const;
+        };
+    }
+}
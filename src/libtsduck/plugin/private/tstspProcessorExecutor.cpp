@@ -28,6 +28,7 @@
 //----------------------------------------------------------------------------
 
 #include "tstspProcessorExecutor.h"
+#include "tsMonotonic.h"
 TSDUCK_SOURCE;
 
 
@@ -164,6 +165,7 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
         // Now process the packets.
         size_t pkt_done = 0;
         size_t pkt_flush = 0;
+        Monotonic process_start(true);
 
         while (pkt_done < pkt_cnt && !aborted) {
 
@@ -245,8 +247,10 @@ void ts::tsp::ProcessorExecutor::processIndividualPackets()
             // Perform periodic flush to avoid waiting too long before two output operations.
             // Also propagate new bitrate values immediately.
             if (pkt_data->getFlush() || got_new_bitrate || pkt_done == pkt_cnt || (_options.max_flush_pkt > 0 && pkt_flush >= _options.max_flush_pkt)) {
+                _stats.addProcessing(Monotonic(true) - process_start, pkt_flush);
                 aborted = !passPackets(pkt_flush, output_bitrate, pkt_done == pkt_cnt && input_end, aborted);
                 pkt_flush = 0;
+                process_start.getSystemTime();
             }
         }
 
@@ -365,7 +369,9 @@ void ts::tsp::ProcessorExecutor::processPacketWindows(size_t window_size)
         }
 
         // Let the plugin process the packet window.
+        const Monotonic process_start(true);
         const size_t processed_packets = _processor->processPacketWindow(win);
+        _stats.addProcessing(Monotonic(true) - process_start, processed_packets);
 
         // If not all packets from the window were processed, the plugin want to terminate the stream processing.
         if (processed_packets < win.size()) {
@@ -0,0 +1,128 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+
+#include "tstspStatisticsReporter.h"
+#include "tstspPluginStatistics.h"
+#include "tsGuardCondition.h"
+#include "tsTextFormatter.h"
+TSDUCK_SOURCE;
+
+// Stack size for the reporter thread
+#define REPORTER_STACK_SIZE (128 * 1024)
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+ts::tsp::StatisticsReporter::StatisticsReporter(const TSProcessorArgs& options, Report& log, InputExecutor* input) :
+    Thread(ThreadAttributes().setPriority(ThreadAttributes::GetMinimumPriority()).setStackSize(REPORTER_STACK_SIZE)),
+    _options(options),
+    _log(log),
+    _input(input),
+    _mutex(),
+    _wake_up(),
+    _terminate(false)
+{
+}
+
+ts::tsp::StatisticsReporter::~StatisticsReporter()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Start/stop the reporting thread.
+//----------------------------------------------------------------------------
+
+bool ts::tsp::StatisticsReporter::open()
+{
+    return _options.stats_interval <= 0 || _input == nullptr || start();
+}
+
+void ts::tsp::StatisticsReporter::close()
+{
+    {
+        GuardCondition lock(_mutex, _wake_up);
+        _terminate = true;
+        lock.signal();
+    }
+    waitForTermination();
+}
+
+
+//----------------------------------------------------------------------------
+// Thread main code.
+//----------------------------------------------------------------------------
+
+void ts::tsp::StatisticsReporter::main()
+{
+    bool terminate = false;
+    while (!terminate) {
+        // Wait until due time or termination request.
+        {
+            GuardCondition lock(_mutex, _wake_up);
+            if (!_terminate) {
+                lock.waitCondition(_options.stats_interval);
+            }
+            terminate = _terminate;
+        }
+        // Always report the statistics, including the last ones on termination.
+        report();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Report the statistics once.
+//----------------------------------------------------------------------------
+
+void ts::tsp::StatisticsReporter::report()
+{
+    const json::ValuePtr root(PluginStatistics::AllToJSON(_input));
+
+    if (_options.stats_file.empty()) {
+        // Log the JSON text on one line.
+        TextFormatter text(_log);
+        text.setString();
+        text.setEndOfLineMode(TextFormatter::EndOfLineMode::SPACING);
+        root->print(text);
+        _log.info(u"stats: " + text.toString());
+    }
+    else {
+        // Rewrite the complete file each time.
+        TextFormatter text(_log);
+        if (text.setFile(_options.stats_file)) {
+            root->print(text);
+            text << ts::endl;
+            text.close();
+        }
+    }
+}
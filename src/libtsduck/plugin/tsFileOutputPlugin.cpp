@@ -39,6 +39,7 @@ TS_REGISTER_OUTPUT_PLUGIN(u"file", ts::FileOutputPlugin);
 const int ts::FileOutputPlugin::REFERENCE = 0;
 
 #define DEF_RETRY_INTERVAL 2000 // milliseconds
+#define PACED_CHUNK_SIZE      7 // packets per paced write
 
 
 //----------------------------------------------------------------------------
@@ -55,7 +56,9 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
     _retry_max(0),
     _start_stuffing(0),
     _stop_stuffing(0),
-    _file()
+    _file(),
+    _pacer_args(),
+    _pacer(this, *tsp_)
 {
     option(u"", 0, STRING, 0, 1);
     help(u"", u"Name of the created output file. Use standard output by default.");
@@ -98,6 +101,8 @@ ts::FileOutputPlugin::FileOutputPlugin(TSP* tsp_) :
     help(u"max-retry",
          u"With --reopen-on-error, specify the maximum number of times the file is reopened on error. "
          u"By default, the file is indefinitely reopened.");
+
+    _pacer_args.defineArgs(*this);
 }
 
 
@@ -121,22 +126,53 @@ bool ts::FileOutputPlugin::getOptions()
     getIntValue(_file_format, u"format", TSPacketFormat::TS);
     getIntValue(_start_stuffing, u"add-start-stuffing", 0);
     getIntValue(_stop_stuffing, u"add-stop-stuffing", 0);
-    return true;
+    return _pacer_args.loadArgs(duck, *this);
 }
 
 bool ts::FileOutputPlugin::start()
 {
     _file.setStuffing(_start_stuffing, _stop_stuffing);
     size_t retry_allowed = _retry_max == 0 ? std::numeric_limits<size_t>::max() : _retry_max;
-    return openAndRetry(false, retry_allowed);
+    if (!openAndRetry(false, retry_allowed)) {
+        return false;
+    }
+    if (_pacer_args.pace) {
+        _pacer_args.configure(_pacer);
+        if (!_pacer.start(PACED_CHUNK_SIZE)) {
+            _file.close(NULLREP);
+            return false;
+        }
+    }
+    return true;
 }
 
 bool ts::FileOutputPlugin::stop()
 {
+    // Write all queued packets, unless tsp is aborting.
+    if (_pacer_args.pace) {
+        _pacer.stop(!tsp->aborting());
+        _pacer.reportStatistics(Severity::Verbose);
+    }
     return _file.close(*tsp);
 }
 
 bool ts::FileOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
+{
+    // With paced output, the packets are written by the pacer thread.
+    return _pacer_args.pace ? _pacer.push(buffer, packet_count, tsp->bitrate()) : writePackets(buffer, pkt_data, packet_count);
+}
+
+bool ts::FileOutputPlugin::handlePacedPackets(OutputPacer& pacer, const TSPacket* packets, size_t count, const Monotonic& due)
+{
+    return writePackets(packets, nullptr, count);
+}
+
+
+//----------------------------------------------------------------------------
+// Write packets in the file, reopen on error if necessary.
+//----------------------------------------------------------------------------
+
+bool ts::FileOutputPlugin::writePackets(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count)
 {
     // Total number of retries.
     size_t retry_allowed = _retry_max == 0 ? std::numeric_limits<size_t>::max() : _retry_max;
@@ -156,7 +192,9 @@ bool ts::FileOutputPlugin::send(const TSPacket* buffer, const TSPacketMetadata*
         // Update counters of actually written packets.
         const size_t written = std::min(size_t(_file.writePacketsCount() - where), packet_count);
         buffer += written;
-        pkt_data += written;
+        if (pkt_data != nullptr) {
+            pkt_data += written;
+        }
         packet_count -= written;
 
         // Close the file and try to reopen it a number of times.
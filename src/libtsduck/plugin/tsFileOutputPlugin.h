@@ -35,13 +35,15 @@
 #pragma once
 #include "tsOutputPlugin.h"
 #include "tsTSFile.h"
+#include "tsOutputPacer.h"
+#include "tsOutputPacerArgs.h"
 
 namespace ts {
     //!
     //! File output plugin for tsp.
     //! @ingroup plugin
     //!
-    class TSDUCKDLL FileOutputPlugin: public OutputPlugin
+    class TSDUCKDLL FileOutputPlugin: public OutputPlugin, private OutputPacerHandlerInterface
     {
         TS_NOBUILD_NOCOPY(FileOutputPlugin);
     public:
@@ -72,9 +74,17 @@ namespace ts {
         size_t            _start_stuffing;
         size_t            _stop_stuffing;
         TSFile            _file;
+        OutputPacerArgs   _pacer_args;
+        OutputPacer       _pacer;
 
         // Open the file, retry on error if necessary.
         // Use max number of retries. Updated with remaining number of retries.
         bool openAndRetry(bool initial_wait, size_t& retry_allowed);
+
+        // Write packets in the file, reopen on error if necessary.
+        bool writePackets(const TSPacket* buffer, const TSPacketMetadata* pkt_data, size_t packet_count);
+
+        // Implementation of OutputPacerHandlerInterface.
+        virtual bool handlePacedPackets(OutputPacer& pacer, const TSPacket* packets, size_t count, const Monotonic& due) override;
     };
 }
@@ -42,6 +42,9 @@ const int ts::IPOutputPlugin::REFERENCE = 0;
 #define DEF_PACKET_BURST    7  // 1316 B, fits (with headers) in Ethernet MTU
 #define MAX_PACKET_BURST  128  // ~ 48 kB
 
+// Lead time of paced datagrams when using SO_TXTIME.
+#define TXTIME_LEAD_US   1000  // microseconds
+
 
 //----------------------------------------------------------------------------
 // Output constructor
@@ -73,7 +76,10 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
     _pkt_count(0),
     _sock(false, *tsp_),
     _out_count(0),
-    _out_buffer()
+    _out_buffer(),
+    _txtime(false),
+    _pacer_args(),
+    _pacer(this, *tsp_)
 {
     option(u"", 0, STRING, 1, 1);
     help(u"",
@@ -103,6 +109,13 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
          u"Specifies the maximum number of TS packets per UDP packet. "
          u"The default is " TS_STRINGIFY(DEF_PACKET_BURST) u", the maximum is " TS_STRINGIFY(MAX_PACKET_BURST) u".");
 
+    option(u"txtime");
+    help(u"txtime",
+         u"Implies --pace. Use the SO_TXTIME socket option: the datagrams are handed to the kernel "
+         u"" TS_STRINGIFY(TXTIME_LEAD_US) u" microseconds before their due time and the kernel transmits "
+         u"them at the precise due time. This requires a time-based queueing discipline such as \"etf\" "
+         u"on the network interface. Currently supported on Linux only.");
+
     option(u"tos", 's', INTEGER, 0, 1, 1, 255);
     help(u"tos",
          u"Specifies the TOS (Type-Of-Service) socket option. Setting this value "
@@ -139,6 +152,8 @@ ts::IPOutputPlugin::IPOutputPlugin(TSP* tsp_) :
     help(u"ssrc-identifier",
         u"With --rtp, specify the SSRC identifier. "
         u"By default, use a random value. Do not modify unless there is a good reason to do so.");
+
+    _pacer_args.defineArgs(*this);
 }
 
 
@@ -173,6 +188,11 @@ bool ts::IPOutputPlugin::getOptions()
     _rtp_fixed_ssrc = present(u"ssrc-identifier");
     _rtp_user_ssrc = intValue<uint32_t>(u"ssrc-identifier");
     _pcr_user_pid = intValue<PID>(u"pcr-pid", PID_NULL);
+    _txtime = present(u"txtime");
+    if (!_pacer_args.loadArgs(duck, *this)) {
+        return false;
+    }
+    _pacer_args.pace = _pacer_args.pace || _txtime;
     return true;
 }
 
@@ -194,7 +214,8 @@ bool ts::IPOutputPlugin::start()
         !_sock.setDefaultDestination(_destination, *tsp) ||
         (!_local_addr.empty() && !_sock.setOutgoingMulticast(_local_addr, *tsp)) ||
         (_tos >= 0 && !_sock.setTOS(_tos, *tsp)) ||
-        (_ttl > 0 && !_sock.setTTL(_ttl, *tsp)))
+        (_ttl > 0 && !_sock.setTTL(_ttl, *tsp)) ||
+        (_txtime && !_sock.setTransmitTime(true, *tsp)))
     {
         _sock.close(*tsp);
         return false;
@@ -234,6 +255,20 @@ bool ts::IPOutputPlugin::start()
     _rtp_pcr_offset = 0;
     _pkt_count = 0;
 
+    // Start the paced output engine.
+    if (_pacer_args.pace) {
+        _pacer_args.configure(_pacer);
+        if (_txtime) {
+            // The kernel transmits at the precise time, no need to busy-poll.
+            _pacer.setLeadTime(TXTIME_LEAD_US * NanoSecPerMicroSec);
+            _pacer.setSpinTime(0);
+        }
+        if (!_pacer.start(_pkt_burst)) {
+            _sock.close(*tsp);
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -244,6 +279,11 @@ bool ts::IPOutputPlugin::start()
 
 bool ts::IPOutputPlugin::stop()
 {
+    // Emit all queued datagrams, unless tsp is aborting.
+    if (_pacer_args.pace) {
+        _pacer.stop(!tsp->aborting());
+        _pacer.reportStatistics(Severity::Verbose);
+    }
     _sock.close(*tsp);
     return true;
 }
@@ -274,7 +314,7 @@ bool ts::IPOutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pkt_d
 
         // Send the output buffer when full.
         if (_out_count == _pkt_burst) {
-            if (!sendDatagram(_out_buffer.data(), _out_count)) {
+            if (!emitDatagram(_out_buffer.data(), _out_count)) {
                 return false;
             }
             _out_count = 0;
@@ -284,7 +324,7 @@ bool ts::IPOutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pkt_d
     // Send subsequent packets from the global buffer.
     while (packet_count > min_burst) {
         size_t count = std::min(packet_count, _pkt_burst);
-        if (!sendDatagram(pkt, count)) {
+        if (!emitDatagram(pkt, count)) {
             return false;
         }
         pkt += count;
@@ -303,11 +343,26 @@ bool ts::IPOutputPlugin::send(const TSPacket* pkt, const TSPacketMetadata* pkt_d
 }
 
 
+//----------------------------------------------------------------------------
+// Send contiguous packets in one single datagram, immediately or through the pacer.
+//----------------------------------------------------------------------------
+
+bool ts::IPOutputPlugin::emitDatagram(const TSPacket* pkt, size_t packet_count)
+{
+    return _pacer_args.pace ? _pacer.push(pkt, packet_count, tsp->bitrate()) : sendDatagram(pkt, packet_count);
+}
+
+bool ts::IPOutputPlugin::handlePacedPackets(OutputPacer& pacer, const TSPacket* packets, size_t count, const Monotonic& due)
+{
+    return sendDatagram(packets, count, &due);
+}
+
+
 //----------------------------------------------------------------------------
 // Send contiguous packets in one single datagram.
 //----------------------------------------------------------------------------
 
-bool ts::IPOutputPlugin::sendDatagram(const TSPacket* pkt, size_t packet_count)
+bool ts::IPOutputPlugin::sendDatagram(const TSPacket* pkt, size_t packet_count, const Monotonic* due)
 {
     bool status = true;
 
@@ -399,11 +454,11 @@ bool ts::IPOutputPlugin::sendDatagram(const TSPacket* pkt, size_t packet_count)
 
         // Copy the TS packets after the RTP header and send the packets.
         ::memcpy(buffer.data() + RTP_HEADER_SIZE, pkt, packet_count * PKT_SIZE);
-        status = _sock.send(buffer.data(), buffer.size(), *tsp);
+        status = due == nullptr ? _sock.send(buffer.data(), buffer.size(), *tsp) : _sock.sendAt(buffer.data(), buffer.size(), *due, *tsp);
     }
     else {
         // No RTP, send TS packets directly as datagram.
-        status = _sock.send(pkt, packet_count * PKT_SIZE, *tsp);
+        status = due == nullptr ? _sock.send(pkt, packet_count * PKT_SIZE, *tsp) : _sock.sendAt(pkt, packet_count * PKT_SIZE, *due, *tsp);
     }
 
     // Count packets datagram per datagram.
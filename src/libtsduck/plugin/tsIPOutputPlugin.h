@@ -35,13 +35,15 @@
 #pragma once
 #include "tsOutputPlugin.h"
 #include "tsUDPSocket.h"
+#include "tsOutputPacer.h"
+#include "tsOutputPacerArgs.h"
 
 namespace ts {
     //!
     //! IP output plugin for tsp.
     //! @ingroup plugin
     //!
-    class TSDUCKDLL IPOutputPlugin: public OutputPlugin
+    class TSDUCKDLL IPOutputPlugin: public OutputPlugin, private OutputPacerHandlerInterface
     {
         TS_NOBUILD_NOCOPY(IPOutputPlugin);
     public:
@@ -89,8 +91,18 @@ namespace ts {
         UDPSocket      _sock;               // Outgoing socket
         size_t         _out_count;          // Number of packets in _out_buffer
         TSPacketVector _out_buffer;         // Buffered packets for output with --enforce-burst
+        bool           _txtime;             // Use SO_TXTIME with paced output
+        OutputPacerArgs _pacer_args;        // Paced output options
+        OutputPacer    _pacer;              // Paced output engine
+
+        // Send contiguous packets in one single datagram, immediately or through the pacer.
+        bool emitDatagram(const TSPacket* pkt, size_t packet_count);
 
         // Send contiguous packets in one single datagram.
-        bool sendDatagram(const TSPacket* pkt, size_t packet_count);
+        // When due is not null, the datagram is sent at this time when SO_TXTIME is used.
+        bool sendDatagram(const TSPacket* pkt, size_t packet_count, const Monotonic* due = nullptr);
+
+        // Implementation of OutputPacerHandlerInterface.
+        virtual bool handlePacedPackets(OutputPacer& pacer, const TSPacket* packets, size_t count, const Monotonic& due) override;
     };
 }
@@ -150,12 +150,18 @@ size_t ts::PushInputPlugin::receive(TSPacket* buffer, TSPacketMetadata* pkt_data
     }
 
     size_t count = 0;
+    const TSPacket* queued = nullptr;
+    size_t queued_count = 0;
     BitRate bitrate = 0;
 
-    // Wait for some packets from the receiver thread.
-    if (!_queue.waitPackets(buffer, max_packets, count, bitrate)) {
-        // End of input.
-        count = 0;
+    // Wait for some packets from the receiver thread, then get as many packets as possible.
+    // The queued packets are returned in two contiguous parts when the queue wraps up.
+    // Zero packet means end of input.
+    while (count < max_packets && _queue.borrowRead(queued, queued_count, bitrate, count == 0)) {
+        queued_count = std::min(queued_count, max_packets - count);
+        TSPacket::Copy(buffer + count, queued, queued_count);
+        _queue.releaseRead(queued_count);
+        count += queued_count;
     }
 
     assert(count <= max_packets);
@@ -183,7 +189,7 @@ bool ts::PushInputPlugin::pushPackets(const TSPacket* buffer, size_t count)
         }
 
         // Wait for space in the queue buffer.
-        if (!_queue.lockWriteBuffer(out_buffer, out_count, count)) {
+        if (!_queue.reserveWrite(out_buffer, out_count, count)) {
             return false;
         }
 
@@ -199,7 +205,7 @@ bool ts::PushInputPlugin::pushPackets(const TSPacket* buffer, size_t count)
         count -= out_count;
 
         // Signal the new packets in the queue.
-        _queue.releaseWriteBuffer(out_count);
+        _queue.commitWrite(out_count);
     }
 
     return true;
@@ -35,7 +35,7 @@
 #pragma once
 #include "tsInputPlugin.h"
 #include "tsThread.h"
-#include "tsTSPacketQueue.h"
+#include "tsTSPacketSPSCQueue.h"
 
 namespace ts {
     //!
@@ -142,10 +142,10 @@ namespace ts {
         };
 
         // Plugin private data.
-        Receiver      _receiver;
-        bool          _started;
-        volatile bool _interrupted;
-        TSPacketQueue _queue;
+        Receiver          _receiver;
+        bool              _started;
+        volatile bool     _interrupted;
+        TSPacketSPSCQueue _queue;
 
         // Standard input routine, now hidden from subclasses.
         virtual size_t receive(TSPacket*, TSPacketMetadata*, size_t) override;
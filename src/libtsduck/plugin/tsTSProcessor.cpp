@@ -32,6 +32,7 @@
 #include "tstspOutputExecutor.h"
 #include "tstspProcessorExecutor.h"
 #include "tstspControlServer.h"
+#include "tstspStatisticsReporter.h"
 #include "tsMonotonic.h"
 #include "tsGuard.h"
 TSDUCK_SOURCE;
@@ -51,6 +52,7 @@ ts::TSProcessor::TSProcessor(Report& report) :
     _output(nullptr),
     _monitor(&_report),
     _control(nullptr),
+    _stats(nullptr),
     _packet_buffer(nullptr),
     _metadata_buffer(nullptr)
 {
@@ -69,6 +71,12 @@ ts::TSProcessor::~TSProcessor()
 
 void ts::TSProcessor::cleanupInternal()
 {
+    // Terminate the statistics reporter before deleting the plugin executors.
+    if (_stats != nullptr) {
+        delete _stats;
+        _stats = nullptr;
+    }
+
     // Abort and wait for threads to terminate
     tsp::PluginExecutor* proc = _input;
     do {
@@ -108,6 +116,48 @@ void ts::TSProcessor::cleanupInternal()
 }
 
 
+//----------------------------------------------------------------------------
+// Check that a CPU affinity can be applied, before starting any thread.
+//----------------------------------------------------------------------------
+
+namespace {
+    bool CheckCPUAffinity(const std::set<size_t>& cpus, ts::Report& report)
+    {
+#if defined(TS_LINUX)
+        // The system validates the mask on the current thread, the initial mask is restored.
+        // An empty set means no specific affinity.
+        if (cpus.empty()) {
+            return true;
+        }
+        ::cpu_set_t initial;
+        ::cpu_set_t mask;
+        CPU_ZERO(&initial);
+        CPU_ZERO(&mask);
+        for (auto it = cpus.begin(); it != cpus.end(); ++it) {
+            if (*it < CPU_SETSIZE) {
+                CPU_SET(*it, &mask);
+            }
+        }
+        const ::pthread_t self = ::pthread_self();
+        if (::pthread_getaffinity_np(self, sizeof(initial), &initial) != 0) {
+            return true;  // cannot check, let the plugin threads fail
+        }
+        const int err = ::pthread_setaffinity_np(self, sizeof(mask), &mask);
+        if (err != 0) {
+            ts::UStringList list;
+            for (auto it = cpus.begin(); it != cpus.end(); ++it) {
+                list.push_back(ts::UString::Decimal(*it, 0, true, ts::UString()));
+            }
+            report.error(u"invalid CPU affinity %s (%s)", {ts::UString::Join(list, u","), ts::SysErrorCodeMessage(err)});
+            return false;
+        }
+        ::pthread_setaffinity_np(self, sizeof(initial), &initial);
+#endif
+        return true;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Start the TS processing.
 //----------------------------------------------------------------------------
@@ -130,6 +180,13 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // Check or adjust a few parameters.
         _args.ts_buffer_size = std::max(_args.ts_buffer_size, TSProcessorArgs::MIN_BUFFER_SIZE);
 
+        // Check all CPU affinities before starting anything.
+        for (size_t i = 0; i <= _args.plugins.size() + 1; ++i) {
+            if (!CheckCPUAffinity(_args.pluginCPUAffinity(i), _report)) {
+                return false;
+            }
+        }
+
         // Clear errors on the report, used to check further initialisation errors.
         _report.resetErrors();
 
@@ -140,10 +197,10 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         // plugin has a hight priority to make room in the buffer, but not as
         // high as the input which must remain the top-most priority?
 
-        _input = new tsp::InputExecutor(_args, *this, _args.input, ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()), _mutex, &_report);
+        _input = new tsp::InputExecutor(_args, *this, _args.input, ThreadAttributes().setPriority(ts::ThreadAttributes::GetMaximumPriority()).setAffinity(_args.pluginCPUAffinity(0)), _mutex, &_report);
         CheckNonNull(_input);
 
-        _output = new tsp::OutputExecutor(_args, *this, _args.output, ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()), _mutex, &_report);
+        _output = new tsp::OutputExecutor(_args, *this, _args.output, ThreadAttributes().setPriority(ts::ThreadAttributes::GetHighPriority()).setAffinity(_args.pluginCPUAffinity(_args.plugins.size() + 1)), _mutex, &_report);
         CheckNonNull(_output);
 
         _output->ringInsertAfter(_input);
@@ -152,7 +209,7 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         bool realtime = _args.realtime == Tristate::TRUE || _input->isRealTime() || _output->isRealTime();
 
         for (size_t i = 0; i < _args.plugins.size(); ++i) {
-            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, ThreadAttributes(), _mutex, &_report);
+            tsp::PluginExecutor* p = new tsp::ProcessorExecutor(_args, *this, i, ThreadAttributes().setAffinity(_args.pluginCPUAffinity(i + 1)), _mutex, &_report);
             CheckNonNull(p);
             p->ringInsertBefore(_output);
             realtime = realtime || p->isRealTime();
@@ -186,17 +243,24 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
         } while ((proc = proc->ringNext<ts::tsp::PluginExecutor>()) != _input);
 
         // Allocate a memory-resident buffer of TS packets
-        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE);
+        _packet_buffer = new PacketBuffer(_args.ts_buffer_size / ts::PKT_SIZE, _args.huge_page_size, _args.numa_node);
         CheckNonNull(_packet_buffer);
         if (!_packet_buffer->isLocked()) {
             _report.verbose(u"tsp: buffer failed to lock into physical memory (%d: %s), risk of real-time issue",
                             {_packet_buffer->lockErrorCode(), ts::SysErrorCodeMessage(_packet_buffer->lockErrorCode())});
         }
+        if (_args.huge_page_size > 0 && !_packet_buffer->isHugePages()) {
+            _report.verbose(u"tsp: no huge page of %'d bytes available, using normal pages", {_args.huge_page_size});
+        }
+        if (_packet_buffer->numaErrorCode() != SYS_SUCCESS) {
+            _report.warning(u"tsp: buffer failed to bind to NUMA node %d (%d: %s)",
+                            {_args.numa_node, _packet_buffer->numaErrorCode(), ts::SysErrorCodeMessage(_packet_buffer->numaErrorCode())});
+        }
         _report.debug(u"tsp: buffer size: %'d TS packets, %'d bytes", {_packet_buffer->count(), _packet_buffer->count() * ts::PKT_SIZE});
 
-        // Buffer for the packet metadata.
+        // Buffer for the packet metadata, on the same NUMA node.
         // A packet and its metadata have the same index in their respective buffer.
-        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count());
+        _metadata_buffer = new PacketMetadataBuffer(_packet_buffer->count(), 0, _args.numa_node);
         CheckNonNull(_metadata_buffer);
 
         // End of locked section.
@@ -233,7 +297,9 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
     // Start all plugin executors threads.
     tsp::PluginExecutor* proc = _input;
     do {
-        proc->start();
+        if (!proc->start()) {
+            _report.error(u"cannot start the thread of plugin %s", {proc->pluginName()});
+        }
     } while ((proc = proc->ringNext<tsp::PluginExecutor>()) != _input);
 
     // Create a control server thread. Display but ignore errors (not a fatal error).
@@ -241,6 +307,13 @@ bool ts::TSProcessor::start(const TSProcessorArgs& args)
     CheckNonNull(_control);
     _control->open();
 
+    // Create a statistics reporter thread. Display but ignore errors (not a fatal error).
+    _stats = new tsp::StatisticsReporter(_args, _report, _input);
+    CheckNonNull(_stats);
+    if (!_stats->open()) {
+        _report.error(u"error starting the statistics reporter thread");
+    }
+
     return true;
 }
 
@@ -47,6 +47,7 @@ namespace ts {
         class InputExecutor;
         class OutputExecutor;
         class ControlServer;
+        class StatisticsReporter;
     }
     //! @endcond
 
@@ -118,6 +119,7 @@ namespace ts {
         tsp::OutputExecutor*  _output;           // Output processor execution thread.
         SystemMonitor         _monitor;          // System monitor thread.
         tsp::ControlServer*   _control;          // TSP control command server thread.
+        tsp::StatisticsReporter* _stats;         // Periodic report of plugin statistics.
         PacketBuffer*         _packet_buffer;    // Global TS packet buffer.
         PacketMetadataBuffer* _metadata_buffer;  // Global packet metabata buffer.
 
@@ -42,6 +42,8 @@ constexpr size_t ts::TSProcessorArgs::MIN_BUFFER_SIZE;
 #define DEF_MAX_FLUSH_PKT_OFL          10000  // packets
 #define DEF_MAX_FLUSH_PKT_RT            1000  // packets
 #define DEF_MAX_INPUT_PKT_OFL              0  // packets
+#define DEF_WAKEUP_LATENCY_RT              2  // milliseconds
+#define DEF_WAKEUP_LATENCY_OFL           100  // milliseconds
 #define DEF_MAX_INPUT_PKT_RT            1000  // packets
 #define DEF_CONTROL_TIMEOUT             5000  // milliseconds
 
@@ -56,6 +58,10 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     ignore_jt(false),
     log_plugin_index(false),
     ts_buffer_size(DEFAULT_BUFFER_SIZE),
+    huge_page_size(0),
+    numa_node(-1),
+    cpu_affinity(),
+    plugin_cpu_affinity(),
     max_flush_pkt(0),
     max_input_pkt(0),
     init_input_pkt(0),
@@ -73,6 +79,10 @@ ts::TSProcessorArgs::TSProcessorArgs() :
     control_reuse(false),
     control_sources(),
     control_timeout(DEF_CONTROL_TIMEOUT),
+    stats_interval(0),
+    stats_file(),
+    wakeup_packets(1),
+    wakeup_latency(0),
     duck_args(),
     input(),
     plugins(),
@@ -127,6 +137,17 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"the buffer between the input and output devices. The default "
               u"is " + UString::Decimal(DEFAULT_BUFFER_SIZE / 1000000) + u" MB.");
 
+    args.option(u"cpu-affinity", 0, Args::STRING, 0, Args::UNLIMITED_COUNT);
+    args.help(u"cpu-affinity", u"[index:]cpu-list",
+              u"Specify the CPU affinity of the threads which execute the plugins. "
+              u"The CPU list is a comma-separated list of CPU indexes or ranges of CPU indexes, "
+              u"for instance \"0-3,8\". When the value starts with a plugin index and a colon, "
+              u"the affinity applies to this plugin only. The input plugin has index 0, the first "
+              u"packet processor has index 1, etc. and the output plugin is the last one. "
+              u"When there is no plugin index, the affinity applies to all plugins which have "
+              u"no explicit affinity. Several --cpu-affinity options are allowed. "
+              u"CPU affinities are currently supported on Linux and Windows only.");
+
     args.option(u"control-port", 0, Args::UINT16);
     args.help(u"control-port",
               u"Specify the TCP port on which tsp listens for control commands. "
@@ -155,6 +176,18 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"Specify the reception timeout in milliseconds for control commands. "
               u"The default timeout is " TS_STRINGIFY(DEF_CONTROL_TIMEOUT) u" ms.");
 
+    args.option(u"huge-pages", 0, Enumeration({
+        {u"2MB", 2 * 1024 * 1024},
+        {u"1GB", 1024 * 1024 * 1024},
+    }), 0, 1, true);
+    args.help(u"huge-pages", u"size",
+              u"Allocate the global buffer of TS packets in huge pages of the specified size. "
+              u"The default huge page size is 2MB. Huge pages shall be reserved in the system "
+              u"(see /proc/sys/vm/nr_hugepages or the hugepages= kernel parameter). "
+              u"When no huge page is available, tsp falls back to normal pages and requests "
+              u"transparent huge pages. Huge pages reduce the TLB misses when plugins access "
+              u"a large buffer. Huge pages are currently supported on Linux only.");
+
     args.option(u"ignore-joint-termination", 'i');
     args.help(u"ignore-joint-termination",
               u"Ignore all --joint-termination options in plugins. "
@@ -208,6 +241,27 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"This includes CPU load, virtual memory usage. Useful to verify the "
               u"stability of the application.");
 
+    args.option(u"numa-node", 0, Args::INTEGER, 0, 1, 0, 1023);
+    args.help(u"numa-node",
+              u"Allocate the global buffer of TS packets on the specified NUMA node. "
+              u"Additionally, unless --cpu-affinity is specified without plugin index, "
+              u"the threads which execute the plugins run on the CPU's of this NUMA node. "
+              u"NUMA nodes are currently supported on Linux only.");
+
+    args.option(u"statistics-file", 0, Args::STRING);
+    args.help(u"statistics-file", u"filename",
+              u"With --statistics-interval, write the performance statistics of all plugins "
+              u"in the specified JSON file. The file is rewritten at each interval. "
+              u"By default, the JSON statistics are logged on one line, prefixed by \"stats:\".");
+
+    args.option(u"statistics-interval", 0, Args::POSITIVE);
+    args.help(u"statistics-interval", u"seconds",
+              u"Periodically report the performance statistics of all plugins in JSON format: "
+              u"time spent in the plugin, time waiting for packets, packets per wake-up and "
+              u"occupancy of the buffer, with histograms. This can be used to find which plugin "
+              u"is the bottleneck in a chain of plugins. The statistics are also available "
+              u"using the command \"tspcontrol stats\" when --control-port is used.");
+
     args.option(u"realtime", 'r', Args::TRISTATE, 0, 1, -255, 256, true);
     args.help(u"realtime",
               u"Specifies if tsp and all plugins should use default values for real-time "
@@ -217,6 +271,23 @@ void ts::TSProcessorArgs::defineArgs(Args& args) const
               u"are enforced. The explicit values 'no', 'false', 'off' are used to enforce "
               u"the offline defaults and the explicit values 'yes', 'true', 'on' are used "
               u"to enforce the real-time defaults.");
+
+    args.option(u"wakeup-latency", 0, Args::POSITIVE);
+    args.help(u"wakeup-latency", u"milliseconds",
+              u"With --wakeup-packets, specify the maximum time a packet can wait in the buffer "
+              u"before the next plugin is woken up, even if the batch of packets is incomplete. "
+              u"The default is " + UString::Decimal(DEF_WAKEUP_LATENCY_RT) + u" ms in real-time mode and " +
+              UString::Decimal(DEF_WAKEUP_LATENCY_OFL) + u" ms in offline mode.");
+
+    args.option(u"wakeup-packets", 0, Args::POSITIVE);
+    args.help(u"wakeup-packets",
+              u"Specify the number of packets which are passed to a plugin before waking it up. "
+              u"By default, a plugin is woken up each time the previous plugin passes packets, "
+              u"even one packet. With many plugins or at low bitrates, this can cause a large "
+              u"number of context switches. With this option, each plugin waits for a batch of "
+              u"packets, within the latency bound of --wakeup-latency. "
+              u"The observed wake-up rate is reported in the statistics (see --statistics-interval). "
+              u"A typical value is 64 packets.");
 }
 
 
@@ -230,6 +301,8 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
     monitor = args.present(u"monitor");
     log_plugin_index = args.present(u"log-plugin-index");
     ts_buffer_size = args.intValue<size_t>(u"buffer-size-mb", DEFAULT_BUFFER_SIZE);
+    huge_page_size = args.present(u"huge-pages") ? args.intValue<size_t>(u"huge-pages", 2 * 1024 * 1024) : 0;
+    numa_node = args.intValue<int>(u"numa-node", -1);
     fixed_bitrate = args.intValue<BitRate>(u"bitrate", 0);
     bitrate_adj = MilliSecPerSec * args.intValue(u"bitrate-adjust-interval", DEF_BITRATE_INTERVAL);
     max_flush_pkt = args.intValue<size_t>(u"max-flushed-packets", 0);
@@ -243,6 +316,10 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
     control_port = args.intValue<uint16_t>(u"control-port", 0);
     control_timeout = args.intValue<MilliSecond>(u"control-timeout", DEF_CONTROL_TIMEOUT);
     control_reuse = args.present(u"control-reuse-port");
+    stats_interval = MilliSecPerSec * args.intValue<MilliSecond>(u"statistics-interval", 0);
+    args.getValue(stats_file, u"statistics-file");
+    wakeup_packets = args.intValue<size_t>(u"wakeup-packets", 1);
+    wakeup_latency = args.intValue<MilliSecond>(u"wakeup-latency", 0);
 
     // Convert MB in MiB for buffer size for compatibility with original versions.
     ts_buffer_size = size_t((uint64_t(ts_buffer_size) * 1024 * 1024) / 1000000);
@@ -290,6 +367,34 @@ bool ts::TSProcessorArgs::loadArgs(DuckContext& duck, Args& args)
         plugins.clear();
     }
 
+    // Decode --cpu-affinity [index:]cpu-list.
+    cpu_affinity.clear();
+    plugin_cpu_affinity.clear();
+    for (size_t i = 0; i < args.count(u"cpu-affinity"); ++i) {
+        const UString value(args.value(u"cpu-affinity", u"", i));
+        const size_t colon = value.find(u':');
+        size_t index = 0;
+        std::set<size_t> cpus;
+        if (colon == NPOS && DecodeCPUList(value, cpus)) {
+            cpu_affinity = cpus;
+        }
+        else if (colon != NPOS && value.substr(0, colon).toInteger(index) && index <= plugins.size() + 1 && DecodeCPUList(value.substr(colon + 1), cpus)) {
+            plugin_cpu_affinity[index] = cpus;
+        }
+        else {
+            args.error(u"invalid value \"%s\" for --cpu-affinity", {value});
+        }
+    }
+
+    // With --numa-node, the default CPU affinity is the set of CPU's of the NUMA node.
+    if (numa_node >= 0 && cpu_affinity.empty()) {
+        UStringList lines;
+        if (!UString::Load(lines, UString::Format(u"/sys/devices/system/node/node%d/cpulist", {numa_node})) || lines.empty() || !DecodeCPUList(lines.front(), cpu_affinity)) {
+            args.warning(u"cannot get the list of CPU's of NUMA node %d, plugin threads are not bound to it", {numa_node});
+            cpu_affinity.clear();
+        }
+    }
+
     // Get default options for TSDuck contexts in each plugin.
     duck.saveArgs(duck_args);
 
@@ -309,4 +414,59 @@ void ts::TSProcessorArgs::applyDefaults(bool rt)
     if (max_input_pkt == 0) {
         max_input_pkt = rt ? DEF_MAX_INPUT_PKT_RT: DEF_MAX_INPUT_PKT_OFL;
     }
+    if (wakeup_latency == 0) {
+        wakeup_latency = rt ? DEF_WAKEUP_LATENCY_RT : DEF_WAKEUP_LATENCY_OFL;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get the CPU affinity of the thread executing a plugin.
+//----------------------------------------------------------------------------
+
+const std::set<size_t>& ts::TSProcessorArgs::pluginCPUAffinity(size_t plugin_index) const
+{
+    const auto it = plugin_cpu_affinity.find(plugin_index);
+    return it == plugin_cpu_affinity.end() ? cpu_affinity : it->second;
+}
+
+
+//----------------------------------------------------------------------------
+// Decode a list of CPU's, e.g. "0-3,8,10-11".
+//----------------------------------------------------------------------------
+
+bool ts::TSProcessorArgs::DecodeCPUList(const UString& list, std::set<size_t>& cpus)
+{
+    // Only the size of the system affinity masks is checked here. CPU numbers may be
+    // sparse and some CPU's may be offline, the actual CPU's are checked by the system
+    // when the affinity is applied.
+#if defined(TS_LINUX)
+    const size_t max_cpus = CPU_SETSIZE;
+#elif defined(TS_WINDOWS)
+    const size_t max_cpus = 8 * sizeof(::DWORD_PTR);
+#else
+    const size_t max_cpus = 0;
+#endif
+
+    cpus.clear();
+    UStringVector ranges;
+    list.split(ranges, u',', true, true);
+    for (auto it = ranges.begin(); it != ranges.end(); ++it) {
+        const size_t dash = it->find(u'-');
+        size_t first = 0;
+        size_t last = 0;
+        if (dash == NPOS && it->toInteger(first)) {
+            last = first;
+        }
+        else if (dash == NPOS || !it->substr(0, dash).toInteger(first) || !it->substr(dash + 1).toInteger(last) || first > last) {
+            return false;
+        }
+        if (max_cpus > 0 && last >= max_cpus) {
+            return false;
+        }
+        for (size_t cpu = first; cpu <= last; ++cpu) {
+            cpus.insert(cpu);
+        }
+    }
+    return !cpus.empty();
 }
@@ -51,6 +51,10 @@ namespace ts {
         bool            ignore_jt;        //!< Ignore "joint termination" options in plugins.
         bool            log_plugin_index; //!< Log plugin index with plugin name.
         size_t          ts_buffer_size;   //!< Size in bytes of the global TS packet buffer.
+        size_t          huge_page_size;   //!< Size in bytes of the huge pages for the global TS packet buffer (zero means normal pages).
+        int             numa_node;        //!< NUMA node for the global TS packet buffer and plugin threads (negative means unspecified).
+        std::set<size_t> cpu_affinity;    //!< Default CPU affinity of all plugin threads (empty means no affinity).
+        std::map<size_t,std::set<size_t>> plugin_cpu_affinity; //!< CPU affinity of specific plugin threads, indexed by plugin index.
         size_t          max_flush_pkt;    //!< Max processed packets before flush.
         size_t          max_input_pkt;    //!< Max packets per input operation.
         size_t          init_input_pkt;   //!< Initial number of input packets to read before starting the processing (zero means default).
@@ -68,6 +72,10 @@ namespace ts {
         bool            control_reuse;    //!< Set the 'reuse port' socket option on the control TCP server port.
         IPAddressVector control_sources;  //!< Remote IP addresses which are allowed to send control commands.
         MilliSecond     control_timeout;  //!< Reception timeout in milliseconds for control commands.
+        MilliSecond     stats_interval;   //!< Interval between two reports of plugin statistics (zero means no report).
+        UString         stats_file;       //!< Output JSON file for plugin statistics (empty means log).
+        size_t          wakeup_packets;   //!< Minimum number of packets to pass before waking up the next plugin (1 means no batching).
+        MilliSecond     wakeup_latency;   //!< Maximum latency of pending packets when wake-up batching is used (zero means default).
         DuckContext::SavedArgs duck_args; //!< Default TSDuck context options for all plugins. Each plugin can override them in its context.
         PluginOptions          input;     //!< Input plugin description.
         PluginOptionsVector    plugins;   //!< Packet processor plugins descriptions.
@@ -90,5 +98,18 @@ namespace ts {
         //! @param [in] realtime If true, apply real-time defaults. If false, apply offline defaults.
         //!
         void applyDefaults(bool realtime);
+
+        //!
+        //! Get the CPU affinity of the thread executing a plugin.
+        //! @param [in] plugin_index Index of the plugin in the chain, 0 for the input plugin,
+        //! the output plugin is last.
+        //! @return A constant reference to the set of CPU indexes on which the plugin thread
+        //! is allowed to run. An empty set means no specific affinity.
+        //!
+        const std::set<size_t>& pluginCPUAffinity(size_t plugin_index) const;
+
+    private:
+        // Decode a list of CPU's, e.g. "0-3,8,10-11".
+        static bool DecodeCPUList(const UString& list, std::set<size_t>& cpus);
     };
 }
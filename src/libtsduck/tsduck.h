@@ -285,6 +285,7 @@
 #include "tsFTAContentManagementDescriptor.h"
 #include "tsGenreDescriptor.h"
 #include "tsGitHubRelease.h"
+#include "tsGOPAnalyzer.h"
 #include "tsGraphicsConstraintsDescriptor.h"
 #include "tsGreenExtensionDescriptor.h"
 #include "tsGrid.h"
@@ -346,11 +347,13 @@
 #include "tsJ2KVideoDescriptor.h"
 #include "tsjson.h"
 #include "tsjsonArray.h"
+#include "tsjsonDocument.h"
 #include "tsjsonFalse.h"
 #include "tsjsonNull.h"
 #include "tsjsonNumber.h"
 #include "tsjsonObject.h"
 #include "tsjsonOutputArgs.h"
+#include "tsjsonReader.h"
 #include "tsjsonString.h"
 #include "tsjsonTrue.h"
 #include "tsjsonValue.h"
@@ -419,6 +422,9 @@
 #include "tsObject.h"
 #include "tsOneShotPacketizer.h"
 #include "tsOUI.h"
+#include "tsOutputPacer.h"
+#include "tsOutputPacerArgs.h"
+#include "tsOutputPacerHandlerInterface.h"
 #include "tsOutputPager.h"
 #include "tsOutputPlugin.h"
 #include "tsOutputRedirector.h"
@@ -446,6 +452,7 @@
 #include "tsPESPacketizer.h"
 #include "tsPESProviderInterface.h"
 #include "tsPESStreamPacketizer.h"
+#include "tsPIDMetrics.h"
 #include "tsPIDOperator.h"
 #include "tsPlatform.h"
 #include "tsPlugin.h"
@@ -659,6 +666,7 @@
 #include "tsTSPacketFormat.h"
 #include "tsTSPacketMetadata.h"
 #include "tsTSPacketQueue.h"
+#include "tsTSPacketSPSCQueue.h"
 #include "tsTSPacketStream.h"
 #include "tsTSPacketWindow.h"
 #include "tsTSPControlCommand.h"
@@ -704,6 +712,7 @@
 #include "tsxml.h"
 #include "tsxmlAttribute.h"
 #include "tsxmlComment.h"
+#include "tsxmlCompiledModel.h"
 #include "tsxmlDeclaration.h"
 #include "tsxmlDocument.h"
 #include "tsxmlElement.h"
@@ -713,6 +722,7 @@
 #include "tsxmlNode.h"
 #include "tsxmlPatchDocument.h"
 #include "tsxmlRunningDocument.h"
+#include "tsxmlStreamWriter.h"
 #include "tsxmlText.h"
 #include "tsxmlTweaks.h"
 #include "tsxmlUnknown.h"
@@ -60,6 +60,7 @@ namespace ts {
         UString           _output_name;
         NanoSecond        _output_interval;
         bool              _multiple_output;
+        TSPacketMetadata::LabelSet _intra_labels;
         TSAnalyzerOptions _analyzer_options;
 
         // Working data:
@@ -87,6 +88,7 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
     _output_name(),
     _output_interval(0),
     _multiple_output(false),
+    _intra_labels(),
     _analyzer_options(),
     _output_stream(),
     _output(nullptr),
@@ -114,6 +116,13 @@ ts::AnalyzePlugin::AnalyzePlugin(TSP* tsp_) :
          u"specified output file name has the form 'base.ext', each file is created "
          u"with a time stamp in its name as 'base_YYYYMMDD_hhmmss.ext'.");
 
+    option(u"set-label-intra", 0, INTEGER, 0, UNLIMITED_COUNT, 0, TSPacketMetadata::LABEL_MAX);
+    help(u"set-label-intra", u"label1[-label2]",
+         u"Set the specified labels on the first TS packet of each video PES packet "
+         u"which starts with an intra-coded image (random access point). "
+         u"The labels can be used by subsequent plugins, for instance to segment the stream. "
+         u"Several --set-label-intra options may be specified.");
+
     option(u"output-file", 'o', STRING);
     help(u"output-file", u"filename",
          u"Specify the output text file for the analysis result. "
@@ -132,6 +141,7 @@ bool ts::AnalyzePlugin::getOptions()
     _output_name = value(u"output-file");
     _output_interval = NanoSecPerSec * intValue<Second>(u"interval", 0);
     _multiple_output = present(u"multiple-files");
+    getIntValues(_intra_labels, u"set-label-intra");
     return true;
 }
 
@@ -246,6 +256,11 @@ ts::ProcessorPlugin::Status ts::AnalyzePlugin::processPacket(TSPacket& pkt, TSPa
     // Feed the analyzer with one packet
     _analyzer.feedPacket (pkt);
 
+    // Mark random access points in video PID's.
+    if (_intra_labels.any() && _analyzer.isIntraImageStart(pkt)) {
+        pkt_data.setLabels(_intra_labels);
+    }
+
     // With --interval, check if it is time to produce a report
     if (_output_interval > 0 && _metrics.processedPacket() && _metrics.sessionNanoSeconds() >= _next_report) {
         // Time to produce a report.
@@ -94,9 +94,39 @@ namespace ts {
         TSPacketMetadata::LabelSet _set_perm_labels;   // Labels to set on all packets after getting one packet
         TSPacketMetadata::LabelSet _reset_perm_labels; // Labels to reset on all packets after getting one packet
 
+        // The selection criteria are compiled once into a short "program", a list of
+        // elementary tests, ordered by increasing cost. A packet is selected as soon as
+        // one test succeeds. Only the tests which correspond to actual options are present.
+        enum Test : uint8_t {
+            TEST_HEADER,         // Bits in the first 4 bytes of the header (--payload, --adaptation-field, --unit-start).
+            TEST_PID,            // --pid
+            TEST_STREAM_ID,      // --stream-id
+            TEST_SCRAMBLING,     // --scrambling-control, --clear
+            TEST_VALID,          // --valid
+            TEST_NULLIFIED,      // --nullified
+            TEST_INPUT_STUFFING, // --input-stuffing
+            TEST_LABELS,         // --label
+            TEST_EVERY,          // --every
+            TEST_PES,            // --pes
+            TEST_PAYLOAD_SIZE,   // --min-payload-size, --max-payload-size
+            TEST_AF_SIZE,        // --min-adaptation-field-size, --max-adaptation-field-size
+            TEST_PCR,            // --pcr
+            TEST_SPLICE,         // --has-splice-countdown, --splice-countdown, --min/max-splice-countdown
+            TEST_RANGES,         // --interval
+            TEST_PATTERN,        // --pattern
+        };
+
         // Working data:
-        PacketCounter   _filtered_packets;   // Number of filtered packets
-        PIDSet          _stream_id_pid;      // PID values selected from stream ids.
+        PacketCounter     _filtered_packets;   // Number of filtered packets
+        PIDSet            _stream_id_pid;      // PID values selected from stream ids.
+        uint32_t          _header_mask;        // Mask of bits in the first 4 bytes for TEST_HEADER.
+        std::vector<Test> _program;            // Compiled selection criteria.
+
+        // Compile the selection criteria.
+        void compile();
+
+        // Run one test of the program.
+        bool runTest(Test test, const TSPacket& pkt, const TSPacketMetadata& pkt_data, PID pid, PacketCounter packetIndex) const;
     };
 }
 
@@ -143,7 +173,9 @@ ts::FilterPlugin::FilterPlugin(TSP* tsp_) :
     _set_perm_labels(),
     _reset_perm_labels(),
     _filtered_packets(0),
-    _stream_id_pid()
+    _stream_id_pid(),
+    _header_mask(0),
+    _program()
 {
     option(u"adaptation-field");
     help(u"adaptation-field", u"Select packets with an adaptation field.");
@@ -403,10 +435,145 @@ bool ts::FilterPlugin::getOptions()
         _drop_status = TSP_DROP;
     }
 
+    compile();
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Compile the selection criteria.
+//----------------------------------------------------------------------------
+
+void ts::FilterPlugin::compile()
+{
+    _program.clear();
+
+    // Header bits: payload_unit_start_indicator in byte 1, adaptation_field_control in byte 3.
+    _header_mask = (_unit_start ? 0x00400000 : 0) | (_with_af ? 0x00000020 : 0) | (_with_payload ? 0x00000010 : 0);
+    if (_header_mask != 0) {
+        _program.push_back(TEST_HEADER);
+    }
+    if (_explicit_pid.any()) {
+        _program.push_back(TEST_PID);
+    }
+    if (!_stream_ids.empty()) {
+        _program.push_back(TEST_STREAM_ID);
+    }
+    if (_scrambling_ctrl >= 0) {
+        _program.push_back(TEST_SCRAMBLING);
+    }
+    if (_valid) {
+        _program.push_back(TEST_VALID);
+    }
+    if (_nullified) {
+        _program.push_back(TEST_NULLIFIED);
+    }
+    if (_input_stuffing) {
+        _program.push_back(TEST_INPUT_STUFFING);
+    }
+    if (_labels.any()) {
+        _program.push_back(TEST_LABELS);
+    }
+    if (_every_packets > 0) {
+        _program.push_back(TEST_EVERY);
+    }
+    if (_with_pes) {
+        _program.push_back(TEST_PES);
+    }
+    if (_min_payload >= 0 || _max_payload >= 0) {
+        _program.push_back(TEST_PAYLOAD_SIZE);
+    }
+    if (_min_af >= 0 || _max_af >= 0) {
+        _program.push_back(TEST_AF_SIZE);
+    }
+    if (_with_pcr) {
+        _program.push_back(TEST_PCR);
+    }
+    if (_with_splice || _splice >= -128 || _min_splice >= -128 || _max_splice >= -128) {
+        _program.push_back(TEST_SPLICE);
+    }
+    if (!_ranges.empty()) {
+        _program.push_back(TEST_RANGES);
+    }
+    if (!_pattern.empty()) {
+        _program.push_back(TEST_PATTERN);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Run one test of the program.
+//----------------------------------------------------------------------------
+
+bool ts::FilterPlugin::runTest(Test test, const TSPacket& pkt, const TSPacketMetadata& pkt_data, PID pid, PacketCounter packetIndex) const
+{
+    switch (test) {
+        case TEST_HEADER:
+            return (GetUInt32(pkt.b) & _header_mask) != 0;
+        case TEST_PID:
+            return _explicit_pid[pid];
+        case TEST_STREAM_ID:
+            return _stream_id_pid[pid];
+        case TEST_SCRAMBLING:
+            return _scrambling_ctrl == pkt.getScrambling();
+        case TEST_VALID:
+            return pkt.hasValidSync() && !pkt.getTEI();
+        case TEST_NULLIFIED:
+            return pkt_data.getNullified();
+        case TEST_INPUT_STUFFING:
+            return pkt_data.getInputStuffing();
+        case TEST_LABELS:
+            return pkt_data.hasAnyLabel(_labels);
+        case TEST_EVERY:
+            return (packetIndex - _after_packets) % _every_packets == 0;
+        case TEST_PES:
+            return pkt.startPES();
+        case TEST_PAYLOAD_SIZE: {
+            const int size = int(pkt.getPayloadSize());
+            return (_min_payload >= 0 && size >= _min_payload) || size <= _max_payload;
+        }
+        case TEST_AF_SIZE: {
+            const int size = int(pkt.getAFSize());
+            return (_min_af >= 0 && size >= _min_af) || size <= _max_af;
+        }
+        case TEST_PCR:
+            return pkt.hasPCR() || pkt.hasOPCR();
+        case TEST_SPLICE: {
+            if (!pkt.hasSpliceCountdown()) {
+                return false;
+            }
+            const int splice = pkt.getSpliceCountdown();
+            return _with_splice ||
+                (_splice >= -128 && splice == _splice) ||
+                (_min_splice >= -128 && splice >= _min_splice) ||
+                (_max_splice >= -128 && splice <= _max_splice);
+        }
+        case TEST_RANGES: {
+            for (auto it = _ranges.begin(); it != _ranges.end(); ++it) {
+                if (packetIndex >= it->first && packetIndex <= it->second) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        case TEST_PATTERN: {
+            const size_t start = _search_payload ? pkt.getHeaderSize() : 0;
+            if (start + _search_offset + _pattern.size() > PKT_SIZE) {
+                return false;
+            }
+            else if (_use_search_offset) {
+                return ::memcmp(pkt.b + start + _search_offset, _pattern.data(), _pattern.size()) == 0;
+            }
+            else {
+                return LocatePattern(pkt.b + start, PKT_SIZE - start, _pattern.data(), _pattern.size()) != nullptr;
+            }
+        }
+        default:
+            return false;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Start method.
 //----------------------------------------------------------------------------
@@ -452,45 +619,10 @@ ts::ProcessorPlugin::Status ts::FilterPlugin::processPacket(TSPacket& pkt, TSPac
         _stream_id_pid.set(pid, selected);
     }
 
-    // Check if the packet matches one of the selected criteria.
-    bool ok = _explicit_pid[pid] ||
-        _stream_id_pid[pid] ||
-        (_with_payload && pkt.hasPayload()) ||
-        (_with_af && pkt.hasAF()) ||
-        (_unit_start && pkt.getPUSI()) ||
-        (_nullified && pkt_data.getNullified()) ||
-        (_input_stuffing && pkt_data.getInputStuffing()) ||
-        (_valid && pkt.hasValidSync() && !pkt.getTEI()) ||
-        (_scrambling_ctrl == pkt.getScrambling()) ||
-        (_with_pcr && (pkt.hasPCR() || pkt.hasOPCR())) ||
-        (_with_splice && pkt.hasSpliceCountdown()) ||
-        (_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() == _splice) ||
-        (_min_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() >= _min_splice) ||
-        (_max_splice >= -128 && pkt.hasSpliceCountdown() && pkt.getSpliceCountdown() <= _max_splice) ||
-        (_min_payload >= 0 && int(pkt.getPayloadSize()) >= _min_payload) ||
-        (int(pkt.getPayloadSize()) <= _max_payload) ||
-        (_min_af >= 0 && int(pkt.getAFSize()) >= _min_af) ||
-        (int(pkt.getAFSize()) <= _max_af) ||
-        pkt_data.hasAnyLabel(_labels) ||
-        (_every_packets > 0 && (tsp->pluginPackets() - _after_packets) % _every_packets == 0) ||
-        (_with_pes && pkt.startPES());
-
-    // Search binary patterns in packets.
-    if (!ok && !_pattern.empty()) {
-        const size_t start = _search_payload ? pkt.getHeaderSize() : 0;
-        if (start + _search_offset + _pattern.size() <= PKT_SIZE) {
-            if (_use_search_offset) {
-                ok = ::memcmp(pkt.b + start + _search_offset, _pattern.data(), _pattern.size()) == 0;
-            }
-            else {
-                ok = LocatePattern(pkt.b + start, PKT_SIZE - start, _pattern.data(), _pattern.size()) != nullptr;
-            }
-        }
-    }
-
-    // Search if packet is in one selected range.
-    for (auto it = _ranges.begin(); !ok && it != _ranges.end(); ++it) {
-        ok = packetIndex >= it->first && packetIndex <= it->second;
+    // Run the compiled selection criteria until one matches.
+    bool ok = false;
+    for (auto it = _program.begin(); !ok && it != _program.end(); ++it) {
+        ok = runTest(*it, pkt, pkt_data, pid, packetIndex);
     }
 
     // Reverse selection criteria with --negate.
@@ -85,8 +85,22 @@ namespace ts {
         CyclingPacketizer     _pzer;              // Packetizer for table
         CyclingPacketizer::StuffingPolicy _stuffing_policy;
 
-        // Reload files, reset packetizer. Return true on success, false on error.
-        bool reloadFiles();
+        // Sections which are currently injected from one input file.
+        class FileSections
+        {
+        public:
+            SectionPtrVector sections;        // Sections from the file, as they were added in the packetizer.
+            uint64_t         bits_per_1000s;  // Contribution of the file in bits every 1000 seconds.
+            FileSections() : sections(), bits_per_1000s(0) {}
+        };
+        std::vector<FileSections> _file_sections;  // Same order as _infiles.
+
+        // Reload files. When 'all' is true, reset the packetizer and reload all files.
+        // Otherwise, reload only the modified files. Return true on success, false on error.
+        bool reloadFiles(bool all);
+
+        // Update the sections of one file in the packetizer, only the modified sections are replaced.
+        void updateSections(const FileNameRate& file, FileSections& current, const SectionPtrVector& sections);
 
         // Process bitrates and compute inter-packet distance.
         bool processBitRates();
@@ -129,7 +143,8 @@ ts::InjectPlugin::InjectPlugin (TSP* tsp_) :
     _eval_interval(0),
     _cycle_count(0),
     _pzer(duck, PID_NULL, CyclingPacketizer::NEVER, 0, tsp),
-    _stuffing_policy(CyclingPacketizer::NEVER)
+    _stuffing_policy(CyclingPacketizer::NEVER),
+    _file_sections()
 {
     duck.defineArgsForCharset(*this);
     _sections_opt.defineArgs(*this);
@@ -188,10 +203,13 @@ ts::InjectPlugin::InjectPlugin (TSP* tsp_) :
     option(u"poll-files");
     help(u"poll-files",
          u"Poll the presence and modification date of the input files. When a file "
-         u"is created, modified or deleted, reload all files at the next section "
-         u"boundary. When a file is deleted, its sections are no longer injected. "
-         u"By default, all input files are loaded once at initialization time and "
-         u"an error is generated if a file is missing.");
+         u"is created, modified or deleted, reload this file at the next section "
+         u"boundary. Only the sections which were added, removed or modified in "
+         u"this file are updated in the injection cycle. The other sections are "
+         u"injected as before. When a file is deleted, its sections are no longer "
+         u"injected. If a modified file cannot be loaded, its previous sections are "
+         u"still injected. By default, all input files are loaded once at "
+         u"initialization time and an error is generated if a file is missing.");
 
     option(u"repeat", 0, POSITIVE);
     help(u"repeat",
@@ -300,7 +318,7 @@ bool ts::InjectPlugin::start()
     }
 
     // Load sections from input files. Compute _files_bitrate when necessary.
-    if (!reloadFiles()) {
+    if (!reloadFiles(true)) {
         return false;
     }
 
@@ -319,15 +337,19 @@ bool ts::InjectPlugin::start()
 
 
 //----------------------------------------------------------------------------
-// Reload files, reset packetizer.
+// Reload files, update packetizer.
 //----------------------------------------------------------------------------
 
-bool ts::InjectPlugin::reloadFiles()
+bool ts::InjectPlugin::reloadFiles(bool all)
 {
-    // Reinitialize packetizer
-    _pzer.reset();
-    _pzer.setPID(_inject_pid);
-    _pzer.setStuffingPolicy(_stuffing_policy);
+    if (all) {
+        // Reinitialize packetizer
+        _pzer.reset();
+        _pzer.setPID(_inject_pid);
+        _pzer.setStuffingPolicy(_stuffing_policy);
+        _file_sections.clear();
+    }
+    _file_sections.resize(_infiles.size());
 
     // Load sections from input files
     bool success = true;
@@ -335,12 +357,19 @@ bool ts::InjectPlugin::reloadFiles()
     SectionFile file(duck);
     file.setCRCValidation(_crc_op);
 
-    for (FileNameRateList::iterator it = _infiles.begin(); it != _infiles.end(); ++it) {
-        if (_poll_files && !FileExists(it->file_name)) {
+    size_t index = 0;
+    for (FileNameRateList::iterator it = _infiles.begin(); it != _infiles.end(); ++it, ++index) {
+        FileSections& current(_file_sections[index]);
+        if (!all && it->retry_count == 0) {
+            // Unmodified file, keep its sections in the packetizer.
+        }
+        else if (_poll_files && !FileExists(it->file_name)) {
             // With --poll-files, we ignore non-existent files.
             it->retry_count = 0;  // no longer needed to retry
+            updateSections(*it, current, SectionPtrVector());
         }
         else if (!file.load(it->file_name, *tsp, _intype) || !_sections_opt.processSectionFile(file, *tsp)) {
+            // Keep the previous sections of the file, if any.
             success = false;
             if (it->retry_count > 0) {
                 it->retry_count--;
@@ -349,21 +378,13 @@ bool ts::InjectPlugin::reloadFiles()
         else {
             // File successfully loaded.
             it->retry_count = 0;  // no longer needed to retry
-            _pzer.addSections(file.sections(), it->repetition);
+            updateSections(*it, current, file.sections());
             tsp->verbose(u"loaded %d sections from %s, repetition rate: %s",
                          {file.sections().size(),
                           it->file_name,
                           it->repetition > 0 ? UString::Decimal(it->repetition) + u" ms" : u"unspecified"});
-
-            if (_use_files_bitrate) {
-                assert(it->repetition != 0);
-                // Number of TS packets of all sections after packetization.
-                const uint64_t packets = Section::PacketCount(file.sections(), _stuffing_policy != CyclingPacketizer::ALWAYS);
-                // Contribution of this file in bits every 1000 seconds.
-                // The repetition rate is in milliseconds.
-                bits_per_1000s += (packets * PKT_SIZE * 8 * MilliSecPerSec * 1000) / it->repetition;
-            }
         }
+        bits_per_1000s += current.bits_per_1000s;
     }
 
     // Compute target bitrate based on repetition rates (if we need it).
@@ -380,6 +401,73 @@ bool ts::InjectPlugin::reloadFiles()
 }
 
 
+//----------------------------------------------------------------------------
+// Update the sections of one file in the packetizer.
+//----------------------------------------------------------------------------
+
+namespace {
+    // Order sections by binary content.
+    bool SectionContentLess(const ts::SectionPtr& s1, const ts::SectionPtr& s2)
+    {
+        const size_t size1 = s1->size();
+        const size_t size2 = s2->size();
+        const int cmp = ::memcmp(s1->content(), s2->content(), std::min(size1, size2));
+        return cmp < 0 || (cmp == 0 && size1 < size2);
+    }
+}
+
+void ts::InjectPlugin::updateSections(const FileNameRate& file, FileSections& current, const SectionPtrVector& sections)
+{
+    // Previous sections of the file, sorted by content.
+    SectionPtrVector previous;
+    previous.swap(current.sections);
+    std::sort(previous.begin(), previous.end(), SectionContentLess);
+    std::vector<bool> reused(previous.size(), false);
+
+    // Sections which are identical to a previous one are kept in the packetizer, with their
+    // current position in the cycle. Only new or modified sections are added.
+    SectionPtrVector added;
+    current.sections.reserve(sections.size());
+    for (const auto& sp : sections) {
+        auto it = std::lower_bound(previous.begin(), previous.end(), sp, SectionContentLess);
+        // Skip identical sections which were already reused (duplicated sections in the file).
+        while (it != previous.end() && !SectionContentLess(sp, *it) && reused[it - previous.begin()]) {
+            ++it;
+        }
+        if (it != previous.end() && !SectionContentLess(sp, *it)) {
+            reused[it - previous.begin()] = true;
+            current.sections.push_back(*it);
+        }
+        else {
+            added.push_back(sp);
+            current.sections.push_back(sp);
+        }
+    }
+
+    // Previous sections which are no longer present are removed.
+    SectionPtrVector removed;
+    for (size_t i = 0; i < previous.size(); ++i) {
+        if (!reused[i]) {
+            removed.push_back(previous[i]);
+        }
+    }
+
+    _pzer.removeSections(removed);
+    _pzer.addSections(added, file.repetition);
+    tsp->debug(u"%s: %d sections unchanged, %d added, %d removed", {file.display_name, current.sections.size() - added.size(), added.size(), removed.size()});
+
+    // Contribution of this file in bits every 1000 seconds.
+    current.bits_per_1000s = 0;
+    if (_use_files_bitrate) {
+        assert(file.repetition != 0);
+        // Number of TS packets of all sections after packetization.
+        const uint64_t packets = Section::PacketCount(current.sections, _stuffing_policy != CyclingPacketizer::ALWAYS);
+        // The repetition rate is in milliseconds.
+        current.bits_per_1000s = (packets * PKT_SIZE * 8 * MilliSecPerSec * 1000) / file.repetition;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Process bitrates and compute inter-packet distance.
 //----------------------------------------------------------------------------
@@ -472,8 +560,8 @@ ts::ProcessorPlugin::Status ts::InjectPlugin::processPacket(TSPacket& pkt, TSPac
     // Do that only at section boundary in the output PID to avoid truncated sections.
     if (_poll_files && _pzer.atSectionBoundary() && Time::CurrentUTC() >= _poll_file_next) {
         if (_infiles.scanFiles(FILE_RETRY, *tsp) > 0) {
-            // Some files have changed. Reset packetizer and reload files.
-            reloadFiles();
+            // Some files have changed. Reload them and update the packetizer.
+            reloadFiles(false);
             // Recompute bitrates and packet interval when based on files repetition rates.
             processBitRates();
         }
@@ -36,7 +36,7 @@
 #include "tsSignalizationHandlerInterface.h"
 #include "tsSignalizationDemux.h"
 #include "tsTSForkPipe.h"
-#include "tsTSPacketQueue.h"
+#include "tsTSPacketSPSCQueue.h"
 #include "tsPacketInsertionController.h"
 #include "tsPSIMerger.h"
 #include "tsSafePtr.h"
@@ -101,7 +101,7 @@ namespace ts {
         PacketCounter _hold_count;         // Number of times we didn't try to merge to perform smoothing insertion.
         PacketCounter _empty_count;        // Number of times we could merge but there was no packet to merge.
         TSForkPipe    _pipe;               // Executed command.
-        TSPacketQueue _queue;              // TS packet queur from merge to main.
+        TSPacketSPSCQueue _queue;          // TS packet queue from merge to main.
         PIDSet        _main_pids;          // Set of detected PID's in main stream.
         PIDSet        _merge_pids;         // Set of detected PID's in merged stream that we pass in main stream.
         MergedPIDContextMap _merged_ctx;   // Description of PID's from the merged stream.
@@ -515,7 +515,7 @@ void ts::MergePlugin::main()
 
         // Wait for free space in the internal packet queue.
         // We don't want to read too many small data sizes, so we wait for at least 16 packets.
-        if (!_queue.lockWriteBuffer(buffer, buffer_size, 16)) {
+        if (!_queue.reserveWrite(buffer, buffer_size, 16)) {
             // The plugin thread has signalled a stop condition.
             break;
         }
@@ -536,7 +536,7 @@ void ts::MergePlugin::main()
 
         // Pass the read packets to the inter-thread queue.
         // The read size was returned in bytes, we must give a number of packets.
-        _queue.releaseWriteBuffer(read_size / PKT_SIZE);
+        _queue.commitWrite(read_size / PKT_SIZE);
     }
 
     tsp->debug(u"receiver thread completed");
@@ -593,7 +593,9 @@ ts::ProcessorPlugin::Status ts::MergePlugin::processMergePacket(TSPacket& pkt, T
 
     // Replace current null packet in main stream with next packet from merged stream.
     BitRate merged_bitrate = 0;
-    if (!_queue.getPacket(pkt, merged_bitrate)) {
+    const TSPacket* merged = nullptr;
+    size_t merged_count = 0;
+    if (!_queue.borrowRead(merged, merged_count, merged_bitrate, false)) {
         // No packet available, keep original null packet.
         _empty_count++;
         if (!_got_eof && _queue.eof()) {
@@ -612,6 +614,10 @@ ts::ProcessorPlugin::Status ts::MergePlugin::processMergePacket(TSPacket& pkt, T
         return TSP_OK;
     }
 
+    // Copy the merged packet in place of the null packet and free its slot in the queue.
+    pkt = *merged;
+    _queue.releaseRead(1);
+
     // Report merged bitrate change.
     _insert_control.setSubBitRate(merged_bitrate);
 
@@ -36,8 +36,13 @@
 #include "tsMPEDemux.h"
 #include "tsMPEPacket.h"
 #include "tsUDPSocket.h"
+#include "tsMemory.h"
 TSDUCK_SOURCE;
 
+#define MAX_UDP_BATCH      1024  // Maximum number of datagrams per UDP batch.
+#define BATCH_MAX_PACKETS   100  // Send a partial batch after that number of TS packets.
+#define PCAP_LINKTYPE_RAW   101  // Link type of pcap files, raw IP datagrams.
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
@@ -79,6 +84,8 @@ namespace ts {
         SocketAddress _ip_forward;      // Forwarded socket address.
         IPAddress     _local_address;   // Local IP address for UDP forwarding.
         uint16_t      _local_port;      // Local UDP source port for UDP forwarding.
+        size_t        _udp_batch;       // Number of forwarded datagrams per batch.
+        UString       _pcap_name;       // Output pcap file name.
 
         // Plugin private fields.
         bool          _abort;           // Error, abort asap.
@@ -87,7 +94,18 @@ namespace ts {
         int           _previous_mc_ttl; // Previous multicast TTL which was set.
         PacketCounter _datagram_count;  // Number of extracted datagrams.
         std::ofstream _outfile;         // Output file for extracted datagrams.
+        std::ofstream _pcapfile;        // Output pcap file for extracted datagrams.
         MPEDemux      _demux;           // MPE demux to extract MPE datagrams.
+        size_t        _batch_count;     // Number of datagrams in current batch.
+        PacketCounter _batch_age;       // Number of TS packets since first datagram in current batch.
+        std::vector<ByteBlock> _batch_data; // Preallocated buffers of datagrams in current batch.
+        std::vector<UDPSocket::OutgoingMessage> _batch; // Datagrams in current batch.
+
+        // Send all datagrams in current batch.
+        bool flushBatch();
+
+        // Write a datagram in the pcap file.
+        bool writePcap(const uint8_t* data, size_t size);
 
         // Inherited methods.
         virtual void handleMPENewPID(MPEDemux&, const PMT&, PID) override;
@@ -131,13 +149,20 @@ ts::MPEPlugin::MPEPlugin(TSP* tsp_) :
     _ip_forward(),
     _local_address(),
     _local_port(SocketAddress::AnyPort),
+    _udp_batch(1),
+    _pcap_name(),
     _abort(false),
     _sock(false, *tsp_),
     _previous_uc_ttl(0),
     _previous_mc_ttl(0),
     _datagram_count(0),
     _outfile(),
-    _demux(duck, this)
+    _pcapfile(),
+    _demux(duck, this),
+    _batch_count(0),
+    _batch_age(0),
+    _batch_data(),
+    _batch()
 {
     option(u"append", 'a');
     help(u"append",
@@ -195,6 +220,12 @@ ts::MPEPlugin::MPEPlugin(TSP* tsp_) :
          u"Specify that the extracted UDP datagrams are saved in this file. The UDP "
          u"messages are written without any encapsulation.");
 
+    option(u"pcap-file", 0, STRING);
+    help(u"pcap-file", u"filename",
+         u"Save the complete extracted IP datagrams (IP header, UDP header and payload) "
+         u"in the specified pcap capture file. The file can be analyzed using tools such "
+         u"as Wireshark. The capture time of each datagram is its extraction time.");
+
     option(u"pid", 'p', PIDVAL, 0, UNLIMITED_COUNT);
     help(u"pid", u"pid1[-pid2]",
          u"Extract MPE datagrams from these PID's. Several -p or --pid options may be "
@@ -236,6 +267,14 @@ ts::MPEPlugin::MPEPlugin(TSP* tsp_) :
          u"unchanged. The source address of the forwarded datagrams will be the "
          u"address of the local machine.");
 
+    option(u"udp-batch", 0, INTEGER, 0, 1, 1, MAX_UDP_BATCH);
+    help(u"udp-batch", u"count",
+         u"With --udp-forward, send the datagrams in batches of the specified number of "
+         u"datagrams. On Linux, each batch is sent using one single system call, which "
+         u"significantly reduces the CPU load with high bitrates of datagrams. "
+         u"An incomplete batch is sent after " TS_STRINGIFY(BATCH_MAX_PACKETS) u" TS packets. "
+         u"By default, each datagram is sent immediately.");
+
     option(u"udp-size", 0, UNSIGNED);
     help(u"udp-size",
         u"Specify the exact size in bytes of the UDP datagrams to filter. "
@@ -273,6 +312,8 @@ bool ts::MPEPlugin::getOptions()
     const UString ipForward(value(u"redirect"));
     const UString ipLocal(value(u"local-address"));
     getIntValue(_local_port, u"local-port", SocketAddress::AnyPort);
+    getIntValue(_udp_batch, u"udp-batch", 1);
+    getValue(_pcap_name, u"pcap-file");
     getIntValue(_min_net_size, u"min-net-size");
     getIntValue(_max_net_size, u"max-net-size", NPOS);
     getIntValue(_min_udp_size, u"min-udp-size");
@@ -347,6 +388,30 @@ bool ts::MPEPlugin::start()
         }
     }
 
+    // Create pcap file if present and write the pcap file header.
+    if (!_pcap_name.empty()) {
+        _pcapfile.open(_pcap_name.toUTF8().c_str(), std::ios::out | std::ios::binary);
+        uint8_t header[24];
+        PutUInt32LE(header, 0xA1B2C3D4);    // magic number, microsecond timestamps
+        PutUInt16LE(header + 4, 2);         // major version
+        PutUInt16LE(header + 6, 4);         // minor version
+        PutUInt32LE(header + 8, 0);         // time zone
+        PutUInt32LE(header + 12, 0);        // timestamps accuracy
+        PutUInt32LE(header + 16, 0xFFFF);   // snapshot length
+        PutUInt32LE(header + 20, PCAP_LINKTYPE_RAW);
+        _pcapfile.write(reinterpret_cast<const char*>(header), sizeof(header));
+        if (!_pcapfile) {
+            tsp->error(u"error creating %s", {_pcap_name});
+            return false;
+        }
+    }
+
+    // Preallocate the batch of forwarded datagrams.
+    _batch_count = 0;
+    _batch_age = 0;
+    _batch_data.resize(_udp_batch);
+    _batch.resize(_udp_batch);
+
     // Initialize the forwarding UDP socket.
     if (_send_udp) {
         if (!_sock.open(*tsp)) {
@@ -382,10 +447,16 @@ bool ts::MPEPlugin::start()
 
 bool ts::MPEPlugin::stop()
 {
-    // Close output file.
+    // Send the last incomplete batch of datagrams.
+    flushBatch();
+
+    // Close output files.
     if (_outfile.is_open()) {
         _outfile.close();
     }
+    if (_pcapfile.is_open()) {
+        _pcapfile.close();
+    }
 
     // Close the forwarding socket.
     if (_sock.isOpen()) {
@@ -470,6 +541,11 @@ void ts::MPEPlugin::handleMPEPacket(MPEDemux& demux, const MPEPacket& mpe)
         }
     }
 
+    // Save complete IP datagrams in pcap file.
+    if (_pcapfile.is_open() && !writePcap(mpe.datagram(), netSize)) {
+        _abort = true;
+    }
+
     // Forward UDP datagrams.
     if (_send_udp) {
 
@@ -488,7 +564,8 @@ void ts::MPEPlugin::handleMPEPacket(MPEDemux& demux, const MPEPacket& mpe)
         const bool mc = dest.isMulticast();
         const int previous_ttl = mc ? _previous_mc_ttl : _previous_uc_ttl;
         const int mpe_ttl = mpe.datagram()[8]; // in original IP header
-        if (_ttl <= 0 && mpe_ttl != previous_ttl && _sock.setTTL(mpe_ttl, mc, *tsp)) {
+        // A new TTL applies to subsequent datagrams, send the previous ones first.
+        if (_ttl <= 0 && mpe_ttl != previous_ttl && flushBatch() && _sock.setTTL(mpe_ttl, mc, *tsp)) {
             if (mc) {
                 _previous_mc_ttl = mpe_ttl;
             }
@@ -497,9 +574,17 @@ void ts::MPEPlugin::handleMPEPacket(MPEDemux& demux, const MPEPacket& mpe)
             }
         }
 
-        // Send the UDP datagram.
-        if (!_sock.send(udp, udpSize, dest, *tsp)) {
-            _abort = true;
+        // Send the UDP datagram or add it in the current batch.
+        if (_udp_batch <= 1) {
+            _abort = !_sock.send(udp, udpSize, dest, *tsp) || _abort;
+        }
+        else {
+            ByteBlock& buffer(_batch_data[_batch_count]);
+            buffer.copy(udp, udpSize);
+            _batch[_batch_count++] = UDPSocket::OutgoingMessage(buffer.data(), buffer.size(), dest);
+            if (_batch_count >= _udp_batch && !flushBatch()) {
+                _abort = true;
+            }
         }
     }
 
@@ -511,6 +596,44 @@ void ts::MPEPlugin::handleMPEPacket(MPEDemux& demux, const MPEPacket& mpe)
 }
 
 
+//----------------------------------------------------------------------------
+// Send all datagrams in current batch.
+//----------------------------------------------------------------------------
+
+bool ts::MPEPlugin::flushBatch()
+{
+    const size_t count = _batch_count;
+    _batch_count = 0;
+    _batch_age = 0;
+    return count == 0 || _sock.sendBatch(_batch.data(), count, *tsp);
+}
+
+
+//----------------------------------------------------------------------------
+// Write a datagram in the pcap file.
+//----------------------------------------------------------------------------
+
+bool ts::MPEPlugin::writePcap(const uint8_t* data, size_t size)
+{
+    // Capture time in microseconds since the Unix epoch.
+    const MilliSecond now = Time::CurrentUTC() - Time::UnixEpoch;
+
+    uint8_t header[16];
+    PutUInt32LE(header, uint32_t(now / MilliSecPerSec));
+    PutUInt32LE(header + 4, uint32_t((now % MilliSecPerSec) * 1000));
+    PutUInt32LE(header + 8, uint32_t(size));
+    PutUInt32LE(header + 12, uint32_t(size));
+
+    _pcapfile.write(reinterpret_cast<const char*>(header), sizeof(header));
+    _pcapfile.write(reinterpret_cast<const char*>(data), std::streamsize(size));
+    if (!_pcapfile) {
+        tsp->error(u"error writing to %s", {_pcap_name});
+        return false;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Build the string for --dump-*.
 //----------------------------------------------------------------------------
@@ -619,5 +742,10 @@ ts::ProcessorPlugin::Status ts::MPEPlugin::processPacket(TSPacket& pkt, TSPacket
 {
     // Feed the MPE demux.
     _demux.feedPacket(pkt);
+
+    // Do not keep an incomplete batch of datagrams for too long.
+    if (_batch_count > 0 && ++_batch_age >= BATCH_MAX_PACKETS && !flushBatch()) {
+        _abort = true;
+    }
     return _abort ? TSP_END : TSP_OK;
 }
@@ -387,6 +387,12 @@ bool ts::PESPlugin::start()
     _demux.setPIDFilter(_pids);
     _demux.setDefaultCodec(_default_h26x);
 
+    // When the PES payloads are not analyzed, only reassemble the PES headers and
+    // the beginning of the payloads (to check the start of video payloads).
+    const bool need_payload = _dump_pes_payload || _dump_start_code || _dump_nal_units || _dump_avc_sei ||
+        _video_attributes || _audio_attributes || _intra_images || !_pes_filename.empty() || !_es_filename.empty();
+    _demux.setDepth(need_payload ? PESDemux::FULL_DEPTH : 256);
+
     // Create output files.
     const bool ok =
         openOutput(_out_filename, &_out_file, &_out, false) &&
@@ -503,8 +509,9 @@ ts::UString ts::PESPlugin::prefix(const PESPacket& pkt) const
 
 void ts::PESPlugin::handlePESPacket(PESDemux&, const PESPacket& pkt)
 {
-    // Skip PES packets without appropriate payload size
-    if (int(pkt.payloadSize()) < _min_payload || (_max_payload >= 0 && int(pkt.payloadSize()) > _max_payload)) {
+    // Skip PES packets without appropriate payload size (the packet may be truncated by the demux).
+    const size_t payload_size = pkt.fullSize() - pkt.headerSize();
+    if (int(payload_size) < _min_payload || (_max_payload >= 0 && int(payload_size) > _max_payload)) {
         return;
     }
 
@@ -512,7 +519,7 @@ void ts::PESPlugin::handlePESPacket(PESDemux&, const PESPacket& pkt)
     if (_trace_packets) {
         *_out << "* " << prefix(pkt)
               << ", stream_id " << names::StreamId(pkt.getStreamId(), names::FIRST)
-              << UString::Format(u", size: %d bytes (header: %d, payload: %d)", {pkt.size(), pkt.headerSize(), pkt.payloadSize()});
+              << UString::Format(u", size: %d bytes (header: %d, payload: %d)", {pkt.fullSize(), pkt.headerSize(), payload_size});
         const size_t spurious = pkt.spuriousDataSize();
         if (spurious > 0) {
             *_out << UString::Format(u", %d spurious trailing bytes", {spurious});
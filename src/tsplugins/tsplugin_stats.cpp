@@ -33,20 +33,23 @@
 //----------------------------------------------------------------------------
 
 #include "tsPluginRepository.h"
-#include "tsTSSpeedMetrics.h"
-#include "tsSingleDataStatistics.h"
-#include "tsSafePtr.h"
-#include "tsFatal.h"
-#include <cmath>
+#include "tsPIDMetrics.h"
+#include "tsThread.h"
+#include "tsGuardCondition.h"
+#include "tsjsonOutputArgs.h"
+#include "tsjsonObject.h"
 TSDUCK_SOURCE;
 
+#define REPORT_THREAD_STACK_SIZE (128 * 1024)
+#define SNAPSHOT_TIMEOUT         100  // milliseconds
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
 //----------------------------------------------------------------------------
 
 namespace ts {
-    class StatsPlugin: public ProcessorPlugin
+    class StatsPlugin: public ProcessorPlugin, private Thread
     {
         TS_NOBUILD_NOCOPY(StatsPlugin);
     public:
@@ -58,53 +61,37 @@ namespace ts {
         virtual Status processPacket(TSPacket&, TSPacketMetadata&) override;
 
     private:
-        // Each category of packets (PID or lable) is described by a structure like this.
-        // The map is indexed by PID or label.
-        class Context;
-        typedef SafePtr<Context> ContextPtr;
-        typedef std::map<size_t, ContextPtr> ContextMap;
-
         // Command line options.
         bool       _track_pids;        // Track PID's, not labels.
         bool       _log;               // Report statistics through the logger, not files.
         bool       _csv;               // Use CSV format for statistics.
+        bool       _json;              // Use JSON format for statistics.
+        bool       _prometheus;        // Use Prometheus text format for statistics.
         bool       _header;            // Display header lines.
         bool       _multiple_output;   // Don't rewrite output files with --interval.
         UString    _csv_separator;     // Separator character in CSV lines.
         UString    _output_name;       // Output file name.
-        NanoSecond _output_interval;   // Recreate output at this time interval.
+        MilliSecond _output_interval;  // Recreate output at this time interval.
         PIDSet     _pids;              // List of PID's to track.
         TSPacketMetadata::LabelSet _labels;  // List of labels to track.
 
         // Working data.
         std::ofstream  _output_stream; // Output file stream.
         std::ostream*  _output;        // Point to actual output stream.
-        ContextMap     _ctx_map;       // Description of all tracked categories of packets.
-        TSSpeedMetrics _metrics;       // Timing to synchronize next output files.
-        NanoSecond     _next_report;   // Next time to create next output.
-
-        // Get or create the description of a tracked PID or label.
-        ContextPtr getContext(size_t index);
+        PIDMetrics     _engine;        // Metrics of all tracked categories of packets, updated in packet thread.
+        volatile bool  _terminate;     // Terminate the reporting thread.
+        volatile bool  _abort;         // Error in the reporting thread, abort the processing.
+        Mutex          _mutex;         // Protect the termination of the reporting thread.
+        Condition      _wake_up;       // Signaled to terminate the reporting thread.
+        Time           _next_report;   // Next time to create next output.
 
         // Open, close and create statistics report.
         bool openOutput();
         void closeOutput();
-        bool produceReport();
+        bool produceReport(const PIDMetrics::Snapshot&);
 
-        // Description of a tracked category of packet (PID or label).
-        class Context
-        {
-        public:
-            uint64_t total_pkt;      // Total number of packets in that category.
-            uint64_t last_ts_index;  // Index in TS of last packet of the category.
-            SingleDataStatistics<uint64_t> ipkt; // Inter-packet distance statistics.
-
-            // Constructor.
-            Context();
-
-            // Add packet data to the context.
-            void addPacketData(PacketCounter, const TSPacket&);
-        };
+        // With --interval, a thread periodically collects metrics and produces reports.
+        virtual void main() override;
     };
 }
 
@@ -117,9 +104,12 @@ TS_REGISTER_PROCESSOR_PLUGIN(u"stats", ts::StatsPlugin);
 
 ts::StatsPlugin::StatsPlugin(TSP* tsp_) :
     ProcessorPlugin(tsp_, u"Report various statistics on PID's and labels", u"[options]"),
+    Thread(ThreadAttributes().setStackSize(REPORT_THREAD_STACK_SIZE)),
     _track_pids(true),
     _log(false),
     _csv(false),
+    _json(false),
+    _prometheus(false),
     _header(false),
     _multiple_output(false),
     _csv_separator(TS_DEFAULT_CSV_SEPARATOR),
@@ -129,9 +119,12 @@ ts::StatsPlugin::StatsPlugin(TSP* tsp_) :
     _labels(),
     _output_stream(),
     _output(nullptr),
-    _ctx_map(),
-    _metrics(),
-    _next_report(0)
+    _engine(),
+    _terminate(false),
+    _abort(false),
+    _mutex(),
+    _wake_up(),
+    _next_report()
 {
     option(u"csv", 'c');
     help(u"csv",
@@ -144,7 +137,13 @@ ts::StatsPlugin::StatsPlugin(TSP* tsp_) :
          u"Produce a new output file at regular intervals. "
          u"The interval value is in seconds. "
          u"After outputting a file, the statistics are reset, "
-         u"ie. each output file contains a fully independent analysis.");
+         u"ie. each output file contains a fully independent analysis. "
+         u"The reports are produced by a separate thread and never slow down the packet processing.");
+
+    option(u"json", 'j');
+    help(u"json",
+         u"Report the statistics in JSON format, including inter-packet distance histograms "
+         u"and bitrates per PID or label.");
 
     option(u"label", 'l', INTEGER, 0, UNLIMITED_COUNT, 0, TSPacketMetadata::LABEL_MAX);
     help(u"label", u"label1[-label2]",
@@ -179,6 +178,12 @@ ts::StatsPlugin::StatsPlugin(TSP* tsp_) :
          u"Several -p or --pid options may be specified. "
          u"By default, all PID's are analyzed.");
 
+    option(u"prometheus");
+    help(u"prometheus",
+         u"Report the statistics in Prometheus text exposition format. "
+         u"When used with --interval and --output-file, the output file is periodically "
+         u"rewritten and can be exported by the node_exporter textfile collector.");
+
     option(u"separator", 's', STRING);
     help(u"separator", u"string",
          u"Field separator string in CSV output (default: '" TS_DEFAULT_CSV_SEPARATOR u"').");
@@ -193,9 +198,11 @@ bool ts::StatsPlugin::getOptions()
 {
     _log = present(u"log");
     _csv = present(u"csv");
+    _json = present(u"json");
+    _prometheus = present(u"prometheus");
     _header = !present(u"noheader");
     _multiple_output = present(u"multiple-files");
-    _output_interval = NanoSecPerSec * intValue<Second>(u"interval", 0);
+    _output_interval = MilliSecPerSec * intValue<Second>(u"interval", 0);
     getValue(_csv_separator, u"separator", TS_DEFAULT_CSV_SEPARATOR);
     getValue(_output_name, u"output-file");
     getIntValues(_pids, u"pid");
@@ -213,6 +220,10 @@ bool ts::StatsPlugin::getOptions()
         tsp->error(u"options --log and --output-file are mutually exclusive");
         return false;
     }
+    if (int(_log) + int(_csv) + int(_json) + int(_prometheus) > 1) {
+        tsp->error(u"options --log, --csv, --json and --prometheus are mutually exclusive");
+        return false;
+    }
 
     _track_pids = _pids.any();
     return true;
@@ -225,10 +236,6 @@ bool ts::StatsPlugin::getOptions()
 
 bool ts::StatsPlugin::start()
 {
-    // For production of multiple reports at regular intervals.
-    _metrics.start();
-    _next_report = _output_interval;
-
     // Create the output file. Note that this file is used only in the stop
     // method and could be created there. However, if the file cannot be
     // created, we do not want to wait all along the analysis and finally fail.
@@ -237,11 +244,96 @@ bool ts::StatsPlugin::start()
         return false;
     }
 
-    _ctx_map.clear();
+    // Reset the metrics engine.
+    if (_track_pids) {
+        _engine.setPIDFilter(_pids);
+    }
+    else {
+        _engine.setLabelFilter(_labels);
+    }
+    _engine.setBitrate(0);
+    _abort = false;
+
+    // For production of multiple reports at regular intervals.
+    if (_output_interval > 0) {
+        _terminate = false;
+        _next_report = Time::CurrentUTC() + _output_interval;
+        if (!Thread::start()) {
+            tsp->error(u"cannot start the reporting thread");
+            return false;
+        }
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop method
+//----------------------------------------------------------------------------
+
+bool ts::StatsPlugin::stop()
+{
+    // Terminate the reporting thread.
+    if (_output_interval > 0) {
+        {
+            GuardCondition lock(_mutex, _wake_up);
+            _terminate = true;
+            lock.signal();
+        }
+        Thread::waitForTermination();
+    }
+
+    // Final report, from the packet thread, no more packet are processed.
+    // Skipped when the reporting thread already failed to produce a report.
+    if (!_abort) {
+        PIDMetrics::Snapshot snapshot;
+        _engine.getSnapshot(snapshot);
+        produceReport(snapshot);
+    }
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Reporting thread (with --interval).
+//----------------------------------------------------------------------------
+
+void ts::StatsPlugin::main()
+{
+    PIDMetrics::Snapshot snapshot;
+
+    for (;;) {
+        // Wait until next report time or termination.
+        {
+            GuardCondition lock(_mutex, _wake_up);
+            Time now(Time::CurrentUTC());
+            while (!_terminate && now < _next_report) {
+                lock.waitCondition(_next_report - now);
+                now = Time::CurrentUTC();
+            }
+            if (_terminate) {
+                break;
+            }
+        }
+
+        // Get the metrics from the packet thread and reset them. Retry
+        // until some packet is processed or termination is requested.
+        bool ok = false;
+        while (!ok && !_terminate) {
+            ok = _engine.waitSnapshot(snapshot, SNAPSHOT_TIMEOUT, true);
+        }
+
+        // Produce the report and compute next report time.
+        // On error, the packet thread is notified to abort the processing.
+        if (ok && !produceReport(snapshot)) {
+            _abort = true;
+            break;
+        }
+        _next_report += _output_interval;
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Create an output file. Return true on success, false on error.
 //----------------------------------------------------------------------------
@@ -292,7 +384,7 @@ void ts::StatsPlugin::closeOutput()
 // Produce a report. Return true on success, false on error.
 //----------------------------------------------------------------------------
 
-bool ts::StatsPlugin::produceReport()
+bool ts::StatsPlugin::produceReport(const PIDMetrics::Snapshot& snapshot)
 {
     // Create output file if required.
     if (!openOutput()) {
@@ -302,6 +394,20 @@ bool ts::StatsPlugin::produceReport()
     std::ostream& out(*_output);
     const UString name(_track_pids ? u"PID" : u"Label");
 
+    // JSON and Prometheus formats are directly produced by the snapshot.
+    if (_json) {
+        json::Object root;
+        snapshot.toJSON(root);
+        out << root.printed() << std::endl;
+        closeOutput();
+        return true;
+    }
+    else if (_prometheus) {
+        snapshot.toPrometheus(out);
+        closeOutput();
+        return true;
+    }
+
     // Header lines if necessary.
     if (_header && !_log) {
         if (_csv) {
@@ -321,27 +427,27 @@ bool ts::StatsPlugin::produceReport()
     }
 
     // Loop on all categories.
-    for (auto it = _ctx_map.begin(); it != _ctx_map.end(); ++it) {
+    for (auto it = snapshot.categories.begin(); it != snapshot.categories.end(); ++it) {
 
-        // PID context.
+        // PID or label metrics.
         const size_t index = it->first;
-        const Context& ctx(*(it->second));
+        const PIDMetrics::Counters& ctx(it->second);
 
         if (_log) {
             tsp->info(u"%s: 0x%X  Total: %8'd  IPD min: %3d  max: %5d  mean: %s  std-dev: %s",
-                      {name, index, ctx.total_pkt, ctx.ipkt.minimum(), ctx.ipkt.maximum(), ctx.ipkt.meanString(7), ctx.ipkt.standardDeviationString(7)});
+                      {name, index, ctx.packets, ctx.ipd.minimum(), ctx.ipd.maximum(), ctx.ipd.meanString(7), ctx.ipd.standardDeviationString(7)});
         }
         else if (_csv) {
             out << index << _csv_separator
-                << ctx.total_pkt << _csv_separator
-                << ctx.ipkt.minimum() << _csv_separator
-                << ctx.ipkt.maximum() << _csv_separator
-                << ctx.ipkt.meanString() << _csv_separator
-                << ctx.ipkt.standardDeviationString() << std::endl;
+                << ctx.packets << _csv_separator
+                << ctx.ipd.minimum() << _csv_separator
+                << ctx.ipd.maximum() << _csv_separator
+                << ctx.ipd.meanString() << _csv_separator
+                << ctx.ipd.standardDeviationString() << std::endl;
         }
         else {
             out << UString::Format(_track_pids ? u"0x%04X" : u"%-6d", {index})
-                << UString::Format(u"  %10'd  %6d  %6d  %s  %s", {ctx.total_pkt, ctx.ipkt.minimum(), ctx.ipkt.maximum(), ctx.ipkt.meanString(8), ctx.ipkt.standardDeviationString(8)})
+                << UString::Format(u"  %10'd  %6d  %6d  %s  %s", {ctx.packets, ctx.ipd.minimum(), ctx.ipd.maximum(), ctx.ipd.meanString(8), ctx.ipd.standardDeviationString(8)})
                 << std::endl;
         }
     }
@@ -352,100 +458,15 @@ bool ts::StatsPlugin::produceReport()
 }
 
 
-//----------------------------------------------------------------------------
-// Stop method
-//----------------------------------------------------------------------------
-
-bool ts::StatsPlugin::stop()
-{
-    produceReport();
-    return true;
-}
-
-
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
 
 ts::ProcessorPlugin::Status ts::StatsPlugin::processPacket(TSPacket& pkt, TSPacketMetadata& pkt_data)
 {
-    const PID pid = pkt.getPID();
-
-    // Check tracked pids.
-    if (_pids.test(pid)) {
-        const ContextPtr ctx(getContext(pid));
-        ctx->addPacketData(tsp->pluginPackets(), pkt);
-    }
-
-    // Check tracked labels.
-    if (!_track_pids) {
-        for (size_t label = 0; label < _labels.size(); ++label) {
-            if (pkt_data.hasLabel(label)) {
-                const ContextPtr ctx(getContext(label));
-                ctx->addPacketData(tsp->pluginPackets(), pkt);
-            }
-        }
-    }
-
-    // With --interval, check if it is time to produce a report
-    if (_output_interval > 0 && _metrics.processedPacket() && _metrics.sessionNanoSeconds() >= _next_report) {
-        // Time to produce a report.
-        if (!produceReport()) {
-            return TSP_END;
-        }
-        // Reset analysis context.
-        _ctx_map.clear();
-        // Compute next report time.
-        _next_report += _output_interval;
-    }
-
-    return TSP_OK;
-}
-
-
-//----------------------------------------------------------------------------
-// Get or create the description of a tracked PID.
-//----------------------------------------------------------------------------
-
-ts::StatsPlugin::ContextPtr ts::StatsPlugin::getContext(size_t index)
-{
-    const auto it = _ctx_map.find(index);
-    if (it != _ctx_map.end()) {
-        return it->second;
-    }
-    else {
-        ContextPtr ptr(new Context);
-        CheckNonNull(ptr.pointer());
-        _ctx_map[index] = ptr;
-        return ptr;
-    }
-}
-
-
-//----------------------------------------------------------------------------
-// Constructor of a tracked PID context.
-//----------------------------------------------------------------------------
-
-ts::StatsPlugin::Context::Context() :
-    total_pkt(0),
-    last_ts_index(0),
-    ipkt()
-{
-}
-
-
-//----------------------------------------------------------------------------
-// Add packet data to the context.
-//----------------------------------------------------------------------------
-
-void ts::StatsPlugin::Context::addPacketData(PacketCounter ts_index, const TSPacket& pkt)
-{
-    // Accumulate inter-packet statistics, starting at the second packet.
-    if (total_pkt > 0) {
-        ipkt.feed(ts_index - last_ts_index);
-    }
-
-    // Global packet statistics.
-    total_pkt++;
-    last_ts_index = ts_index;
+    // The metrics engine is designed to be called from the packet thread only.
+    // With --interval, a pending snapshot request is served here.
+    _engine.setBitrate(tsp->bitrate());
+    _engine.feedPacket(pkt, pkt_data);
+    return _abort ? TSP_END : TSP_OK;
 }
@@ -37,9 +37,14 @@
 #include "tsT2MIDescriptor.h"
 #include "tsT2MIPacket.h"
 #include "tsTSFile.h"
+#include "tsUDPSocket.h"
 #include "tsNames.h"
 TSDUCK_SOURCE;
 
+#define DEFAULT_UDP_BURST   7  // Default number of TS packets per UDP datagram.
+#define MAX_UDP_BURST     128  // Maximum number of TS packets per UDP datagram.
+#define FILE_BURST        512  // Number of TS packets per write in PLP files.
+
 
 //----------------------------------------------------------------------------
 // Plugin definition
@@ -64,6 +69,26 @@ namespace ts {
         // Set of identified T2-MI PID's with their PLP's (with --identify).
         typedef std::map<PID, PLPSet> IdentifiedSet;
 
+        // Output of one PLP (with --plp-file or --plp-udp). The extracted
+        // packets are accumulated in a preallocated buffer and written in bursts.
+        class PLPOutput
+        {
+            TS_NOCOPY(PLPOutput);
+        public:
+            UString        name;     // File name or UDP destination.
+            bool           udp;      // Send UDP datagrams, not a file.
+            SocketAddress  dest;     // UDP destination.
+            TSFile         file;     // Output file.
+            TSPacketVector buffer;   // Preallocated burst buffer.
+            size_t         count;    // Number of packets in buffer.
+            PacketCounter  packets;  // Total number of extracted packets.
+
+            // Constructor.
+            PLPOutput(const UString& name_, bool udp_);
+        };
+        typedef SafePtr<PLPOutput> PLPOutputPtr;
+        typedef std::array<PLPOutputPtr, 256> PLPOutputArray;
+
         // Plugin private fields.
         bool              _abort;           // Error, abort asap.
         bool              _extract;         // Extract encapsulated TS.
@@ -82,6 +107,18 @@ namespace ts {
         T2MIDemux         _demux;           // T2-MI demux.
         IdentifiedSet     _identified;      // Map of identified PID's and PLP's.
         std::deque<TSPacket> _ts_queue;     // Queue of demuxed TS packets.
+        PLPOutputArray    _plp_outputs;     // Outputs of individual PLP's, indexed by PLP.
+        size_t            _plp_out_count;   // Number of PLP outputs.
+        size_t            _udp_burst;       // Number of TS packets per UDP datagram.
+        int               _ttl;             // TTL of UDP datagrams.
+        IPAddress         _local_address;   // Outgoing local interface for UDP multicast.
+        UDPSocket         _sock;            // Outgoing UDP socket for PLP outputs.
+
+        // Decode --plp-file and --plp-udp options.
+        bool getPLPOutputs(const UChar* option, bool udp);
+
+        // Write the buffered packets of a PLP output.
+        bool flushPLP(PLPOutput& out);
 
         // Inherited methods.
         virtual void handleT2MINewPID(T2MIDemux& demux, const PMT& pmt, PID pid, const T2MIDescriptor& desc) override;
@@ -116,7 +153,13 @@ ts::T2MIPlugin::T2MIPlugin(TSP* tsp_) :
     _ts_count(0),
     _demux(duck, this),
     _identified(),
-    _ts_queue()
+    _ts_queue(),
+    _plp_outputs(),
+    _plp_out_count(0),
+    _udp_burst(DEFAULT_UDP_BURST),
+    _ttl(0),
+    _local_address(),
+    _sock(false, *tsp_)
 {
     option(u"append", 'a');
     help(u"append",
@@ -141,6 +184,12 @@ ts::T2MIPlugin::T2MIPlugin(TSP* tsp_) :
          u"With --output-file, keep existing file (abort if the specified file "
          u"already exists). By default, existing files are overwritten.");
 
+    option(u"local-address", 0, STRING);
+    help(u"local-address", u"address",
+         u"With --plp-udp, specify the IP address of the outgoing local interface "
+         u"for multicast traffic. It can be also a host name that translates to a "
+         u"local address.");
+
     option(u"log", 'l');
     help(u"log", u"Log all T2-MI packets using one single summary line per packet.");
 
@@ -154,11 +203,36 @@ ts::T2MIPlugin::T2MIPlugin(TSP* tsp_) :
          u"Specify the PID carrying the T2-MI encapsulation. By default, use the "
          u"first component with a T2MI_descriptor in a service.");
 
+    option(u"packet-burst", 0, INTEGER, 0, 1, 1, MAX_UDP_BURST);
+    help(u"packet-burst",
+         u"With --plp-udp, specify the number of TS packets per UDP datagram. "
+         u"The default is " TS_STRINGIFY(DEFAULT_UDP_BURST) u".");
+
+    option(u"plp-file", 0, STRING, 0, UNLIMITED_COUNT);
+    help(u"plp-file", u"plp=filename",
+         u"Extract the encapsulated TS from the specified PLP into the specified file. "
+         u"Several --plp-file and --plp-udp options may be specified to extract "
+         u"several PLP's in one pass. In that case, the main transport stream is "
+         u"passed unchanged to the next plugin, unless --extract is also specified.");
+
+    option(u"plp-udp", 0, STRING, 0, UNLIMITED_COUNT);
+    help(u"plp-udp", u"plp=address:port",
+         u"Extract the encapsulated TS from the specified PLP and send it as UDP "
+         u"datagrams to the specified socket address. "
+         u"Several --plp-file and --plp-udp options may be specified to extract "
+         u"several PLP's in one pass.");
+
     option(u"plp", 0, UINT8);
     help(u"plp",
          u"Specify the PLP (Physical Layer Pipe) to extract from the T2-MI "
          u"encapsulation. By default, use the first PLP which is found. "
          u"Ignored if --extract is not used.");
+
+    option(u"ttl", 0, INTEGER, 0, 1, 1, 255);
+    help(u"ttl",
+         u"With --plp-udp, specify the TTL (Time-To-Live) socket option. "
+         u"The actual option is either \"Unicast TTL\" or \"Multicast TTL\", "
+         u"depending on the destination address. By default, use the system default.");
 }
 
 
@@ -176,6 +250,24 @@ bool ts::T2MIPlugin::getOptions()
     _plp = intValue<uint8_t>(u"plp");
     _plp_valid = present(u"plp");
     getValue(_outfile_name, u"output-file");
+    getIntValue(_udp_burst, u"packet-burst", DEFAULT_UDP_BURST);
+    getIntValue(_ttl, u"ttl", 0);
+
+    // Outgoing interface for UDP multicast.
+    const UString local(value(u"local-address"));
+    _local_address.clear();
+    if (!local.empty() && !_local_address.resolve(local, *tsp)) {
+        return false;
+    }
+
+    // Outputs of individual PLP's.
+    for (auto& out : _plp_outputs) {
+        out.clear();
+    }
+    _plp_out_count = 0;
+    if (!getPLPOutputs(u"plp-file", false) || !getPLPOutputs(u"plp-udp", true)) {
+        return false;
+    }
 
     // Output file open flags.
     _outfile_flags = TSFile::WRITE | TSFile::SHARED;
@@ -188,7 +280,7 @@ bool ts::T2MIPlugin::getOptions()
 
     // Extract is the default operation.
     // It is also implicit if an output file is specified.
-    if ((!_extract && !_log && !_identify) || !_outfile_name.empty()) {
+    if ((!_extract && !_log && !_identify && _plp_out_count == 0) || !_outfile_name.empty()) {
         _extract = true;
     }
 
@@ -198,6 +290,53 @@ bool ts::T2MIPlugin::getOptions()
 }
 
 
+//----------------------------------------------------------------------------
+// Decode --plp-file and --plp-udp options.
+//----------------------------------------------------------------------------
+
+ts::T2MIPlugin::PLPOutput::PLPOutput(const UString& name_, bool udp_) :
+    name(name_),
+    udp(udp_),
+    dest(),
+    file(),
+    buffer(udp_ ? MAX_UDP_BURST : FILE_BURST),
+    count(0),
+    packets(0)
+{
+}
+
+bool ts::T2MIPlugin::getPLPOutputs(const UChar* option, bool udp)
+{
+    UStringVector args;
+    getValues(args, option);
+
+    for (const auto& arg : args) {
+        const size_t eq = arg.find(u'=');
+        uint8_t plp = 0;
+        if (eq == NPOS || eq + 1 >= arg.size() || !arg.substr(0, eq).toInteger(plp)) {
+            tsp->error(u"invalid value \"%s\" for --%s", {arg, option});
+            return false;
+        }
+        if (!_plp_outputs[plp].isNull()) {
+            tsp->error(u"more than one output for PLP %d", {plp});
+            return false;
+        }
+        PLPOutputPtr out(new PLPOutput(arg.substr(eq + 1), udp));
+        CheckNonNull(out.pointer());
+        if (udp && !out->dest.resolve(out->name, *tsp)) {
+            return false;
+        }
+        if (udp && (!out->dest.hasAddress() || !out->dest.hasPort())) {
+            tsp->error(u"missing IP address or port in --%s %s", {option, arg});
+            return false;
+        }
+        _plp_outputs[plp] = out;
+        _plp_out_count++;
+    }
+    return true;
+}
+
+
 //----------------------------------------------------------------------------
 // Start method
 //----------------------------------------------------------------------------
@@ -217,6 +356,32 @@ bool ts::T2MIPlugin::start()
     _ts_count = 0;
     _abort = false;
 
+    // Open outputs of individual PLP's.
+    bool udp = false;
+    for (auto& out : _plp_outputs) {
+        if (!out.isNull()) {
+            out->count = 0;
+            out->packets = 0;
+            if (out->udp) {
+                udp = true;
+            }
+            else if (!out->file.open(out->name, _outfile_flags, *tsp)) {
+                return false;
+            }
+        }
+    }
+    if (udp) {
+        if (!_sock.open(*tsp)) {
+            return false;
+        }
+        if (_ttl > 0 && (!_sock.setTTL(_ttl, false, *tsp) || !_sock.setTTL(_ttl, true, *tsp))) {
+            return false;
+        }
+        if (_local_address.hasAddress() && !_sock.setOutgoingMulticast(_local_address, *tsp)) {
+            return false;
+        }
+    }
+
     // Open output file if present.
     return _outfile_name.empty() || _outfile.open(_outfile_name, _outfile_flags , *tsp);
 }
@@ -233,6 +398,21 @@ bool ts::T2MIPlugin::stop()
         _outfile.close(*tsp);
     }
 
+    // Flush and close outputs of individual PLP's.
+    for (size_t plp = 0; plp < _plp_outputs.size(); ++plp) {
+        const PLPOutputPtr& out(_plp_outputs[plp]);
+        if (!out.isNull()) {
+            flushPLP(*out);
+            if (out->file.isOpen()) {
+                out->file.close(*tsp);
+            }
+            tsp->verbose(u"extracted %'d TS packets from PLP %d to %s", {out->packets, plp, out->name});
+        }
+    }
+    if (_sock.isOpen()) {
+        _sock.close(*tsp);
+    }
+
     // With --extract, display a summary.
     if (_extract) {
         tsp->verbose(u"extracted %'d TS packets from %'d T2-MI packets", {_ts_count, _t2mi_count});
@@ -343,6 +523,18 @@ void ts::T2MIPlugin::handleT2MIPacket(T2MIDemux& demux, const T2MIPacket& pkt)
 
 void ts::T2MIPlugin::handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, const TSPacket& ts)
 {
+    // Dispatch packets to outputs of individual PLP's.
+    if (_plp_out_count > 0 && t2mi.getSourcePID() == _extract_pid) {
+        PLPOutput* out = _plp_outputs[t2mi.plp()].pointer();
+        if (out != nullptr) {
+            out->buffer[out->count++] = ts;
+            out->packets++;
+            if (out->count >= (out->udp ? _udp_burst : out->buffer.size())) {
+                _abort = !flushPLP(*out) || _abort;
+            }
+        }
+    }
+
     // Keep packet from the filtered PLP only.
     if (_extract && _plp_valid && t2mi.plp() == _plp) {
         if (_replace_ts) {
@@ -361,6 +553,26 @@ void ts::T2MIPlugin::handleTSPacket(T2MIDemux& demux, const T2MIPacket& t2mi, co
 }
 
 
+//----------------------------------------------------------------------------
+// Write the buffered packets of a PLP output.
+//----------------------------------------------------------------------------
+
+bool ts::T2MIPlugin::flushPLP(PLPOutput& out)
+{
+    bool ok = true;
+    if (out.count > 0) {
+        if (out.udp) {
+            ok = _sock.send(out.buffer.data(), out.count * PKT_SIZE, out.dest, *tsp);
+        }
+        else {
+            ok = out.file.writePackets(out.buffer.data(), nullptr, out.count, *tsp);
+        }
+        out.count = 0;
+    }
+    return ok;
+}
+
+
 //----------------------------------------------------------------------------
 // Packet processing method
 //----------------------------------------------------------------------------
@@ -72,6 +72,9 @@ namespace ts {
         SubRipGenerator  _srtOutput;  // Generate SRT output file.
         std::set<int>    _pages;      // Set of all Teletext pages in the PID (for information only).
 
+        // Start demuxing the Teletext PID.
+        void demuxTeletextPID();
+
         // Implementation of interfaces.
         virtual void handlePMT(const PMT&, PID) override;
         virtual void handleTeletextMessage(TeletextDemux&, const TeletextFrame&) override;
@@ -174,11 +177,12 @@ bool ts::TeletextPlugin::start()
     // Reinitialize the plugin state.
     _abort = false;
     _demux.reset();
+    _demux.clearPages();
     _pages.clear();
 
     // If the Teletext page is already known, filter it immediately.
     if (_pid != PID_NULL) {
-        _demux.addPID(_pid);
+        demuxTeletextPID();
     }
 
     return true;
@@ -197,6 +201,22 @@ bool ts::TeletextPlugin::stop()
 }
 
 
+//----------------------------------------------------------------------------
+// Start demuxing the Teletext PID.
+//----------------------------------------------------------------------------
+
+void ts::TeletextPlugin::demuxTeletextPID()
+{
+    _demux.addPID(_pid);
+
+    // When the Teletext page is known, the other pages are not decoded.
+    // In verbose mode, all pages are decoded to report them.
+    if (_page >= 0 && !tsp->verbose()) {
+        _demux.addPage(_pid, _page);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Invoked by the service discovery when the PMT of the service is available.
 //----------------------------------------------------------------------------
@@ -237,7 +257,7 @@ void ts::TeletextPlugin::handlePMT(const PMT& pmt, PID)
 
     if (_pid != PID_NULL) {
         // Found a Teletext PID, demux it.
-        _demux.addPID(_pid);
+        demuxTeletextPID();
         tsp->verbose(u"using Teletext PID 0x%X (%d)", {_pid, _pid});
     }
     else {
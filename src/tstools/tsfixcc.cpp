@@ -33,6 +33,8 @@
 
 #include "tsMain.h"
 #include "tsContinuityAnalyzer.h"
+#include "tsTSFile.h"
+#include "tsSysUtils.h"
 TSDUCK_SOURCE;
 TS_MAIN(MainCode);
 
@@ -48,14 +50,9 @@ namespace {
     public:
         Options(int argc, char *argv[]);
 
-        bool         test;      // Test mode
-        bool         circular;  // Add empty packets to enforce circular continuity
-        ts::UString  filename;  // File name
-        std::fstream file;      // File buffer
-
-        // Check if there was an I/O error on the file.
-        // Print an error message if this is the case.
-        bool fileError(const ts::UChar* message);
+        bool        test;      // Test mode
+        bool        circular;  // Add empty packets to enforce circular continuity
+        ts::UString filename;  // File name
     };
 }
 
@@ -64,8 +61,7 @@ Options::Options(int argc, char *argv[]) :
     Args(u"Fix continuity counters in a transport stream", u"[options] filename"),
     test(false),
     circular(false),
-    filename(),
-    file()
+    filename()
 {
     option(u"", 0, STRING, 1, 1);
     help(u"", u"MPEG capture file to be modified.");
@@ -88,18 +84,6 @@ Options::Options(int argc, char *argv[]) :
     exitOnError();
 }
 
-// Check error on file
-bool Options::fileError(const ts::UChar* message)
-{
-    if (file) {
-        return false;
-    }
-    else {
-        error(u"%s: %s", {filename, message});
-        return true;
-    }
-}
-
 
 //----------------------------------------------------------------------------
 //  Program entry point
@@ -115,54 +99,53 @@ int MainCode(int argc, char *argv[])
     fixer.setFix(!opt.test);
     fixer.setMessageSeverity(opt.test ? ts::Severity::Info : ts::Severity::Verbose);
 
-    // Open file in read/write mode (CC are overwritten)
-    std::ios::openmode mode = std::ios::in | std::ios::binary;
-    if (!opt.test) {
-        mode |= std::ios::out;
-    }
-
-    opt.file.open(opt.filename.toUTF8().c_str(), mode);
-
-    if (!opt.file) {
+    // Open file in read/write mode (CC are overwritten).
+    // Only plain TS files are supported, packets are rewritten in place.
+    // The read/write mode of TSFile creates missing files, the file must already exist.
+    if (!ts::FileExists(opt.filename)) {
         opt.error(u"cannot open file %s", {opt.filename});
         return EXIT_FAILURE;
     }
+    ts::TSFile file;
+    if (!file.open(opt.filename, opt.test ? ts::TSFile::READ : (ts::TSFile::READ | ts::TSFile::WRITE), opt, ts::TSPacketFormat::TS)) {
+        return EXIT_FAILURE;
+    }
 
-    // Process all packets in the file
-    ts::TSPacket pkt;
+    // Process the file in one pass, by large chunks of packets. Each chunk is
+    // analyzed at once and is rewritten in place only when some packets were fixed.
+    ts::TSPacketVector buffer(10000);
+    ts::PacketCounter position = 0;
+    bool sync_lost = false;
 
-    for (;;) {
+    while (!sync_lost && opt.valid()) {
 
-        // Save position of current packet
-        const std::ios::pos_type pos = opt.file.tellg();
-        if (opt.fileError(u"error getting file position")) {
-            break;
-        }
-
-        // Read a TS packet
-        if (!pkt.read(opt.file, true, opt)) {
+        // Read a chunk of TS packets.
+        size_t count = file.readPackets(buffer.data(), nullptr, buffer.size(), opt);
+        if (count == 0) {
             break; // end of file
         }
 
-        // Process packet
-        if (!fixer.feedPacket(pkt) && !opt.test) {
-            // Packet was modified, need to rewrite it.
-            // Rewind to beginning of current packet
-            opt.file.seekp(pos);
-            if (opt.fileError(u"error setting file position")) {
+        // Stop at the first packet with an invalid sync byte.
+        for (size_t i = 0; i < count; ++i) {
+            if (!buffer[i].hasValidSync()) {
+                opt.error(u"synchronization lost after %'d packets, got 0x%X instead of 0x%X at start of TS packet", {position + i, buffer[i].b[0], ts::SYNC_BYTE});
+                count = i;
+                sync_lost = true;
                 break;
             }
-            // Rewrite the packet
-            pkt.write(opt.file, opt);
-            if (opt.fileError(u"error rewriting packet")) {
-                break;
-            }
-            // Make sure the get position is ok
-            opt.file.seekg(opt.file.tellp());
-            if (opt.fileError(u"error setting file position")) {
+        }
+
+        // Process the chunk.
+        const ts::PacketCounter fix_count = fixer.fixCount();
+        fixer.feedPackets(buffer.data(), count);
+
+        // Rewrite the chunk if some packets were modified.
+        if (fixer.fixCount() != fix_count && !opt.test) {
+            if (!file.seek(position, opt) || !file.writePackets(buffer.data(), nullptr, count, opt)) {
                 break;
             }
         }
+        position += count;
     }
 
     opt.verbose(u"%'d packets read, %'d discontinuities, %'d packets updated", {fixer.totalPackets(), fixer.errorCount(), fixer.fixCount()});
@@ -171,20 +154,15 @@ int MainCode(int argc, char *argv[])
     if (opt.circular && opt.valid()) {
 
         // Create an empty packet (no payload, 184-byte adaptation field)
-        pkt = ts::NullPacket;
+        ts::TSPacket pkt(ts::NullPacket);
         pkt.b[3] = 0x20;    // adaptation field, no payload
         pkt.b[4] = 183;     // adaptation field length
         pkt.b[5] = 0x00;    // nothing in adaptation field
 
-        // Ensure write position is at end of file
+        // Set write position at end of file.
         if (!opt.test) {
-            // First, need to clear the eof bit
-            opt.file.clear();
-            // Set write position at eof
-            opt.file.seekp(0, std::ios::end);
-            // Returned value ignored on purpose, just report error when needed.
-            // coverity[CHECKED_RETURN]
-            opt.fileError(u"error setting file position");
+            // Returned value ignored on purpose, errors are already reported.
+            file.seek(position, opt);
         }
 
         // Loop through all PIDs, adding packets where some are missing
@@ -204,8 +182,7 @@ int MainCode(int argc, char *argv[])
                         pkt.setPID(ts::PID(pid));
                         pkt.setCC(last_cc);
                         // Write the new packet
-                        pkt.write(opt.file, opt);
-                        if (opt.fileError(u"error writing extra packet")) {
+                        if (!file.writePackets(&pkt, nullptr, 1, opt)) {
                             break;
                         }
                     }
@@ -214,7 +191,7 @@ int MainCode(int argc, char *argv[])
         }
     }
 
-    opt.file.close();
+    file.close(opt);
 
     return opt.valid() ? EXIT_SUCCESS : EXIT_FAILURE;
 }
@@ -80,6 +80,7 @@ public:
     void testDecode24();
     void testDecode25();
     void testDecode26();
+    void testDecodeCache();
     void testEncode1();
     void testEncode2();
     void testEncode3();
@@ -134,6 +135,7 @@ public:
     TSUNIT_TEST(testDecode24);
     TSUNIT_TEST(testDecode25);
     TSUNIT_TEST(testDecode26);
+    TSUNIT_TEST(testDecodeCache);
     TSUNIT_TEST(testEncode1);
     TSUNIT_TEST(testEncode2);
     TSUNIT_TEST(testEncode3);
@@ -500,6 +502,40 @@ void ARIBCharsetTest::testDecode26()
     T(false);
 }
 
+void ARIBCharsetTest::testDecodeCache()
+{
+    const ts::ARIBCharset& cset(ts::ARIBCharset::B24);
+    TSUNIT_EQUAL(ts::ARIBCharset::DEFAULT_DECODE_CACHE_SIZE, cset.decodeCacheSize());
+
+    const ts::ByteBlock b1({0x0E, 0x4E, 0x48, 0x4B, 0x0F, 0x41, 0x6D, 0x39, 0x67, 0x0E, 0x31, 0xFE, 0x0F, 0x3D, 0x29, 0x45, 0x44});
+    const ts::UString u1({0x004E, 0x0048, 0x004B, 0x7DCF, 0x5408, 0x0031, 0x30FB, 0x79CB, 0x7530});
+    const ts::ByteBlock b2({0x0E, 0x4E, 0x48, 0x4B, 0x0F, 0x41, 0x6D, 0x39, 0x67, 0x0E, 0x32, 0xFE, 0x0F, 0x3D, 0x29, 0x45, 0x44});
+    const ts::UString u2({0x004E, 0x0048, 0x004B, 0x7DCF, 0x5408, 0x0032, 0x30FB, 0x79CB, 0x7530});
+    const ts::ByteBlock b3({0x1B, 0x24, 0x3B, 0x7A, 0x56, 0x7A, 0x6D});  // ends with an invalid character
+
+    // Decode each string several times, with cache hits and evictions.
+    cset.setDecodeCacheSize(2);
+    for (int i = 0; i < 3; ++i) {
+        ts::UString str;
+        TSUNIT_ASSERT(cset.decode(str, b1.data(), b1.size()));
+        TSUNIT_EQUAL(u1, str);
+        TSUNIT_ASSERT(cset.decode(str, b2.data(), b2.size()));
+        TSUNIT_EQUAL(u2, str);
+        const bool ok3 = cset.decode(str, b3.data(), b3.size());
+        TSUNIT_EQUAL(ok3, cset.decode(str, b3.data(), b3.size()));
+        TSUNIT_ASSERT(cset.decode(str, b1.data(), b1.size()));
+        TSUNIT_EQUAL(u1, str);
+    }
+
+    // Same results without cache.
+    cset.setDecodeCacheSize(0);
+    TSUNIT_EQUAL(0, cset.decodeCacheSize());
+    TSUNIT_EQUAL(u1, cset.decoded(b1.data(), b1.size()));
+    TSUNIT_EQUAL(u2, cset.decoded(b2.data(), b2.size()));
+
+    cset.setDecodeCacheSize(ts::ARIBCharset::DEFAULT_DECODE_CACHE_SIZE);
+}
+
 #undef B
 #undef U
 #undef T
@@ -49,10 +49,12 @@ public:
 
     void testAnalyze();
     void testFix();
+    void testBatch();
 
     TSUNIT_TEST_BEGIN(ContinuityTest);
     TSUNIT_TEST(testAnalyze);
     TSUNIT_TEST(testFix);
+    TSUNIT_TEST(testBatch);
     TSUNIT_TEST_END();
 };
 
@@ -236,3 +238,61 @@ void ContinuityTest::testFix()
     TSUNIT_EQUAL(2, fixer.errorCount());
     TSUNIT_EQUAL(5, fixer.fixCount());
 }
+
+void ContinuityTest::testBatch()
+{
+    // Same scenario as testFix(), with several PID's and in one batch.
+    static const struct {
+        ts::PID pid;
+        uint8_t cc_in;
+        uint8_t cc_out;
+    } scenario[] = {
+        {100, 5, 5}, {101, 13, 13}, {100, 6, 6}, {101, 14, 14}, {101, 14, 14}, {101, 15, 15}, {101, 0, 0},
+        {101, 3, 1}, {101, 4, 2}, {101, 4, 2}, {101, 4, 2}, {101, 5, 3}, {200, 7, 7}, {100, 9, 7},
+    };
+    const size_t count = sizeof(scenario) / sizeof(scenario[0]);
+
+    ts::TSPacketVector packets(count, ts::NullPacket);
+    for (size_t i = 0; i < count; ++i) {
+        packets[i].setPID(scenario[i].pid);
+        packets[i].setCC(scenario[i].cc_in);
+    }
+
+    ts::ContinuityAnalyzer analyzer(ts::AllPIDs);
+    TSUNIT_ASSERT(!analyzer.feedPackets(packets.data(), count));
+    TSUNIT_EQUAL(count, analyzer.totalPackets());
+    TSUNIT_EQUAL(3, analyzer.errorCount());
+    TSUNIT_EQUAL(0, analyzer.fixCount());
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_EQUAL(scenario[i].cc_in, packets[i].getCC());
+    }
+
+    ts::ContinuityAnalyzer fixer(ts::AllPIDs);
+    fixer.setFix(true);
+    TSUNIT_ASSERT(fixer.feedPackets(packets.data(), 7));
+    TSUNIT_ASSERT(!fixer.feedPackets(packets.data() + 7, count - 7));
+    TSUNIT_EQUAL(count, fixer.totalPackets());
+    TSUNIT_EQUAL(3, fixer.errorCount());
+    TSUNIT_EQUAL(6, fixer.fixCount());
+    for (size_t i = 0; i < count; ++i) {
+        TSUNIT_EQUAL(scenario[i].cc_out, packets[i].getCC());
+    }
+
+    TSUNIT_EQUAL(5, fixer.firstCC(100));
+    TSUNIT_EQUAL(7, fixer.lastCC(100));
+    TSUNIT_EQUAL(13, fixer.firstCC(101));
+    TSUNIT_EQUAL(3, fixer.lastCC(101));
+    TSUNIT_EQUAL(7, fixer.firstCC(200));
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(300));
+
+    // Remove PID's, the other states must remain valid.
+    fixer.removePID(100);
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(100));
+    TSUNIT_EQUAL(13, fixer.firstCC(101));
+    TSUNIT_EQUAL(7, fixer.firstCC(200));
+    fixer.removePID(200);
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(200));
+    TSUNIT_EQUAL(3, fixer.lastCC(101));
+    fixer.reset();
+    TSUNIT_EQUAL(ts::INVALID_CC, fixer.firstCC(101));
+}
@@ -32,6 +32,7 @@
 //----------------------------------------------------------------------------
 
 #include "tsDVBCharset.h"
+#include "tsDVBCharTableSingleByte.h"
 #include "tsByteBlock.h"
 #include "tsunit.h"
 TSDUCK_SOURCE;
@@ -48,10 +49,12 @@ public:
 
     void testRepository();
     void testDVB();
+    void testSingleByte();
 
     TSUNIT_TEST_BEGIN(DVBCharsetTest);
     TSUNIT_TEST(testRepository);
     TSUNIT_TEST(testDVB);
+    TSUNIT_TEST(testSingleByte);
     TSUNIT_TEST_END();
 };
 
@@ -103,3 +106,31 @@ void DVBCharsetTest::testDVB()
     TSUNIT_EQUAL(str1, ts::DVBCharset::DVB.decoded(dvb1, sizeof(dvb1)));
     TSUNIT_ASSERT(ts::ByteBlock(dvb1, sizeof(dvb1)) == ts::DVBCharset::DVB.encoded(str1.toDecomposedDiacritical()));
 }
+
+void DVBCharsetTest::testSingleByte()
+{
+    // Long ASCII runs, across the block size of the ASCII fast path, mixed with other characters.
+    static const char s1[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz";
+    TSUNIT_EQUAL(u"0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz",
+                 ts::DVBCharTableSingleByte::RAW_ISO_6937.decoded(reinterpret_cast<const uint8_t*>(s1), ::strlen(s1)));
+
+    // New line, diacritical marks at end of an ASCII run, untranslatable characters.
+    ts::ByteBlock dvb2;
+    dvb2.appendUTF8(u"0123456789ABCDEF");
+    dvb2.append(ts::ByteBlock({0xC2, 0x65, 0x8A}));
+    dvb2.appendUTF8(u"0123456789abcdef0123456789");
+    dvb2.append(ts::ByteBlock({0xC3, 0x75, 0x7F, 0x41}));
+    const ts::UString str2(u"0123456789ABCDEF" + ts::UString(1, ts::LATIN_SMALL_LETTER_E_WITH_ACUTE) + u"\n0123456789abcdef0123456789" + ts::UString({ts::LATIN_SMALL_LETTER_U_WITH_CIRCUMFLEX, u'A'}));
+    ts::UString str;
+    TSUNIT_ASSERT(!ts::DVBCharTableSingleByte::RAW_ISO_6937.decode(str, dvb2.data(), dvb2.size()));
+    TSUNIT_EQUAL(str2, str);
+
+    // Non-ASCII table.
+    static const uint8_t dvb3[] = {0x41, 0x42, 0xA4, 0x43, 0x44, 0xE9};
+    TSUNIT_EQUAL(ts::UString({u'A', u'B', ts::EURO_SIGN, u'C', u'D', ts::LATIN_SMALL_LETTER_E_WITH_ACUTE}),
+                 ts::DVBCharTableSingleByte::RAW_ISO_8859_15.decoded(dvb3, sizeof(dvb3)));
+
+    // Empty or null input.
+    TSUNIT_ASSERT(ts::DVBCharTableSingleByte::RAW_ISO_6937.decode(str, nullptr, 0));
+    TSUNIT_ASSERT(str.empty());
+}
@@ -0,0 +1,362 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//
+//  TSUnit test suite for class ts::GOPAnalyzer
+//
+//----------------------------------------------------------------------------
+
+#include "tsGOPAnalyzer.h"
+#include "tsAVC.h"
+#include "tsHEVC.h"
+#include "tsPESOneShotPacketizer.h"
+#include "tsDuckContext.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class GOPAnalyzerTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testAVC();
+    void testHEVC();
+    void testMPEG2();
+    void testIntraImageStart();
+
+    TSUNIT_TEST_BEGIN(GOPAnalyzerTest);
+    TSUNIT_TEST(testAVC);
+    TSUNIT_TEST(testHEVC);
+    TSUNIT_TEST(testMPEG2);
+    TSUNIT_TEST(testIntraImageStart);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(GOPAnalyzerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void GOPAnalyzerTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void GOPAnalyzerTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Build synthetic video PES packets.
+//----------------------------------------------------------------------------
+
+namespace {
+    const ts::PID VIDEO_PID = 100;
+
+    // Build a video PES packet with an optional PTS.
+    ts::ByteBlock BuildPES(const ts::ByteBlock& payload, uint64_t pts = ts::INVALID_PTS)
+    {
+        ts::ByteBlock data;
+        data.appendUInt24(0x000001);
+        data.appendUInt8(0xE0);
+        data.appendUInt16(0x0000);  // unbounded video PES
+        data.appendUInt8(0x80);
+        if (pts == ts::INVALID_PTS) {
+            data.appendUInt8(0x00);
+            data.appendUInt8(0x00);
+        }
+        else {
+            data.appendUInt8(0x80);  // PTS only
+            data.appendUInt8(0x05);
+            data.appendUInt8(uint8_t(0x21 | ((pts >> 29) & 0x0E)));
+            data.appendUInt16(uint16_t(((pts >> 14) & 0xFFFE) | 0x0001));
+            data.appendUInt16(uint16_t(((pts << 1) & 0xFFFE) | 0x0001));
+        }
+        data.append(payload);
+        return data;
+    }
+
+    // Build an AVC access unit: access unit delimiter (any picture type), one slice, filler.
+    // A byte stream starts with a 4-byte start code.
+    ts::ByteBlock AVCFrame(char type, size_t filler)
+    {
+        ts::ByteBlock data;
+        data.appendUInt32(0x00000001);
+        data.appendUInt8(ts::AVC_AUT_DELIMITER);
+        data.appendUInt8(0xF0);
+        data.appendUInt24(0x000001);
+        // Slice header: first_mb_in_slice = ue(0), slice_type = ue(7), ue(5) or ue(6).
+        if (type == 'I') {
+            data.appendUInt8(0x65);
+            data.appendUInt8(0x88);
+        }
+        else if (type == 'P') {
+            data.appendUInt8(0x41);
+            data.appendUInt8(0x98);
+        }
+        else {
+            data.appendUInt8(0x01);
+            data.appendUInt8(0x9C);
+        }
+        data.append(0x55, filler);
+        return data;
+    }
+
+    // Build an HEVC NAL unit header (2 bytes) with a 4-byte start code.
+    void HEVCNalHeader(ts::ByteBlock& data, uint8_t type)
+    {
+        data.appendUInt32(0x00000001);
+        data.appendUInt8(uint8_t(type << 1));
+        data.appendUInt8(0x01);  // nuh_temporal_id_plus1 = 1
+    }
+
+    // Build an HEVC PPS with pps_pic_parameter_set_id = 0 and num_extra_slice_header_bits = 2.
+    ts::ByteBlock HEVCPPS()
+    {
+        ts::ByteBlock data;
+        HEVCNalHeader(data, ts::HEVC_AUT_PPS_NUT);
+        // pps_id = ue(0), sps_id = ue(0), two flags = 0, num_extra_slice_header_bits = u(3) = 2, stop bit.
+        data.appendUInt8(0xC5);
+        return data;
+    }
+
+    // Build an HEVC picture with one TRAIL_R slice, first slice in picture, PPS id 0, filler.
+    // With an access unit delimiter, the slice header has no extra bits and the AUD
+    // declares I-frames only. Without AUD, the slice header has the two extra bits
+    // which are declared in HEVCPPS().
+    ts::ByteBlock HEVCFrame(char type, bool aud, size_t filler)
+    {
+        ts::ByteBlock data;
+        if (aud) {
+            HEVCNalHeader(data, ts::HEVC_AUT_AUD_NUT);
+            // pic_type = u(3) = 0 (I) or 2 (IPB), stop bit.
+            data.appendUInt8(type == 'I' ? 0x10 : 0x50);
+        }
+        HEVCNalHeader(data, ts::HEVC_AUT_TRAIL_R);
+        // first_slice_segment_in_pic_flag = 1, pps_id = ue(0), [extra bits = 00], slice_type = ue(2), ue(1) or ue(0).
+        if (type == 'I') {
+            data.appendUInt8(aud ? 0xDC : 0xC7);
+        }
+        else if (type == 'P') {
+            data.appendUInt8(aud ? 0xD4 : 0xC5);
+        }
+        else {
+            data.appendUInt8(aud ? 0xF0 : 0xCC);
+        }
+        data.append(0x55, filler);
+        return data;
+    }
+
+    // Build an MPEG-2 picture, with a sequence header for I-frames.
+    ts::ByteBlock MPEG2Frame(char type, size_t filler)
+    {
+        ts::ByteBlock data;
+        if (type == 'I') {
+            data.appendUInt32(0x000001B3);
+            data.appendUInt32(0x2D0240A3);  // 720x576, 4:3, 25 Hz
+            data.appendUInt32(0xFFFFE000);
+        }
+        data.appendUInt32(0x00000100);
+        data.appendUInt8(0x00);
+        data.appendUInt8(uint8_t((type == 'I' ? 1 : (type == 'P' ? 2 : 3)) << 3));
+        data.appendUInt16(0xFFF8);
+        data.appendUInt32(0x00000101);  // first slice
+        data.append(0x55, filler);
+        return data;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void GOPAnalyzerTest::testAVC()
+{
+    ts::GOPAnalyzer gop;
+    gop.setStreamType(VIDEO_PID, ts::ST_AVC_VIDEO);
+
+    // Three GOP's "IBBPBBPBB" at 25 frames/second, then one I-frame and one P-frame.
+    const ts::UString structure(u"IBBPBBPBBIBBPBBPBBIBBPBBPBBIP");
+    const size_t i_sizes[] = {1000, 2000, 3000, 4000};
+    size_t i_count = 0;
+    for (size_t i = 0; i < structure.size(); ++i) {
+        const char type = char(structure[i]);
+        const ts::ByteBlock frame(AVCFrame(type, type == 'I' ? i_sizes[i_count++] - 11 : 100));
+        gop.feedPES(ts::PESPacket(BuildPES(frame, 3600 * i), VIDEO_PID));
+    }
+
+    TSUNIT_ASSERT(gop.statistics(ts::PID_NULL) == nullptr);
+    const ts::GOPAnalyzer::Statistics* st = gop.statistics(VIDEO_PID);
+    TSUNIT_ASSERT(st != nullptr);
+
+    std::vector<ts::PID> pids;
+    gop.getPIDs(pids);
+    TSUNIT_EQUAL(1, pids.size());
+    TSUNIT_EQUAL(VIDEO_PID, pids[0]);
+
+    // The last P-frame is still open.
+    TSUNIT_ASSERT(st->codec == ts::CodecType::AVC);
+    TSUNIT_EQUAL(28, st->frames());
+    TSUNIT_EQUAL(4, st->i_frames);
+    TSUNIT_EQUAL(6, st->p_frames);
+    TSUNIT_EQUAL(18, st->b_frames);
+    TSUNIT_EQUAL(0, st->other_frames);
+
+    TSUNIT_EQUAL(3, st->gop_count);
+    TSUNIT_EQUAL(9, st->gop_min);
+    TSUNIT_EQUAL(9, st->gop_max);
+    TSUNIT_EQUAL(9, st->gopAverage());
+    TSUNIT_EQUAL(u"IBBPBBPBB", st->gop_structure);
+
+    TSUNIT_EQUAL(1000, st->i_size_min);
+    TSUNIT_EQUAL(4000, st->i_size_max);
+    TSUNIT_EQUAL(2500, st->iSizeAverage());
+
+    // 9 frames at 25 fps = 360 ms, in bin 2^8 to 2^9-1 ms.
+    for (size_t bin = 0; bin < ts::GOPAnalyzer::RAP_INTERVAL_BINS; ++bin) {
+        TSUNIT_EQUAL(bin == 8 ? 3 : 0, st->rap_intervals[bin]);
+    }
+
+    gop.reset();
+    TSUNIT_ASSERT(gop.statistics(VIDEO_PID) == nullptr);
+}
+
+void GOPAnalyzerTest::testHEVC()
+{
+    // With access unit delimiters but without PPS: the AUD types the I-frames,
+    // the type of other frames cannot be found in the slice headers.
+    ts::GOPAnalyzer gop1;
+    gop1.setStreamType(VIDEO_PID, ts::ST_HEVC_VIDEO);
+    const ts::UString structure(u"IBBPBBPIBBPBBPIP");
+    for (size_t i = 0; i < structure.size(); ++i) {
+        gop1.feedPES(ts::PESPacket(BuildPES(HEVCFrame(char(structure[i]), true, 100), 3600 * i), VIDEO_PID));
+    }
+
+    const ts::GOPAnalyzer::Statistics* st = gop1.statistics(VIDEO_PID);
+    TSUNIT_ASSERT(st != nullptr);
+    TSUNIT_ASSERT(st->codec == ts::CodecType::HEVC);
+    TSUNIT_EQUAL(15, st->frames());
+    TSUNIT_EQUAL(3, st->i_frames);
+    TSUNIT_EQUAL(0, st->p_frames);
+    TSUNIT_EQUAL(0, st->b_frames);
+    TSUNIT_EQUAL(12, st->other_frames);
+    TSUNIT_EQUAL(2, st->gop_count);
+    TSUNIT_EQUAL(7, st->gopAverage());
+    TSUNIT_EQUAL(u"I??????", st->gop_structure);
+
+    // Without access unit delimiter, with a PPS which declares extra slice header bits:
+    // the frames are delimited and typed by the first slice of each picture.
+    ts::GOPAnalyzer gop2;
+    gop2.setStreamType(VIDEO_PID, ts::ST_HEVC_VIDEO);
+    for (size_t i = 0; i < structure.size(); ++i) {
+        ts::ByteBlock payload(i == 0 ? HEVCPPS() : ts::ByteBlock());
+        payload.append(HEVCFrame(char(structure[i]), false, 100));
+        gop2.feedPES(ts::PESPacket(BuildPES(payload, 3600 * i), VIDEO_PID));
+    }
+
+    st = gop2.statistics(VIDEO_PID);
+    TSUNIT_ASSERT(st != nullptr);
+    TSUNIT_ASSERT(st->codec == ts::CodecType::HEVC);
+    TSUNIT_EQUAL(15, st->frames());
+    TSUNIT_EQUAL(3, st->i_frames);
+    TSUNIT_EQUAL(4, st->p_frames);
+    TSUNIT_EQUAL(8, st->b_frames);
+    TSUNIT_EQUAL(0, st->other_frames);
+    TSUNIT_EQUAL(2, st->gop_count);
+    TSUNIT_EQUAL(u"IBBPBBP", st->gop_structure);
+
+    // 7 frames at 25 fps = 280 ms, in bin 2^8 to 2^9-1 ms.
+    for (size_t bin = 0; bin < ts::GOPAnalyzer::RAP_INTERVAL_BINS; ++bin) {
+        TSUNIT_EQUAL(bin == 8 ? 2 : 0, st->rap_intervals[bin]);
+    }
+}
+
+void GOPAnalyzerTest::testMPEG2()
+{
+    // Stream type is not declared, MPEG-2 video is detected from PES packets.
+    ts::GOPAnalyzer gop;
+
+    const ts::UString structure(u"IPPPIPPPIP");
+    for (size_t i = 0; i < structure.size(); ++i) {
+        const char type = char(structure[i]);
+        gop.feedPES(ts::PESPacket(BuildPES(MPEG2Frame(type, type == 'I' ? 500 : 50)), VIDEO_PID));
+    }
+
+    const ts::GOPAnalyzer::Statistics* st = gop.statistics(VIDEO_PID);
+    TSUNIT_ASSERT(st != nullptr);
+    TSUNIT_ASSERT(st->codec == ts::CodecType::MPEG2_VIDEO);
+    TSUNIT_EQUAL(9, st->frames());
+    TSUNIT_EQUAL(3, st->i_frames);
+    TSUNIT_EQUAL(6, st->p_frames);
+    TSUNIT_EQUAL(0, st->b_frames);
+    TSUNIT_EQUAL(2, st->gop_count);
+    TSUNIT_EQUAL(4, st->gopAverage());
+    TSUNIT_EQUAL(u"IPPP", st->gop_structure);
+    TSUNIT_EQUAL(524, st->i_size_min);
+    TSUNIT_EQUAL(524, st->i_size_max);
+
+    // No PTS, no interval between random access points.
+    for (size_t bin = 0; bin < ts::GOPAnalyzer::RAP_INTERVAL_BINS; ++bin) {
+        TSUNIT_EQUAL(0, st->rap_intervals[bin]);
+    }
+}
+
+void GOPAnalyzerTest::testIntraImageStart()
+{
+    ts::DuckContext duck;
+    ts::GOPAnalyzer gop;
+
+    ts::PESOneShotPacketizer zer(duck, VIDEO_PID);
+    zer.addPES(BuildPES(AVCFrame('I', 500)), ts::ShareMode::COPY);
+    zer.addPES(BuildPES(AVCFrame('P', 500)), ts::ShareMode::COPY);
+    ts::TSPacketVector packets;
+    zer.getPackets(packets);
+    TSUNIT_EQUAL(6, packets.size());
+
+    // Unknown PID before the stream type is declared.
+    TSUNIT_ASSERT(!gop.isIntraImageStart(packets[0]));
+
+    gop.setStreamType(VIDEO_PID, ts::ST_AVC_VIDEO);
+    TSUNIT_ASSERT(gop.isIntraImageStart(packets[0]));
+    TSUNIT_ASSERT(!gop.isIntraImageStart(packets[1]));
+    TSUNIT_ASSERT(!gop.isIntraImageStart(packets[3]));
+
+    // Non-video stream types are ignored.
+    gop.setStreamType(VIDEO_PID + 1, ts::ST_MPEG2_AUDIO);
+    TSUNIT_ASSERT(gop.statistics(VIDEO_PID + 1) == nullptr);
+}
@@ -40,8 +40,14 @@
 #include "tsjsonString.h"
 #include "tsjsonObject.h"
 #include "tsjsonArray.h"
+#include "tsjsonDocument.h"
+#include "tsjsonReader.h"
+#include "tsSysUtils.h"
+#include "tsTime.h"
 #include "tsCerrReport.h"
 #include "tsNullReport.h"
+#include "tsReportBuffer.h"
+#include "tsTextParser.h"
 #include "tsunit.h"
 TSDUCK_SOURCE;
 
@@ -60,12 +66,22 @@ public:
     void testGitHub();
     void testFactory();
     void testQuery();
+    void testParser();
+    void testParserConsistency();
+    void testReader();
+    void testDocument();
+    void testDocumentBenchmark();
 
     TSUNIT_TEST_BEGIN(JsonTest);
     TSUNIT_TEST(testSimple);
     TSUNIT_TEST(testGitHub);
     TSUNIT_TEST(testFactory);
     TSUNIT_TEST(testQuery);
+    TSUNIT_TEST(testParser);
+    TSUNIT_TEST(testParserConsistency);
+    TSUNIT_TEST(testReader);
+    TSUNIT_TEST(testDocument);
+    TSUNIT_TEST(testDocumentBenchmark);
     TSUNIT_TEST_END();
 };
 
@@ -696,3 +712,325 @@ void JsonTest::testQuery()
 
     debug() << "JsonTest::testQuery:" << std::endl << root.printed() << std::endl;
 }
+
+void JsonTest::testParser()
+{
+    // Same results with the text parser and the document parser.
+    const ts::UString text(
+        u"{\r\n"
+        u"  \"name\": \"a \\\"quoted\\\" \\u00E9\\n string\",\r\n"
+        u"  \"num\": -1234,\n"
+        u"  \"list\": [1, +2, true, false, null, \"\", {}, []],\n"
+        u"  \"sub\": {\"x\" : {\"y\":\"z\"}}\n"
+        u"}\n");
+
+    ts::json::ValuePtr jv1;
+    TSUNIT_ASSERT(ts::json::Parse(jv1, text, CERR));
+    TSUNIT_ASSERT(!jv1.isNull());
+    TSUNIT_EQUAL(u"a \"quoted\" \u00E9\n string", jv1->value(u"name").toString());
+    TSUNIT_EQUAL(-1234, jv1->value(u"num").toInteger());
+    TSUNIT_EQUAL(8, jv1->value(u"list").size());
+    TSUNIT_EQUAL(2, jv1->value(u"list").at(1).toInteger());
+    TSUNIT_EQUAL(u"z", jv1->query(u"sub.x.y").toString());
+
+    ts::json::ValuePtr jv2;
+    ts::TextParser parser(text, CERR);
+    TSUNIT_ASSERT(ts::json::Parse(jv2, parser, true, CERR));
+    TSUNIT_ASSERT(!jv2.isNull());
+    TSUNIT_EQUAL(jv2->printed(), jv1->printed());
+
+    ts::UStringList lines;
+    text.toRemoved(u'\r').split(lines, u'\n', false);
+    ts::json::ValuePtr jv3;
+    TSUNIT_ASSERT(ts::json::Parse(jv3, lines, CERR));
+    TSUNIT_ASSERT(!jv3.isNull());
+    TSUNIT_EQUAL(jv1->printed(), jv3->printed());
+
+    // Errors and line numbers.
+    ts::ReportBuffer<> rep;
+    TSUNIT_ASSERT(!ts::json::Parse(jv1, u"[1,\n2\n3]", rep));
+    TSUNIT_EQUAL(u"Error: line 3: syntax error in JSON array, missing ','", rep.getMessages());
+    rep.resetMessages();
+    TSUNIT_ASSERT(!ts::json::Parse(jv1, u"{\"a\": 0x12}", rep));
+    TSUNIT_EQUAL(u"Error: line 1: not a valid JSON value", rep.getMessages());
+    rep.resetMessages();
+    TSUNIT_ASSERT(!ts::json::Parse(jv1, u"[\"abc\n\"]", rep));
+    TSUNIT_ASSERT(!ts::json::Parse(jv1, u"{\"abc\": 1", NULLREP));
+    TSUNIT_ASSERT(!ts::json::Parse(jv1, u"{\"abc\": 1} 2", NULLREP));
+}
+
+void JsonTest::testParserConsistency()
+{
+    // The document parser and the text parser must give the same results and the same errors.
+    static const ts::UChar* const inputs[] = {
+        u"",
+        u"   ",
+        u"\n\n",
+        u"nul",
+        u"nullx",
+        u"truefalse",
+        u"[1,\n2\n3]",
+        u"[1,\n2,\n",
+        u"[1 2]",
+        u"[,]",
+        u"[1,]",
+        u"{\"a\": 0x12}",
+        u"{\"a\" 1}",
+        u"{\"a\": 1 \"b\": 2}",
+        u"{\"a\":\n1,\n",
+        u"{a: 1}",
+        u"{\"abc\": 1",
+        u"{\"abc\": 1} 2",
+        u"{\"abc\": 1}\n\n  x",
+        u"[\"abc\n\"]",
+        u"[\"abc\\\ndef\"]",
+        u"[\"unterminated]",
+        u"[1.5, 2e3, -0.5e-2]",
+        u"[12ab]",
+        u"[1_000]",
+        u"[+-1]",
+        u"[-]",
+        u"[\"\\u00e9\\t\\\"\"]",
+        u"\r\n[1,\r\n2 3]\r\n",
+        u" {\"x\": [true, false, null, {}, []]} \n",
+    };
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); ++i) {
+        const ts::UString text(inputs[i]);
+
+        ts::ReportBuffer<> rep1;
+        ts::json::ValuePtr jv1;
+        const bool ok1 = ts::json::Parse(jv1, text, rep1);
+
+        ts::ReportBuffer<> rep2;
+        ts::json::ValuePtr jv2;
+        ts::TextParser parser(text, rep2);
+        const bool ok2 = ts::json::Parse(jv2, parser, true, rep2);
+
+        debug() << "JsonTest::testParserConsistency: input " << i << ": " << ok1 << ", \"" << rep1.getMessages() << "\"" << std::endl;
+        TSUNIT_EQUAL(ok2, ok1);
+        TSUNIT_EQUAL(rep2.getMessages(), rep1.getMessages());
+        TSUNIT_EQUAL(jv2.isNull(), jv1.isNull());
+        if (ok1 && ok2) {
+            TSUNIT_EQUAL(jv2->printed(), jv1->printed());
+        }
+
+        ts::ReportBuffer<> rep3;
+        ts::json::Document doc;
+        const bool ok3 = doc.parse(text, rep3);
+        TSUNIT_EQUAL(ok1, ok3);
+        TSUNIT_EQUAL(rep1.getMessages(), rep3.getMessages());
+        TSUNIT_EQUAL(!ok1, doc.empty());
+        if (ok1 && ok3) {
+            TSUNIT_EQUAL(jv1->printed(), doc.root().printed());
+        }
+    }
+}
+
+void JsonTest::testReader()
+{
+    const std::string text("{\"b\": [1, \"x\\u00e9\\ud83d\\ude00\\n\", null], \"a\": {\"t\": true, \"f\": false}}");
+    ts::json::Reader reader(text.data(), text.size(), CERR);
+
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventBeginObject, reader.event());
+    TSUNIT_ASSERT(!reader.hasKey());
+    TSUNIT_EQUAL(1, reader.depth());
+
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventBeginArray, reader.event());
+    TSUNIT_ASSERT(reader.hasKey());
+    TSUNIT_EQUAL("b", reader.key());
+    TSUNIT_EQUAL(2, reader.depth());
+
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventNumber, reader.event());
+    TSUNIT_ASSERT(!reader.hasKey());
+    TSUNIT_EQUAL("1", reader.text());
+
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventString, reader.event());
+    TSUNIT_EQUAL("x\xC3\xA9\xF0\x9F\x98\x80\n", reader.text());
+
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventNull, reader.event());
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventEndArray, reader.event());
+    TSUNIT_EQUAL(1, reader.depth());
+
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventBeginObject, reader.event());
+    TSUNIT_EQUAL("a", reader.key());
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventTrue, reader.event());
+    TSUNIT_EQUAL("t", reader.key());
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventFalse, reader.event());
+    TSUNIT_EQUAL("f", reader.key());
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventEndObject, reader.event());
+    TSUNIT_ASSERT(reader.next());
+    TSUNIT_EQUAL(ts::json::Reader::EventEndObject, reader.event());
+    TSUNIT_EQUAL(0, reader.depth());
+
+    TSUNIT_ASSERT(!reader.next());
+    TSUNIT_ASSERT(!reader.error());
+    TSUNIT_EQUAL(ts::json::Reader::EventNone, reader.event());
+
+    int64_t i = 0;
+    TSUNIT_ASSERT(ts::json::Reader::ToInteger(i, "-9223372036854775808"));
+    TSUNIT_EQUAL(std::numeric_limits<int64_t>::min(), i);
+    TSUNIT_ASSERT(ts::json::Reader::ToInteger(i, "+9223372036854775807"));
+    TSUNIT_EQUAL(std::numeric_limits<int64_t>::max(), i);
+    TSUNIT_ASSERT(!ts::json::Reader::ToInteger(i, "9223372036854775808"));
+    TSUNIT_ASSERT(!ts::json::Reader::ToInteger(i, "1.5"));
+    TSUNIT_ASSERT(!ts::json::Reader::ToInteger(i, "-"));
+}
+
+void JsonTest::testDocument()
+{
+    const ts::UString text(
+        u"{\n"
+        u"  \"zeta\": [1, -2, \"3\", true, false, null, {}, []],\n"
+        u"  \"alpha\": {\"name\": \"caf\\u00e9\", \"on\": \"yes\", \"n\": 12},\n"
+        u"  \"dup\": 1,\n"
+        u"  \"mid\": \"\u4E2D\",\n"
+        u"  \"dup\": 2\n"
+        u"}\n");
+
+    ts::json::Document doc;
+    TSUNIT_ASSERT(doc.parse(text, CERR));
+    TSUNIT_ASSERT(!doc.empty());
+
+    const ts::json::Value& root(doc.root());
+    TSUNIT_ASSERT(root.isObject());
+    TSUNIT_EQUAL(ts::json::TypeObject, root.type());
+    TSUNIT_EQUAL(4, root.size());
+
+    // Insertion order, a duplicated field keeps its first position and its last value.
+    ts::UStringList names;
+    root.getNames(names);
+    TSUNIT_EQUAL(u"zeta, alpha, dup, mid", ts::UString::Join(names));
+    TSUNIT_EQUAL(2, root.value(u"dup").toInteger());
+
+    const ts::json::Value& zeta(root.value(u"zeta"));
+    TSUNIT_ASSERT(zeta.isArray());
+    TSUNIT_EQUAL(8, zeta.size());
+    TSUNIT_EQUAL(1, zeta.at(0).toInteger());
+    TSUNIT_EQUAL(-2, zeta.at(1).toInteger());
+    TSUNIT_ASSERT(zeta.at(2).isString());
+    TSUNIT_EQUAL(3, zeta.at(2).toInteger());
+    TSUNIT_ASSERT(zeta.at(3).isTrue());
+    TSUNIT_ASSERT(zeta.at(3).toBoolean());
+    TSUNIT_ASSERT(zeta.at(4).isFalse());
+    TSUNIT_EQUAL(u"false", zeta.at(4).toString());
+    TSUNIT_ASSERT(zeta.at(5).isNull());
+    TSUNIT_ASSERT(zeta.at(6).isObject());
+    TSUNIT_EQUAL(0, zeta.at(6).size());
+    TSUNIT_ASSERT(zeta.at(7).isArray());
+    TSUNIT_ASSERT(zeta.at(8).isNull());
+    TSUNIT_ASSERT(zeta.value(u"x").isNull());
+
+    TSUNIT_EQUAL(u"caf\u00e9", root.value(u"alpha").value(u"name").toString());
+    TSUNIT_EQUAL(4, root.value(u"alpha").value(u"name").size());
+    TSUNIT_ASSERT(root.value(u"alpha").value(u"on").toBoolean());
+    TSUNIT_EQUAL(u"\u4E2D", root.value(u"mid").toString());
+    TSUNIT_ASSERT(root.value(u"nonexistent").isNull());
+
+    TSUNIT_EQUAL(12, root.query(u"alpha.n").toInteger());
+    TSUNIT_EQUAL(u"3", root.query(u"zeta[2]").toString());
+    TSUNIT_ASSERT(root.query(u"zeta[6]").isObject());
+    TSUNIT_ASSERT(root.query(u"zeta[]").isNull());
+    TSUNIT_ASSERT(root.query(u"zeta.foo").isNull());
+    TSUNIT_ASSERT(root.query(u"[1]").isNull());
+
+    // The document is read-only.
+    ts::json::Value& mroot(const_cast<ts::json::Value&>(root));
+    mroot.add(u"new", 12);
+    TSUNIT_ASSERT(mroot.value(u"new", true).isNull());
+    TSUNIT_ASSERT(mroot.query(u"a.b.c", true).isNull());
+    TSUNIT_EQUAL(4, root.size());
+
+    // Printed in sorted name order, same as a document from json::Parse().
+    ts::json::ValuePtr jv;
+    TSUNIT_ASSERT(ts::json::Parse(jv, text, CERR));
+    const ts::UString printed(jv->printed());
+    debug() << "JsonTest::testDocument: " << printed << std::endl;
+    TSUNIT_EQUAL(printed, root.printed());
+    TSUNIT_EQUAL(jv->printed(0), root.printed(0));
+
+    // Modifiable copy.
+    ts::json::ValuePtr copy(doc.toValue());
+    TSUNIT_ASSERT(!copy.isNull());
+    TSUNIT_EQUAL(printed, copy->printed());
+    copy->add(u"new", 12);
+    TSUNIT_EQUAL(12, copy->value(u"new").toInteger());
+
+    // Large object with duplicated fields.
+    ts::UString big(u"{");
+    for (int i = 0; i < 100; ++i) {
+        big.append(ts::UString::Format(u"\"f%d\": %d, ", {i % 40, i}));
+    }
+    big.append(u"\"last\": 0}");
+    TSUNIT_ASSERT(doc.parse(big, CERR));
+    TSUNIT_ASSERT(ts::json::Parse(jv, big, CERR));
+    TSUNIT_EQUAL(41, doc.root().size());
+    TSUNIT_EQUAL(99, doc.root().value(u"f19").toInteger());
+    doc.root().getNames(names);
+    TSUNIT_EQUAL(u"f0", names.front());
+    TSUNIT_EQUAL(u"last", names.back());
+    TSUNIT_EQUAL(jv->printed(), doc.root().printed());
+
+    // Errors clear the document.
+    TSUNIT_ASSERT(!doc.parse(u"[1, 2", NULLREP));
+    TSUNIT_ASSERT(doc.empty());
+    TSUNIT_ASSERT(doc.root().isNull());
+    TSUNIT_ASSERT(doc.toValue().isNull());
+}
+
+// Not a real test, a benchmark on a large JSON file, typically an EIT export.
+// Run only when the environment variable TS_UTEST_JSON_BENCHMARK contains a file name.
+void JsonTest::testDocumentBenchmark()
+{
+    const ts::UString fileName(ts::GetEnvironment(u"TS_UTEST_JSON_BENCHMARK"));
+    if (fileName.empty()) {
+        return;
+    }
+
+    // Load with json::Document. Memory is measured while the document is alive.
+    ts::ProcessMetrics pm0, pm1;
+    ts::UString docPrinted;
+    ts::GetProcessMetrics(pm0);
+    ts::MilliSecond docTime = 0;
+    {
+        const ts::Time start(ts::Time::CurrentUTC());
+        ts::json::Document doc;
+        TSUNIT_ASSERT(doc.load(fileName, CERR));
+        docTime = ts::Time::CurrentUTC() - start;
+        ts::GetProcessMetrics(pm1);
+        docPrinted = doc.root().printed();
+    }
+
+    // Load with json::Parse(). The text lines are measured separately.
+    ts::ProcessMetrics pm2, pm3, pm4;
+    ts::GetProcessMetrics(pm2);
+    ts::MilliSecond valueTime = 0;
+    {
+        const ts::Time start(ts::Time::CurrentUTC());
+        ts::UStringList lines;
+        ts::json::ValuePtr jv;
+        TSUNIT_ASSERT(ts::UString::Load(lines, fileName));
+        ts::GetProcessMetrics(pm3);
+        TSUNIT_ASSERT(ts::json::Parse(jv, lines, CERR));
+        valueTime = ts::Time::CurrentUTC() - start;
+        ts::GetProcessMetrics(pm4);
+        TSUNIT_ASSERT(jv->printed() == docPrinted);
+    }
+
+    std::cerr << "JsonTest::testDocumentBenchmark: " << fileName << std::endl
+              << "  json::Document: " << docTime << " ms, "
+              << ((pm1.vmem_size - pm0.vmem_size) >> 20) << " MB" << std::endl
+              << "  json::Parse:    " << valueTime << " ms, "
+              << ((pm4.vmem_size - pm3.vmem_size) >> 20) << " MB, plus "
+              << ((pm3.vmem_size - pm2.vmem_size) >> 20) << " MB of text lines" << std::endl;
+}
@@ -49,10 +49,12 @@ public:
 
     void testSection();
     void testBuild();
+    void testReuse();
 
     TSUNIT_TEST_BEGIN(MPEPacketTest);
     TSUNIT_TEST(testSection);
     TSUNIT_TEST(testBuild);
+    TSUNIT_TEST(testReuse);
     TSUNIT_TEST_END();
 };
 
@@ -142,3 +144,39 @@ void MPEPacketTest::testBuild()
     TSUNIT_ASSERT(mpe2.udpMessage() != nullptr);
     TSUNIT_EQUAL(0, ::memcmp(mpe2.udpMessage(), ref, mpe2.udpMessageSize()));
 }
+
+void MPEPacketTest::testReuse()
+{
+    ts::Section sec1(psi_mpe_sections, sizeof(psi_mpe_sections), 1234, ts::CRC32::CHECK);
+    TSUNIT_ASSERT(sec1.isValid());
+
+    static const uint8_t ref[] = {0x10, 0x11, 0x12, 0x13};
+    ts::MPEPacket build;
+    build.setSourceIPAddress(ts::IPAddress(54, 59, 197, 201));
+    build.setDestinationIPAddress(ts::IPAddress(123, 34, 45, 78));
+    build.setSourceUDPPort(7920);
+    build.setDestinationUDPPort(4654);
+    build.setUDPMessage(ref, sizeof(ref));
+    ts::Section sec2;
+    build.createSection(sec2);
+    TSUNIT_ASSERT(sec2.isValid());
+
+    // The datagram buffer is reused when not shared.
+    ts::MPEPacket mpe(sec1);
+    TSUNIT_ASSERT(mpe.isValid());
+    const uint8_t* const buffer = mpe.datagram();
+    mpe.copy(sec2);
+    TSUNIT_ASSERT(mpe.isValid());
+    TSUNIT_ASSERT(mpe.datagram() == buffer);
+    TSUNIT_EQUAL(sizeof(ref), mpe.udpMessageSize());
+    TSUNIT_EQUAL(0, ::memcmp(mpe.udpMessage(), ref, sizeof(ref)));
+
+    // A shared datagram buffer is never overwritten.
+    ts::MPEPacket kept(mpe, ts::ShareMode::SHARE);
+    mpe.copy(sec1);
+    TSUNIT_ASSERT(mpe.isValid());
+    TSUNIT_ASSERT(mpe.datagram() != kept.datagram());
+    TSUNIT_EQUAL(1468, mpe.udpMessageSize());
+    TSUNIT_EQUAL(sizeof(ref), kept.udpMessageSize());
+    TSUNIT_EQUAL(0, ::memcmp(kept.udpMessage(), ref, sizeof(ref)));
+}
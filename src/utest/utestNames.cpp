@@ -87,6 +87,7 @@ public:
     void testAudioType();
     void testT2MIPacketType();
     void testPlatformId();
+    void testSectionHandle();
 
     TSUNIT_TEST_BEGIN(NamesTest);
     TSUNIT_TEST(testConfigFile);
@@ -125,6 +126,7 @@ public:
     TSUNIT_TEST(testAudioType);
     TSUNIT_TEST(testT2MIPacketType);
     TSUNIT_TEST(testPlatformId);
+    TSUNIT_TEST(testSectionHandle);
     TSUNIT_TEST_END();
 };
 
@@ -412,3 +414,28 @@ void NamesTest::testPlatformId()
     TSUNIT_EQUAL(u"0x000004 (TV digitale mobile, Telecom Italia)", ts::names::PlatformId(4, ts::names::FIRST));
     TSUNIT_EQUAL(u"VTC Mobile TV (0x704001)", ts::names::PlatformId(0x704001, ts::names::VALUE));
 }
+
+void NamesTest::testSectionHandle()
+{
+    const ts::Names* const repo = ts::NamesMain::Instance();
+
+    const ts::Names::SectionHandle st = repo->section(u"StreamType");
+    TSUNIT_ASSERT(st != ts::Names::NO_SECTION);
+    TSUNIT_EQUAL(st, repo->section(u" streamtype "));
+    TSUNIT_EQUAL(ts::Names::NO_SECTION, repo->section(u"NonExistentSection"));
+
+    TSUNIT_ASSERT(repo->nameExists(st, 0x02));
+    TSUNIT_ASSERT(!repo->nameExists(ts::Names::NO_SECTION, 0x02));
+    TSUNIT_EQUAL(repo->nameFromSection(u"StreamType", 0x1B, ts::names::VALUE), repo->nameFromSection(st, 0x1B, ts::names::VALUE));
+    TSUNIT_EQUAL(ts::names::StreamType(0x1B), repo->nameFromSection(st, 0x1B));
+    TSUNIT_EQUAL(u"unknown (0x12)", repo->nameFromSection(ts::Names::NO_SECTION, 0x12, ts::names::NAME, 8));
+
+    // Values inside a range of values.
+    const ts::Names::SectionHandle pds = repo->section(u"PrivateDataSpecifier");
+    TSUNIT_ASSERT(pds != ts::Names::NO_SECTION);
+    TSUNIT_EQUAL(u"SES", repo->nameFromSection(pds, 0x00000001));
+    TSUNIT_EQUAL(u"BskyB", repo->nameFromSection(pds, 0x00000002));
+    TSUNIT_EQUAL(u"BskyB", repo->nameFromSection(pds, 0x00000003));
+    TSUNIT_EQUAL(u"BskyB", repo->nameFromSection(pds, 0x00000004));
+    TSUNIT_EQUAL(u"ARD, ZDF, ORF", repo->nameFromSection(pds, 0x00000005));
+}
@@ -39,6 +39,7 @@
 #include "tsTCPConnection.h"
 #include "tsTCPServer.h"
 #include "tsUDPSocket.h"
+#include "tsByteBlock.h"
 #include "tsThread.h"
 #include "tsSysUtils.h"
 #include "tsIPUtils.h"
@@ -69,6 +70,7 @@ public:
     void testSocketAddress();
     void testTCPSocket();
     void testUDPSocket();
+    void testUDPBatch();
     void testIPHeader();
 
     TSUNIT_TEST_BEGIN(NetworkingTest);
@@ -81,6 +83,7 @@ public:
     TSUNIT_TEST(testSocketAddress);
     TSUNIT_TEST(testTCPSocket);
     TSUNIT_TEST(testUDPSocket);
+    TSUNIT_TEST(testUDPBatch);
     TSUNIT_TEST(testIPHeader);
     TSUNIT_TEST_END();
 
@@ -680,6 +683,51 @@ void NetworkingTest::testUDPSocket()
     CERR.debug(u"UDPSocketTest: main thread: reply sent");
 }
 
+// Test sending messages in batches, more messages than one system call can send.
+void NetworkingTest::testUDPBatch()
+{
+    TSUNIT_ASSERT(ts::IPInitialize());
+
+    const uint16_t portNumber = 12346;
+    const size_t msgCount = 150;
+
+    // Receiver socket. Never wait forever in case of lost message.
+    ts::UDPSocket receiver;
+    TSUNIT_ASSERT(receiver.open(CERR));
+    TSUNIT_ASSERT(receiver.setReceiveBufferSize(1024 * 1024, CERR));
+    TSUNIT_ASSERT(receiver.setReceiveTimeout(5000, CERR));
+    TSUNIT_ASSERT(receiver.reusePort(true, CERR));
+    TSUNIT_ASSERT(receiver.bind(ts::SocketAddress(ts::IPAddress::LocalHost, portNumber), CERR));
+
+    // Sender socket.
+    ts::UDPSocket sender(true);
+    TSUNIT_ASSERT(sender.isOpen());
+    TSUNIT_ASSERT(sender.bind(ts::SocketAddress(ts::IPAddress::LocalHost, ts::SocketAddress::AnyPort), CERR));
+
+    // Message i has size i+1, all its bytes are i.
+    std::vector<ts::ByteBlock> data(msgCount);
+    std::vector<ts::UDPSocket::OutgoingMessage> messages(msgCount);
+    const ts::SocketAddress destination(ts::IPAddress::LocalHost, portNumber);
+    for (size_t i = 0; i < msgCount; ++i) {
+        data[i].resize(i + 1, uint8_t(i));
+        messages[i] = ts::UDPSocket::OutgoingMessage(data[i].data(), data[i].size(), destination);
+    }
+    TSUNIT_ASSERT(sender.sendBatch(messages.data(), messages.size(), CERR));
+
+    // All messages are received in order with the right sizes.
+    uint8_t buffer[1024];
+    for (size_t i = 0; i < msgCount; ++i) {
+        ts::SocketAddress from;
+        ts::SocketAddress to;
+        size_t size = 0;
+        TSUNIT_ASSERT(receiver.receive(buffer, sizeof(buffer), size, from, to, nullptr, CERR));
+        TSUNIT_EQUAL(i + 1, size);
+        TSUNIT_EQUAL(uint8_t(i), buffer[0]);
+        TSUNIT_EQUAL(uint8_t(i), buffer[size - 1]);
+        TSUNIT_ASSERT(ts::IPAddress(from) == ts::IPAddress::LocalHost);
+    }
+}
+
 // Test IP header
 void NetworkingTest::testIPHeader()
 {
@@ -0,0 +1,145 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::OutputPacer
+//
+//----------------------------------------------------------------------------
+
+#include "tsOutputPacer.h"
+#include "tsCerrReport.h"
+#include <numeric>
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class OutputPacerTest: public tsunit::Test, private ts::OutputPacerHandlerInterface
+{
+public:
+    OutputPacerTest();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testTimeline();
+
+    TSUNIT_TEST_BEGIN(OutputPacerTest);
+    TSUNIT_TEST(testTimeline);
+    TSUNIT_TEST_END();
+
+private:
+    std::vector<size_t> _counts;
+    std::vector<ts::Monotonic> _dues;
+
+    virtual bool handlePacedPackets(ts::OutputPacer& pacer, const ts::TSPacket* packets, size_t count, const ts::Monotonic& due) override;
+};
+
+TSUNIT_REGISTER(OutputPacerTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+OutputPacerTest::OutputPacerTest() :
+    _counts(),
+    _dues()
+{
+}
+
+// Test suite initialization method.
+void OutputPacerTest::beforeTest()
+{
+    _counts.clear();
+    _dues.clear();
+}
+
+// Test suite cleanup method.
+void OutputPacerTest::afterTest()
+{
+}
+
+// Invoked in the context of the pacer thread.
+bool OutputPacerTest::handlePacedPackets(ts::OutputPacer& pacer, const ts::TSPacket* packets, size_t count, const ts::Monotonic& due)
+{
+    _counts.push_back(count);
+    _dues.push_back(due);
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void OutputPacerTest::testTimeline()
+{
+    // 10 Mb/s, 70 packets, PCR at packets 0 and 35.
+    const ts::BitRate bitrate = 10000000;
+    const ts::NanoSecond packet_ns = (ts::PKT_SIZE_BITS * ts::NanoSecPerSec) / bitrate;
+
+    ts::TSPacketVector packets(70);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        packets[i].init(100, uint8_t(i & 0x0F));
+    }
+    TSUNIT_ASSERT(packets[0].setPCR(1000000, true));
+    TSUNIT_ASSERT(packets[35].setPCR(1000000 + 10 * ts::SYSTEM_CLOCK_FREQ / ts::MilliSecPerSec, true));
+
+    ts::OutputPacer pacer(this, CERR, ts::Severity::Debug);
+    pacer.setLatency(10);
+    TSUNIT_ASSERT(pacer.start(7, 1000));
+    TSUNIT_ASSERT(pacer.push(packets.data(), packets.size(), bitrate));
+    pacer.stop(true);
+
+    // 10 chunks of 7 packets.
+    TSUNIT_EQUAL(10, _counts.size());
+    TSUNIT_EQUAL(10, _dues.size());
+    for (size_t i = 0; i < _counts.size(); ++i) {
+        TSUNIT_EQUAL(7, _counts[i]);
+    }
+
+    // Interpolated from the bitrate before the second PCR, synchronized on the PCR after.
+    TSUNIT_EQUAL(7 * packet_ns, _dues[1] - _dues[0]);
+    TSUNIT_EQUAL(10 * ts::NanoSecPerMilliSec, _dues[5] - _dues[0]);
+    TSUNIT_EQUAL(7 * packet_ns, _dues[6] - _dues[5]);
+
+    // All chunks are accounted in the histograms.
+    ts::OutputPacer::Histogram histo;
+    pacer.getLatenessHistogram(histo);
+    TSUNIT_EQUAL(10, std::accumulate(histo.begin(), histo.end(), ts::PacketCounter(0)));
+    pacer.getJitterHistogram(histo);
+    TSUNIT_EQUAL(9, std::accumulate(histo.begin(), histo.end(), ts::PacketCounter(0)));
+
+    if (tsunit::Test::debugMode()) {
+        pacer.reportStatistics();
+    }
+}
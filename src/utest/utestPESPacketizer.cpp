@@ -52,13 +52,19 @@ public:
     virtual void afterTest() override;
 
     void testPacketizer();
+    void testKeptPackets();
+    void testDepth();
 
     TSUNIT_TEST_BEGIN(PESPacketizerTest);
     TSUNIT_TEST(testPacketizer);
+    TSUNIT_TEST(testKeptPackets);
+    TSUNIT_TEST(testDepth);
     TSUNIT_TEST_END();
 
 private:
     size_t _pes_count;
+    bool _keep;
+    ts::PESPacketPtrVector _kept;
     virtual void handlePESPacket(ts::PESDemux& demux, const ts::PESPacket& packet) override;
 };
 
@@ -71,7 +77,9 @@ TSUNIT_REGISTER(PESPacketizerTest);
 
 // Constructor.
 PESPacketizerTest::PESPacketizerTest() :
-    _pes_count(0)
+    _pes_count(0),
+    _keep(false),
+    _kept()
 {
 }
 
@@ -79,6 +87,8 @@ PESPacketizerTest::PESPacketizerTest() :
 void PESPacketizerTest::beforeTest()
 {
     _pes_count = 0;
+    _keep = false;
+    _kept.clear();
 }
 
 // Test suite cleanup method.
@@ -149,10 +159,134 @@ void PESPacketizerTest::testPacketizer()
     TSUNIT_EQUAL(2, _pes_count);
 }
 
+void PESPacketizerTest::testKeptPackets()
+{
+    // Build PES packets of various sizes with distinct contents.
+    ts::DuckContext duck;
+    ts::PESOneShotPacketizer zer(duck, 200, &CERR);
+    static const size_t sizes[] = {1500, 300, 5000, 184, 2000, 700};
+    for (size_t n = 0; n < sizeof(sizes) / sizeof(sizes[0]); ++n) {
+        ts::ByteBlock data(sizes[n]);
+        data[0] = 0x00;
+        data[1] = 0x00;
+        data[2] = 0x01;
+        data[3] = 0xBE;
+        ts::PutUInt16(data.data() + 4, uint16_t(sizes[n] - 6));
+        for (size_t i = 6; i < sizes[n]; i++) {
+            data[i] = uint8_t(i + n);
+        }
+        zer.addPES(ts::PESPacket(data), ts::ShareMode::COPY);
+    }
+    ts::TSPacketVector packets;
+    zer.getPackets(packets);
+
+    // Demux them and keep all PES packets: the reassembly buffers of the demux must not be reused.
+    _keep = true;
+    ts::PESDemux demux(duck, this);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        demux.feedPacket(packets[i]);
+    }
+    TSUNIT_EQUAL(sizeof(sizes) / sizeof(sizes[0]), _kept.size());
+    for (size_t n = 0; n < _kept.size(); ++n) {
+        const ts::PESPacket& pes(*_kept[n]);
+        TSUNIT_ASSERT(pes.isValid());
+        TSUNIT_EQUAL(sizes[n], pes.size());
+        TSUNIT_EQUAL(200, pes.getSourcePID());
+        bool ok = true;
+        for (size_t i = 6; ok && i < pes.size(); i++) {
+            ok = pes.content()[i] == uint8_t(i + n);
+        }
+        TSUNIT_ASSERT(ok);
+    }
+
+    // Release some packets, their buffers are reused by the demux.
+    _kept.clear();
+    for (size_t i = 0; i < packets.size(); ++i) {
+        demux.feedPacket(packets[i]);
+    }
+    TSUNIT_EQUAL(sizeof(sizes) / sizeof(sizes[0]), _kept.size());
+    TSUNIT_EQUAL(sizes[0], _kept[0]->size());
+    TSUNIT_EQUAL(uint8_t(100), _kept[0]->content()[100]);
+}
+
+void PESPacketizerTest::testDepth()
+{
+    // One bounded and one unbounded PES packet.
+    ts::DuckContext duck;
+    ts::PESOneShotPacketizer zer(duck, 300, &CERR);
+    ts::ByteBlock data(3000);
+    data[0] = 0x00;
+    data[1] = 0x00;
+    data[2] = 0x01;
+    data[3] = 0xBE;
+    ts::PutUInt16(data.data() + 4, uint16_t(data.size() - 6));
+    for (size_t i = 6; i < data.size(); i++) {
+        data[i] = uint8_t(i);
+    }
+    zer.addPES(ts::PESPacket(data), ts::ShareMode::COPY);
+    ts::PutUInt16(data.data() + 4, 0);
+    zer.addPES(ts::PESPacket(data), ts::ShareMode::COPY);
+    ts::TSPacketVector packets;
+    zer.getPackets(packets);
+    // Add a PUSI packet to terminate the unbounded PES packet.
+    packets.push_back(packets[0]);
+
+    _keep = true;
+    ts::PESDemux demux(duck, this);
+    TSUNIT_EQUAL(ts::PESDemux::FULL_DEPTH, demux.getDepth(300));
+    demux.setDepth(300, 100);
+    TSUNIT_EQUAL(100, demux.getDepth(300));
+    TSUNIT_EQUAL(ts::PESDemux::FULL_DEPTH, demux.getDepth(301));
+    for (size_t i = 0; i < packets.size(); ++i) {
+        demux.feedPacket(packets[i]);
+    }
+
+    TSUNIT_EQUAL(2, _kept.size());
+    for (size_t n = 0; n < _kept.size(); ++n) {
+        const ts::PESPacket& pes(*_kept[n]);
+        TSUNIT_ASSERT(pes.isValid());
+        TSUNIT_ASSERT(pes.isTruncated());
+        TSUNIT_EQUAL(106, pes.size());
+        TSUNIT_EQUAL(100, pes.payloadSize());
+        TSUNIT_EQUAL(0, pes.spuriousDataSize());
+        TSUNIT_EQUAL(3000, pes.fullSize());
+        TSUNIT_EQUAL(uint8_t(105), pes.content()[105]);
+    }
+
+    // Header only, then full PES packets.
+    _kept.clear();
+    demux.setDepth(0);
+    demux.setDepth(300, 0);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        demux.feedPacket(packets[i]);
+    }
+    TSUNIT_EQUAL(2, _kept.size());
+    TSUNIT_EQUAL(6, _kept[0]->size());
+    TSUNIT_EQUAL(0, _kept[0]->payloadSize());
+    TSUNIT_EQUAL(3000, _kept[0]->fullSize());
+
+    _kept.clear();
+    demux.setDepth(300, ts::PESDemux::FULL_DEPTH);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        demux.feedPacket(packets[i]);
+    }
+    TSUNIT_EQUAL(2, _kept.size());
+    TSUNIT_ASSERT(!_kept[0]->isTruncated());
+    TSUNIT_EQUAL(3000, _kept[0]->size());
+    TSUNIT_EQUAL(3000, _kept[0]->fullSize());
+}
+
 void PESPacketizerTest::handlePESPacket(ts::PESDemux& demux, const ts::PESPacket& pes)
 {
     _pes_count++;
     TSUNIT_ASSERT(pes.isValid());
+    if (_keep) {
+        // Keep a shared reference on the demux buffer, without copy.
+        ts::PESPacketPtr kept(new ts::PESPacket);
+        *kept = pes;
+        _kept.push_back(kept);
+        return;
+    }
     TSUNIT_EQUAL(100, pes.getSourcePID());
     TSUNIT_EQUAL(6, pes.headerSize());
     switch (_pes_count) {
@@ -0,0 +1,302 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::PIDMetrics
+//
+//----------------------------------------------------------------------------
+
+#include "tsPIDMetrics.h"
+#include "tsjsonObject.h"
+#include "tsunit.h"
+#include "utestTSUnitThread.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class PIDMetricsTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testCounters();
+    void testBitrate();
+    void testLabels();
+    void testExport();
+    void testWaitSnapshot();
+
+    TSUNIT_TEST_BEGIN(PIDMetricsTest);
+    TSUNIT_TEST(testCounters);
+    TSUNIT_TEST(testBitrate);
+    TSUNIT_TEST(testLabels);
+    TSUNIT_TEST(testExport);
+    TSUNIT_TEST(testWaitSnapshot);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(PIDMetricsTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+void PIDMetricsTest::beforeTest()
+{
+}
+
+void PIDMetricsTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void PIDMetricsTest::testCounters()
+{
+    ts::PIDSet pids;
+    pids.set(100);
+    pids.set(200);
+    ts::PIDMetrics metrics(pids);
+    ts::TSPacket pkt(ts::NullPacket);
+
+    // Stream: 100 200 100 8191 100 8191 8191 8191 100 200
+    // PID 100: packets 0, 2, 4, 8, distances 2, 2, 4
+    // PID 200: packets 1, 9, distance 8
+    const ts::PID stream[] = {100, 200, 100, 8191, 100, 8191, 8191, 8191, 100, 200};
+    for (size_t i = 0; i < sizeof(stream) / sizeof(stream[0]); ++i) {
+        pkt.setPID(stream[i]);
+        metrics.feedPacket(pkt);
+    }
+
+    ts::PIDMetrics::Snapshot snap;
+    metrics.getSnapshot(snap);
+    TSUNIT_ASSERT(!snap.labels);
+    TSUNIT_EQUAL(10, snap.total_packets);
+    TSUNIT_EQUAL(2, snap.categories.size());
+
+    const ts::PIDMetrics::Counters& c100(snap.categories[100]);
+    TSUNIT_EQUAL(100, c100.index);
+    TSUNIT_EQUAL(4, c100.packets);
+    TSUNIT_EQUAL(0, c100.first_packet);
+    TSUNIT_EQUAL(8, c100.last_packet);
+    TSUNIT_EQUAL(3, c100.ipd.count());
+    TSUNIT_EQUAL(2, c100.ipd.minimum());
+    TSUNIT_EQUAL(4, c100.ipd.maximum());
+    TSUNIT_EQUAL(0, c100.ipd_histogram[0]);
+    TSUNIT_EQUAL(2, c100.ipd_histogram[1]);
+    TSUNIT_EQUAL(1, c100.ipd_histogram[2]);
+
+    const ts::PIDMetrics::Counters& c200(snap.categories[200]);
+    TSUNIT_EQUAL(2, c200.packets);
+    TSUNIT_EQUAL(1, c200.first_packet);
+    TSUNIT_EQUAL(9, c200.last_packet);
+    TSUNIT_EQUAL(8, c200.ipd.minimum());
+    TSUNIT_EQUAL(1, c200.ipd_histogram[3]);
+
+    // Snapshot with reset.
+    metrics.getSnapshot(snap, true);
+    TSUNIT_EQUAL(2, snap.categories.size());
+    metrics.getSnapshot(snap);
+    TSUNIT_EQUAL(0, snap.total_packets);
+    TSUNIT_ASSERT(snap.categories.empty());
+
+    // Very large distances go into the last bin.
+    pkt.setPID(100);
+    metrics.feedPacket(pkt);
+    pkt.setPID(8191);
+    for (size_t i = 0; i < 100000; ++i) {
+        metrics.feedPacket(pkt);
+    }
+    pkt.setPID(100);
+    metrics.feedPacket(pkt);
+    metrics.getSnapshot(snap);
+    TSUNIT_EQUAL(1, snap.categories[100].ipd_histogram[ts::PIDMetrics::IPD_BINS - 1]);
+}
+
+void PIDMetricsTest::testBitrate()
+{
+    ts::PIDMetrics metrics;
+    ts::TSPacket pkt(ts::NullPacket);
+
+    metrics.setBitrateWindow(100);
+    metrics.setBitrate(1000000);
+
+    // One packet out of 4 in PID 100, other ones in PID 200.
+    for (size_t i = 0; i < 250; ++i) {
+        pkt.setPID(i % 4 == 0 ? 100 : 200);
+        metrics.feedPacket(pkt);
+    }
+
+    // Bitrates are computed over the last complete window.
+    ts::PIDMetrics::Snapshot snap;
+    metrics.getSnapshot(snap);
+    TSUNIT_EQUAL(1000000, snap.ts_bitrate);
+    TSUNIT_EQUAL(250000, snap.categories[100].bitrate);
+    TSUNIT_EQUAL(750000, snap.categories[200].bitrate);
+    TSUNIT_EQUAL(13, snap.categories[100].window_packets);
+}
+
+void PIDMetricsTest::testLabels()
+{
+    ts::PIDMetrics metrics;
+    ts::TSPacket pkt(ts::NullPacket);
+    ts::TSPacketMetadata mdata;
+
+    ts::TSPacketMetadata::LabelSet labels;
+    labels.set(2);
+    labels.set(5);
+    metrics.setLabelFilter(labels);
+
+    // Label 2 on all packets, label 5 on one packet out of two, label 7 not analyzed.
+    for (size_t i = 0; i < 10; ++i) {
+        mdata.reset();
+        mdata.setLabel(2);
+        mdata.setLabel(7);
+        if (i % 2 == 1) {
+            mdata.setLabel(5);
+        }
+        metrics.feedPacket(pkt, mdata);
+    }
+
+    ts::PIDMetrics::Snapshot snap;
+    metrics.getSnapshot(snap);
+    TSUNIT_ASSERT(snap.labels);
+    TSUNIT_EQUAL(10, snap.total_packets);
+    TSUNIT_EQUAL(2, snap.categories.size());
+    TSUNIT_EQUAL(10, snap.categories[2].packets);
+    TSUNIT_EQUAL(1, snap.categories[2].ipd.maximum());
+    TSUNIT_EQUAL(5, snap.categories[5].packets);
+    TSUNIT_EQUAL(1, snap.categories[5].first_packet);
+    TSUNIT_EQUAL(2, snap.categories[5].ipd.minimum());
+}
+
+void PIDMetricsTest::testExport()
+{
+    ts::PIDMetrics metrics;
+    ts::TSPacket pkt(ts::NullPacket);
+
+    for (size_t i = 0; i < 6; ++i) {
+        pkt.setPID(i % 2 == 0 ? 0x0100 : 0x0200);
+        metrics.feedPacket(pkt);
+    }
+
+    ts::PIDMetrics::Snapshot snap;
+    metrics.getSnapshot(snap);
+
+    ts::json::Object root;
+    snap.toJSON(root);
+    TSUNIT_EQUAL(6, root.value(u"packets").toInteger());
+    const ts::json::Value& pids(root.value(u"pids"));
+    TSUNIT_ASSERT(pids.isArray());
+    TSUNIT_EQUAL(2, pids.size());
+    TSUNIT_EQUAL(0x0100, pids.at(0).value(u"id").toInteger());
+    TSUNIT_EQUAL(3, pids.at(0).value(u"packets").toInteger());
+    TSUNIT_EQUAL(2, pids.at(0).value(u"ipd").value(u"min").toInteger());
+    TSUNIT_EQUAL(2, pids.at(0).value(u"ipd").value(u"histogram").at(1).toInteger());
+
+    std::ostringstream prom;
+    snap.toPrometheus(prom, u"test");
+    const ts::UString text(ts::UString::FromUTF8(prom.str()));
+    debug() << "PIDMetricsTest::testExport: " << std::endl << prom.str();
+    TSUNIT_ASSERT(text.contain(u"\ntest_packets_total 6\n"));
+    TSUNIT_ASSERT(text.contain(u"\ntest_pid_packets_total{pid=\"256\"} 3\n"));
+    TSUNIT_ASSERT(text.contain(u"\ntest_pid_ipd_bucket{pid=\"512\",le=\"1\"} 0\n"));
+    TSUNIT_ASSERT(text.contain(u"\ntest_pid_ipd_bucket{pid=\"512\",le=\"3\"} 2\n"));
+    TSUNIT_ASSERT(text.contain(u"\ntest_pid_ipd_bucket{pid=\"512\",le=\"+Inf\"} 2\n"));
+    TSUNIT_ASSERT(text.contain(u"\ntest_pid_ipd_sum{pid=\"512\"} 4\n"));
+    TSUNIT_ASSERT(text.contain(u"\ntest_pid_ipd_count{pid=\"512\"} 2\n"));
+}
+
+// Thread for testWaitSnapshot()
+namespace {
+    class PIDMetricsTestThread: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(PIDMetricsTestThread);
+    private:
+        ts::PIDMetrics& _metrics;
+    public:
+        std::atomic<bool> done;
+
+        explicit PIDMetricsTestThread(ts::PIDMetrics& metrics) :
+            utest::TSUnitThread(),
+            _metrics(metrics),
+            done(false)
+        {
+        }
+
+        virtual ~PIDMetricsTestThread() override
+        {
+            waitForTermination();
+        }
+
+        // Reader thread: get two snapshots with reset.
+        virtual void test() override
+        {
+            ts::PIDMetrics::Snapshot snap;
+            TSUNIT_ASSERT(_metrics.waitSnapshot(snap, 10000, true));
+            TSUNIT_ASSERT(snap.total_packets > 0);
+            TSUNIT_ASSERT(_metrics.waitSnapshot(snap, 10000, true));
+            TSUNIT_ASSERT(snap.total_packets > 0);
+            done = true;
+        }
+    };
+}
+
+void PIDMetricsTest::testWaitSnapshot()
+{
+    ts::PIDMetrics metrics;
+    ts::TSPacket pkt(ts::NullPacket);
+    ts::PIDMetrics::Snapshot snap;
+
+    // No packet is processed, timeout.
+    TSUNIT_ASSERT(!metrics.waitSnapshot(snap, 50));
+
+    // The writer feeds packets until the reader thread has collected two snapshots.
+    PIDMetricsTestThread thread(metrics);
+    TSUNIT_ASSERT(thread.start());
+    ts::PacketCounter count = 0;
+    const ts::Time start(ts::Time::CurrentUTC());
+    while (!thread.done && ts::Time::CurrentUTC() - start < 10000) {
+        metrics.feedPacket(pkt);
+        count++;
+    }
+    TSUNIT_ASSERT(thread.done);
+    thread.waitForTermination();
+
+    // The metrics were reset by the reader thread.
+    metrics.getSnapshot(snap);
+    debug() << "PIDMetricsTest::testWaitSnapshot: fed " << count << " packets, " << snap.total_packets << " since last reset" << std::endl;
+    TSUNIT_ASSERT(snap.total_packets < count);
+}
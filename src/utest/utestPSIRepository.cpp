@@ -35,6 +35,8 @@
 #include "tsAbstractTable.h"
 #include "tsMGT.h"
 #include "tsLDT.h"
+#include "tsCADescriptor.h"
+#include "tsDuckContext.h"
 #include "tsunit.h"
 TSDUCK_SOURCE;
 
@@ -51,10 +53,14 @@ public:
 
     void testRegistrations();
     void testSharedTID();
+    void testSimilarNames();
+    void testLateRegistration();
 
     TSUNIT_TEST_BEGIN(PSIRepositoryTest);
     TSUNIT_TEST(testRegistrations);
     TSUNIT_TEST(testSharedTID);
+    TSUNIT_TEST(testSimilarNames);
+    TSUNIT_TEST(testLateRegistration);
     TSUNIT_TEST_END();
 };
 
@@ -70,9 +76,18 @@ void PSIRepositoryTest::beforeTest()
 {
 }
 
+// Extended descriptor ids which are temporarily registered by the tests.
+namespace {
+    const ts::EDID LATE_EDID(ts::EDID::Private(0xFE, 0x75746573));
+    const ts::EDID COPY_EDID(ts::EDID::Private(0xFF, 0x75746573));
+}
+
 // Test suite cleanup method.
 void PSIRepositoryTest::afterTest()
 {
+    // Do not leave test registrations in the repository for subsequent tests.
+    ts::PSIRepository::Instance()->unregisterDescriptor(LATE_EDID);
+    ts::PSIRepository::Instance()->unregisterDescriptor(COPY_EDID);
 }
 
 
@@ -140,3 +155,84 @@ void PSIRepositoryTest::testSharedTID()
     TSUNIT_ASSERT(ts::MGT::DisplaySection == ts::PSIRepository::Instance()->getSectionDisplay(ts::TID_LDT, ts::Standards::NONE, ts::PID_PSIP));
     TSUNIT_ASSERT(ts::LDT::DisplaySection == ts::PSIRepository::Instance()->getSectionDisplay(ts::TID_LDT, ts::Standards::NONE, ts::PID_LDT));
 }
+
+void PSIRepositoryTest::testSimilarNames()
+{
+    ts::PSIRepository* const repo = ts::PSIRepository::Instance();
+
+    // XML names are searched ignoring case and spaces.
+    TSUNIT_ASSERT(repo->getTableFactory(u"PAT") != nullptr);
+    TSUNIT_ASSERT(repo->getTableFactory(u" p a t ") != nullptr);
+    TSUNIT_ASSERT(repo->getTableFactory(u"PAT") == repo->getTableFactory(u"pat"));
+    TSUNIT_ASSERT(repo->getTableFactory(u"PATX") == nullptr);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"CA_descriptor") != nullptr);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"ca_DESCRIPTOR") == repo->getDescriptorFactory(ts::EDID::Standard(ts::DID_CA)));
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"ca") == nullptr);
+
+    // Legacy names are registered as well.
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"time_shifted_service_descriptor") != nullptr);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"time_shifted_service_descriptor") == repo->getDescriptorFactory(u"DVB_time_shifted_service_descriptor"));
+
+    // Table-specific descriptors.
+    TSUNIT_ASSERT(repo->isDescriptorAllowed(u"CA_descriptor", ts::TID_PMT));
+    TSUNIT_ASSERT(repo->isDescriptorAllowed(u"application_descriptor", ts::TID_AIT));
+    TSUNIT_ASSERT(repo->isDescriptorAllowed(u"Application Descriptor", ts::TID_AIT));
+    TSUNIT_ASSERT(!repo->isDescriptorAllowed(u"application_descriptor", ts::TID_PMT));
+    TSUNIT_ASSERT(repo->descriptorTables(ts::DuckContext(), u"CA_descriptor").empty());
+    TSUNIT_EQUAL(u"AIT", repo->descriptorTables(ts::DuckContext(), u"application_descriptor"));
+
+    std::vector<ts::TID> tids;
+    repo->getRegisteredTableIds(tids);
+    TSUNIT_ASSERT(!tids.empty());
+    TSUNIT_EQUAL(ts::TID_PAT, tids.front());
+    TSUNIT_ASSERT(std::is_sorted(tids.begin(), tids.end()));
+
+    std::vector<ts::EDID> edids;
+    repo->getRegisteredDescriptorIds(edids);
+    TSUNIT_ASSERT(!edids.empty());
+    TSUNIT_ASSERT(std::is_sorted(edids.begin(), edids.end()));
+    TSUNIT_ASSERT(std::adjacent_find(edids.begin(), edids.end()) == edids.end());
+}
+
+namespace {
+    ts::AbstractDescriptorPtr LateFactory()
+    {
+        return new ts::CADescriptor;
+    }
+}
+
+void PSIRepositoryTest::testLateRegistration()
+{
+    ts::PSIRepository* const repo = ts::PSIRepository::Instance();
+    const ts::EDID edid(LATE_EDID);
+
+    // Force the construction of the indexes.
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"CA_descriptor") != nullptr);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"utest_late_descriptor") == nullptr);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(edid) == nullptr);
+
+    // A registration after the first lookup, as done when a shared library is loaded.
+    ts::PSIRepository::RegisterDescriptor reg(TS_LIBRARY_VERSION, LateFactory, edid, u"utest_late_descriptor");
+
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"UTEST_Late_Descriptor") == LateFactory);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(edid) == LateFactory);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"CA_descriptor") != nullptr);
+
+    // A registration with a non-literal name: the name is copied in the repository.
+    {
+        ts::UString name(u"utest_copy_descriptor");
+        ts::PSIRepository::RegisterDescriptor reg2(TS_LIBRARY_VERSION, LateFactory, COPY_EDID, name, nullptr, name + u"_legacy");
+        name.assign(u"overwritten");
+    }
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"utest_copy_descriptor") == LateFactory);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"utest_copy_descriptor_legacy") == LateFactory);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"overwritten") == nullptr);
+
+    // Undo the registrations.
+    repo->unregisterDescriptor(edid);
+    repo->unregisterDescriptor(COPY_EDID);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"utest_late_descriptor") == nullptr);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(edid) == nullptr);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"utest_copy_descriptor") == nullptr);
+    TSUNIT_ASSERT(repo->getDescriptorFactory(u"CA_descriptor") != nullptr);
+}
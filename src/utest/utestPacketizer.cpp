@@ -59,9 +59,11 @@ public:
     virtual void afterTest() override;
 
     void testPacketizer();
+    void testRemoveSections();
 
     TSUNIT_TEST_BEGIN(PacketizerTest);
     TSUNIT_TEST(testPacketizer);
+    TSUNIT_TEST(testRemoveSections);
     TSUNIT_TEST_END();
 
 private:
@@ -178,3 +180,45 @@ void PacketizerTest::testPacketizer()
     TSUNIT_ASSERT(pmt_count == 4);
     TSUNIT_ASSERT(sdt_count >= 15 && sdt_count <= 18);
 }
+
+void PacketizerTest::testRemoveSections()
+{
+    ts::DuckContext duck;
+    ts::BinaryTablePtr binpat;
+    ts::BinaryTablePtr binpmt;
+    ts::BinaryTablePtr binsdt;
+
+    DemuxTable(binpat, "PAT", psi_pat_r4_packets, sizeof(psi_pat_r4_packets));
+    DemuxTable(binpmt, "PMT", psi_pmt_planete_packets, sizeof(psi_pmt_planete_packets));
+    DemuxTable(binsdt, "SDT", psi_sdt_r3_packets, sizeof(psi_sdt_r3_packets));
+
+    ts::SectionPtr pat(binpat->sectionAt(0));
+    ts::SectionPtr pmt(binpmt->sectionAt(0));
+    ts::SectionPtr sdt(binsdt->sectionAt(0));
+
+    // A copy of the PMT section: same content, distinct instance.
+    ts::SectionPtr pmt2(new ts::Section(*pmt, ts::ShareMode::COPY));
+
+    ts::CyclingPacketizer pzer(duck, ts::PID_PAT, ts::CyclingPacketizer::ALWAYS);
+    pzer.addSection(pat);
+    pzer.addSection(pmt);
+    pzer.addSection(sdt);
+    TSUNIT_EQUAL(3, pzer.storedSectionCount());
+
+    // Sections are removed by instance, not by content.
+    pzer.removeSections(ts::SectionPtrVector({pmt2}));
+    TSUNIT_EQUAL(3, pzer.storedSectionCount());
+
+    pzer.removeSections(ts::SectionPtrVector({pmt}));
+    TSUNIT_EQUAL(2, pzer.storedSectionCount());
+
+    // Now only the PAT and SDT are cycled (one packet each).
+    for (int pi = 0; pi < 10; ++pi) {
+        ts::TSPacket pkt;
+        pzer.getNextPacket(pkt);
+        TSUNIT_EQUAL(pi % 2 == 0 ? ts::TID_PAT : ts::TID_SDT_ACT, pkt.b[5]);
+    }
+
+    pzer.removeSections(ts::SectionPtrVector({pat, sdt}));
+    TSUNIT_EQUAL(0, pzer.storedSectionCount());
+}
@@ -122,6 +122,8 @@ public:
     void testGetIntVarLE();
     void testPutIntVarBE();
     void testPutIntVarLE();
+    void testLocatePattern();
+    void testLocateZeroZero();
 
     TSUNIT_TEST_BEGIN(PlatformTest);
     TSUNIT_TEST(testIntegerTypes);
@@ -196,6 +198,8 @@ public:
     TSUNIT_TEST(testGetIntVarLE);
     TSUNIT_TEST(testPutIntVarBE);
     TSUNIT_TEST(testPutIntVarLE);
+    TSUNIT_TEST(testLocatePattern);
+    TSUNIT_TEST(testLocateZeroZero);
     TSUNIT_TEST_END();
 };
 
@@ -881,3 +885,55 @@ void PlatformTest::testPutIntVarLE()
     ts::PutIntVarLE(out, 8, TS_UCONST64(0x908F8E8D8C8B8A89));
     TSUNIT_EQUAL(0, ::memcmp(out, _bytes + 0x89, 8));
 }
+
+void PlatformTest::testLocatePattern()
+{
+    static const uint8_t area[] = {0x00, 0x01, 0x47, 0x00, 0x47, 0x12, 0x34, 0x47, 0x12, 0x35, 0x00, 0x47};
+    static const uint8_t pat1[] = {0x47, 0x12, 0x35};
+    static const uint8_t pat2[] = {0x47, 0x12, 0x36};
+    static const uint8_t pat3[] = {0x00, 0x47};
+    static const uint8_t pat4[] = {0x47};
+
+    TSUNIT_ASSERT(ts::LocatePattern(area, sizeof(area), pat1, sizeof(pat1)) == area + 7);
+    TSUNIT_ASSERT(ts::LocatePattern(area, sizeof(area), pat2, sizeof(pat2)) == nullptr);
+    TSUNIT_ASSERT(ts::LocatePattern(area, sizeof(area), pat3, sizeof(pat3)) == area + 3);
+    TSUNIT_ASSERT(ts::LocatePattern(area + 4, sizeof(area) - 4, pat3, sizeof(pat3)) == area + 10);
+    TSUNIT_ASSERT(ts::LocatePattern(area + 8, sizeof(area) - 8, pat4, sizeof(pat4)) == area + 11);
+    TSUNIT_ASSERT(ts::LocatePattern(area, 9, pat1, sizeof(pat1)) == nullptr);
+    TSUNIT_ASSERT(ts::LocatePattern(area, 10, pat1, sizeof(pat1)) == area + 7);
+    TSUNIT_ASSERT(ts::LocatePattern(area, 2, pat1, sizeof(pat1)) == nullptr);
+    TSUNIT_ASSERT(ts::LocatePattern(area, sizeof(area), pat1, 0) == nullptr);
+}
+
+void PlatformTest::testLocateZeroZero()
+{
+    static const uint8_t area[] = {0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x01, 0x47, 0x00, 0x01, 0x00, 0x00, 0x01};
+
+    TSUNIT_ASSERT(ts::LocateZeroZero(area, sizeof(area)) == area + 4);
+    TSUNIT_ASSERT(ts::LocateZeroZero(area, sizeof(area), 0x00, 0x01) == area + 3);
+    TSUNIT_ASSERT(ts::LocateZeroZero(area, sizeof(area), 0x02, 0x02) == area);
+    TSUNIT_ASSERT(ts::LocateZeroZero(area + 5, sizeof(area) - 5) == area + 10);
+    TSUNIT_ASSERT(ts::LocateZeroZero(area + 5, sizeof(area) - 6) == nullptr);
+    TSUNIT_ASSERT(ts::LocateZeroZero(area, 2) == nullptr);
+    TSUNIT_ASSERT(ts::LocateZeroZero(nullptr, 10) == nullptr);
+
+    // Compare with a basic search on long areas with sparse zeroes, crossing block boundaries.
+    uint8_t data[200];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = uint8_t(0x80 + i);
+    }
+    for (size_t pos = 0; pos + 3 <= sizeof(data); pos += 7) {
+        uint8_t buf[sizeof(data)];
+        ::memcpy(buf, data, sizeof(buf));
+        buf[pos] = buf[pos + 1] = 0x00;
+        buf[pos + 2] = 0x01;
+        if (pos > 0) {
+            buf[pos - 1] = 0x00; // 00 00 00 01: the match is one byte later with xx_min = 1
+        }
+        static const uint8_t prefix[] = {0x00, 0x00, 0x01};
+        TSUNIT_ASSERT(ts::LocateZeroZero(buf, sizeof(buf)) == buf + pos);
+        TSUNIT_ASSERT(ts::LocateZeroZero(buf, sizeof(buf)) == ts::LocatePattern(buf, sizeof(buf), prefix, sizeof(prefix)));
+        TSUNIT_ASSERT(ts::LocateZeroZero(buf, sizeof(buf), 0x00, 0x01) == buf + (pos > 0 ? pos - 1 : pos));
+        TSUNIT_ASSERT(ts::LocateZeroZero(buf, pos + 2) == nullptr);
+    }
+}
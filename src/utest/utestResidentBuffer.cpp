@@ -47,9 +47,11 @@ public:
     virtual void afterTest() override;
 
     void testResidentBuffer();
+    void testHugePages();
 
     TSUNIT_TEST_BEGIN(ResidentBufferTest);
     TSUNIT_TEST(testResidentBuffer);
+    TSUNIT_TEST(testHugePages);
     TSUNIT_TEST_END();
 };
 
@@ -87,3 +89,21 @@ void ResidentBufferTest::testResidentBuffer()
     TSUNIT_ASSERT(buf.isLocked());
     TSUNIT_ASSERT(buf.count() >= buf_size);
 }
+
+void ResidentBufferTest::testHugePages()
+{
+    const size_t buf_size = 10000;
+
+    // Huge pages are usually not reserved on test systems, must fall back to normal pages.
+    ts::ResidentBuffer<uint8_t> buf(buf_size, 2 * 1024 * 1024);
+
+    debug() << "ResidentBufferTest: isLocked() = " << buf.isLocked() << ", isHugePages() = " << buf.isHugePages()
+            << ", requested size = " << buf_size << ", count() = " << buf.count() << std::endl;
+
+    TSUNIT_ASSERT(buf.base() != nullptr);
+    TSUNIT_ASSERT(buf.count() >= buf_size);
+
+    // Check that the whole buffer is usable.
+    ts::Zero(buf.base(), buf.count());
+    TSUNIT_EQUAL(0, buf.base()[buf.count() - 1]);
+}
@@ -73,6 +73,7 @@ public:
     void testMultiSectionsCAT();
     void testMultiSectionsAtProgramLevelPMT();
     void testMultiSectionsAtStreamLevelPMT();
+    void testSectionCache();
 
     TSUNIT_TEST_BEGIN(SectionFileTest);
     TSUNIT_TEST(testConfigurationFile);
@@ -85,6 +86,7 @@ public:
     TSUNIT_TEST(testMultiSectionsCAT);
     TSUNIT_TEST(testMultiSectionsAtProgramLevelPMT);
     TSUNIT_TEST(testMultiSectionsAtStreamLevelPMT);
+    TSUNIT_TEST(testSectionCache);
     TSUNIT_TEST_END();
 
 private:
@@ -735,3 +737,58 @@ void SectionFileTest::testMultiSectionsAtStreamLevelPMT()
         }
     }
 }
+
+void SectionFileTest::testSectionCache()
+{
+    const ts::UString dir(ts::TempFile(u".cache"));
+    TSUNIT_EQUAL(ts::SYS_SUCCESS, ts::CreateDirectory(dir));
+
+    ts::DuckContext duck;
+    ts::UStringVector files;
+    std::ostringstream strm;
+
+    // First load, the cache file is created.
+    ts::SectionFile file1(duck);
+    file1.setCacheDirectory(dir);
+    TSUNIT_ASSERT(file1.parseXML(psi_pat1_xml, report()));
+    TSUNIT_ASSERT(ts::ExpandWildcard(files, dir + ts::PathSeparator + u"*.bin"));
+    TSUNIT_EQUAL(1, files.size());
+    TSUNIT_ASSERT(file1.saveBinary(strm, report()));
+    TSUNIT_EQUAL(sizeof(psi_pat1_sections), strm.str().size());
+    TSUNIT_EQUAL(0, ::memcmp(psi_pat1_sections, strm.str().data(), sizeof(psi_pat1_sections)));
+
+    // Replace the cache file with other sections to check that it is actually used.
+    const ts::UString cache_file(files[0]);
+    TSUNIT_ASSERT(ts::ByteBlock(psi_pmt_scte35_sections, sizeof(psi_pmt_scte35_sections)).saveToFile(cache_file));
+
+    ts::SectionFile file2(duck);
+    file2.setCacheDirectory(dir);
+    TSUNIT_ASSERT(file2.parseXML(psi_pat1_xml, report()));
+    strm.str(std::string());
+    TSUNIT_ASSERT(file2.saveBinary(strm, report()));
+    TSUNIT_EQUAL(sizeof(psi_pmt_scte35_sections), strm.str().size());
+    TSUNIT_EQUAL(0, ::memcmp(psi_pmt_scte35_sections, strm.str().data(), sizeof(psi_pmt_scte35_sections)));
+
+    // A corrupted cache file is ignored and recreated.
+    TSUNIT_ASSERT(ts::ByteBlock(3, 0x55).saveToFile(cache_file));
+    ts::SectionFile file3(duck);
+    file3.setCacheDirectory(dir);
+    TSUNIT_ASSERT(file3.parseXML(psi_pat1_xml, report()));
+    strm.str(std::string());
+    TSUNIT_ASSERT(file3.saveBinary(strm, report()));
+    TSUNIT_EQUAL(sizeof(psi_pat1_sections), strm.str().size());
+    TSUNIT_EQUAL(0, ::memcmp(psi_pat1_sections, strm.str().data(), sizeof(psi_pat1_sections)));
+    TSUNIT_ASSERT(ts::GetFileSize(cache_file) == int64_t(sizeof(psi_pat1_sections)));
+
+    // Another XML content uses another cache file.
+    ts::SectionFile file4(duck);
+    file4.setCacheDirectory(dir);
+    TSUNIT_ASSERT(file4.parseXML(psi_pmt_scte35_xml, report()));
+    TSUNIT_ASSERT(ts::ExpandWildcard(files, dir + ts::PathSeparator + u"*.bin"));
+    TSUNIT_EQUAL(2, files.size());
+
+    for (const auto& name : files) {
+        ts::DeleteFile(name);
+    }
+    ts::DeleteFile(dir);
+}
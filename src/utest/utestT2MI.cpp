@@ -0,0 +1,238 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::T2MIDemux
+//
+//----------------------------------------------------------------------------
+
+#include "tsT2MIDemux.h"
+#include "tsT2MIPacket.h"
+#include "tsDuckContext.h"
+#include "tsCRC32.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class T2MITest: public tsunit::Test, private ts::T2MIHandlerInterface
+{
+public:
+    T2MITest();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testExtract();
+
+    TSUNIT_TEST_BEGIN(T2MITest);
+    TSUNIT_TEST(testExtract);
+    TSUNIT_TEST_END();
+
+private:
+    ts::TSPacketVector _extracted[2];  // Extracted packets per PLP.
+    ts::T2MIPacket     _kept;          // A T2-MI packet kept by the application.
+    ts::ByteBlock      _kept_data;     // Copy of the content of the kept packet.
+    size_t             _t2mi_count;    // Number of T2-MI packets.
+
+    // Implementation of T2MIHandlerInterface.
+    virtual void handleT2MINewPID(ts::T2MIDemux& demux, const ts::PMT& pmt, ts::PID pid, const ts::T2MIDescriptor& desc) override;
+    virtual void handleT2MIPacket(ts::T2MIDemux& demux, const ts::T2MIPacket& pkt) override;
+    virtual void handleTSPacket(ts::T2MIDemux& demux, const ts::T2MIPacket& t2mi, const ts::TSPacket& ts) override;
+};
+
+TSUNIT_REGISTER(T2MITest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+T2MITest::T2MITest() :
+    _extracted(),
+    _kept(),
+    _kept_data(),
+    _t2mi_count(0)
+{
+}
+
+// Test suite initialization method.
+void T2MITest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void T2MITest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// T2-MI handler.
+//----------------------------------------------------------------------------
+
+void T2MITest::handleT2MINewPID(ts::T2MIDemux& demux, const ts::PMT& pmt, ts::PID pid, const ts::T2MIDescriptor& desc)
+{
+}
+
+void T2MITest::handleT2MIPacket(ts::T2MIDemux& demux, const ts::T2MIPacket& pkt)
+{
+    // Keep a reference to the third T2-MI packet, it must not be overwritten by the demux.
+    if (++_t2mi_count == 3) {
+        _kept = pkt;
+        _kept_data.copy(pkt.content(), pkt.size());
+    }
+}
+
+void T2MITest::handleTSPacket(ts::T2MIDemux& demux, const ts::T2MIPacket& t2mi, const ts::TSPacket& ts)
+{
+    TSUNIT_ASSERT(t2mi.plp() < 2);
+    _extracted[t2mi.plp()].push_back(ts);
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void T2MITest::testExtract()
+{
+    constexpr size_t INNER_COUNT = 50;
+    constexpr ts::PID T2MI_PID = 0x1000;
+
+    // Inner transport streams, one per PLP.
+    ts::TSPacketVector inner[2];
+    for (size_t plp = 0; plp < 2; ++plp) {
+        inner[plp].resize(INNER_COUNT);
+        for (size_t i = 0; i < INNER_COUNT; ++i) {
+            ts::TSPacket& pkt(inner[plp][i]);
+            pkt.init(ts::PID(0x0100 + plp), uint8_t(i & ts::CC_MASK));
+            for (size_t j = 4; j < ts::PKT_SIZE; ++j) {
+                pkt.b[j] = uint8_t(i + 7 * plp + j);
+            }
+        }
+    }
+
+    // Build T2-MI packets, alternating PLP's. Each data field contains 187-byte
+    // user packets (without sync byte), split at various positions.
+    static const size_t df_sizes[] = {500, 1000, 187, 77, 2000, 374, 1};
+    ts::ByteBlock t2mi;               // Concatenated T2-MI packets.
+    std::vector<size_t> t2mi_starts;  // Start offsets of T2-MI packets.
+    size_t offset[2] = {0, 0};        // Current offset in each inner stream (without sync bytes).
+    const size_t inner_size = INNER_COUNT * (ts::PKT_SIZE - 1);
+    for (size_t index = 0; offset[0] < inner_size || offset[1] < inner_size; ++index) {
+        const size_t plp = index % 2;
+        if (offset[plp] >= inner_size) {
+            continue;
+        }
+        const size_t dfl = std::min(df_sizes[(index / 2 + plp) % 7], inner_size - offset[plp]);
+        const size_t syncd = (ts::PKT_SIZE - 1 - offset[plp] % (ts::PKT_SIZE - 1)) % (ts::PKT_SIZE - 1);
+        const size_t start = t2mi.size();
+        t2mi_starts.push_back(start);
+
+        // T2-MI header.
+        t2mi.appendUInt8(0x00); // baseband frame
+        t2mi.appendUInt8(uint8_t(index));
+        t2mi.appendUInt16(0);
+        t2mi.appendUInt16(uint16_t(8 * (3 + ts::T2_BBHEADER_SIZE + dfl)));
+        // Baseband frame payload header: frame index, PLP, flags.
+        t2mi.appendUInt8(0);
+        t2mi.appendUInt8(uint8_t(plp));
+        t2mi.appendUInt8(0);
+        // Baseband header: MATYPE (TS, no NPD), UPL, DFL, SYNC, SYNCD, CRC-8.
+        t2mi.appendUInt8(0xC0);
+        t2mi.appendUInt8(0x00);
+        t2mi.appendUInt16(8 * ts::PKT_SIZE);
+        t2mi.appendUInt16(uint16_t(8 * dfl));
+        t2mi.appendUInt8(ts::SYNC_BYTE);
+        t2mi.appendUInt16(syncd >= dfl ? 0xFFFF : uint16_t(8 * syncd));
+        t2mi.appendUInt8(0);
+        // Data field.
+        for (size_t i = 0; i < dfl; ++i) {
+            const size_t pos = offset[plp] + i;
+            t2mi.appendUInt8(inner[plp][pos / (ts::PKT_SIZE - 1)].b[1 + pos % (ts::PKT_SIZE - 1)]);
+        }
+        offset[plp] += dfl;
+        // CRC32.
+        t2mi.appendUInt32(ts::CRC32(t2mi.data() + start, t2mi.size() - start).value());
+    }
+    debug() << "T2MITest::testExtract: " << t2mi_starts.size() << " T2-MI packets, " << t2mi.size() << " bytes" << std::endl;
+
+    // Packetize the T2-MI packets in TS packets, with a pointer field when a T2-MI packet starts.
+    ts::TSPacketVector outer;
+    size_t pos = 0;
+    size_t next_start = 0;
+    for (uint8_t cc = 0; pos < t2mi.size(); cc = (cc + 1) & ts::CC_MASK) {
+        outer.resize(outer.size() + 1);
+        ts::TSPacket& pkt(outer.back());
+        pkt.init(T2MI_PID, cc);
+        size_t hsize = 4;
+        while (next_start < t2mi_starts.size() && t2mi_starts[next_start] < pos) {
+            next_start++;
+        }
+        if (next_start < t2mi_starts.size() && t2mi_starts[next_start] < pos + ts::PKT_SIZE - 5) {
+            pkt.setPUSI();
+            pkt.b[hsize++] = uint8_t(t2mi_starts[next_start] - pos);
+        }
+        const size_t size = std::min(ts::PKT_SIZE - hsize, t2mi.size() - pos);
+        ::memcpy(pkt.b + hsize, t2mi.data() + pos, size);
+        ::memset(pkt.b + hsize + size, 0xFF, ts::PKT_SIZE - hsize - size);
+        pos += size;
+    }
+    debug() << "T2MITest::testExtract: " << outer.size() << " outer TS packets" << std::endl;
+
+    // Demux the T2-MI stream.
+    ts::DuckContext duck;
+    ts::T2MIDemux demux(duck, this);
+    demux.addPID(T2MI_PID);
+    for (const auto& pkt : outer) {
+        demux.feedPacket(pkt);
+    }
+
+    // All T2-MI packets but the last one are processed (a T2-MI packet is
+    // processed when more data are received after its end).
+    TSUNIT_ASSERT(_t2mi_count + 1 >= t2mi_starts.size());
+
+    // Check the extracted TS packets.
+    for (size_t plp = 0; plp < 2; ++plp) {
+        debug() << "T2MITest::testExtract: PLP " << plp << ": extracted " << _extracted[plp].size() << " TS packets" << std::endl;
+        TSUNIT_ASSERT(_extracted[plp].size() + 10 >= INNER_COUNT);
+        TSUNIT_ASSERT(_extracted[plp].size() <= INNER_COUNT);
+        for (size_t i = 0; i < _extracted[plp].size(); ++i) {
+            TSUNIT_EQUAL(0, ::memcmp(_extracted[plp][i].b, inner[plp][i].b, ts::PKT_SIZE));
+        }
+    }
+
+    // The T2-MI packet which was kept by the application is unchanged.
+    TSUNIT_ASSERT(_kept.isValid());
+    TSUNIT_ASSERT(_kept_data == ts::ByteBlock(_kept.content(), _kept.size()));
+}
@@ -0,0 +1,283 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TSPacketSPSCQueue
+//
+//----------------------------------------------------------------------------
+
+#include "tsTSPacketSPSCQueue.h"
+#include "tsunit.h"
+#include "utestTSUnitThread.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TSPacketSPSCQueueTest: public tsunit::Test
+{
+public:
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testSingleThread();
+    void testThreads();
+    void testEOFRace();
+
+    TSUNIT_TEST_BEGIN(TSPacketSPSCQueueTest);
+    TSUNIT_TEST(testSingleThread);
+    TSUNIT_TEST(testThreads);
+    TSUNIT_TEST(testEOFRace);
+    TSUNIT_TEST_END();
+};
+
+TSUNIT_REGISTER(TSPacketSPSCQueueTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Test suite initialization method.
+void TSPacketSPSCQueueTest::beforeTest()
+{
+}
+
+// Test suite cleanup method.
+void TSPacketSPSCQueueTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TSPacketSPSCQueueTest::testSingleThread()
+{
+    ts::TSPacketSPSCQueue queue(10);
+    TSUNIT_EQUAL(10, queue.bufferSize());
+    TSUNIT_EQUAL(0, queue.currentSize());
+
+    ts::TSPacket* wbuf = nullptr;
+    const ts::TSPacket* rbuf = nullptr;
+    size_t size = 0;
+    ts::BitRate bitrate = 0;
+
+    // Nothing to read.
+    TSUNIT_ASSERT(!queue.borrowRead(rbuf, size, bitrate, false));
+    TSUNIT_EQUAL(0, size);
+
+    // Write 7 packets.
+    TSUNIT_ASSERT(queue.reserveWrite(wbuf, size, 7));
+    TSUNIT_EQUAL(10, size);
+    for (size_t i = 0; i < 7; ++i) {
+        wbuf[i].init(ts::PID(i));
+    }
+    queue.commitWrite(7);
+    TSUNIT_EQUAL(7, queue.currentSize());
+
+    // Read 5 packets in place.
+    TSUNIT_ASSERT(queue.borrowRead(rbuf, size, bitrate, false));
+    TSUNIT_EQUAL(7, size);
+    TSUNIT_EQUAL(0, rbuf[0].getPID());
+    TSUNIT_EQUAL(4, rbuf[4].getPID());
+    queue.releaseRead(5);
+    TSUNIT_EQUAL(2, queue.currentSize());
+
+    // The write window is limited by the end of the buffer.
+    TSUNIT_ASSERT(queue.reserveWrite(wbuf, size, 5));
+    TSUNIT_EQUAL(3, size);
+    wbuf[0].init(7);
+    wbuf[1].init(8);
+    wbuf[2].init(9);
+    queue.commitWrite(3);
+
+    // Then wraps up at the beginning of the buffer.
+    TSUNIT_ASSERT(queue.reserveWrite(wbuf, size, 1));
+    TSUNIT_EQUAL(5, size);
+    wbuf[0].init(10);
+    queue.commitWrite(1);
+    TSUNIT_EQUAL(6, queue.currentSize());
+
+    // The read span is limited by the end of the buffer.
+    TSUNIT_ASSERT(queue.borrowRead(rbuf, size, bitrate, false));
+    TSUNIT_EQUAL(5, size);
+    TSUNIT_EQUAL(5, rbuf[0].getPID());
+    queue.releaseRead(5);
+    TSUNIT_ASSERT(queue.borrowRead(rbuf, size, bitrate, false));
+    TSUNIT_EQUAL(1, size);
+    TSUNIT_EQUAL(10, rbuf[0].getPID());
+    queue.releaseRead(1);
+
+    // End of file after last packet.
+    TSUNIT_ASSERT(!queue.eof());
+    queue.setEOF();
+    TSUNIT_ASSERT(queue.eof());
+    TSUNIT_ASSERT(!queue.borrowRead(rbuf, size, bitrate, true));
+
+    // Stop condition on writer side.
+    queue.reset();
+    TSUNIT_ASSERT(!queue.eof());
+    queue.stop();
+    TSUNIT_ASSERT(queue.stopped());
+    TSUNIT_ASSERT(!queue.reserveWrite(wbuf, size));
+    TSUNIT_EQUAL(0, size);
+}
+
+// Thread for testThreads(): writes packets with increasing PID values.
+namespace {
+    class SPSCQueueTestThread: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(SPSCQueueTestThread);
+    private:
+        ts::TSPacketSPSCQueue& _queue;
+        const size_t _count;
+    public:
+        SPSCQueueTestThread(ts::TSPacketSPSCQueue& queue, size_t count) :
+            utest::TSUnitThread(),
+            _queue(queue),
+            _count(count)
+        {
+        }
+
+        virtual ~SPSCQueueTestThread() override
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            size_t index = 0;
+            while (index < _count) {
+                ts::TSPacket* buffer = nullptr;
+                size_t size = 0;
+                TSUNIT_ASSERT(_queue.reserveWrite(buffer, size, 3));
+                TSUNIT_ASSERT(size > 0);
+                size = std::min(size, _count - index);
+                for (size_t i = 0; i < size; ++i) {
+                    buffer[i].init(ts::PID(index++ % ts::PID_MAX));
+                }
+                _queue.commitWrite(size);
+            }
+            _queue.setEOF();
+        }
+    };
+}
+
+void TSPacketSPSCQueueTest::testThreads()
+{
+    const size_t count = 100000;
+    ts::TSPacketSPSCQueue queue(37);
+    SPSCQueueTestThread thread(queue, count);
+    TSUNIT_ASSERT(thread.start());
+
+    // Read all packets in place, check the sequence.
+    size_t index = 0;
+    const ts::TSPacket* buffer = nullptr;
+    size_t size = 0;
+    ts::BitRate bitrate = 0;
+    while (queue.borrowRead(buffer, size, bitrate)) {
+        for (size_t i = 0; i < size; ++i) {
+            TSUNIT_EQUAL(index++ % ts::PID_MAX, buffer[i].getPID());
+        }
+        queue.releaseRead(size);
+    }
+    TSUNIT_EQUAL(count, index);
+    TSUNIT_ASSERT(queue.eof());
+}
+
+// Thread for testEOFRace(): commits a few packets one by one and immediately reports the end of file.
+namespace {
+    class SPSCQueueEOFThread: public utest::TSUnitThread
+    {
+        TS_NOBUILD_NOCOPY(SPSCQueueEOFThread);
+    private:
+        ts::TSPacketSPSCQueue& _queue;
+        const size_t _count;
+    public:
+        SPSCQueueEOFThread(ts::TSPacketSPSCQueue& queue, size_t count) :
+            utest::TSUnitThread(),
+            _queue(queue),
+            _count(count)
+        {
+        }
+
+        virtual ~SPSCQueueEOFThread() override
+        {
+            waitForTermination();
+        }
+
+        virtual void test() override
+        {
+            for (size_t index = 0; index < _count; ++index) {
+                ts::TSPacket* buffer = nullptr;
+                size_t size = 0;
+                TSUNIT_ASSERT(_queue.reserveWrite(buffer, size, 1));
+                buffer[0].init(ts::PID(index));
+                _queue.commitWrite(1);
+            }
+            _queue.setEOF();
+        }
+    };
+}
+
+void TSPacketSPSCQueueTest::testEOFRace()
+{
+    // The end of file is reported right after the last commit, while the reader
+    // spins without waiting. A false return after the end of file must mean that
+    // all packets were read.
+    const size_t count = 4;
+    for (size_t trial = 0; trial < 10000; ++trial) {
+        ts::TSPacketSPSCQueue queue(16);
+        SPSCQueueEOFThread thread(queue, count);
+        TSUNIT_ASSERT(thread.start());
+
+        size_t index = 0;
+        const ts::TSPacket* buffer = nullptr;
+        size_t size = 0;
+        ts::BitRate bitrate = 0;
+        for (;;) {
+            // Non-waiting read. When nothing is available, a waiting read returns
+            // false only at end of file, without waiting when the end is already known.
+            if (queue.borrowRead(buffer, size, bitrate, false) || queue.borrowRead(buffer, size, bitrate, true)) {
+                for (size_t i = 0; i < size; ++i) {
+                    TSUNIT_EQUAL(index++, buffer[i].getPID());
+                }
+                queue.releaseRead(size);
+            }
+            else {
+                break;
+            }
+        }
+        TSUNIT_EQUAL(count, index);
+        TSUNIT_ASSERT(queue.eof());
+    }
+}
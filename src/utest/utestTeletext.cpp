@@ -0,0 +1,342 @@
+//----------------------------------------------------------------------------
+//
+// TSDuck - The MPEG Transport Stream Toolkit
+// Copyright (c) 2005-2021, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+//  TSUnit test suite for class ts::TeletextDemux
+//
+//----------------------------------------------------------------------------
+
+#include "tsTeletextDemux.h"
+#include "tsTeletextFrame.h"
+#include "tsPESOneShotPacketizer.h"
+#include "tsDuckContext.h"
+#include "tsunit.h"
+TSDUCK_SOURCE;
+
+
+//----------------------------------------------------------------------------
+// The test fixture
+//----------------------------------------------------------------------------
+
+class TeletextTest: public tsunit::Test, private ts::TeletextHandlerInterface
+{
+public:
+    TeletextTest();
+
+    virtual void beforeTest() override;
+    virtual void afterTest() override;
+
+    void testAllPages();
+    void testSubscription();
+    void testRowCache();
+
+    TSUNIT_TEST_BEGIN(TeletextTest);
+    TSUNIT_TEST(testAllPages);
+    TSUNIT_TEST(testSubscription);
+    TSUNIT_TEST(testRowCache);
+    TSUNIT_TEST_END();
+
+private:
+    // A Teletext handler which logs all frames as "page:line|line|...".
+    class FrameLog : public ts::TeletextHandlerInterface
+    {
+    public:
+        ts::UStringVector frames;
+        FrameLog() : frames() {}
+        virtual void handleTeletextMessage(ts::TeletextDemux& demux, const ts::TeletextFrame& frame) override;
+    };
+
+    ts::DuckContext _duck;
+    FrameLog        _log;   // Frames for the demux handler.
+    FrameLog        _page;  // Frames for a page-specific handler.
+
+    // Implementation of TeletextHandlerInterface.
+    virtual void handleTeletextMessage(ts::TeletextDemux& demux, const ts::TeletextFrame& frame) override;
+
+    // Build Teletext packets and feed them in one PES packet.
+    static void AddPacket(ts::ByteBlock& units, int magazine, int row, const uint8_t* data);
+    static void AddHeader(ts::ByteBlock& units, int page);
+    static void AddRow(ts::ByteBlock& units, int page, int row, const char* text, uint8_t color = 0x07);
+    void feed(ts::TeletextDemux& demux, const ts::ByteBlock& units);
+};
+
+TSUNIT_REGISTER(TeletextTest);
+
+
+//----------------------------------------------------------------------------
+// Initialization.
+//----------------------------------------------------------------------------
+
+// Constructor.
+TeletextTest::TeletextTest() :
+    _duck(),
+    _log(),
+    _page()
+{
+}
+
+// Test suite initialization method.
+void TeletextTest::beforeTest()
+{
+    _log.frames.clear();
+    _page.frames.clear();
+}
+
+// Test suite cleanup method.
+void TeletextTest::afterTest()
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Build a synthetic Teletext stream.
+//----------------------------------------------------------------------------
+
+namespace {
+    const ts::PID TELETEXT_PID = 100;
+
+    // Hamming 8/4 encoding, ETSI 300 706, section 8.2.
+    const uint8_t HAM_8_4[16] = {
+        0x15, 0x02, 0x49, 0x5E, 0x64, 0x73, 0x38, 0x2F, 0xD0, 0xC7, 0x8C, 0x9B, 0xA1, 0xB6, 0xFD, 0xEA
+    };
+
+    // Teletext bytes are transmitted LSB first.
+    uint8_t Reverse(uint8_t b)
+    {
+        uint8_t r = 0;
+        for (int i = 0; i < 8; ++i) {
+            if ((b & (1 << i)) != 0) {
+                r |= uint8_t(0x80 >> i);
+            }
+        }
+        return r;
+    }
+
+    // Build a PES packet on private stream 1 with a data_identifier for EBU data.
+    ts::PESPacket BuildPES(const ts::ByteBlock& units)
+    {
+        ts::ByteBlock data;
+        data.appendUInt24(0x000001);
+        data.appendUInt8(0xBD);
+        data.appendUInt16(uint16_t(4 + units.size()));
+        data.appendUInt8(0x80);
+        data.appendUInt8(0x00);
+        data.appendUInt8(0x00);  // PES header data length
+        data.appendUInt8(ts::TELETEXT_PES_FIRST_EBU_DATA_ID);
+        data.append(units);
+        return ts::PESPacket(data);
+    }
+
+    // Characters use odd parity.
+    uint8_t OddParity(uint8_t c)
+    {
+        int ones = 0;
+        for (int i = 0; i < 7; ++i) {
+            ones += (c >> i) & 0x01;
+        }
+        return (ones % 2) == 0 ? uint8_t(c | 0x80) : c;
+    }
+}
+
+void TeletextTest::AddPacket(ts::ByteBlock& units, int magazine, int row, const uint8_t* data)
+{
+    const uint8_t address = uint8_t((row << 3) | (magazine & 0x07));
+    uint8_t pkt[ts::TELETEXT_PACKET_SIZE];
+    pkt[0] = 0x55;  // clock run-in
+    pkt[1] = 0x27;  // framing code
+    pkt[2] = HAM_8_4[address & 0x0F];
+    pkt[3] = HAM_8_4[address >> 4];
+    ::memcpy(pkt + 4, data, 40);
+
+    units.appendUInt8(uint8_t(ts::TeletextDataUnitId::SUBTITLE));
+    units.appendUInt8(uint8_t(ts::TELETEXT_PACKET_SIZE));
+    for (size_t i = 0; i < sizeof(pkt); ++i) {
+        units.appendUInt8(Reverse(pkt[i]));
+    }
+}
+
+void TeletextTest::AddHeader(ts::ByteBlock& units, int page)
+{
+    uint8_t data[40];
+    ::memset(data, OddParity(0x20), sizeof(data));
+    data[0] = HAM_8_4[page % 10];
+    data[1] = HAM_8_4[(page / 10) % 10];
+    for (size_t i = 2; i < 7; ++i) {
+        data[i] = HAM_8_4[0];
+    }
+    data[7] = HAM_8_4[0x01];  // serial mode, default charset
+    AddPacket(units, page / 100, 0, data);
+}
+
+void TeletextTest::AddRow(ts::ByteBlock& units, int page, int row, const char* text, uint8_t color)
+{
+    uint8_t data[40];
+    ::memset(data, OddParity(0x20), sizeof(data));
+    size_t col = 0;
+    data[col++] = OddParity(color);
+    data[col++] = OddParity(0x0B);  // start box
+    data[col++] = OddParity(0x0B);
+    for (const char* p = text; *p != 0 && col < 38; ++p) {
+        data[col++] = OddParity(uint8_t(*p));
+    }
+    data[col++] = OddParity(0x0A);  // end box
+    data[col++] = OddParity(0x0A);
+    AddPacket(units, page / 100, row, data);
+}
+
+void TeletextTest::feed(ts::TeletextDemux& demux, const ts::ByteBlock& units)
+{
+    ts::PESOneShotPacketizer zer(_duck, TELETEXT_PID);
+    zer.addPES(BuildPES(units), ts::ShareMode::COPY);
+
+    // A short PES packet is complete at the next unit start only, add an empty one.
+    zer.addPES(BuildPES(ts::ByteBlock()), ts::ShareMode::COPY);
+
+    ts::TSPacketVector packets;
+    zer.getPackets(packets);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        demux.feedPacket(packets[i]);
+    }
+}
+
+void TeletextTest::FrameLog::handleTeletextMessage(ts::TeletextDemux& demux, const ts::TeletextFrame& frame)
+{
+    frames.push_back(ts::UString::Format(u"%d:%s", {frame.page(), ts::UString::Join(frame.lines(), u"|")}));
+}
+
+void TeletextTest::handleTeletextMessage(ts::TeletextDemux& demux, const ts::TeletextFrame& frame)
+{
+    _log.handleTeletextMessage(demux, frame);
+}
+
+
+//----------------------------------------------------------------------------
+// Unitary tests.
+//----------------------------------------------------------------------------
+
+void TeletextTest::testAllPages()
+{
+    ts::TeletextDemux demux(_duck, this, ts::PIDSet().set(TELETEXT_PID));
+
+    ts::ByteBlock units;
+    AddHeader(units, 888);
+    AddRow(units, 888, 22, "HELLO");
+    AddHeader(units, 100);
+    AddRow(units, 100, 22, "WORLD");
+    feed(demux, units);
+    TSUNIT_ASSERT(_log.frames.empty());
+
+    // Next page headers terminate the previous frames.
+    units.clear();
+    AddHeader(units, 888);
+    AddHeader(units, 100);
+    feed(demux, units);
+    demux.flushTeletext();
+
+    TSUNIT_EQUAL(2, _log.frames.size());
+    TSUNIT_EQUAL(u"888:HELLO", _log.frames[0]);
+    TSUNIT_EQUAL(u"100:WORLD", _log.frames[1]);
+    TSUNIT_EQUAL(1, demux.frameCount(888));
+    TSUNIT_EQUAL(1, demux.frameCount(100, TELETEXT_PID));
+}
+
+void TeletextTest::testSubscription()
+{
+    ts::TeletextDemux demux(_duck, this, ts::PIDSet().set(TELETEXT_PID));
+    demux.addPage(TELETEXT_PID, 888, &_page);
+
+    ts::ByteBlock units;
+    AddHeader(units, 888);
+    AddRow(units, 888, 22, "HELLO");
+    AddHeader(units, 100);
+    AddRow(units, 100, 22, "WORLD");
+    AddHeader(units, 888);
+    AddHeader(units, 100);
+    feed(demux, units);
+    demux.flushTeletext();
+
+    // Only the subscribed page is decoded, and it goes to its own handler.
+    TSUNIT_ASSERT(_log.frames.empty());
+    TSUNIT_EQUAL(1, _page.frames.size());
+    TSUNIT_EQUAL(u"888:HELLO", _page.frames[0]);
+    TSUNIT_EQUAL(1, demux.frameCount(888));
+    TSUNIT_EQUAL(0, demux.frameCount(100));
+
+    // Subscriptions survive a reset. Without any subscription, all pages are decoded again.
+    demux.reset();
+    demux.addPID(TELETEXT_PID);
+    demux.removePage(TELETEXT_PID, 888);
+    _page.frames.clear();
+    feed(demux, units);
+    demux.flushTeletext();
+
+    TSUNIT_ASSERT(_page.frames.empty());
+    TSUNIT_EQUAL(2, _log.frames.size());
+    TSUNIT_EQUAL(u"888:HELLO", _log.frames[0]);
+    TSUNIT_EQUAL(u"100:WORLD", _log.frames[1]);
+}
+
+void TeletextTest::testRowCache()
+{
+    ts::TeletextDemux demux(_duck, this, ts::PIDSet().set(TELETEXT_PID));
+
+    ts::ByteBlock units;
+    AddHeader(units, 888);
+    AddRow(units, 888, 22, "HELLO");
+    AddRow(units, 888, 23, "AGAIN");
+    AddHeader(units, 888);
+    AddRow(units, 888, 22, "HELLO");
+    AddRow(units, 888, 23, "WORLD");
+    AddHeader(units, 888);
+    AddRow(units, 888, 23, "RED", 0x01);
+    feed(demux, units);
+
+    // The last frame is rendered after changing the color option.
+    demux.setAddColors(true);
+    units.clear();
+    AddHeader(units, 888);
+    AddRow(units, 888, 23, "RED", 0x01);
+    AddHeader(units, 888);
+    feed(demux, units);
+
+    // Back to no color, same content.
+    demux.setAddColors(false);
+    units.clear();
+    AddRow(units, 888, 23, "RED", 0x01);
+    AddHeader(units, 888);
+    feed(demux, units);
+    demux.flushTeletext();
+
+    TSUNIT_EQUAL(5, _log.frames.size());
+    TSUNIT_EQUAL(u"888:HELLO|AGAIN", _log.frames[0]);
+    TSUNIT_EQUAL(u"888:HELLO|WORLD", _log.frames[1]);
+    TSUNIT_EQUAL(u"888:<font color=\"#ff0000\">RED</font>", _log.frames[2]);
+    TSUNIT_EQUAL(u"888:<font color=\"#ff0000\">RED</font>", _log.frames[3]);
+    TSUNIT_EQUAL(u"888:RED", _log.frames[4]);
+    TSUNIT_EQUAL(5, demux.frameCount(888));
+}
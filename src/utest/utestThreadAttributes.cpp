@@ -61,11 +61,13 @@ public:
     void testStackSize();
     void testDeleteWhenTerminated();
     void testPriority();
+    void testAffinity();
 
     TSUNIT_TEST_BEGIN(ThreadAttributesTest);
     TSUNIT_TEST(testStackSize);
     TSUNIT_TEST(testDeleteWhenTerminated);
     TSUNIT_TEST(testPriority);
+    TSUNIT_TEST(testAffinity);
     TSUNIT_TEST_END();
 };
 
@@ -134,3 +136,15 @@ void ThreadAttributesTest::testPriority()
     attr.setPriority (ts::ThreadAttributes::GetNormalPriority());
     TSUNIT_ASSERT(attr.getPriority() == ts::ThreadAttributes::GetNormalPriority());
 }
+
+void ThreadAttributesTest::testAffinity()
+{
+    ts::ThreadAttributes attr;
+    TSUNIT_ASSERT(attr.getAffinity().empty()); // default value
+
+    std::set<size_t> cpus;
+    cpus.insert(0);
+    cpus.insert(3);
+    TSUNIT_ASSERT(attr.setAffinity(cpus).getAffinity() == cpus);
+    TSUNIT_ASSERT(attr.setAffinity(std::set<size_t>()).getAffinity().empty());
+}
@@ -52,6 +52,7 @@ public:
 
     void testIsSpace();
     void testUTF();
+    void testUTFBlocks();
     void testDiacritical();
     void testSurrogate();
     void testFromWChar();
@@ -107,6 +108,7 @@ public:
     TSUNIT_TEST_BEGIN(UStringTest);
     TSUNIT_TEST(testIsSpace);
     TSUNIT_TEST(testUTF);
+    TSUNIT_TEST(testUTFBlocks);
     TSUNIT_TEST(testDiacritical);
     TSUNIT_TEST(testSurrogate);
     TSUNIT_TEST(testFromWChar);
@@ -321,6 +323,32 @@ void UStringTest::testUTF()
     TSUNIT_EQUAL(s1, s4);
 }
 
+void UStringTest::testUTFBlocks()
+{
+    // Long ASCII sequences with non-ASCII characters at all possible offsets
+    // to exercise the ASCII block conversions and their boundaries.
+    static const uint32_t codes[] = {0x00E9, 0x20AC, 0x1F600};
+    for (size_t len = 0; len < 70; ++len) {
+        for (size_t ic = 0; ic < 3; ++ic) {
+            for (size_t pos = 0; pos <= len; pos += 7) {
+                ts::UString str;
+                std::string utf8;
+                for (size_t i = 0; i < len; ++i) {
+                    if (i == pos) {
+                        str.append(codes[ic]);
+                        utf8.append(ic == 0 ? "\xC3\xA9" : (ic == 1 ? "\xE2\x82\xAC" : "\xF0\x9F\x98\x80"));
+                    }
+                    const char c = char('A' + (i % 26));
+                    str.push_back(ts::UChar(c));
+                    utf8.push_back(c);
+                }
+                TSUNIT_EQUAL(utf8, str.toUTF8());
+                TSUNIT_EQUAL(str, ts::UString::FromUTF8(utf8));
+            }
+        }
+    }
+}
+
 void UStringTest::testDiacritical()
 {
     TSUNIT_ASSERT(!ts::IsCombiningDiacritical(ts::UChar('a')));
@@ -31,9 +31,14 @@
 //
 //----------------------------------------------------------------------------
 
+#include "tsxmlCompiledModel.h"
 #include "tsxmlModelDocument.h"
+#include "tsxmlStreamWriter.h"
+#include "tsxmlJSONConverter.h"
+#include "tsjson.h"
 #include "tsxmlElement.h"
 #include "tsSectionFile.h"
+#include "tsDuckContext.h"
 #include "tsTextFormatter.h"
 #include "tsCerrReport.h"
 #include "tsReportBuffer.h"
@@ -58,22 +63,28 @@ public:
     void testInvalid();
     void testFileBOM();
     void testValidation();
+    void testCompiledModel();
+    void testStreamWriter();
     void testCreation();
     void testKeepOpen();
     void testEscape();
     void testTweaks();
     void testChannels();
+    void testAttributes();
 
     TSUNIT_TEST_BEGIN(XMLTest);
     TSUNIT_TEST(testDocument);
     TSUNIT_TEST(testInvalid);
     TSUNIT_TEST(testFileBOM);
     TSUNIT_TEST(testValidation);
+    TSUNIT_TEST(testCompiledModel);
+    TSUNIT_TEST(testStreamWriter);
     TSUNIT_TEST(testCreation);
     TSUNIT_TEST(testKeepOpen);
     TSUNIT_TEST(testEscape);
     TSUNIT_TEST(testTweaks);
     TSUNIT_TEST(testChannels);
+    TSUNIT_TEST(testAttributes);
     TSUNIT_TEST_END();
 
 private:
@@ -280,6 +291,165 @@ void XMLTest::testValidation()
     TSUNIT_ASSERT(model.validate(doc));
 }
 
+void XMLTest::testCompiledModel()
+{
+    ts::xml::ModelDocument model(report());
+    TSUNIT_ASSERT(model.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<root>\n"
+        u"  <_items>\n"
+        u"    <item id='' name=''/>\n"
+        u"  </_items>\n"
+        u"  <list size=''>\n"
+        u"    <header/>\n"
+        u"    <_any in='_items'/>\n"
+        u"  </list>\n"
+        u"</root>"));
+
+    ts::xml::CompiledModel compiled;
+    TSUNIT_ASSERT(!compiled.isValid());
+    TSUNIT_ASSERT(compiled.compile(model, report()));
+    TSUNIT_ASSERT(compiled.isValid());
+
+    ts::ReportBuffer<> rep;
+    ts::xml::Document doc(rep);
+    TSUNIT_ASSERT(doc.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<ROOT>\n"
+        u"  <list Size='2'>\n"
+        u"    <Header/>\n"
+        u"    <item id='1' name='foo'/>\n"
+        u"    <ITEM id='2'/>\n"
+        u"  </list>\n"
+        u"</ROOT>"));
+    TSUNIT_ASSERT(compiled.validate(doc));
+    TSUNIT_ASSERT(model.validate(doc));
+    TSUNIT_ASSERT(rep.emptyMessages());
+
+    ts::xml::Document doc2(rep);
+    TSUNIT_ASSERT(doc2.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<root>\n"
+        u"  <list>\n"
+        u"    <item id='1' value='foo'/>\n"
+        u"    <other/>\n"
+        u"  </list>\n"
+        u"</root>"));
+    TSUNIT_ASSERT(!compiled.validate(doc2));
+    debug() << "XMLTest::testCompiledModel: " << rep.getMessages() << std::endl;
+    TSUNIT_EQUAL(u"Error: unexpected attribute 'value' in <item>, line 4\n"
+                 u"Error: unexpected node <other> in <list>, line 5",
+                 rep.getMessages());
+
+    // Invalid reference in model.
+    ts::xml::ModelDocument badModel(report());
+    TSUNIT_ASSERT(badModel.parse(u"<?xml version='1.0' encoding='UTF-8'?><root><a><_any in='_none'/></a></root>"));
+    TSUNIT_ASSERT(!compiled.compile(badModel, NULLREP));
+    TSUNIT_ASSERT(!compiled.isValid());
+
+    // The process-wide cache returns the same compiled model.
+    const ts::xml::CompiledModelPtr tables1(ts::xml::CompiledModel::Cached(TS_XML_TABLES_MODEL, report()));
+    const ts::xml::CompiledModelPtr tables2(ts::xml::CompiledModel::Cached(TS_XML_TABLES_MODEL, report()));
+    TSUNIT_ASSERT(!tables1.isNull());
+    TSUNIT_ASSERT(tables1.pointer() == tables2.pointer());
+    TSUNIT_ASSERT(ts::xml::CompiledModel::Cached(u"non-existent-model.xml", NULLREP).isNull());
+
+    ts::DuckContext duck;
+    ts::SectionFile file(duck);
+    TSUNIT_ASSERT(file.parseXML(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<tsduck>\n"
+        u"  <PAT version='2' transport_stream_id='27'>\n"
+        u"    <service service_id='1' program_map_PID='1000'/>\n"
+        u"  </PAT>\n"
+        u"</tsduck>", report()));
+    TSUNIT_EQUAL(1, file.tables().size());
+}
+
+void XMLTest::testStreamWriter()
+{
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(doc.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<root a1=\"x'y\" a2='x\"y&amp;z'>\n"
+        u"  <!-- comment -->\n"
+        u"  <child name='\u00E9t\u00E9'>\n"
+        u"    Some   text &lt;here&gt;\n"
+        u"  </child>\n"
+        u"  <empty/>\n"
+        u"  <data><![CDATA[  raw <data> ]]></data>\n"
+        u"</root>"));
+
+    // Reference one-liner.
+    ts::TextFormatter text(report());
+    text.setString();
+    text.setEndOfLineMode(ts::TextFormatter::EndOfLineMode::SPACING);
+    doc.print(text);
+
+    ts::xml::StreamWriter writer;
+    writer.write(doc);
+    debug() << "XMLTest::testStreamWriter: XML: \"" << writer.toString() << "\"" << std::endl;
+    TSUNIT_EQUAL(text.toString(), writer.toString());
+    TSUNIT_EQUAL(0, writer.depth());
+
+    writer.setFormat(ts::xml::StreamWriter::Format::JSON);
+    TSUNIT_ASSERT(writer.utf8().empty());
+    writer.write(doc);
+    debug() << "XMLTest::testStreamWriter: JSON: " << writer.toString() << std::endl;
+    TSUNIT_EQUAL(u"{\"#name\":\"root\",\"a1\":\"x'y\",\"a2\":\"x\\\"y&z\",\"#nodes\":["
+                 u"{\"#name\":\"child\",\"name\":\"\\u00E9t\\u00E9\",\"#nodes\":[\"\\n    Some   text <here>\\n  \"]},"
+                 u"{\"#name\":\"empty\"},"
+                 u"{\"#name\":\"data\",\"#nodes\":[\"  raw <data> \"]}]}",
+                 writer.toString());
+
+    // SAX-style events.
+    writer.setFormat(ts::xml::StreamWriter::Format::XML);
+    writer.startElement(u"a");
+    writer.attribute(u"x", u"1");
+    TSUNIT_EQUAL(1, writer.depth());
+    writer.startElement(u"b");
+    writer.text(u" t ");
+    writer.endElement();
+    writer.startElement(u"c");
+    writer.endElement();
+    writer.endElement();
+    TSUNIT_EQUAL(0, writer.depth());
+    TSUNIT_EQUAL("<a x=\"1\"> <b>t</b> <c/> </a>", writer.utf8());
+
+    // Typed JSON with the tables model, same values as JSONConverter.
+    ts::xml::Document pat(report());
+    TSUNIT_ASSERT(pat.parse(
+        u"<?xml version='1.0' encoding='UTF-8'?>\n"
+        u"<tsduck>\n"
+        u"  <PAT version='2' current='true' transport_stream_id='0x001B' network_PID='16'>\n"
+        u"    <service service_id='1' program_map_PID='1,000'/>\n"
+        u"  </PAT>\n"
+        u"  <generic_short_table table_id='0x99' private='false'>\n"
+        u"    01 02 03\n"
+        u"  </generic_short_table>\n"
+        u"</tsduck>"));
+
+    writer.setFormat(ts::xml::StreamWriter::Format::JSON);
+    writer.setModel(ts::SectionFile::CompiledTablesModel(report()));
+    writer.write(pat);
+    debug() << "XMLTest::testStreamWriter: typed JSON: " << writer.toString() << std::endl;
+    TSUNIT_EQUAL(u"{\"#name\":\"tsduck\",\"#nodes\":["
+                 u"{\"#name\":\"PAT\",\"version\":2,\"current\":true,\"transport_stream_id\":27,\"network_PID\":16,\"#nodes\":["
+                 u"{\"#name\":\"service\",\"service_id\":1,\"program_map_PID\":1000}]},"
+                 u"{\"#name\":\"generic_short_table\",\"table_id\":153,\"private\":false,\"#nodes\":[\"01 02 03\"]}]}",
+                 writer.toString());
+
+    ts::xml::JSONConverterArgs args;
+    ts::xml::JSONConverter converter(args, report());
+    TSUNIT_ASSERT(ts::SectionFile::LoadModel(converter));
+    const ts::json::ValuePtr expected(converter.convert(pat, true));
+    ts::json::ValuePtr actual;
+    TSUNIT_ASSERT(!expected.isNull());
+    TSUNIT_ASSERT(ts::json::Parse(actual, writer.toString(), report()));
+    // JSONConverter uses the lower-case attribute keys of the XML elements.
+    TSUNIT_EQUAL(expected->printed().toLower(), actual->printed().toLower());
+}
+
 void XMLTest::testCreation()
 {
     ts::xml::Document doc(report());
@@ -489,3 +659,32 @@ void XMLTest::testChannels()
     ts::xml::Document model(report());
     TSUNIT_ASSERT(model.load(TS_XML_TABLES_MODEL));
 }
+
+void XMLTest::testAttributes()
+{
+    ts::xml::Document doc(report());
+    TSUNIT_ASSERT(doc.parse(u"<root Zeta='1' alpha=\"2\" Mid='3'/>"));
+    ts::xml::Element* root = doc.rootElement();
+    TSUNIT_ASSERT(root != nullptr);
+
+    // Case-insensitive lookup, original case of names is preserved.
+    TSUNIT_ASSERT(root->hasAttribute(u"zeta"));
+    TSUNIT_ASSERT(root->hasAttribute(u"ALPHA"));
+    TSUNIT_ASSERT(!root->hasAttribute(u"alph"));
+    TSUNIT_EQUAL(u"Zeta", root->attribute(u"ZETA").name());
+    TSUNIT_EQUAL(u"2", root->attribute(u"Alpha").value());
+
+    // Names are returned sorted by key, attributes are printed in modification order.
+    ts::UStringList names;
+    root->getAttributesNames(names);
+    TSUNIT_EQUAL(u"alpha, Mid, Zeta", ts::UString::Join(names));
+    root->setIntAttribute(u"ZETA", 4);
+    root->setAttribute(u"new", u"5");
+    root->deleteAttribute(u"mid");
+    TSUNIT_ASSERT(!root->hasAttribute(u"Mid"));
+    TSUNIT_EQUAL(u"<root alpha=\"2\" Zeta=\"4\" new=\"5\"/>\n", doc.toString());
+
+    // Duplicate attributes are rejected, whatever the case.
+    ts::xml::Document doc2(NULLREP);
+    TSUNIT_ASSERT(!doc2.parse(u"<root a='1' A='2'/>"));
+}